@@ -255,6 +255,7 @@ CTX.INPUT['common'] = """
  SerializableEEException.cpp
  SQLException.cpp
  InterruptException.cpp
+ StringDictionary.cpp
  StringRef.cpp
  tabletuple.cpp
  TupleSchema.cpp
@@ -266,8 +267,10 @@ CTX.INPUT['common'] = """
  executorcontext.cpp
  serializeio.cpp
  StreamPredicateList.cpp
+ TDigest.cpp
  Topend.cpp
  TupleOutputStream.cpp
+ TupleSerializationPlan.cpp
  TupleOutputStreamProcessor.cpp
  MiscUtil.cpp
  debuglog.cpp
@@ -275,13 +278,17 @@ CTX.INPUT['common'] = """
 
 CTX.INPUT['execution'] = """
  FragmentManager.cpp
+ FragmentResultCache.cpp
+ FragmentResultCacheStats.cpp
  JNITopend.cpp
+ KeyValueBatch.cpp
  VoltDBEngine.cpp
  ExecutorVector.cpp
 """
 
 CTX.INPUT['executors'] = """
  OptimizedProjector.cpp
+ ParallelScan.cpp
  abstractexecutor.cpp
  abstractjoinexecutor.cpp
  aggregateexecutor.cpp
@@ -315,10 +322,12 @@ CTX.INPUT['expressions'] = """
  expressionutil.cpp
  functionexpression.cpp
  geofunctions.cpp
+ inlistexpression.cpp
  operatorexpression.cpp
  parametervalueexpression.cpp
  scalarvalueexpression.cpp
  subqueryexpression.cpp
+ subqueryresultmemo.cpp
  tupleaddressexpression.cpp
  vectorexpression.cpp
 """
@@ -367,6 +376,8 @@ CTX.INPUT['storage'] = """
  AbstractDRTupleStream.cpp
  BinaryLogSink.cpp
  BinaryLogSinkWrapper.cpp
+ ColdBlockStore.cpp
+ CompactionStats.cpp
  ConstraintFailureException.cpp
  constraintutil.cpp
  CopyOnWriteContext.cpp
@@ -383,6 +394,7 @@ CTX.INPUT['storage'] = """
  persistenttable.cpp
  PersistentTableStats.cpp
  RecoveryContext.cpp
+ SnapshotReadContext.cpp
  streamedtable.cpp
  StreamedTableStats.cpp
  table.cpp
@@ -394,6 +406,7 @@ CTX.INPUT['storage'] = """
  tableutil.cpp
  tabletuplefilter.cpp
  temptable.cpp
+ TempTableBlockPool.cpp
  TempTableLimits.cpp
  TupleBlock.cpp
  TupleStreamBase.cpp
@@ -481,11 +494,13 @@ if whichtests in ("${eetestsuite}", "common"):
      pool_test
      serializeio_test
      tabletuple_test
+     tdigest_test
      ThreadLocalPoolTest
      tupleschema_test
      undolog_test
      valuearray_test
      uniqueid_test
+     DecimalBenchmark
     """
 
 if whichtests in ("${eetestsuite}", "execution"):
@@ -498,12 +513,19 @@ if whichtests in ("${eetestsuite}", "executors"):
     CTX.TESTS['executors'] = """
     OptimizedProjectorTest
     MergeReceiveExecutorTest
+    NestLoopIndexExecutorTest
+    ParallelScanTest
+    PipelinedExecutionTest
+    SetOperationsTest
+    SubqueryMemoTest
     TestGeneratedPlans
+    TopNTest
     TestWindowedRank
     TestWindowedCount
     TestWindowedMin
     TestWindowedMax
     TestWindowedSum
+    ExecutorBenchmark
     """
 
 if whichtests in ("${eetestsuite}", "expressions"):
@@ -531,6 +553,7 @@ if whichtests in ("${eetestsuite}", "storage"):
      ExportTupleStream_test
      PersistentTableMemStatsTest
      StreamedTable_test
+     TempTableBlockPoolTest
      TempTableLimitsTest
      constraint_test
      filter_test
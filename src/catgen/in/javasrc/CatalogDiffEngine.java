@@ -964,7 +964,14 @@ public class CatalogDiffEngine {
             if (field.equals("defaulttype")) {
                 return null;
             }
-            if (field.equals("nullable")) {
+            // Values written from now on are shared; the EE can't stop sharing
+            if (field.equals("dictionary")) {
+                Boolean dictionary = (Boolean) suspect.getField(field);
+                assert(dictionary != null);
+                if (dictionary) return null;
+                restrictionQualifier = " from dictionary to no dictionary";
+            }
+            else if (field.equals("nullable")) {
                 Boolean nullable = (Boolean) suspect.getField(field);
                 assert(nullable != null);
                 if (nullable) return null;
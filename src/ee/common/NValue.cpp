@@ -114,6 +114,11 @@ TTInt NValue::s_minDecimalValue("-9999999999"   //10 digits
                                  "9999999999"   //30 digits
                                  "99999999");    //38 digits
 
+// 10**38 - 1, built from 10**19 since integer literals stop at 64 bits
+const NativeDecimal NValue::s_maxNativeDecimalValue =
+        static_cast<NativeDecimal>(10000000000000000000ULL) * 10000000000000000000ULL - 1;
+const NativeDecimal NValue::s_minNativeDecimalValue = -NValue::s_maxNativeDecimalValue;
+
 const double NValue::s_gtMaxDecimalAsDouble = 1E26;
 const double NValue::s_ltMinDecimalAsDouble = -1E26;
 
@@ -207,29 +212,28 @@ std::string NValue::debug() const {
  */
 std::string NValue::createStringFromDecimal() const {
     assert(!isNull());
-    std::ostringstream buffer;
-    TTInt scaledValue = getDecimal();
-    if (scaledValue.IsSign()) {
-        buffer << '-';
-    }
-    TTInt whole(scaledValue);
-    TTInt fractional(scaledValue);
-    whole /= NValue::kMaxScaleFactor;
-    fractional %= NValue::kMaxScaleFactor;
-    if (whole.IsSign()) {
-        whole.ChangeSign();
+    const NativeDecimal scaledValue = getNativeDecimal();
+    unsigned __int128 magnitude = static_cast<unsigned __int128>(scaledValue);
+    if (scaledValue < 0) {
+        magnitude = -magnitude;
     }
-    buffer << whole.ToString(10);
-    buffer << '.';
-    if (fractional.IsSign()) {
-        fractional.ChangeSign();
-    }
-    std::string fractionalString = fractional.ToString(10);
-    for (int ii = static_cast<int>(fractionalString.size()); ii < NValue::kMaxDecScale; ii++) {
-        buffer << '0';
+    const unsigned __int128 whole = magnitude / NValue::kMaxScaleFactor;
+    const uint64_t fractional = static_cast<uint64_t>(magnitude % NValue::kMaxScaleFactor);
+    // At most 26 whole digits, so they print as two 64-bit pieces of up to 18 digits each
+    const uint64_t pieceFactor = 1000000000000000000ULL;  // == 10**18
+    const char* sign = (scaledValue < 0) ? "-" : "";
+    char buffer[64];
+    if (whole < pieceFactor) {
+        snprintf(buffer, sizeof(buffer), "%s%llu.%012llu", sign,
+                 static_cast<unsigned long long>(whole),
+                 static_cast<unsigned long long>(fractional));
+    } else {
+        snprintf(buffer, sizeof(buffer), "%s%llu%018llu.%012llu", sign,
+                 static_cast<unsigned long long>(whole / pieceFactor),
+                 static_cast<unsigned long long>(whole % pieceFactor),
+                 static_cast<unsigned long long>(fractional));
     }
-    buffer << fractionalString;
-    return buffer.str();
+    return std::string(buffer);
 }
 
 /**
@@ -408,10 +412,8 @@ bool NValue::inList(const NValue& rhs) const
     }
     const NValueList* listOfNValues = reinterpret_cast<const NValueList*>(rhs.getObjectValue_withoutNull());
     const StlFriendlyNValue& value = *static_cast<const StlFriendlyNValue*>(this);
-    //TODO: An O(ln(length)) implementation vs. the current O(length) implementation
-    // such as binary search would likely require some kind of sorting/re-org of values
-    // post-update/pre-lookup, and would likely require some sortable inequality method
-    // (operator<()?) to be defined on StlFriendlyNValue.
+    // Lists that are the same for every row are arranged for O(1)/O(ln(length))
+    // lookups by InListLookup instead; this covers the rest.
     return std::find(listOfNValues->begin(), listOfNValues->end(), value) != listOfNValues->end();
 }
 
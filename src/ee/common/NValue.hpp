@@ -68,6 +68,8 @@ namespace voltdb {
 typedef ttmath::Int<2> TTInt;
 //Long integer with space for multiplication and division without carry/overflow
 typedef ttmath::Int<4> TTLInt;
+//Native integer with the same two's complement bits as a TTInt, for the DECIMAL fast paths
+typedef __int128 NativeDecimal;
 
 template<typename T>
 void throwCastSQLValueOutOfRangeException(
@@ -452,6 +454,9 @@ class NValue {
     template <int F> // template for SQL functions of multiple NValues
     static NValue call(const std::vector<NValue>& arguments);
 
+    template <int F, typename CACHE> // template for SQL functions of multiple NValues that can reuse
+    static NValue call(const std::vector<NValue>& arguments, CACHE& cache); // work done by earlier calls
+
     /// Iterates over UTF8 strings one character "code point" at a time, being careful not to walk off the end.
     class UTF8Iterator {
     public:
@@ -753,6 +758,8 @@ private:
     static ValueType s_doublePromotionTable[];
     static TTInt s_maxDecimalValue;
     static TTInt s_minDecimalValue;
+    static const NativeDecimal s_maxNativeDecimalValue;
+    static const NativeDecimal s_minNativeDecimalValue;
     // These initializers give the unique double values that are
     // closest but not equal to +/-1E26 within the accuracy of a double.
     static const double s_gtMaxDecimalAsDouble;
@@ -845,6 +852,33 @@ private:
     const StringRef* getObjectPointer() const
     { return *reinterpret_cast<const StringRef* const*>(m_data); }
 
+    /**
+     * Two strings shared through the same StringDictionary are equal
+     * exactly when they are the same StringRef. Returns whether that
+     * applies, setting equal if it does.
+     */
+    bool compareSharedStrings(const NValue& rhs, bool& equal) const
+    {
+        if (m_valueType != VALUE_TYPE_VARCHAR || rhs.m_valueType != VALUE_TYPE_VARCHAR ||
+                m_sourceInlined || rhs.m_sourceInlined) {
+            return false;
+        }
+        const StringRef* left = getObjectPointer();
+        const StringRef* right = rhs.getObjectPointer();
+        if (left == NULL || right == NULL) {
+            return false;
+        }
+        if (left == right) {
+            equal = true;
+            return true;
+        }
+        if (left->isShared() && right->isShared() && left->getDictionary() == right->getDictionary()) {
+            equal = false;
+            return true;
+        }
+        return false;
+    }
+
     const char* getObjectValue_withoutNull() const
     {
         if (m_sourceInlined) {
@@ -942,6 +976,23 @@ private:
         return *reinterpret_cast<TTInt*>(retval);
     }
 
+    /** the decimal reassembled from the two words of its TTInt, low word first */
+    NativeDecimal getNativeDecimal() const {
+
+        BOOST_STATIC_ASSERT_MSG(sizeof(ttmath::uint) == sizeof(uint64_t),
+                                "Native decimals need ttmath to use 64-bit words");
+
+        const TTInt& value = getDecimal();
+        return static_cast<NativeDecimal>((static_cast<unsigned __int128>(value.table[1]) << 64) |
+                                          value.table[0]);
+    }
+
+    void setNativeDecimal(NativeDecimal value) {
+        TTInt& target = getDecimal();
+        target.table[0] = static_cast<uint64_t>(value);
+        target.table[1] = static_cast<uint64_t>(static_cast<unsigned __int128>(value) >> 64);
+    }
+
     const bool& getBoolean() const {
         assert(getValueType() == VALUE_TYPE_BOOLEAN);
         return *reinterpret_cast<const bool*>(m_data);
@@ -1968,6 +2019,12 @@ private:
 
         assert(m_valueType == VALUE_TYPE_VARCHAR);
 
+        // The same StringRef is the same string, which is common for
+        // strings shared through a StringDictionary.
+        if (!m_sourceInlined && !rhs.m_sourceInlined && getObjectPointer() == rhs.getObjectPointer()) {
+            return VALUE_COMPARE_EQUAL;
+        }
+
         int32_t leftLength;
         const char* left = getObject_withoutNull(&leftLength);
         int32_t rightLength;
@@ -2024,7 +2081,7 @@ private:
         assert(m_valueType == VALUE_TYPE_DECIMAL);
         switch (rhs.getValueType()) {
         case VALUE_TYPE_DECIMAL:
-            return compareValue<TTInt>(getDecimal(), rhs.getDecimal());
+            return compareValue<NativeDecimal>(getNativeDecimal(), rhs.getNativeDecimal());
         case VALUE_TYPE_DOUBLE: {
             const double rhsValue = rhs.getDouble();
             TTInt scaledValue = getDecimal();
@@ -2228,8 +2285,9 @@ private:
         assert(lhs.getValueType() == VALUE_TYPE_DECIMAL);
         assert(rhs.getValueType() == VALUE_TYPE_DECIMAL);
 
-        TTInt retval(lhs.getDecimal());
-        if (retval.Add(rhs.getDecimal()) || retval > s_maxDecimalValue || retval < s_minDecimalValue) {
+        // The sum of two in-range decimals always fits in 128 bits, so only its range needs checking.
+        const NativeDecimal retval = lhs.getNativeDecimal() + rhs.getNativeDecimal();
+        if (retval > s_maxNativeDecimalValue || retval < s_minNativeDecimalValue) {
             char message[4096];
             snprintf(message, 4096, "Attempted to add %s with %s causing overflow/underflow",
                     lhs.createStringFromDecimal().c_str(), rhs.createStringFromDecimal().c_str());
@@ -2237,7 +2295,7 @@ private:
                                message);
         }
 
-        return getDecimalValue(retval);
+        return getNativeDecimalValue(retval);
     }
 
     static NValue opSubtractDecimals(const NValue& lhs, const NValue& rhs) {
@@ -2246,8 +2304,8 @@ private:
         assert(lhs.getValueType() == VALUE_TYPE_DECIMAL);
         assert(rhs.getValueType() == VALUE_TYPE_DECIMAL);
 
-        TTInt retval(lhs.getDecimal());
-        if (retval.Sub(rhs.getDecimal()) || retval > s_maxDecimalValue || retval < s_minDecimalValue) {
+        const NativeDecimal retval = lhs.getNativeDecimal() - rhs.getNativeDecimal();
+        if (retval > s_maxNativeDecimalValue || retval < s_minNativeDecimalValue) {
             char message[4096];
             snprintf(message, 4096, "Attempted to subtract %s from %s causing overflow/underflow",
                     rhs.createStringFromDecimal().c_str(), lhs.createStringFromDecimal().c_str());
@@ -2255,7 +2313,7 @@ private:
                                message);
         }
 
-        return getDecimalValue(retval);
+        return getNativeDecimalValue(retval);
     }
 
     /*
@@ -2263,6 +2321,8 @@ private:
      * (dec * 2*kMaxScale*E-12). Then the result of simple multiplication
      * is a*b*E-24 and have to further multiply to get back to the assumed
      * E-12, which can overflow unnecessarily at the middle step.
+     * Operands that each fit in 64 bits have a product that fits in 128,
+     * so only larger ones or overflowing results need the 256-bit TTLInt.
      */
     static NValue opMultiplyDecimals(const NValue& lhs, const NValue& rhs) {
         assert(lhs.isNull() == false);
@@ -2270,6 +2330,15 @@ private:
         assert(lhs.getValueType() == VALUE_TYPE_DECIMAL);
         assert(rhs.getValueType() == VALUE_TYPE_DECIMAL);
 
+        const NativeDecimal lhsValue = lhs.getNativeDecimal();
+        const NativeDecimal rhsValue = rhs.getNativeDecimal();
+        if (lhsValue == static_cast<int64_t>(lhsValue) && rhsValue == static_cast<int64_t>(rhsValue)) {
+            const NativeDecimal retval = lhsValue * rhsValue / kMaxScaleFactor;
+            if (retval <= s_maxNativeDecimalValue && retval >= s_minNativeDecimalValue) {
+                return getNativeDecimalValue(retval);
+            }
+        }
+
         TTLInt calc;
         calc.FromInt(lhs.getDecimal());
         calc *= rhs.getDecimal();
@@ -2297,6 +2366,9 @@ private:
      *   (5) scale the quotient back to 19,12.
      *   (6) sum the scaled quotient and remainder.
      *   (7) construct the final decimal.
+     * A dividend under 2**86 can be scaled by 10**12 (under 2**40) without
+     * leaving 128 bits, so only larger ones, zero divisors and overflowing
+     * results need the 256-bit TTLInt.
      */
 
     static NValue opDivideDecimals(const NValue& lhs, const NValue& rhs) {
@@ -2305,6 +2377,16 @@ private:
         assert(lhs.getValueType() == VALUE_TYPE_DECIMAL);
         assert(rhs.getValueType() == VALUE_TYPE_DECIMAL);
 
+        const NativeDecimal lhsValue = lhs.getNativeDecimal();
+        const NativeDecimal rhsValue = rhs.getNativeDecimal();
+        const NativeDecimal scalableLimit = static_cast<NativeDecimal>(1) << 86;
+        if (rhsValue != 0 && lhsValue < scalableLimit && lhsValue > -scalableLimit) {
+            const NativeDecimal retval = lhsValue * kMaxScaleFactor / rhsValue;
+            if (retval <= s_maxNativeDecimalValue && retval >= s_minNativeDecimalValue) {
+                return getNativeDecimalValue(retval);
+            }
+        }
+
         TTLInt calc;
         calc.FromInt(lhs.getDecimal());
         calc *= kMaxScaleFactor;
@@ -2446,6 +2528,12 @@ private:
         return retval;
     }
 
+    static NValue getNativeDecimalValue(NativeDecimal value) {
+        NValue retval(VALUE_TYPE_DECIMAL);
+        retval.setNativeDecimal(value);
+        return retval;
+    }
+
     static NValue getAddressValue(void *address) {
         NValue retval(VALUE_TYPE_ADDRESS);
         *reinterpret_cast<void**>(retval.m_data) = address;
@@ -3298,9 +3386,8 @@ inline bool NValue::isNull() const {
     // representation in m_data, and the object null bit
     // (if set) lives in m_data[13].
     if (getValueType() == VALUE_TYPE_DECIMAL) {
-        TTInt min;
-        min.SetMin();
-        return getDecimal() == min;
+        // the null decimal is TTInt's minimum, the most negative 128-bit value
+        return getNativeDecimal() == static_cast<NativeDecimal>(static_cast<unsigned __int128>(1) << 127);
     }
     else if (getValueType() == VALUE_TYPE_POINT) {
         return getGeographyPointValue().isNull();
@@ -3343,10 +3430,18 @@ inline NValue NValue::op_greaterThanOrEqual(const NValue& rhs) const {
 
 // without null comparison
 inline NValue NValue::op_equals_withoutNull(const NValue& rhs) const {
+    bool equal;
+    if (compareSharedStrings(rhs, equal)) {
+        return equal ? getTrue() : getFalse();
+    }
     return compare_withoutNull(rhs) == 0 ? getTrue() : getFalse();
 }
 
 inline NValue NValue::op_notEquals_withoutNull(const NValue& rhs) const {
+    bool equal;
+    if (compareSharedStrings(rhs, equal)) {
+        return equal ? getFalse() : getTrue();
+    }
     return compare_withoutNull(rhs) != 0 ? getTrue() : getFalse();
 }
 
@@ -3411,9 +3506,15 @@ inline void NValue::hashCombine(std::size_t &seed) const {
             boost::hash_combine( seed, std::string(""));
             return;
         }
+        // Combining hash_range over the bytes is the same as combining the
+        // hash of a std::string of them, without building the string.
+        if (!m_sourceInlined && getObjectPointer()->isShared()) {
+            boost::hash_combine(seed, getObjectPointer()->getSharedHash());
+            return;
+        }
         int32_t length;
         const char* buf = getObject_withoutNull(&length);
-        boost::hash_combine(seed, std::string(buf, length));
+        boost::hash_combine(seed, boost::hash_range(buf, buf + length));
         return;
     }
     case VALUE_TYPE_VARBINARY:
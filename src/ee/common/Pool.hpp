@@ -218,6 +218,12 @@ public:
      */
     inline void* allocateZeroes(std::size_t size) { return ::memset(allocate(size), 0, size); }
 
+    /*
+     * Set how many chunks purge() keeps for reuse. Chunks beyond the
+     * count are freed by the next purge().
+     */
+    inline void setMaxChunkCount(std::size_t maxChunkCount) { m_maxChunkCount = maxChunkCount; }
+
     inline void purge() {
         /*
          * Erase any oversize chunks that were allocated
@@ -264,7 +270,7 @@ public:
         }
     }
 
-    int64_t getAllocatedMemory()
+    int64_t getAllocatedMemory() const
     {
         int64_t total = 0;
         total += m_chunks.size() * m_allocationSize;
@@ -322,6 +328,9 @@ public:
      */
     inline void* allocateZeroes(std::size_t size) { return ::memset(allocate(size), 0, size); }
 
+    // Every allocation is freed by purge(), so there are no chunks to keep
+    inline void setMaxChunkCount(std::size_t) { }
+
     inline void purge() {
         for (std::size_t ii = 0; ii < m_allocations.size(); ii++) {
             delete [] m_allocations[ii];
@@ -330,7 +339,7 @@ public:
         m_memTotal = 0;
     }
 
-    int64_t getAllocatedMemory()
+    int64_t getAllocatedMemory() const
     {
         return m_memTotal;
     }
@@ -0,0 +1,93 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StringDictionary.h"
+
+#include <cstring>
+
+using namespace voltdb;
+
+bool StringDictionary::EntryEqualityChecker::operator()(const StringRef* lhs, const StringRef* rhs) const
+{
+    int32_t lhsLength;
+    const char* lhsBytes = lhs->getObject(&lhsLength);
+    int32_t rhsLength;
+    const char* rhsBytes = rhs->getObject(&rhsLength);
+    return lhsLength == rhsLength && ::memcmp(lhsBytes, rhsBytes, lhsLength) == 0;
+}
+
+bool StringDictionary::ProbeEqualityChecker::operator()(const Probe& probe, const StringRef* sref) const
+{
+    int32_t length;
+    const char* bytes = sref->getObject(&length);
+    return probe.length == length && ::memcmp(probe.bytes, bytes, length) == 0;
+}
+
+StringDictionary::StringDictionary()
+  : m_memorySize(0), m_detached(false)
+{ }
+
+StringRef* StringDictionary::acquire(const char* bytes, int32_t length)
+{
+    Probe probe = { bytes, length, boost::hash_range(bytes, bytes + length) };
+    EntrySet::iterator found = m_entries.find(probe, ProbeHasher(), ProbeEqualityChecker());
+    if (found != m_entries.end()) {
+        (*found)->sharedHeader()->m_refCount++;
+        return *found;
+    }
+    StringRef* sref = StringRef::createShared(this, probe.hash, length, bytes);
+    m_entries.insert(sref);
+    m_memorySize += StringRef::getSharedAllocationSize(length);
+    return sref;
+}
+
+StringRef* StringDictionary::acquire(const StringRef* sref)
+{
+    if (sref->isShared() && sref->getDictionary() == this) {
+        sref->sharedHeader()->m_refCount++;
+        return const_cast<StringRef*>(sref);
+    }
+    int32_t length;
+    const char* bytes = sref->getObject(&length);
+    return acquire(bytes, length);
+}
+
+void StringDictionary::release(StringRef* sref)
+{
+    if (--sref->sharedHeader()->m_refCount == 0) {
+        sref->getDictionary()->free(sref);
+    }
+}
+
+void StringDictionary::free(StringRef* sref)
+{
+    m_entries.erase(sref);
+    m_memorySize -= StringRef::getSharedAllocationSize(sref->getObjectLength());
+    StringRef::destroyShared(sref);
+    if (m_detached && m_entries.empty()) {
+        delete this;
+    }
+}
+
+void StringDictionary::detach()
+{
+    if (m_entries.empty()) {
+        delete this;
+        return;
+    }
+    m_detached = true;
+}
@@ -0,0 +1,102 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STRINGDICTIONARY_H
+#define STRINGDICTIONARY_H
+
+#include "common/StringRef.h"
+
+#include "boost/unordered_set.hpp"
+
+#include <stdint.h>
+
+namespace voltdb
+{
+
+/// Shares one copy of each distinct string among the tuples of a table
+/// column. A tuple in a column with a dictionary holds a pointer to the
+/// dictionary's reference-counted StringRef for its value rather than a
+/// StringRef of its own, so a value stored in many rows takes memory once,
+/// and two values from the same dictionary are equal exactly when they
+/// are the same StringRef.
+///
+/// StringRef::destroy() drops a reference, so shared strings are freed by
+/// the same code that frees any other persistent string. A dictionary
+/// that its table has let go of lives on until its last string is freed.
+class StringDictionary
+{
+public:
+    StringDictionary();
+
+    /// Return the shared string with the given bytes, adding it if this is
+    /// the first reference to it, and count one more reference to it.
+    StringRef* acquire(const char* bytes, int32_t length);
+
+    /// Same as above for the value of a string that may already be shared.
+    StringRef* acquire(const StringRef* sref);
+
+    /// Drop a reference to a shared string, freeing it with the last one.
+    /// Only called by StringRef::destroy().
+    static void release(StringRef* sref);
+
+    /// Give up the table's hold on the dictionary. The dictionary is freed
+    /// now if none of its strings are left, and otherwise with the last one.
+    void detach();
+
+    std::size_t entryCount() const { return m_entries.size(); }
+
+    /// Bytes allocated for the shared strings
+    int64_t memorySize() const { return m_memorySize; }
+
+private:
+    ~StringDictionary() { }
+
+    struct EntryHasher {
+        std::size_t operator()(const StringRef* sref) const { return sref->getSharedHash(); }
+    };
+
+    struct EntryEqualityChecker {
+        bool operator()(const StringRef* lhs, const StringRef* rhs) const;
+    };
+
+    // The bytes of a string being looked up, with their hash
+    struct Probe {
+        const char* bytes;
+        int32_t length;
+        std::size_t hash;
+    };
+
+    struct ProbeHasher {
+        std::size_t operator()(const Probe& probe) const { return probe.hash; }
+    };
+
+    struct ProbeEqualityChecker {
+        bool operator()(const Probe& probe, const StringRef* sref) const;
+    };
+
+    typedef boost::unordered_set<StringRef*, EntryHasher, EntryEqualityChecker> EntrySet;
+
+    void free(StringRef* sref);
+
+    EntrySet m_entries;
+    int64_t m_memorySize;
+    bool m_detached;
+};
+
+} // namespace voltdb
+
+#endif // STRINGDICTIONARY_H
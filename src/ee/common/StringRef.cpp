@@ -18,6 +18,7 @@
 #include "StringRef.h"
 
 #include "Pool.hpp"
+#include "StringDictionary.h"
 #include "ThreadLocalPool.h"
 
 using namespace voltdb;
@@ -48,6 +49,11 @@ const char* StringRef::getObject(int32_t* lengthOut) const
 
 int32_t StringRef::getAllocatedSize() const
 {
+    // A shared string's memory is charged to its dictionary, once for all
+    // of the tuples that hold it.
+    if (isShared()) {
+        return 0;
+    }
     // The CompactingPool allocated a chunk of this size for storage.
     int32_t alloc_size = ThreadLocalPool::getAllocationSizeForRelocatable(asSizedObject(m_stringPtr));
     //cout << "Pool allocation size: " << alloc_size << endl;
@@ -85,6 +91,19 @@ inline StringRef::StringRef(Pool* unused, int32_t sz)
   : m_stringPtr(reinterpret_cast<char*>(this+1))
 { asSizedObject(m_stringPtr)->m_size = sz; }
 
+// Shared strings are allocated in one piece by their StringDictionary,
+// with a SharedHeader between the StringRef and the string data.
+inline StringRef::StringRef(StringDictionary* dictionary, std::size_t hash, int32_t sz)
+  : m_stringPtr(reinterpret_cast<char*>(sharedHeader() + 1))
+{
+    SharedHeader* header = sharedHeader();
+    header->m_magic = SHARED_STRING_MAGIC;
+    header->m_refCount = 1;
+    header->m_hash = hash;
+    header->m_dictionary = dictionary;
+    asSizedObject(m_stringPtr)->m_size = sz;
+}
+
 // The destroy method keeps this from getting run on temporary strings.
 inline StringRef::~StringRef()
 {
@@ -118,6 +137,26 @@ StringRef* StringRef::create(int32_t sz, const char* source, Pool* tempPool)
     return result;
 }
 
+int32_t StringRef::getSharedAllocationSize(int32_t sz)
+{
+    return static_cast<int32_t>(sizeof(StringRef) + sizeof(SharedHeader) +
+                                sizeof(ThreadLocalPool::Sized) + sz);
+}
+
+StringRef* StringRef::createShared(StringDictionary* dictionary, std::size_t hash,
+                                   int32_t sz, const char* source)
+{
+    StringRef* result = new (::operator new(getSharedAllocationSize(sz))) StringRef(dictionary, hash, sz);
+    ::memcpy(result->getObjectValue(), source, sz);
+    return result;
+}
+
+void StringRef::destroyShared(StringRef* sref)
+{
+    sref->sharedHeader()->m_magic = 0;
+    ::operator delete(sref);
+}
+
 // The destroy method keeps this from getting run on temporary strings.
 void StringRef::operator delete(void* sref)
 {
@@ -145,5 +184,10 @@ StringRef::destroy(StringRef* sref)
     if (sref->m_stringPtr == reinterpret_cast<char*>(sref+1)) {
         return;
     }
+    // A shared string is freed by its dictionary once nothing holds it.
+    if (sref->isShared()) {
+        StringDictionary::release(sref);
+        return;
+    }
     delete sref;
 }
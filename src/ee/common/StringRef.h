@@ -18,11 +18,13 @@
 #ifndef STRINGREF_H
 #define STRINGREF_H
 
+#include <cstddef>
 #include <stdint.h>
 
 namespace voltdb
 {
 class Pool;
+class StringDictionary;
 
 /// An object to use in lieu of raw char* pointers for strings
 /// which are not inlined into tuple storage.  This provides a
@@ -67,11 +69,45 @@ public:
 
     const char* getObject(int32_t* lengthOut) const;
 
+    /// Whether this string belongs to a StringDictionary, which shares it
+    /// among all of the tuples in a column that hold the same value.
+    bool isShared() const;
+
+    /// The dictionary that a shared string belongs to.
+    StringDictionary* getDictionary() const;
+
+    /// boost::hash_range over the bytes of a shared string, computed once
+    /// when the string was added to its dictionary.
+    std::size_t getSharedHash() const;
+
 private:
+    friend class StringDictionary;
+
+    // Shared strings are allocated in one piece by their dictionary:
+    // the StringRef, then this header, then the string data.
+    struct SharedHeader {
+        uint32_t m_magic;
+        int32_t m_refCount;
+        std::size_t m_hash;
+        StringDictionary* m_dictionary;
+    };
+
+    static const uint32_t SHARED_STRING_MAGIC = 0x53484152;
+
     // Signature used internally for persistent strings
     StringRef(int32_t size);
     // Signature used internally for temporary strings
     StringRef(Pool* tempPool, int32_t size);
+    // Signature used internally for shared strings
+    StringRef(StringDictionary* dictionary, std::size_t hash, int32_t size);
+
+    SharedHeader* sharedHeader() const
+    { return reinterpret_cast<SharedHeader*>(const_cast<StringRef*>(this) + 1); }
+
+    static StringRef* createShared(StringDictionary* dictionary, std::size_t hash,
+                                   int32_t size, const char* bytes);
+    static void destroyShared(StringRef* sref);
+    static int32_t getSharedAllocationSize(int32_t size);
     // Only called from destroy and only for persistent strings.
     ~StringRef();
 
@@ -81,6 +117,20 @@ private:
     char* m_stringPtr;
 };
 
+inline bool StringRef::isShared() const
+{
+    // Nothing else points just past a header placed right after itself;
+    // the magic number is only read once that is known to be the layout.
+    return m_stringPtr == reinterpret_cast<const char*>(sharedHeader() + 1) &&
+           sharedHeader()->m_magic == SHARED_STRING_MAGIC;
+}
+
+inline StringDictionary* StringRef::getDictionary() const
+{ return sharedHeader()->m_dictionary; }
+
+inline std::size_t StringRef::getSharedHash() const
+{ return sharedHeader()->m_hash; }
+
 } // namespace voltdb
 
 #endif // STRINGREF_H
@@ -0,0 +1,177 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TDigest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace voltdb {
+
+TDigest::TDigest(int32_t compression)
+    : m_compression(compression)
+    , m_totalWeight(0)
+    , m_bufferWeight(0)
+    , m_min(std::numeric_limits<double>::infinity())
+    , m_max(-std::numeric_limits<double>::infinity())
+{
+    m_buffer.reserve(bufferLimit());
+}
+
+void TDigest::add(double value, double weight)
+{
+    m_buffer.push_back(Centroid(value, weight));
+    m_bufferWeight += weight;
+    m_min = std::min(m_min, value);
+    m_max = std::max(m_max, value);
+    if (m_buffer.size() >= bufferLimit()) {
+        compress();
+    }
+}
+
+void TDigest::merge(const TDigest& other)
+{
+    for (std::vector<Centroid>::const_iterator it = other.m_centroids.begin(); it != other.m_centroids.end(); ++it) {
+        add(it->mean, it->weight);
+    }
+    for (std::vector<Centroid>::const_iterator it = other.m_buffer.begin(); it != other.m_buffer.end(); ++it) {
+        add(it->mean, it->weight);
+    }
+}
+
+double TDigest::scale(double fraction) const
+{
+    return m_compression / (2 * M_PI) * ::asin(2 * fraction - 1);
+}
+
+void TDigest::compress()
+{
+    if (m_buffer.empty()) {
+        return;
+    }
+    m_buffer.insert(m_buffer.end(), m_centroids.begin(), m_centroids.end());
+    std::sort(m_buffer.begin(), m_buffer.end());
+    m_totalWeight += m_bufferWeight;
+    m_bufferWeight = 0;
+
+    // Sweep the sorted centroids, folding each into the one before it while
+    // the merged centroid still spans no more than one unit of the scale.
+    m_centroids.clear();
+    Centroid current = m_buffer[0];
+    double weightBefore = 0;
+    double scaleBefore = scale(0);
+    for (size_t i = 1; i < m_buffer.size(); ++i) {
+        const Centroid& next = m_buffer[i];
+        double mergedWeight = current.weight + next.weight;
+        if (scale((weightBefore + mergedWeight) / m_totalWeight) - scaleBefore <= 1) {
+            current.mean += (next.mean - current.mean) * next.weight / mergedWeight;
+            current.weight = mergedWeight;
+        }
+        else {
+            m_centroids.push_back(current);
+            weightBefore += current.weight;
+            scaleBefore = scale(weightBefore / m_totalWeight);
+            current = next;
+        }
+    }
+    m_centroids.push_back(current);
+    m_buffer.clear();
+}
+
+double TDigest::quantile(double fraction)
+{
+    compress();
+    if (m_centroids.empty()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (m_centroids.size() == 1) {
+        return m_centroids[0].mean;
+    }
+    fraction = std::max(0.0, std::min(1.0, fraction));
+    double index = fraction * m_totalWeight;
+
+    // Each centroid's mean is taken to sit at the middle of its weight, and
+    // values are interpolated linearly between neighbouring means, and
+    // between the outer means and the minimum and maximum.
+    const Centroid& first = m_centroids.front();
+    if (index < first.weight / 2) {
+        return m_min + (first.mean - m_min) * index / (first.weight / 2);
+    }
+    double weightSoFar = first.weight / 2;
+    for (size_t i = 0; i + 1 < m_centroids.size(); ++i) {
+        const Centroid& left = m_centroids[i];
+        const Centroid& right = m_centroids[i + 1];
+        double gap = (left.weight + right.weight) / 2;
+        if (weightSoFar + gap > index) {
+            return left.mean + (right.mean - left.mean) * (index - weightSoFar) / gap;
+        }
+        weightSoFar += gap;
+    }
+    const Centroid& last = m_centroids.back();
+    double intoLast = std::min(1.0, (index - weightSoFar) / (last.weight / 2));
+    return last.mean + (m_max - last.mean) * intoLast;
+}
+
+void TDigest::clear()
+{
+    m_centroids.clear();
+    m_buffer.clear();
+    m_totalWeight = 0;
+    m_bufferWeight = 0;
+    m_min = std::numeric_limits<double>::infinity();
+    m_max = -std::numeric_limits<double>::infinity();
+}
+
+size_t TDigest::serializedSize()
+{
+    compress();
+    // compression, min, max, centroid count, then the centroids
+    return sizeof(int32_t) + 2 * sizeof(double) + sizeof(int32_t) + m_centroids.size() * 2 * sizeof(double);
+}
+
+void TDigest::serializeTo(SerializeOutput& output)
+{
+    compress();
+    output.writeInt(m_compression);
+    output.writeDouble(m_min);
+    output.writeDouble(m_max);
+    output.writeInt(static_cast<int32_t>(m_centroids.size()));
+    for (std::vector<Centroid>::const_iterator it = m_centroids.begin(); it != m_centroids.end(); ++it) {
+        output.writeDouble(it->mean);
+        output.writeDouble(it->weight);
+    }
+}
+
+void TDigest::mergeSerialized(SerializeInputBE& input)
+{
+    input.readInt();    // the compression it was built with
+    double min = input.readDouble();
+    double max = input.readDouble();
+    int32_t count = input.readInt();
+    for (int32_t i = 0; i < count; ++i) {
+        double mean = input.readDouble();
+        double weight = input.readDouble();
+        add(mean, weight);
+    }
+    if (count > 0) {
+        m_min = std::min(m_min, min);
+        m_max = std::max(m_max, max);
+    }
+}
+
+} // namespace voltdb
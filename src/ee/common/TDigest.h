@@ -0,0 +1,98 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDIGEST_H_
+#define TDIGEST_H_
+
+#include "common/serializeio.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace voltdb {
+
+/**
+ * A mergeable sketch of a distribution of doubles, from which quantiles can
+ * be estimated (a merging t-digest). Values are summarized by centroids,
+ * each a mean and a weight; centroids near the tails are kept small, so
+ * that extreme quantiles such as p99 stay accurate, and the number of
+ * centroids is bounded by about the compression, whatever the number of
+ * values added. Digests built separately can be merged, which is how
+ * partitions ship their partial percentile aggregates to the coordinator.
+ */
+class TDigest {
+public:
+    // Bigger makes for more accurate estimates and bigger digests
+    static const int32_t DEFAULT_COMPRESSION = 100;
+
+    explicit TDigest(int32_t compression = DEFAULT_COMPRESSION);
+
+    void add(double value) { add(value, 1.0); }
+
+    void add(double value, double weight);
+
+    void merge(const TDigest& other);
+
+    /** Estimate the value below which the given fraction (0 to 1) of the values fall */
+    double quantile(double fraction);
+
+    bool empty() const { return m_centroids.empty() && m_buffer.empty(); }
+
+    /** The total weight of the values added */
+    double totalWeight() const { return m_totalWeight + m_bufferWeight; }
+
+    size_t centroidCount() { compress(); return m_centroids.size(); }
+
+    void clear();
+
+    size_t serializedSize();
+
+    void serializeTo(SerializeOutput& output);
+
+    /** Merge a digest written by serializeTo into this one */
+    void mergeSerialized(SerializeInputBE& input);
+
+private:
+    struct Centroid {
+        Centroid(double mean, double weight) : mean(mean), weight(weight) { }
+        bool operator<(const Centroid& other) const { return mean < other.mean; }
+        double mean;
+        double weight;
+    };
+
+    // How many values are buffered before they are folded in
+    size_t bufferLimit() const { return static_cast<size_t>(m_compression) * 5; }
+
+    /** Fold buffered values into the centroids */
+    void compress();
+
+    /** The scale function: a centroid may cover at most one unit of it */
+    double scale(double fraction) const;
+
+    int32_t m_compression;
+    std::vector<Centroid> m_centroids;     // sorted by mean
+    double m_totalWeight;
+    // Values added since the last compress(), in no order
+    std::vector<Centroid> m_buffer;
+    double m_bufferWeight;
+    double m_min;
+    double m_max;
+};
+
+} // namespace voltdb
+
+#endif // TDIGEST_H_
@@ -80,6 +80,18 @@ class Topend {
 
     virtual void fallbackToEEAllocatedBuffer(char *buffer, size_t length) = 0;
 
+    /**
+     * Take some of the results of the current batch before they are
+     * complete, so that the EE can reuse its result buffer. The chunk goes
+     * at headLength in the batch's results, after the chunks pushed before
+     * it, and whatever the result buffer holds from headLength on when the
+     * batch is done follows the last chunk. Return false if chunks are not
+     * supported, in which case the EE falls back to a larger buffer.
+     */
+    virtual bool pushResultChunk(const char *data, size_t length, size_t headLength) {
+        return false;
+    }
+
     /** Calls the java method in org.voltdb.utils.Encoder */
     virtual std::string decodeBase64AndDecompress(const std::string& buffer) = 0;
 
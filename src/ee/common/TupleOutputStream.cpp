@@ -45,7 +45,10 @@ std::size_t TupleOutputStream::startRows(int32_t partitionId)
 std::size_t TupleOutputStream::writeRow(const TableTuple &tuple)
 {
     const std::size_t startPos = position();
-    tuple.serializeTo(*this, true);
+    if ( ! m_serializationPlan.isBuiltFor(tuple.getSchema(), true)) {
+        m_serializationPlan.build(tuple.getSchema(), true);
+    }
+    m_serializationPlan.serialize(tuple, *this);
     const std::size_t endPos = position();
     m_rowCount++;
     std::size_t bytesSerialized = endPos - startPos;
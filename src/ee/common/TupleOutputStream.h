@@ -21,6 +21,7 @@
 #include <cstddef>
 #include <boost/ptr_container/ptr_vector.hpp>
 #include "serializeio.h"
+#include "TupleSerializationPlan.h"
 
 namespace voltdb {
 class TableTuple;
@@ -84,6 +85,8 @@ private:
     std::size_t m_rowCountPosition;
     /** Keep track of bytes written for throttling to yield control. */
     std::size_t m_totalBytesSerialized;
+    /** Rebuilt whenever a row of a different schema comes along */
+    TupleSerializationPlan m_serializationPlan;
 };
 
 } // namespace voltdb
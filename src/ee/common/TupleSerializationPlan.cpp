@@ -0,0 +1,195 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common/TupleSerializationPlan.h"
+
+#include "common/SQLException.h"
+#include "common/StringRef.h"
+
+#include <cstring>
+
+namespace voltdb {
+
+static uint32_t fixedWidthOf(ValueType type) {
+    switch (type) {
+    case VALUE_TYPE_TINYINT:
+        return 1;
+    case VALUE_TYPE_SMALLINT:
+        return 2;
+    case VALUE_TYPE_INTEGER:
+        return 4;
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_TIMESTAMP:
+    case VALUE_TYPE_DOUBLE:
+        return 8;
+    case VALUE_TYPE_DECIMAL:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+void TupleSerializationPlan::build(const TupleSchema* schema, bool includeHiddenColumns)
+{
+    m_schema = schema;
+    m_includeHiddenColumns = includeHiddenColumns;
+    m_fixedFields.clear();
+    m_steps.clear();
+    for (int i = 0; i < schema->columnCount(); i++) {
+        addColumn(schema->getColumnInfo(i), i, false);
+    }
+    if (includeHiddenColumns) {
+        for (int i = 0; i < schema->hiddenColumnCount(); i++) {
+            addColumn(schema->getHiddenColumnInfo(i), i, true);
+        }
+    }
+}
+
+void TupleSerializationPlan::addColumn(const TupleSchema::ColumnInfo* columnInfo, int columnIndex, bool hidden)
+{
+    const ValueType type = columnInfo->getVoltType();
+    const uint32_t width = fixedWidthOf(type);
+    if (width > 0) {
+        if (m_steps.empty() || m_steps.back().kind != STEP_FIXED_RUN ||
+                m_steps.back().runBytes + width > MAX_RUN_BYTES) {
+            Step step = Step();
+            step.kind = STEP_FIXED_RUN;
+            step.firstField = static_cast<uint32_t>(m_fixedFields.size());
+            m_steps.push_back(step);
+        }
+        FixedField field;
+        field.offset = columnInfo->offset;
+        field.width = width;
+        m_fixedFields.push_back(field);
+        m_steps.back().fieldCount++;
+        m_steps.back().runBytes += width;
+        return;
+    }
+
+    Step step = Step();
+    step.kind = (type == VALUE_TYPE_VARCHAR || type == VALUE_TYPE_VARBINARY) ? STEP_STRING : STEP_VALUE;
+    step.offset = columnInfo->offset;
+    step.inlined = columnInfo->inlined;
+    step.columnIndex = columnIndex;
+    step.hidden = hidden;
+    m_steps.push_back(step);
+}
+
+// Serialized values are big-endian, so each fixed-width field (a DECIMAL
+// is serialized high word first) is its storage with the bytes reversed.
+static inline void writeReversed(char* target, const char* source, uint32_t width) {
+    switch (width) {
+    case 1:
+        *target = *source;
+        return;
+    case 2: {
+        uint16_t value;
+        ::memcpy(&value, source, sizeof(value));
+        value = __builtin_bswap16(value);
+        ::memcpy(target, &value, sizeof(value));
+        return;
+    }
+    case 4: {
+        uint32_t value;
+        ::memcpy(&value, source, sizeof(value));
+        value = __builtin_bswap32(value);
+        ::memcpy(target, &value, sizeof(value));
+        return;
+    }
+    case 8: {
+        uint64_t value;
+        ::memcpy(&value, source, sizeof(value));
+        value = __builtin_bswap64(value);
+        ::memcpy(target, &value, sizeof(value));
+        return;
+    }
+    default: {
+        uint64_t low;
+        uint64_t high;
+        ::memcpy(&low, source, sizeof(low));
+        ::memcpy(&high, source + sizeof(low), sizeof(high));
+        high = __builtin_bswap64(high);
+        low = __builtin_bswap64(low);
+        ::memcpy(target, &high, sizeof(high));
+        ::memcpy(target + sizeof(high), &low, sizeof(low));
+        return;
+    }
+    }
+}
+
+void TupleSerializationPlan::serialize(const TableTuple& tuple, SerializeOutput& output) const
+{
+    assert(tuple.getSchema() == m_schema);
+    size_t start = output.reserveBytes(4);
+    const char* data = tuple.address() + TUPLE_HEADER_SIZE;
+    char run[MAX_RUN_BYTES];
+
+    for (std::vector<Step>::const_iterator step = m_steps.begin(); step != m_steps.end(); ++step) {
+        switch (step->kind) {
+        case STEP_FIXED_RUN: {
+            char* target = run;
+            const FixedField* field = &m_fixedFields[step->firstField];
+            for (uint32_t i = 0; i < step->fieldCount; i++, field++) {
+                writeReversed(target, data + field->offset, field->width);
+                target += field->width;
+            }
+            output.writeBytes(run, step->runBytes);
+            break;
+        }
+        case STEP_STRING: {
+            const char* storage = data + step->offset;
+            int32_t length;
+            const char* buffer;
+            if (step->inlined) {
+                if ((storage[0] & OBJECT_NULL_BIT) != 0) {
+                    output.writeInt(OBJECTLENGTH_NULL);
+                    break;
+                }
+                length = storage[0];
+                buffer = storage + SHORT_OBJECT_LENGTHLENGTH;
+            }
+            else {
+                const StringRef* sref = *reinterpret_cast<StringRef* const*>(storage);
+                if (sref == NULL) {
+                    output.writeInt(OBJECTLENGTH_NULL);
+                    break;
+                }
+                buffer = sref->getObject(&length);
+            }
+            if (length <= OBJECTLENGTH_NULL) {
+                throwDynamicSQLException("Attempted to serialize an NValue with a negative length");
+            }
+            output.writeInt(length);
+            output.writeBytes(buffer, length);
+            break;
+        }
+        case STEP_VALUE:
+            if (step->hidden) {
+                tuple.getHiddenNValue(step->columnIndex).serializeTo(output);
+            }
+            else {
+                tuple.getNValue(step->columnIndex).serializeTo(output);
+            }
+            break;
+        }
+    }
+
+    // write the length of the tuple
+    output.writeIntAt(start, static_cast<int32_t>(output.position() - start - sizeof(int32_t)));
+}
+
+}
@@ -0,0 +1,97 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TUPLESERIALIZATIONPLAN_H_
+#define TUPLESERIALIZATIONPLAN_H_
+
+#include "common/tabletuple.h"
+#include "common/serializeio.h"
+
+#include <vector>
+
+namespace voltdb {
+
+/**
+ * The steps that TableTuple::serializeTo goes through for every tuple of a
+ * schema, worked out once. Adjacent fixed-width columns (including the NULL
+ * sentinels they hold) are byte-reversed from tuple storage into a buffer
+ * and written with one copy, and VARCHAR/VARBINARY columns are written
+ * straight from tuple storage, without materializing NValues or switching
+ * on the column type for each value. GEOGRAPHY and POINT columns, which
+ * have their own serialization, still go through NValue.
+ *
+ * A plan refers to its schema and must not outlive it.
+ */
+class TupleSerializationPlan {
+public:
+    TupleSerializationPlan() : m_schema(NULL), m_includeHiddenColumns(false) { }
+
+    TupleSerializationPlan(const TupleSchema* schema, bool includeHiddenColumns)
+        : m_schema(NULL), m_includeHiddenColumns(false)
+    {
+        build(schema, includeHiddenColumns);
+    }
+
+    void build(const TupleSchema* schema, bool includeHiddenColumns);
+
+    bool isBuiltFor(const TupleSchema* schema, bool includeHiddenColumns) const {
+        return m_schema == schema && m_includeHiddenColumns == includeHiddenColumns;
+    }
+
+    /** Write exactly what tuple.serializeTo(output, includeHiddenColumns) would */
+    void serialize(const TableTuple& tuple, SerializeOutput& output) const;
+
+private:
+    // The most bytes of fixed-width columns written with one copy
+    static const uint32_t MAX_RUN_BYTES = 256;
+
+    enum StepKind {
+        STEP_FIXED_RUN,
+        STEP_STRING,
+        STEP_VALUE
+    };
+
+    struct FixedField {
+        uint32_t offset;
+        uint32_t width;
+    };
+
+    struct Step {
+        StepKind kind;
+        // STEP_FIXED_RUN: the fields [firstField, firstField + fieldCount)
+        // of m_fixedFields, making up runBytes bytes of output
+        uint32_t firstField;
+        uint32_t fieldCount;
+        uint32_t runBytes;
+        // STEP_STRING: where the column is; STEP_VALUE: which column it is
+        uint32_t offset;
+        bool inlined;
+        int columnIndex;
+        bool hidden;
+    };
+
+    void addColumn(const TupleSchema::ColumnInfo* columnInfo, int columnIndex, bool hidden);
+
+    const TupleSchema* m_schema;
+    bool m_includeHiddenColumns;
+    std::vector<FixedField> m_fixedFields;
+    std::vector<Step> m_steps;
+};
+
+}
+
+#endif // TUPLESERIALIZATIONPLAN_H_
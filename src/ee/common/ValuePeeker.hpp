@@ -111,6 +111,10 @@ public:
         return value.getDecimal();
     }
 
+    static NativeDecimal peekNativeDecimal(const NValue& value) {
+        return value.getNativeDecimal();
+    }
+
     static const GeographyValue peekGeographyValue(const NValue& value) {
         return value.getGeographyValue();
     }
@@ -87,6 +87,7 @@ ExecutorContext::ExecutorContext(int64_t siteId,
     m_tempStringPool(tempStringPool),
     m_undoQuantum(undoQuantum),
     m_staticParams(MAX_PARAM_COUNT),
+    m_parameterChangeCount(0),
     m_tuplesModifiedStack(),
     m_executorsMap(NULL),
     m_drStream(drStream),
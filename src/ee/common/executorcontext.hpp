@@ -317,6 +317,18 @@ class ExecutorContext {
         return singleton->m_tempStringPool;
     }
 
+    /**
+     * Where temp tables take their block storage from, or NULL if it is
+     * to be allocated afresh, as when there is no engine.
+     */
+    static TempTableBlockPool* getTempTableBlockPool() {
+        ExecutorContext* singleton = getExecutorContext();
+        if (singleton == NULL || singleton->m_engine == NULL) {
+            return NULL;
+        }
+        return singleton->m_engine->getTempTableBlockPool();
+    }
+
     bool allOutputTempTablesAreEmpty() const;
 
     void checkTransactionForDR();
@@ -326,6 +338,14 @@ class ExecutorContext {
     NValueArray& getParameterContainer() { return m_staticParams; }
     const NValueArray& getParameterContainer() const { return m_staticParams; }
 
+    /**
+     * Whoever stores new values in the parameter container calls this, so
+     * that expressions that precompute something from parameter values
+     * (see InListExpression) can tell when to recompute it.
+     */
+    void parametersChanged() { ++m_parameterChangeCount; }
+    int64_t getParameterChangeCount() const { return m_parameterChangeCount; }
+
     void pushNewModifiedTupleCounter() { m_tuplesModifiedStack.push(0); }
     void popModifiedTupleCounter() { m_tuplesModifiedStack.pop(); }
     const int64_t getModifiedTupleCount() const {
@@ -395,6 +415,7 @@ class ExecutorContext {
     NValueArray m_staticParams;
     /** TODO : should be passed as execute() parameter..*/
     int m_usedParamcnt;
+    int64_t m_parameterChangeCount;
 
     /** Counts tuples modified by a plan fragments.  Top of stack is the
      * most deeply nested executing plan fragment.
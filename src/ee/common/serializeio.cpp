@@ -41,6 +41,17 @@ void FallbackSerializeOutput::expand(size_t minimum_desired) {
     ExecutorContext::getExecutorContext()->getTopend()->fallbackToEEAllocatedBuffer(fallbackBuffer_, maxAllocationSize);
 }
 
+bool FallbackSerializeOutput::flushChunkFrom(size_t position) {
+    assert(position <= position_);
+    if ( ! ExecutorContext::getExecutorContext()->getTopend()->pushResultChunk(
+                data() + position, position_ - position, position)) {
+        return false;
+    }
+    flushedBytes_ += position_ - position;
+    setPosition(position);
+    return true;
+}
+
 template<voltdb::Endianess E>
 std::string SerializeInput<E>::fullBufferStringRep() {
     std::stringstream message(std::stringstream::in
@@ -529,11 +529,15 @@ protected:
 /*
  * A serialize output class that falls back to allocating a 50 meg buffer
  * if the regular allocation runs out of space. The topend is notified when this occurs.
+ *
+ * Before it comes to that, a writer that knows where it can cut its output
+ * may hand the completed bytes to the topend as a result chunk with
+ * flushChunkFrom(), and carry on writing from the same place.
  */
 class FallbackSerializeOutput : public ReferenceSerializeOutput {
 public:
     FallbackSerializeOutput() :
-        ReferenceSerializeOutput(), fallbackBuffer_(NULL) {
+        ReferenceSerializeOutput(), fallbackBuffer_(NULL), flushedBytes_(0) {
     }
 
     /** Set the buffer to buffer with capacity and sets the position. */
@@ -543,6 +547,7 @@ public:
             fallbackBuffer_ = NULL;
             delete []temp;
         }
+        flushedBytes_ = 0;
         setPosition(position);
         initialize(buffer, capacity);
     }
@@ -554,8 +559,24 @@ public:
 
     /** Expand once to a fallback size, and if that doesn't work abort */
     void expand(size_t minimum_desired);
+
+    /**
+     * Push the bytes from position up to the current position to the
+     * topend as a result chunk, and move back to position to write what
+     * follows them. Every chunk of a batch must start at the same position,
+     * and nothing from there on may be written to with writeIntAt() and
+     * friends afterwards. Returns false, having done nothing, if the topend
+     * does not take result chunks.
+     */
+    bool flushChunkFrom(size_t position);
+
+    /** The number of bytes pushed to the topend since the last initialization */
+    size_t flushedBytes() const {
+        return flushedBytes_;
+    }
 private:
     char *fallbackBuffer_;
+    size_t flushedBytes_;
 };
 
 /** Implementation of SerializeOutput that makes a copy of the buffer. */
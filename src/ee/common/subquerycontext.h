@@ -20,10 +20,15 @@
 
 #include <vector>
 
+#include <boost/shared_ptr.hpp>
+
 #include "common/NValue.hpp"
 
 namespace voltdb {
 
+class InListLookup;
+class SubqueryResultMemo;
+
 /*
 * Keep track of the actual parameter values coming into a subquery invocation
 * and if they have not changed since last invocation reuses the cached result
@@ -34,6 +39,10 @@ namespace voltdb {
 *    by columns from the join's OUTER side would effectively get run once per OUTER row.
 * -- subqueries that were correlated by a parent's indexed column (producing ordered values)
 *    could get executed once per unique value.
+* Correlated subqueries also keep a SubqueryResultMemo of the results for earlier parameter
+* values, so that unordered values get the same benefit. And a result that is searched by
+* "= ANY" more than once gets an InListLookup of its values, so that an uncorrelated
+* IN (SELECT ...) is evaluated as a hash semi-join.
 * The subquery context is registered with the global executor context as candidates for
 * post-fragment cleanup, allowing results to be retained between invocations.
 */
@@ -41,11 +50,15 @@ struct SubqueryContext {
     SubqueryContext(std::vector<NValue> lastParams)
       : m_hasValidResult(false)
       , m_lastParams(lastParams)
+      , m_resultProbeCount(0)
     { }
 
     SubqueryContext(const SubqueryContext& other)
       : m_hasValidResult(other.m_hasValidResult)
       , m_lastParams(other.m_lastParams)
+      , m_memo(other.m_memo)
+      , m_resultLookup(other.m_resultLookup)
+      , m_resultProbeCount(other.m_resultProbeCount)
     {
         if (m_hasValidResult) {
             m_lastResult = other.m_lastResult;
@@ -53,7 +66,11 @@ struct SubqueryContext {
     }
 
     bool hasValidResult() const { return m_hasValidResult; }
-    void invalidateResult() { m_hasValidResult = false; }
+    void invalidateResult()
+    {
+        m_hasValidResult = false;
+        resetResultLookup();
+    }
 
     const NValue& getResult() const { return m_lastResult; }
 
@@ -61,16 +78,37 @@ struct SubqueryContext {
     {
         m_lastResult = result.copyNValue();
         m_hasValidResult = true;
+        resetResultLookup();
     }
 
     std::vector<NValue>& accessLastParams() { return m_lastParams; }
 
+    SubqueryResultMemo* getMemo() const { return m_memo.get(); }
+    void setMemo(const boost::shared_ptr<SubqueryResultMemo>& memo) { m_memo = memo; }
+
+    /** Count a search of the current result, returning how many there have been */
+    int noteResultProbe() { return ++m_resultProbeCount; }
+
+    /** The values of the current result, if they have been arranged for lookups */
+    InListLookup* getResultLookup() const { return m_resultLookup.get(); }
+    void setResultLookup(const boost::shared_ptr<InListLookup>& lookup) { m_resultLookup = lookup; }
+
 private:
     bool m_hasValidResult;
     NValue m_lastResult;
     // The parameter values that were used to obtain the last result in the ascending
     // order of the parameter indexes
     std::vector<NValue> m_lastParams;
+
+    void resetResultLookup()
+    {
+        m_resultLookup.reset();
+        m_resultProbeCount = 0;
+    }
+
+    boost::shared_ptr<SubqueryResultMemo> m_memo;
+    boost::shared_ptr<InListLookup> m_resultLookup;
+    int m_resultProbeCount;
 };
 
 }
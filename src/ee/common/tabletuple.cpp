@@ -50,6 +50,7 @@
 #include "common/common.h"
 #include "common/debuglog.h"
 #include "common/FatalException.hpp"
+#include "common/StringDictionary.h"
 
 namespace voltdb {
 
@@ -102,4 +103,26 @@ std::string TableTuple::debugNoHeader() const {
     return debug("");
 }
 
+void TableTuple::setSharedObjectCopy(const int idx, const TableTuple &source,
+                                     StringDictionary* dictionary) const {
+    const TupleSchema::ColumnInfo *columnInfo = m_schema->getColumnInfo(idx);
+    assert(columnInfo->getVoltType() == VALUE_TYPE_VARCHAR && ! columnInfo->inlined);
+    const TupleSchema::ColumnInfo *sourceColumnInfo = source.getSchema()->getColumnInfo(idx);
+    const StringRef* sref = *reinterpret_cast<const StringRef* const*>(source.getDataPtr(sourceColumnInfo));
+    StringRef** dataPtr = reinterpret_cast<StringRef**>(getWritableDataPtr(columnInfo));
+    *dataPtr = (sref == NULL) ? NULL : dictionary->acquire(sref);
+}
+
+void TableTuple::shareObjectColumn(const int idx, StringDictionary* dictionary) const {
+    const TupleSchema::ColumnInfo *columnInfo = m_schema->getColumnInfo(idx);
+    assert(columnInfo->getVoltType() == VALUE_TYPE_VARCHAR && ! columnInfo->inlined);
+    StringRef** dataPtr = reinterpret_cast<StringRef**>(getWritableDataPtr(columnInfo));
+    StringRef* original = *dataPtr;
+    if (original == NULL) {
+        return;
+    }
+    *dataPtr = dictionary->acquire(original);
+    StringRef::destroy(original);
+}
+
 }
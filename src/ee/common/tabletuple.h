@@ -75,6 +75,7 @@ namespace voltdb {
 #define PENDING_DELETE_MASK 4
 #define PENDING_DELETE_ON_UNDO_RELEASE_MASK 8
 
+class StringDictionary;
 class TableColumn;
 class TupleIterator;
 class ElasticScanner;
@@ -293,6 +294,13 @@ public:
     }
 
 
+    /**
+     * Point an uninlined column at the dictionary's shared copy of the
+     * value of the same column of the source tuple.
+     */
+    void setSharedObjectCopy(const int idx, const TableTuple &source,
+                             StringDictionary* dictionary) const;
+
     /** How long is a tuple? */
     inline int tupleLength() const {
         return m_schema->tupleLength() + TUPLE_HEADER_SIZE;
@@ -396,12 +404,25 @@ public:
         return std::string(retval, 0, retval.length() - 1);
     }
 
-    /** Copy values from one tuple into another (uses memcpy) */
-    void copyForPersistentInsert(const TableTuple &source, Pool *pool = NULL) const;
+    /**
+     * Copy values from one tuple into another (uses memcpy).
+     * If dictionaries is given, it has one entry per uninlined column, and
+     * the values of the columns whose entry is not NULL are shared through
+     * that StringDictionary rather than copied.
+     */
+    void copyForPersistentInsert(const TableTuple &source, Pool *pool = NULL,
+                                 StringDictionary* const* dictionaries = NULL) const;
     // The vector "output" arguments detail the non-inline object memory management
     // required of the upcoming release or undo.
     void copyForPersistentUpdate(const TableTuple &source,
-                                 std::vector<char*> &oldObjects, std::vector<char*> &newObjects);
+                                 std::vector<char*> &oldObjects, std::vector<char*> &newObjects,
+                                 StringDictionary* const* dictionaries = NULL);
+
+    /**
+     * Replace the persistent string in an uninlined column with the
+     * dictionary's shared copy of its value, freeing the original.
+     */
+    void shareObjectColumn(const int idx, StringDictionary* dictionary) const;
     void copy(const TableTuple &source);
 
     /** this does set NULL in addition to clear string count.*/
@@ -729,7 +750,8 @@ inline void TableTuple::setNValues(int beginIdx, TableTuple lhs, int begin, int
 /*
  * With a persistent insert the copy should do an allocation for all uninlinable strings
  */
-inline void TableTuple::copyForPersistentInsert(const voltdb::TableTuple &source, Pool *pool) const
+inline void TableTuple::copyForPersistentInsert(const voltdb::TableTuple &source, Pool *pool,
+                                                StringDictionary* const* dictionaries) const
 {
     assert(m_schema);
     assert(source.m_schema);
@@ -757,6 +779,10 @@ inline void TableTuple::copyForPersistentInsert(const voltdb::TableTuple &source
         for (uint16_t ii = 0; ii < uninlineableObjectColumnCount; ii++) {
             const uint16_t uinlineableObjectColumnIndex =
                     m_schema->getUninlinedObjectColumnInfoIndex(ii);
+            if (dictionaries != NULL && dictionaries[ii] != NULL) {
+                setSharedObjectCopy(uinlineableObjectColumnIndex, source, dictionaries[ii]);
+                continue;
+            }
             setNValueAllocateForObjectCopies(uinlineableObjectColumnIndex,
                     source.getNValue(uinlineableObjectColumnIndex),
                     pool);
@@ -770,7 +796,8 @@ inline void TableTuple::copyForPersistentInsert(const voltdb::TableTuple &source
  * a string if the source and destination pointers are different.
  */
 inline void TableTuple::copyForPersistentUpdate(const TableTuple &source,
-                                                std::vector<char*> &oldObjects, std::vector<char*> &newObjects)
+                                                std::vector<char*> &oldObjects, std::vector<char*> &newObjects,
+                                                StringDictionary* const* dictionaries)
 {
     assert(m_schema);
     assert(m_schema->equals(source.m_schema));
@@ -800,9 +827,14 @@ inline void TableTuple::copyForPersistentUpdate(const TableTuple &source,
                     // Make a copy of the input string. Don't want to delete the old string
                     // because it's either from the temp pool or persistently referenced elsewhere.
                     oldObjects.push_back(*mPtr);
-                    // TODO: Here, it's known that the column is an object type, and yet
-                    // setNValueAllocateForObjectCopies is called to figure this all out again.
-                    setNValueAllocateForObjectCopies(ii, source.getNValue(ii), NULL);
+                    if (dictionaries != NULL && dictionaries[uninlineableObjectColumnIndex] != NULL) {
+                        setSharedObjectCopy(ii, source, dictionaries[uninlineableObjectColumnIndex]);
+                    }
+                    else {
+                        // TODO: Here, it's known that the column is an object type, and yet
+                        // setNValueAllocateForObjectCopies is called to figure this all out again.
+                        setNValueAllocateForObjectCopies(ii, source.getNValue(ii), NULL);
+                    }
                     // Yes, uses the same old pointer as two statements ago to get a new value. Neat.
                     newObjects.push_back(*mPtr);
                 }
@@ -223,6 +223,9 @@ std::string tableStreamTypeToString(TableStreamType type) {
       case TABLE_STREAM_RECOVERY: {
           return "TABLE_STREAM_RECOVERY";
       }
+      case TABLE_STREAM_SNAPSHOT_READ: {
+          return "TABLE_STREAM_SNAPSHOT_READ";
+      }
       case TABLE_STREAM_NONE: {
           return "TABLE_STREAM_NONE";
       }
@@ -622,6 +625,15 @@ string expressionToString(ExpressionType type)
     case EXPRESSION_TYPE_AGGREGATE_HYPERLOGLOGS_TO_CARD: {
         return "AGGREGATE_HYPERLOGLOGS_TO_CARD";
     }
+    case EXPRESSION_TYPE_AGGREGATE_APPROX_PERCENTILE: {
+        return "AGGREGATE_APPROX_PERCENTILE";
+    }
+    case EXPRESSION_TYPE_AGGREGATE_VALS_TO_QUANTILE_SKETCH: {
+        return "AGGREGATE_VALS_TO_QUANTILE_SKETCH";
+    }
+    case EXPRESSION_TYPE_AGGREGATE_QUANTILE_SKETCHES_TO_PERCENTILE: {
+        return "AGGREGATE_QUANTILE_SKETCHES_TO_PERCENTILE";
+    }
     case EXPRESSION_TYPE_AGGREGATE_WINDOWED_RANK: {
         return "EXPRESSION_TYPE_AGGREGATE_WINDOWED_RANK";
     }
@@ -745,6 +757,12 @@ ExpressionType stringToExpression(string str )
         return EXPRESSION_TYPE_AGGREGATE_VALS_TO_HYPERLOGLOG;
     } else if (str == "AGGREGATE_HYPERLOGLOGS_TO_CARD") {
         return EXPRESSION_TYPE_AGGREGATE_HYPERLOGLOGS_TO_CARD;
+    } else if (str == "AGGREGATE_APPROX_PERCENTILE") {
+        return EXPRESSION_TYPE_AGGREGATE_APPROX_PERCENTILE;
+    } else if (str == "AGGREGATE_VALS_TO_QUANTILE_SKETCH") {
+        return EXPRESSION_TYPE_AGGREGATE_VALS_TO_QUANTILE_SKETCH;
+    } else if (str == "AGGREGATE_QUANTILE_SKETCHES_TO_PERCENTILE") {
+        return EXPRESSION_TYPE_AGGREGATE_QUANTILE_SKETCHES_TO_PERCENTILE;
     } else if (str == "AGGREGATE_WINDOWED_RANK") {
         return EXPRESSION_TYPE_AGGREGATE_WINDOWED_RANK;
     } else if (str == "AGGREGATE_WINDOWED_DENSE_RANK") {
@@ -313,6 +313,12 @@ enum ExpressionType {
     EXPRESSION_TYPE_AGGREGATE_APPROX_COUNT_DISTINCT = 46,
     EXPRESSION_TYPE_AGGREGATE_VALS_TO_HYPERLOGLOG   = 47,
     EXPRESSION_TYPE_AGGREGATE_HYPERLOGLOGS_TO_CARD  = 48,
+    // APPROX_PERCENTILE and its two split halves exist only in the EE for
+    // now: there is no SQL function for them and the planner never emits
+    // them, so they are reached only by hand-built plans.
+    EXPRESSION_TYPE_AGGREGATE_APPROX_PERCENTILE     = 49,
+    EXPRESSION_TYPE_AGGREGATE_VALS_TO_QUANTILE_SKETCH = 50,
+    EXPRESSION_TYPE_AGGREGATE_QUANTILE_SKETCHES_TO_PERCENTILE = 51,
 
     // -----------------------------
     // Windowed Expression Aggregates.
@@ -406,6 +412,11 @@ enum TableStreamType {
     // that tableStreamTypeHasPredicates() doesn't have to change.
     TABLE_STREAM_RECOVERY,
 
+    // Point-in-time copy of a table, streamed in slices while the site
+    // keeps committing writes. Only activated from within the EE; it has
+    // no counterpart in org.voltdb.TableStreamType.
+    TABLE_STREAM_SNAPSHOT_READ,
+
     // Table stream type provided when no stream is active.
     TABLE_STREAM_NONE = -1
 };
@@ -432,6 +443,13 @@ inline bool tableStreamTypeIsSnapshot(TableStreamType streamType) {
     return streamType == TABLE_STREAM_SNAPSHOT;
 }
 
+/**
+ * Return true if the table stream type is feeding a point-in-time read.
+ */
+inline bool tableStreamTypeIsSnapshotRead(TableStreamType streamType) {
+    return streamType == TABLE_STREAM_SNAPSHOT_READ;
+}
+
 /**
  * Return true if the table stream type is for recovery.
  */
@@ -453,9 +471,12 @@ inline bool tableStreamTypeIsStreamIndexing(TableStreamType streamType) {
 // ------------------------------------------------------------------
 // Statistics Selector Types
 // ------------------------------------------------------------------
+// Values match the ordinals of org.voltdb.StatsSelector
 enum StatisticsSelectorType {
-    STATISTICS_SELECTOR_TYPE_TABLE,
-    STATISTICS_SELECTOR_TYPE_INDEX
+    STATISTICS_SELECTOR_TYPE_TABLE = 0,
+    STATISTICS_SELECTOR_TYPE_INDEX = 1,
+    STATISTICS_SELECTOR_TYPE_FRAGMENT_RESULT_CACHE = 33,
+    STATISTICS_SELECTOR_TYPE_COMPACTION = 34
 };
 
 // ------------------------------------------------------------------
@@ -499,6 +520,10 @@ enum TaskType {
     TASK_TYPE_RESET_DR_APPLIED_TRACKER = 7,      // not supported in EE
     TASK_TYPE_SET_MERGED_DRID_TRACKER = 8,       // not supported in EE
     TASK_TYPE_INIT_DRID_TRACKER = 9,             // not supported in EE
+    TASK_TYPE_SET_FRAGMENT_RESULT_CACHE_MEMORY_LIMIT = 10,
+    TASK_TYPE_SET_PARALLEL_SCAN_THREAD_COUNT = 11,
+    TASK_TYPE_SET_COMPACTION_BUDGET = 12,
+    TASK_TYPE_SET_COLD_TIER = 13,
 };
 
 // ------------------------------------------------------------------
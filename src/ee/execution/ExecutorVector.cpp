@@ -48,12 +48,17 @@
 #include "catalog/planfragment.h"
 #include "catalog/statement.h"
 #include "executors/abstractexecutor.h"
+#include "expressions/abstractexpression.h"
 #include "plannodes/abstractplannode.h"
 #include "plannodes/abstractplannode.h"
+#include "plannodes/abstractscannode.h"
 #include "executors/executorfactory.h"
+#include "storage/TableCatalogDelegate.hpp"
 
 #include "boost/foreach.hpp"
 
+#include <algorithm>
+
 namespace voltdb {
 
 boost::shared_ptr<ExecutorVector> ExecutorVector::fromCatalogStatement(VoltDBEngine* engine,
@@ -108,6 +113,7 @@ boost::shared_ptr<ExecutorVector> ExecutorVector::fromJsonPlan(VoltDBEngine* eng
                                                             tempTableMemoryLimit,
                                                             pnf));
     ev->init(engine);
+    ev->initResultCacheability();
     return ev;
 }
 
@@ -122,6 +128,7 @@ void ExecutorVector::init(VoltDBEngine* engine) {
             initPlanNode(engine, planNode);
             executorList->push_back(planNode->getExecutor());
         }
+        initPipelines(*executorList);
         m_subplanExecListMap.insert(make_pair(it->first, executorList.get()));
         executorList.release();
     }
@@ -142,6 +149,44 @@ std::string ExecutorVector::debug() const {
     return oss.str();
 }
 
+void ExecutorVector::setRetainsWorkingSet(bool retainsWorkingSet) {
+    BOOST_FOREACH (AbstractExecutor* executor, m_allExecutors) {
+        executor->setRetainsWorkingSet(retainsWorkingSet);
+    }
+}
+
+int64_t ExecutorVector::measureWorkingSet() {
+    m_workingSetSize = 0;
+    BOOST_FOREACH (AbstractExecutor* executor, m_allExecutors) {
+        m_workingSetSize += executor->workingSetSize();
+    }
+    return m_workingSetSize;
+}
+
+void ExecutorVector::releaseWorkingSet() {
+    BOOST_FOREACH (AbstractExecutor* executor, m_allExecutors) {
+        executor->releaseWorkingSet();
+    }
+    m_workingSetSize = 0;
+}
+
+// Let each executor that reads its outer input front to back pull that
+// input a batch at a time from a child that can produce it that way, rather
+// than having the child materialize all of its output first. Chains form
+// naturally, since a driven child may itself pull from a driven child.
+void ExecutorVector::initPipelines(const std::vector<AbstractExecutor*>& executorList) {
+    BOOST_FOREACH (AbstractExecutor* executor, executorList) {
+        const std::vector<AbstractPlanNode*>& children = executor->getPlanNode()->getChildren();
+        if ( ! executor->consumesBatches() || children.empty()) {
+            continue;
+        }
+        AbstractExecutor* child = children[0]->getExecutor();
+        if (child->canProduceBatches()) {
+            child->setDrivenByParent(true);
+        }
+    }
+}
+
 void ExecutorVector::initPlanNode(VoltDBEngine* engine, AbstractPlanNode* node) {
     assert(node);
     assert(node->getExecutor() == NULL);
@@ -157,6 +202,7 @@ void ExecutorVector::initPlanNode(VoltDBEngine* engine, AbstractPlanNode* node)
         throw SerializableEEException(VOLT_EE_EXCEPTION_TYPE_EEEXCEPTION, message);
     }
     node->setExecutor(executor);
+    m_allExecutors.push_back(executor);
 
     // If this PlanNode has an internal PlanNode (e.g.,
     // AbstractScanPlanNode can have internal Projections), set
@@ -181,6 +227,74 @@ void ExecutorVector::initPlanNode(VoltDBEngine* engine, AbstractPlanNode* node)
     throw SerializableEEException(VOLT_EE_EXCEPTION_TYPE_EEEXCEPTION, msg);
 }
 
+void ExecutorVector::initResultCacheability() {
+    m_resultCacheable = false;
+    m_scannedTables.clear();
+    if ( ! m_fragment->cachesResult()) {
+        return;
+    }
+    for (PlanNodeFragment::PlanNodeMapIterator it = m_fragment->executeListBegin();
+         it != m_fragment->executeListEnd(); ++it) {
+        BOOST_FOREACH (AbstractPlanNode* planNode, *it->second) {
+            if ( ! collectScannedTables(planNode)) {
+                m_scannedTables.clear();
+                return;
+            }
+        }
+    }
+    m_resultCacheable = true;
+}
+
+/**
+ * Add the persistent table scanned by this node or its inline nodes to
+ * m_scannedTables. Return false if the node writes, receives input from
+ * other fragments, scans something that is not a persistent table or
+ * evaluates an expression, such as the current time, whose value can
+ * change between executions.
+ */
+bool ExecutorVector::collectScannedTables(AbstractPlanNode* node) {
+    switch (node->getPlanNodeType()) {
+    case PLAN_NODE_TYPE_UPDATE:
+    case PLAN_NODE_TYPE_INSERT:
+    case PLAN_NODE_TYPE_DELETE:
+    case PLAN_NODE_TYPE_SWAPTABLES:
+    case PLAN_NODE_TYPE_RECEIVE:
+    case PLAN_NODE_TYPE_MERGERECEIVE:
+        return false;
+    default:
+        break;
+    }
+
+    std::vector<const AbstractExpression*> expressions;
+    node->collectExpressions(expressions);
+    BOOST_FOREACH (const AbstractExpression* expression, expressions) {
+        if (expression->isNondeterministic()) {
+            return false;
+        }
+    }
+
+    AbstractScanPlanNode* scanNode = dynamic_cast<AbstractScanPlanNode*>(node);
+    // Subquery scans read temp tables produced within this same fragment.
+    if (scanNode != NULL && ! scanNode->isSubQuery()) {
+        TableCatalogDelegate* tcd = scanNode->getTargetTableDelegate();
+        if (tcd == NULL || tcd->getPersistentTable() == NULL) {
+            return false;
+        }
+        if (std::find(m_scannedTables.begin(), m_scannedTables.end(), tcd) == m_scannedTables.end()) {
+            m_scannedTables.push_back(tcd);
+        }
+    }
+
+    std::map<PlanNodeType, AbstractPlanNode*>::const_iterator internal_it;
+    for (internal_it = node->getInlinePlanNodes().begin();
+         internal_it != node->getInlinePlanNodes().end(); internal_it++) {
+        if ( ! collectScannedTables(internal_it->second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void ExecutorVector::setupContext(ExecutorContext* executorContext)
     { executorContext->setupForExecutors(&m_subplanExecListMap); }
 
@@ -63,6 +63,7 @@ class VoltDBEngine;
 class AbstractPlanNode;
 class AbstractExecutor;
 class ExecutorContext;
+class TableCatalogDelegate;
 
 /**
  * A list of executors for runtime.
@@ -100,6 +101,33 @@ public:
 
     void getRidOfSendExecutor(int planId = 0);
 
+    /**
+     * True if the planner asked for the fragment's result to be cached,
+     * the fragment only reads persistent tables and nothing else, such
+     * as the current time, can change its result between executions
+     * with the same parameters.
+     */
+    bool isResultCacheable() const { return m_resultCacheable; }
+
+    /** The persistent tables read by a cacheable fragment. */
+    const std::vector<TableCatalogDelegate*>& getScannedTables() const { return m_scannedTables; }
+
+    /**
+     * Have the executors keep their output tables' blocks, hash tables,
+     * sort buffers and pools between executions, clearing rather than
+     * freeing them.
+     */
+    void setRetainsWorkingSet(bool retainsWorkingSet);
+
+    /** Measure, and remember, the memory the executors keep between executions. */
+    int64_t measureWorkingSet();
+
+    /** The memory kept between executions, as last measured */
+    int64_t workingSetSize() const { return m_workingSetSize; }
+
+    /** Free the memory kept between executions. */
+    void releaseWorkingSet();
+
     ~ExecutorVector();
 
 private:
@@ -125,14 +153,27 @@ private:
         : m_fragId(fragmentId)
         , m_limits(memoryLimit, logThreshold)
         , m_fragment(fragment)
+        , m_resultCacheable(false)
+        , m_workingSetSize(0)
     { }
 
+    void initPipelines(const std::vector<AbstractExecutor*>& executorList);
+
     void initPlanNode(VoltDBEngine* engine, AbstractPlanNode* node);
 
+    void initResultCacheability();
+
+    bool collectScannedTables(AbstractPlanNode* node);
+
     const int64_t m_fragId;
     std::map<int, std::vector<AbstractExecutor*>* > m_subplanExecListMap;
     TempTableLimits m_limits;
     boost::scoped_ptr<PlanNodeFragment> m_fragment;
+    bool m_resultCacheable;
+    std::vector<TableCatalogDelegate*> m_scannedTables;
+    // Every executor, inline ones included
+    std::vector<AbstractExecutor*> m_allExecutors;
+    int64_t m_workingSetSize;
 };
 
 } // namespace voltdb
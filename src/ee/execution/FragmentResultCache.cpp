@@ -0,0 +1,122 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "execution/FragmentResultCache.h"
+#include "storage/persistenttable.h"
+#include "storage/TableCatalogDelegate.hpp"
+
+#include "boost/foreach.hpp"
+
+#include <cstring>
+
+namespace voltdb {
+
+FragmentResultCache::FragmentResultCache()
+    : m_memoryLimit(0)
+    , m_memoryUsed(0)
+    , m_hits(0)
+    , m_misses(0)
+    , m_evictions(0)
+    , m_invalidations(0)
+    , m_stats(this)
+{ }
+
+void FragmentResultCache::setMemoryLimit(int64_t memoryLimit) {
+    m_memoryLimit = memoryLimit < 0 ? 0 : memoryLimit;
+    evictToLimit();
+}
+
+std::string FragmentResultCache::makeKey(int64_t fragId, const char* params, size_t paramsLength) {
+    std::string key(sizeof(fragId) + paramsLength, '\0');
+    ::memcpy(&key[0], &fragId, sizeof(fragId));
+    if (paramsLength > 0) {
+        ::memcpy(&key[sizeof(fragId)], params, paramsLength);
+    }
+    return key;
+}
+
+const CachedFragmentResult* FragmentResultCache::lookup(const std::string& key) {
+    ResultSet::nth_index<1>::type::iterator iter = m_results.get<1>().find(key);
+    if (iter == m_results.get<1>().end()) {
+        ++m_misses;
+        return NULL;
+    }
+    BOOST_FOREACH (const CachedFragmentResult::TableVersion& version, iter->tableVersions) {
+        PersistentTable* table = version.tcd->getPersistentTable();
+        if (table == NULL ||
+                table->instanceId() != version.instanceId ||
+                table->modificationCount() != version.modificationCount) {
+            m_memoryUsed -= iter->footprint();
+            m_results.get<1>().erase(iter);
+            ++m_invalidations;
+            ++m_misses;
+            return NULL;
+        }
+    }
+    // move it to the front of the list
+    m_results.relocate(m_results.begin(), m_results.project<0>(iter));
+    ++m_hits;
+    return &*iter;
+}
+
+void FragmentResultCache::insert(const std::string& key,
+                                 const std::vector<TableCatalogDelegate*>& scannedTables,
+                                 int32_t dependencyCount,
+                                 const char* result,
+                                 size_t resultLength) {
+    CachedFragmentResult entry;
+    entry.key = key;
+    entry.result.assign(result, resultLength);
+    entry.dependencyCount = dependencyCount;
+    entry.tableVersions.reserve(scannedTables.size());
+    BOOST_FOREACH (TableCatalogDelegate* tcd, scannedTables) {
+        PersistentTable* table = tcd->getPersistentTable();
+        assert(table);
+        CachedFragmentResult::TableVersion version = { tcd, table->instanceId(), table->modificationCount() };
+        entry.tableVersions.push_back(version);
+    }
+
+    if (static_cast<int64_t>(entry.footprint()) > m_memoryLimit) {
+        return;
+    }
+
+    // A stale entry for the same key was dropped by the lookup that
+    // preceded this insert, so the key is normally new here.
+    std::pair<ResultSet::iterator, bool> p = m_results.push_front(entry);
+    if ( ! p.second) {
+        m_memoryUsed -= p.first->footprint();
+        m_results.replace(p.first, entry);
+        m_results.relocate(m_results.begin(), p.first);
+    }
+    m_memoryUsed += p.first->footprint();
+    evictToLimit();
+}
+
+void FragmentResultCache::clear() {
+    m_results.clear();
+    m_memoryUsed = 0;
+}
+
+void FragmentResultCache::evictToLimit() {
+    while (m_memoryUsed > m_memoryLimit && ! m_results.empty()) {
+        m_memoryUsed -= m_results.back().footprint();
+        m_results.pop_back();
+        ++m_evictions;
+    }
+}
+
+}
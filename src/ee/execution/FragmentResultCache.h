@@ -0,0 +1,139 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FRAGMENTRESULTCACHE_H_
+#define FRAGMENTRESULTCACHE_H_
+
+#include "execution/FragmentResultCacheStats.h"
+
+#include <string>
+#include <vector>
+// The next #define limits the number of features pulled into the build
+// We don't use those features.
+#define BOOST_MULTI_INDEX_DISABLE_SERIALIZATION
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+
+namespace voltdb {
+
+class TableCatalogDelegate;
+
+/**
+ * The serialized result of one execution of a read-only plan fragment,
+ * along with the versions of the tables it read.
+ */
+struct CachedFragmentResult {
+    struct TableVersion {
+        TableCatalogDelegate* tcd;
+        int64_t instanceId;
+        int64_t modificationCount;
+    };
+
+    /** Fragment id followed by the serialized parameters */
+    std::string key;
+    /** Result dependencies as they were written to the result buffer */
+    std::string result;
+    int32_t dependencyCount;
+    std::vector<TableVersion> tableVersions;
+
+    size_t footprint() const {
+        return sizeof(CachedFragmentResult) + key.capacity() + result.capacity() +
+               tableVersions.capacity() * sizeof(TableVersion);
+    }
+};
+
+/**
+ * LRU cache of read-only fragment results, keyed by fragment id and
+ * serialized parameters. An entry is only returned while every table it
+ * read is still the same table instance with the same modification count
+ * (see PersistentTable::modificationCount()). The cache holds nothing
+ * until it is given a memory limit.
+ */
+class FragmentResultCache {
+private:
+    /**
+     * Entries in MRU-first order, also hashed by their keys.
+     */
+    typedef boost::multi_index::multi_index_container<
+        CachedFragmentResult,
+        boost::multi_index::indexed_by<
+            boost::multi_index::sequenced<>,
+            boost::multi_index::hashed_unique<
+                boost::multi_index::member<CachedFragmentResult, std::string, &CachedFragmentResult::key>
+            >
+        >
+    > ResultSet;
+
+public:
+    FragmentResultCache();
+
+    /** Set the budget in bytes, evicting as needed. Zero disables the cache. */
+    void setMemoryLimit(int64_t memoryLimit);
+
+    int64_t memoryLimit() const { return m_memoryLimit; }
+
+    bool isEnabled() const { return m_memoryLimit > 0; }
+
+    static std::string makeKey(int64_t fragId, const char* params, size_t paramsLength);
+
+    /**
+     * Return the cached result for the key if the tables it read have not
+     * changed since, or NULL. A stale entry is dropped.
+     */
+    const CachedFragmentResult* lookup(const std::string& key);
+
+    /**
+     * Cache a result that was computed from the current contents of the
+     * given tables. Results larger than the whole budget are not kept.
+     */
+    void insert(const std::string& key,
+                const std::vector<TableCatalogDelegate*>& scannedTables,
+                int32_t dependencyCount,
+                const char* result,
+                size_t resultLength);
+
+    void clear();
+
+    int64_t hits() const { return m_hits; }
+    int64_t misses() const { return m_misses; }
+    int64_t evictions() const { return m_evictions; }
+    int64_t invalidations() const { return m_invalidations; }
+    int64_t entryCount() const { return static_cast<int64_t>(m_results.size()); }
+    int64_t memoryUsed() const { return m_memoryUsed; }
+
+    FragmentResultCacheStats* getStats() { return &m_stats; }
+
+private:
+    void evictToLimit();
+
+    ResultSet m_results;
+    int64_t m_memoryLimit;
+    int64_t m_memoryUsed;
+
+    int64_t m_hits;
+    int64_t m_misses;
+    int64_t m_evictions;
+    int64_t m_invalidations;
+
+    FragmentResultCacheStats m_stats;
+};
+
+}
+
+#endif // FRAGMENTRESULTCACHE_H_
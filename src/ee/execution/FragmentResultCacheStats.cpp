@@ -0,0 +1,126 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "execution/FragmentResultCacheStats.h"
+#include "execution/FragmentResultCache.h"
+#include "common/TupleSchema.h"
+#include "common/ValueFactory.hpp"
+#include "common/tabletuple.h"
+#include "storage/tablefactory.h"
+#include "storage/temptable.h"
+#include <vector>
+#include <string>
+
+using namespace voltdb;
+using namespace std;
+
+vector<string> FragmentResultCacheStats::generateFragmentResultCacheStatsColumnNames() {
+    vector<string> columnNames = StatsSource::generateBaseStatsColumnNames();
+    columnNames.push_back("CACHE_HITS");
+    columnNames.push_back("CACHE_MISSES");
+    columnNames.push_back("CACHE_EVICTIONS");
+    columnNames.push_back("CACHE_INVALIDATIONS");
+    columnNames.push_back("ENTRY_COUNT");
+    columnNames.push_back("MEMORY_USED");
+    columnNames.push_back("MEMORY_LIMIT");
+    return columnNames;
+}
+
+void FragmentResultCacheStats::populateFragmentResultCacheStatsSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes) {
+    StatsSource::populateBaseSchema(types, columnLengths, allowNull, inBytes);
+    for (int ii = 0; ii < 7; ii++) {
+        types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    }
+}
+
+TempTable* FragmentResultCacheStats::generateEmptyFragmentResultCacheStatsTable() {
+    string name = "Fragment result cache stats temp table";
+    vector<string> columnNames = FragmentResultCacheStats::generateFragmentResultCacheStatsColumnNames();
+    vector<ValueType> columnTypes;
+    vector<int32_t> columnLengths;
+    vector<bool> columnAllowNull;
+    vector<bool> columnInBytes;
+    FragmentResultCacheStats::populateFragmentResultCacheStatsSchema(columnTypes, columnLengths,
+                                                                     columnAllowNull, columnInBytes);
+    TupleSchema *schema =
+        TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                       columnAllowNull, columnInBytes);
+
+    return TableFactory::buildTempTable(name,
+                                        schema,
+                                        columnNames,
+                                        NULL);
+}
+
+FragmentResultCacheStats::FragmentResultCacheStats(FragmentResultCache* cache)
+    : StatsSource(), m_cache(cache), m_lastHits(0), m_lastMisses(0),
+      m_lastEvictions(0), m_lastInvalidations(0)
+{
+}
+
+vector<string> FragmentResultCacheStats::generateStatsColumnNames() {
+    return FragmentResultCacheStats::generateFragmentResultCacheStatsColumnNames();
+}
+
+/**
+ * Update the stats tuple with the latest statistics available to this StatsSource.
+ * Memory is reported in KB, like the table stats.
+ */
+void FragmentResultCacheStats::updateStatsTuple(TableTuple *tuple) {
+    int64_t hits = m_cache->hits();
+    int64_t misses = m_cache->misses();
+    int64_t evictions = m_cache->evictions();
+    int64_t invalidations = m_cache->invalidations();
+
+    if (interval()) {
+        hits -= m_lastHits;
+        m_lastHits = m_cache->hits();
+        misses -= m_lastMisses;
+        m_lastMisses = m_cache->misses();
+        evictions -= m_lastEvictions;
+        m_lastEvictions = m_cache->evictions();
+        invalidations -= m_lastInvalidations;
+        m_lastInvalidations = m_cache->invalidations();
+    }
+
+    tuple->setNValue(StatsSource::m_columnName2Index["CACHE_HITS"],
+            ValueFactory::getBigIntValue(hits));
+    tuple->setNValue(StatsSource::m_columnName2Index["CACHE_MISSES"],
+            ValueFactory::getBigIntValue(misses));
+    tuple->setNValue(StatsSource::m_columnName2Index["CACHE_EVICTIONS"],
+            ValueFactory::getBigIntValue(evictions));
+    tuple->setNValue(StatsSource::m_columnName2Index["CACHE_INVALIDATIONS"],
+            ValueFactory::getBigIntValue(invalidations));
+    tuple->setNValue(StatsSource::m_columnName2Index["ENTRY_COUNT"],
+            ValueFactory::getBigIntValue(m_cache->entryCount()));
+    tuple->setNValue(StatsSource::m_columnName2Index["MEMORY_USED"],
+            ValueFactory::getBigIntValue(m_cache->memoryUsed() / 1024));
+    tuple->setNValue(StatsSource::m_columnName2Index["MEMORY_LIMIT"],
+            ValueFactory::getBigIntValue(m_cache->memoryLimit() / 1024));
+}
+
+void FragmentResultCacheStats::populateSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes) {
+    FragmentResultCacheStats::populateFragmentResultCacheStatsSchema(types, columnLengths, allowNull, inBytes);
+}
@@ -0,0 +1,80 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FRAGMENTRESULTCACHESTATS_H_
+#define FRAGMENTRESULTCACHESTATS_H_
+
+#include "stats/StatsSource.h"
+
+namespace voltdb {
+class FragmentResultCache;
+class TempTable;
+
+/**
+ * StatsSource extension for the fragment result cache.
+ */
+class FragmentResultCacheStats : public voltdb::StatsSource {
+public:
+    /**
+     * Static method to generate the column names for the tables which
+     * contain fragment result cache stats.
+     */
+    static std::vector<std::string> generateFragmentResultCacheStatsColumnNames();
+
+    /**
+     * Static method to generate the remaining schema information for
+     * the tables which contain fragment result cache stats.
+     */
+    static void populateFragmentResultCacheStatsSchema(std::vector<voltdb::ValueType>& types,
+                                                       std::vector<int32_t>& columnLengths,
+                                                       std::vector<bool>& allowNull,
+                                                       std::vector<bool>& inBytes);
+
+    /**
+     * Return an empty FragmentResultCacheStats table
+     */
+    static TempTable* generateEmptyFragmentResultCacheStatsTable();
+
+    /*
+     * Constructor caches reference to the cache that will be generating the statistics
+     */
+    FragmentResultCacheStats(voltdb::FragmentResultCache* cache);
+
+protected:
+
+    /**
+     * Update the stats tuple with the latest statistics available to this StatsSource.
+     */
+    virtual void updateStatsTuple(voltdb::TableTuple *tuple);
+
+    virtual std::vector<std::string> generateStatsColumnNames();
+
+    virtual void populateSchema(std::vector<voltdb::ValueType> &types, std::vector<int32_t> &columnLengths,
+            std::vector<bool> &allowNull, std::vector<bool> &inBytes);
+
+private:
+    voltdb::FragmentResultCache* m_cache;
+
+    int64_t m_lastHits;
+    int64_t m_lastMisses;
+    int64_t m_lastEvictions;
+    int64_t m_lastInvalidations;
+};
+
+}
+
+#endif /* FRAGMENTRESULTCACHESTATS_H_ */
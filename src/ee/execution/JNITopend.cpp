@@ -91,6 +91,17 @@ JNITopend::JNITopend(JNIEnv *env, jobject caller) : m_jniEnv(env), m_javaExecuti
         throw std::exception();
     }
 
+    m_pushResultChunkMID =
+            m_jniEnv->GetMethodID(
+                    jniClass,
+                    "pushResultChunk",
+                    "(Ljava/nio/ByteBuffer;I)V");
+    if (m_pushResultChunkMID == NULL) {
+        m_jniEnv->ExceptionDescribe();
+        assert(m_pushResultChunkMID != 0);
+        throw std::exception();
+    }
+
     m_nextDependencyMID = m_jniEnv->GetMethodID(jniClass, "nextDependencyAsBytes", "(I)[B");
     if (m_nextDependencyMID == NULL) {
         m_jniEnv->ExceptionDescribe();
@@ -244,6 +255,29 @@ void JNITopend::fallbackToEEAllocatedBuffer(char *buffer, size_t length) {
     }
 }
 
+bool JNITopend::pushResultChunk(const char *data, size_t length, size_t headLength) {
+    JNILocalFrameBarrier jni_frame = JNILocalFrameBarrier(m_jniEnv, 1);
+    if (jni_frame.checkResult() < 0) {
+        VOLT_ERROR("Unable to push result chunk: jni frame error.");
+        throw std::exception();
+    }
+
+    // Java copies the chunk before returning, so the buffer can be wrapped as is
+    jobject jbuffer = m_jniEnv->NewDirectByteBuffer(const_cast<char*>(data), length);
+    if (jbuffer == NULL) {
+        m_jniEnv->ExceptionDescribe();
+        throw std::exception();
+    }
+
+    m_jniEnv->CallVoidMethod(m_javaExecutionEngine, m_pushResultChunkMID, jbuffer,
+                             static_cast<jint>(headLength));
+    if (m_jniEnv->ExceptionCheck()) {
+        m_jniEnv->ExceptionDescribe();
+        throw std::exception();
+    }
+    return true;
+}
+
 int JNITopend::loadNextDependency(int32_t dependencyId, voltdb::Pool *stringPool, Table* destination) {
     VOLT_DEBUG("iterating java dependency for id %d", dependencyId);
 
@@ -62,6 +62,8 @@ public:
 
     void fallbackToEEAllocatedBuffer(char *buffer, size_t length);
 
+    bool pushResultChunk(const char *data, size_t length, size_t headLength);
+
     std::string decodeBase64AndDecompress(const std::string& buffer);
 
 private:
@@ -73,6 +75,7 @@ private:
     */
     jobject m_javaExecutionEngine;
     jmethodID m_fallbackToEEAllocatedBufferMID;
+    jmethodID m_pushResultChunkMID;
     jmethodID m_nextDependencyMID;
     jmethodID m_traceLogMID;
     jmethodID m_fragmentProgressUpdateMID;
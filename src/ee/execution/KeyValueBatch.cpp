@@ -0,0 +1,163 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "execution/KeyValueBatch.h"
+
+#include "common/executorcontext.hpp"
+#include "common/NValue.hpp"
+#include "common/SerializableEEException.h"
+#include "execution/VoltDBEngine.h"
+#include "indexes/tableindex.h"
+#include "storage/ConstraintFailureException.h"
+#include "storage/persistenttable.h"
+
+namespace voltdb {
+
+KeyValueBatch::KeyValueBatch(PersistentTable* table, Pool* stringPool)
+    : m_table(table)
+    , m_pkeyIndex(table->primaryKeyIndex())
+    , m_stringPool(stringPool)
+    , m_key()
+    , m_row()
+{
+    if (m_pkeyIndex == NULL) {
+        throwSerializableEEException("Table %s has no primary key", table->name().c_str());
+    }
+    m_key.init(m_pkeyIndex->getKeySchema());
+    m_row.init(table->schema());
+}
+
+int64_t KeyValueBatch::execute(ReferenceSerializeInputBE& in, SerializeOutput& out) {
+    int64_t changed = 0;
+    const int32_t count = in.readInt();
+    for (int32_t ii = 0; ii < count; ++ii) {
+        const int8_t op = in.readByte();
+        switch (op) {
+        case KEY_VALUE_OP_GET:
+            get(in, out);
+            break;
+        case KEY_VALUE_OP_PUT:
+            put(in, out);
+            ++changed;
+            break;
+        case KEY_VALUE_OP_DELETE:
+            if (remove(in, out)) {
+                ++changed;
+            }
+            break;
+        case KEY_VALUE_OP_INCREMENT:
+            if (increment(in, out)) {
+                ++changed;
+            }
+            break;
+        default:
+            throwSerializableEEException("Unknown key-value operation %d", static_cast<int>(op));
+        }
+    }
+    return changed;
+}
+
+TableTuple KeyValueBatch::findByKey(ReferenceSerializeInputBE& in) {
+    TableTuple key = m_key.tuple();
+    const int keyColumnCount = key.getSchema()->columnCount();
+    for (int ii = 0; ii < keyColumnCount; ++ii) {
+        NValue value;
+        value.deserializeFromAllocateForStorage(in, m_stringPool);
+        key.setNValue(ii, value);
+    }
+    IndexCursor cursor(m_pkeyIndex->getTupleSchema());
+    m_pkeyIndex->moveToKey(&key, cursor);
+    TableTuple found = m_pkeyIndex->nextValueAtKey(cursor);
+    // A row that a snapshot or an earlier operation is deleting is gone
+    if (! found.isNullTuple() && found.isPendingDelete()) {
+        return TableTuple(m_table->schema());
+    }
+    return found;
+}
+
+void KeyValueBatch::get(ReferenceSerializeInputBE& in, SerializeOutput& out) {
+    TableTuple found = findByKey(in);
+    out.writeBool(! found.isNullTuple());
+    if (! found.isNullTuple()) {
+        found.serializeTo(out);
+    }
+}
+
+bool KeyValueBatch::put(ReferenceSerializeInputBE& in, SerializeOutput& out) {
+    TableTuple row = m_row.tuple();
+    const int columnCount = row.getSchema()->columnCount();
+    for (int ii = 0; ii < columnCount; ++ii) {
+        NValue value;
+        value.deserializeFromAllocateForStorage(in, m_stringPool);
+        row.setNValueAllocateForObjectCopies(ii, value, m_stringPool);
+    }
+    // The caller routes operations by key, but a row must still live where
+    // its partitioning value does
+    int partitionColumn = m_table->partitionColumn();
+    if (partitionColumn != -1 &&
+            ! ExecutorContext::getEngine()->isLocalSite(row.getNValue(partitionColumn))) {
+        throw ConstraintFailureException(m_table, row, "Mispartitioned tuple in key-value put.");
+    }
+    TableTuple existing = m_table->lookupTupleByValues(row);
+    // As in findByKey, a row that is being deleted is not there
+    if (existing.isNullTuple() || existing.isPendingDelete()) {
+        m_table->insertPersistentTuple(row, true);
+        out.writeBool(false);
+        return false;
+    }
+    TableTuple& update = m_table->copyIntoTempTuple(existing);
+    for (int ii = 0; ii < columnCount; ++ii) {
+        update.setNValue(ii, row.getNValue(ii));
+    }
+    m_table->updateTupleWithSpecificIndexes(existing, update, m_table->allIndexes());
+    out.writeBool(true);
+    return true;
+}
+
+bool KeyValueBatch::remove(ReferenceSerializeInputBE& in, SerializeOutput& out) {
+    TableTuple found = findByKey(in);
+    out.writeBool(! found.isNullTuple());
+    if (found.isNullTuple()) {
+        return false;
+    }
+    m_table->deleteTuple(found, true);
+    return true;
+}
+
+bool KeyValueBatch::increment(ReferenceSerializeInputBE& in, SerializeOutput& out) {
+    TableTuple found = findByKey(in);
+    const int32_t column = in.readInt();
+    NValue delta;
+    delta.deserializeFromAllocateForStorage(in, m_stringPool);
+    if (column < 0 || column >= m_table->schema()->columnCount() ||
+            ! isIntegralType(m_table->schema()->columnType(column))) {
+        throwSerializableEEException("Column %d of table %s is not an integer column",
+                                     column, m_table->name().c_str());
+    }
+    out.writeBool(! found.isNullTuple());
+    if (found.isNullTuple()) {
+        return false;
+    }
+    NValue sum = found.getNValue(column).op_add(delta).castAs(m_table->schema()->columnType(column));
+    TableTuple& update = m_table->copyIntoTempTuple(found);
+    update.setNValue(column, sum);
+    m_table->updateTupleWithSpecificIndexes(found, update, m_table->allIndexes());
+    sum.serializeTo(out);
+    return true;
+}
+
+} // namespace voltdb
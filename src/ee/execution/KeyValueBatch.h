@@ -0,0 +1,87 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEYVALUEBATCH_H_
+#define KEYVALUEBATCH_H_
+
+#include "common/serializeio.h"
+#include "common/tabletuple.h"
+
+namespace voltdb {
+
+class PersistentTable;
+class Pool;
+class TableIndex;
+
+/**
+ * The operations of a key-value batch (see VoltDBEngine::executeKeyValueBatch).
+ */
+enum KeyValueOpType {
+    KEY_VALUE_OP_GET       = 1,
+    KEY_VALUE_OP_PUT       = 2,
+    KEY_VALUE_OP_DELETE    = 3,
+    KEY_VALUE_OP_INCREMENT = 4
+};
+
+/**
+ * Gets, puts, deletes and increments rows of a persistent table by primary
+ * key, going straight to its primary key index instead of through plan
+ * executors. Changes are made with the same PersistentTable calls that the
+ * insert, update and delete executors use, so they are undone, DR'd and
+ * kept in views in the same way.
+ *
+ * A batch is an int count followed by that many operations. Each is a
+ * KeyValueOpType byte followed by values serialized as parameters are:
+ *   GET, DELETE: the primary key columns, in primary key order
+ *   PUT:         every column of the row, which replaces any row with its key
+ *   INCREMENT:   the primary key columns, then an int column index and the
+ *                amount to add to that column
+ * For each operation a byte is written that is 1 if a row with the key was
+ * there and 0 if not. Found rows are then written for GET, and the column's
+ * new value for INCREMENT.
+ */
+class KeyValueBatch {
+public:
+    /**
+     * Values are deserialized into the given pool, which the caller purges.
+     */
+    KeyValueBatch(PersistentTable* table, Pool* stringPool);
+
+    /**
+     * Run the whole batch and return how many rows were changed.
+     */
+    int64_t execute(ReferenceSerializeInputBE& in, SerializeOutput& out);
+
+private:
+    /** Read the key and return the row it names, or a null tuple. */
+    TableTuple findByKey(ReferenceSerializeInputBE& in);
+
+    void get(ReferenceSerializeInputBE& in, SerializeOutput& out);
+    bool put(ReferenceSerializeInputBE& in, SerializeOutput& out);
+    bool remove(ReferenceSerializeInputBE& in, SerializeOutput& out);
+    bool increment(ReferenceSerializeInputBE& in, SerializeOutput& out);
+
+    PersistentTable* m_table;
+    TableIndex* m_pkeyIndex;
+    Pool* m_stringPool;
+    StandAloneTupleStorage m_key;
+    StandAloneTupleStorage m_row;
+};
+
+} // namespace voltdb
+
+#endif /* KEYVALUEBATCH_H_ */
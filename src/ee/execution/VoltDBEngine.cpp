@@ -46,6 +46,8 @@
 #include "VoltDBEngine.h"
 
 #include "ExecutorVector.h"
+#include "FragmentResultCache.h"
+#include "KeyValueBatch.h"
 
 #include "catalog/catalog.h"
 #include "catalog/catalogmap.h"
@@ -73,6 +75,7 @@
 #include "common/TupleOutputStreamProcessor.h"
 
 #include "executors/abstractexecutor.h"
+#include "executors/ParallelScan.h"
 
 #include "indexes/tableindex.h"
 #include "indexes/tableindexfactory.h"
@@ -114,6 +117,10 @@ ENABLE_BOOST_FOREACH_ON_CONST_MAP(MaterializedViewInfo);
 ENABLE_BOOST_FOREACH_ON_CONST_MAP(Table);
 
 static const size_t PLAN_CACHE_SIZE = 1000;
+// how much memory cached fragments may keep between executions by default
+static const int64_t DEFAULT_WORKING_SET_MEMORY = 16 * 1024 * 1024;
+// how many cold blocks each table may move to its file in a tick
+static const int32_t COLD_TIER_BLOCKS_PER_TICK = 16;
 // table name prefix of DR conflict table
 const std::string DR_REPLICATED_CONFLICT_TABLE_NAME = "VOLTDB_AUTOGEN_XDCR_CONFLICTS_REPLICATED";
 const std::string DR_PARTITIONED_CONFLICT_TABLE_NAME = "VOLTDB_AUTOGEN_XDCR_CONFLICTS_PARTITIONED";
@@ -146,6 +153,12 @@ class EnginePlanSet : public PlanSet { };
 
 VoltDBEngine::VoltDBEngine(Topend* topend, LogProxy* logProxy)
     : m_currentIndexInBatch(-1),
+      m_fragmentResultCache(new FragmentResultCache()),
+      m_workingSetMemoryLimit(DEFAULT_WORKING_SET_MEMORY),
+      m_workingSetMemory(0),
+      m_compactionTuplesPerTick(0),
+      m_compactionMillisPerTick(0),
+      m_coldAfterTicks(0),
       m_currentUndoQuantum(NULL),
       m_partitionId(-1),
       m_hashinator(NULL),
@@ -233,6 +246,12 @@ void VoltDBEngine::initialize(int32_t clusterIndex,
                                             m_drStream,
                                             m_drReplicatedStream,
                                             drClusterId);
+
+    // The stats source needs the executor context for its host and site ids.
+    m_fragmentResultCache->getStats()->configure("Fragment result cache stats");
+    getStatsManager().registerStatsSource(STATISTICS_SELECTOR_TYPE_FRAGMENT_RESULT_CACHE,
+                                          0,
+                                          m_fragmentResultCache->getStats());
 }
 
 VoltDBEngine::~VoltDBEngine() {
@@ -268,6 +287,10 @@ VoltDBEngine::~VoltDBEngine() {
         tid.second->decrementRefcount();
     }
 
+    BOOST_FOREACH (TID tid, m_snapshotReadTables) {
+        tid.second->decrementRefcount();
+    }
+
     delete m_executorContext;
 
     delete m_drReplicatedStream;
@@ -399,9 +422,13 @@ int VoltDBEngine::executePlanFragments(int32_t numFragments,
         }
         assert (usedParamcnt < MAX_PARAM_COUNT);
 
+        // The serialized parameters are also the fragment result cache key.
+        const char* paramBytes = serialInput.getRawPointer();
         for (int j = 0; j < usedParamcnt; ++j) {
             params[j].deserializeFromAllocateForStorage(serialInput, &m_stringPool);
         }
+        m_executorContext->parametersChanged();
+        size_t paramsLength = serialInput.getRawPointer() - paramBytes;
 
         if (perFragmentTimingEnabled) {
             startTime = std::chrono::high_resolution_clock::now();
@@ -409,6 +436,8 @@ int VoltDBEngine::executePlanFragments(int32_t numFragments,
         // success is 0 and error is 1.
         if (executePlanFragment(planfragmentIds[m_currentIndexInBatch],
                                 inputDependencyIds ? inputDependencyIds[m_currentIndexInBatch] : -1,
+                                paramBytes,
+                                paramsLength,
                                 m_currentIndexInBatch == 0,
                                 m_currentIndexInBatch == (numFragments - 1),
                                 traceOn)) {
@@ -438,6 +467,8 @@ int VoltDBEngine::executePlanFragments(int32_t numFragments,
 
 int VoltDBEngine::executePlanFragment(int64_t planfragmentId,
                                       int64_t inputDependencyId,
+                                      const char* params,
+                                      size_t paramsLength,
                                       bool first,
                                       bool last,
                                       bool traceOn)
@@ -473,18 +504,41 @@ int VoltDBEngine::executePlanFragment(int64_t planfragmentId,
     assert(m_executorContext->getModifiedTupleStackSize() == 0);
 
     int64_t tuplesModified = 0;
+    size_t flushedBytesBefore = m_resultOutput.flushedBytes();
+    // Set only when the fragment's result may be cached but was not found.
+    std::string resultCacheKey;
     try {
         // execution lists for planfragments are cached by planfragment id
         setExecutorVectorForFragmentId(planfragmentId);
         assert(m_currExecutorVec);
 
-        executePlanFragment(m_currExecutorVec, &tuplesModified);
+        const CachedFragmentResult* cached = NULL;
+        if (m_fragmentResultCache->isEnabled() &&
+                inputDependencyId == -1 &&
+                m_currExecutorVec->isResultCacheable()) {
+            std::string key = FragmentResultCache::makeKey(planfragmentId, params, paramsLength);
+            cached = m_fragmentResultCache->lookup(key);
+            if (cached == NULL) {
+                resultCacheKey.swap(key);
+            }
+        }
+
+        if (cached != NULL) {
+            m_resultOutput.writeBytes(cached->result.data(), cached->result.size());
+            m_numResultDependencies = cached->dependencyCount;
+        }
+        else {
+            executePlanFragment(m_currExecutorVec, &tuplesModified);
+        }
     }
     catch (const SerializableEEException &e) {
         serializeException(e);
+        m_executorContext->cleanupAllExecutors();
+        if (m_currExecutorVec != NULL && m_workingSetMemoryLimit > 0) {
+            accountWorkingSet(m_currExecutorVec);
+        }
         m_currExecutorVec = NULL;
         m_currentInputDepId = -1;
-        m_executorContext->cleanupAllExecutors();
         return ENGINE_ERRORCODE_ERROR;
     }
 
@@ -499,6 +553,21 @@ int VoltDBEngine::executePlanFragment(int64_t planfragmentId,
     DEBUG_ASSERT_OR_THROW_OR_CRASH(m_executorContext->allOutputTempTablesAreEmpty(),
                                    "Output temp tables not cleaned up after execution");
 
+    if (m_workingSetMemoryLimit > 0) {
+        accountWorkingSet(m_currExecutorVec);
+    }
+
+    // A result that was pushed to the topend in chunks is no longer all here
+    if ( ! resultCacheKey.empty() && tuplesModified == 0 && m_numResultDependencies > 0 &&
+            m_resultOutput.flushedBytes() == flushedBytesBefore) {
+        size_t resultStart = numResultDependenciesCountOffset + sizeof(int32_t);
+        m_fragmentResultCache->insert(resultCacheKey,
+                                      m_currExecutorVec->getScannedTables(),
+                                      m_numResultDependencies,
+                                      m_resultOutput.data() + resultStart,
+                                      m_resultOutput.position() - resultStart);
+    }
+
     m_currExecutorVec = NULL;
     m_currentInputDepId = -1;
 
@@ -523,12 +592,47 @@ int VoltDBEngine::executePlanFragment(int64_t planfragmentId,
     // the result buffer
     if (last) {
         m_resultOutput.writeBoolAt(m_startOfResultBuffer, m_dirtyFragmentBatch);
-        m_resultOutput.writeIntAt(m_startOfResultBuffer+1, static_cast<int32_t>(m_resultOutput.position() - m_startOfResultBuffer) - sizeof(int32_t) - sizeof(int8_t));
+        m_resultOutput.writeIntAt(m_startOfResultBuffer+1, static_cast<int32_t>(m_resultOutput.position() + m_resultOutput.flushedBytes() - m_startOfResultBuffer) - sizeof(int32_t) - sizeof(int8_t));
     }
 
     return ENGINE_ERRORCODE_SUCCESS;
 }
 
+int VoltDBEngine::executeKeyValueBatch(int32_t tableId,
+                                       ReferenceSerializeInputBE &serialInput,
+                                       int64_t txnId,
+                                       int64_t spHandle,
+                                       int64_t lastCommittedSpHandle,
+                                       int64_t uniqueId,
+                                       int64_t undoToken)
+{
+    resetReusedResultOutputBuffer();
+    setUndoToken(undoToken);
+    m_executorContext->setupForPlanFragments(getCurrentUndoQuantum(),
+                                             txnId,
+                                             spHandle,
+                                             lastCommittedSpHandle,
+                                             uniqueId,
+                                             false);
+    m_executorContext->checkTransactionForDR();
+
+    int result = ENGINE_ERRORCODE_SUCCESS;
+    try {
+        PersistentTable* table = dynamic_cast<PersistentTable*>(getTableById(tableId));
+        if (table == NULL) {
+            throwSerializableEEException("Table ID %d is not a persistent table", (int) tableId);
+        }
+        KeyValueBatch batch(table, &m_stringPool);
+        batch.execute(serialInput, m_resultOutput);
+    }
+    catch (const SerializableEEException &e) {
+        serializeException(e);
+        result = ENGINE_ERRORCODE_ERROR;
+    }
+    m_stringPool.purge();
+    return result;
+}
+
 UniqueTempTableResult VoltDBEngine::executePlanFragment(ExecutorVector* executorVector, int64_t* tuplesModified) {
     UniqueTempTableResult result;
     // set this to zero for dml operations
@@ -587,7 +691,14 @@ void VoltDBEngine::serializeException(const SerializableEEException& e) {
 void VoltDBEngine::send(Table* dependency) {
     VOLT_DEBUG("Sending Dependency from C++");
     m_resultOutput.writeInt(-1); // legacy placeholder for old output id
-    dependency->serializeTo(m_resultOutput);
+    // Only one dependency of a batch can be pushed to the topend in chunks,
+    // since everything written after the chunks stays in the buffer.
+    if (m_resultOutput.flushedBytes() == 0) {
+        dependency->serializeInChunksTo(m_resultOutput);
+    }
+    else {
+        dependency->serializeTo(m_resultOutput);
+    }
     m_numResultDependencies++;
 }
 
@@ -1108,6 +1219,9 @@ bool VoltDBEngine::updateCatalog(int64_t timestamp, bool isStreamUpdate, std::st
     if (m_plans) {
         m_plans->clear();
     }
+    m_workingSetMemory = 0;
+    // cached results refer to table delegates that may be deleted below
+    m_fragmentResultCache->clear();
 
     assert(m_catalog != NULL); // the engine must be initialized
     VOLT_DEBUG("Updating catalog...");
@@ -1202,6 +1316,7 @@ void VoltDBEngine::rebuildTableCollections() {
     // need to re-map all the table ids / indexes
     getStatsManager().unregisterStatsSource(STATISTICS_SELECTOR_TYPE_TABLE);
     getStatsManager().unregisterStatsSource(STATISTICS_SELECTOR_TYPE_INDEX);
+    getStatsManager().unregisterStatsSource(STATISTICS_SELECTOR_TYPE_COMPACTION);
 
     // walk the table delegates and update local table collections
     BOOST_FOREACH (LabeledTCD cd, m_catalogDelegates) {
@@ -1239,6 +1354,19 @@ void VoltDBEngine::rebuildTableCollections() {
                                                       relativeIndexOfTable,
                                                       index->getIndexStats());
             }
+            getStatsManager().registerStatsSource(STATISTICS_SELECTOR_TYPE_COMPACTION,
+                                                  relativeIndexOfTable,
+                                                  persistentTable->getCompactionStats());
+            persistentTable->setIncrementalCompaction(m_compactionTuplesPerTick > 0);
+            if ( ! m_coldTierDirectory.empty() && ! persistentTable->hasColdTier()) {
+                persistentTable->enableColdTier(m_coldTierDirectory, m_coldAfterTicks);
+            }
+            // columns named in a DICTIONARY TABLE statement share their values
+            BOOST_FOREACH (LabeledColumn labeledColumn, catTable->columns()) {
+                if (labeledColumn.second->dictionary()) {
+                    persistentTable->enableStringDictionary(labeledColumn.second->index());
+                }
+            }
         }
         else {
             stats = tcd->getStreamedTable()->getTableStats();
@@ -1303,6 +1431,7 @@ void VoltDBEngine::setExecutorVectorForFragmentId(int64_t fragId) {
     }
 
     boost::shared_ptr<ExecutorVector> ev_guard = ExecutorVector::fromJsonPlan(this, plan, fragId);
+    ev_guard->setRetainsWorkingSet(m_workingSetMemoryLimit > 0);
 
     // add the plan to the back
     //
@@ -1313,6 +1442,7 @@ void VoltDBEngine::setExecutorVectorForFragmentId(int64_t fragId) {
     // remove a plan from the front if the cache is full
     if (plans.size() > PLAN_CACHE_SIZE) {
         PlanSet::iterator iter = plans.get<0>().begin();
+        m_workingSetMemory -= (*iter)->workingSetSize();
         plans.erase(iter);
     }
 
@@ -1495,6 +1625,83 @@ void VoltDBEngine::tick(int64_t timeInMillis, int64_t lastCommittedSpHandle) {
     if (m_executorContext->drReplicatedStream()) {
         m_executorContext->drReplicatedStream()->periodicFlush(timeInMillis, lastCommittedSpHandle);
     }
+    if (m_compactionTuplesPerTick > 0) {
+        compactTablesIncrementally();
+    }
+    typedef std::pair<CatalogId, Table*> TableEntry;
+    BOOST_FOREACH (TableEntry entry, m_tables) {
+        PersistentTable* table = dynamic_cast<PersistentTable*>(entry.second);
+        if (table && table->hasColdTier()) {
+            table->tierColdBlocks(COLD_TIER_BLOCKS_PER_TICK);
+        }
+    }
+}
+
+void VoltDBEngine::setCompactionBudget(int64_t tuplesPerTick, int32_t millisPerTick) {
+    m_compactionTuplesPerTick = std::max<int64_t>(0, tuplesPerTick);
+    m_compactionMillisPerTick = std::max(0, millisPerTick);
+    typedef std::pair<CatalogId, Table*> TableEntry;
+    BOOST_FOREACH (TableEntry entry, m_tables) {
+        PersistentTable* table = dynamic_cast<PersistentTable*>(entry.second);
+        if (table) {
+            table->setIncrementalCompaction(m_compactionTuplesPerTick > 0);
+        }
+    }
+}
+
+void VoltDBEngine::setColdTier(const std::string& directory, int32_t coldAfterTicks) {
+    m_coldTierDirectory = directory;
+    m_coldAfterTicks = coldAfterTicks;
+    typedef std::pair<CatalogId, Table*> TableEntry;
+    BOOST_FOREACH (TableEntry entry, m_tables) {
+        PersistentTable* table = dynamic_cast<PersistentTable*>(entry.second);
+        if (table) {
+            table->enableColdTier(m_coldTierDirectory, m_coldAfterTicks);
+        }
+    }
+}
+
+void VoltDBEngine::compactTablesIncrementally() {
+    // Tables with the most blocks in the emptier half of the load histogram
+    // go first: every one of those blocks is given back for at most half a
+    // block's worth of moved tuples.
+    std::vector<std::pair<size_t, PersistentTable*> > candidates;
+    std::vector<size_t> histogram;
+    typedef std::pair<CatalogId, Table*> TableEntry;
+    BOOST_FOREACH (TableEntry entry, m_tables) {
+        PersistentTable* table = dynamic_cast<PersistentTable*>(entry.second);
+        if (table == NULL || table->reclaimableBlockCount() == 0) {
+            continue;
+        }
+        table->blockLoadHistogram(histogram);
+        size_t lightBlocks = 0;
+        for (int ii = 0; ii < TUPLE_BLOCK_NUM_BUCKETS / 2; ii++) {
+            lightBlocks += histogram[ii];
+        }
+        candidates.push_back(std::make_pair(lightBlocks, table));
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const std::pair<size_t, PersistentTable*>& a,
+                        const std::pair<size_t, PersistentTable*>& b) { return a.first > b.first; });
+
+    std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(m_compactionMillisPerTick);
+    int64_t tupleMovesLeft = m_compactionTuplesPerTick;
+    for (size_t ii = 0; ii < candidates.size() && tupleMovesLeft > 0; ii++) {
+        PersistentTable* table = candidates[ii].second;
+        // Go a block's worth at a time so the clock is checked often
+        int64_t step = std::max<int64_t>(1, table->getTuplesPerBlock());
+        while (tupleMovesLeft > 0) {
+            int64_t tuplesMoved = table->doBudgetedCompaction(std::min(step, tupleMovesLeft));
+            if (tuplesMoved == 0) {
+                break;
+            }
+            tupleMovesLeft -= tuplesMoved;
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return;
+            }
+        }
+    }
 }
 
 /** Bring the Export and DR system to a steady state with no pending committed data */
@@ -1570,6 +1777,7 @@ int VoltDBEngine::getStats(int selector, int locators[], int numLocators,
                 locatorIds, interval, now);
             break;
         case STATISTICS_SELECTOR_TYPE_INDEX:
+        case STATISTICS_SELECTOR_TYPE_COMPACTION:
             for (int ii = 0; ii < numLocators; ii++) {
                 CatalogId locator = static_cast<CatalogId>(locators[ii]);
                 if ( ! getTableById(locator)) {
@@ -1582,6 +1790,12 @@ int VoltDBEngine::getStats(int selector, int locators[], int numLocators,
                 }
             }
 
+            resultTable = m_statsManager.getStats(
+                (StatisticsSelectorType) selector,
+                locatorIds, interval, now);
+            break;
+        case STATISTICS_SELECTOR_TYPE_FRAGMENT_RESULT_CACHE:
+            // The cache is per engine; its stats source is registered with locator 0.
             resultTable = m_statsManager.getStats(
                 (StatisticsSelectorType) selector,
                 locatorIds, interval, now);
@@ -1610,6 +1824,58 @@ int VoltDBEngine::getStats(int selector, int locators[], int numLocators,
 }
 
 
+void VoltDBEngine::setFragmentResultCacheMemoryLimit(int64_t memoryLimit) {
+    m_fragmentResultCache->setMemoryLimit(memoryLimit);
+}
+
+void VoltDBEngine::setWorkingSetMemoryLimit(int64_t memoryLimit) {
+    bool wasRetaining = m_workingSetMemoryLimit > 0;
+    m_workingSetMemoryLimit = std::max<int64_t>(memoryLimit, 0);
+    bool retaining = m_workingSetMemoryLimit > 0;
+    if ( ! m_plans) {
+        return;
+    }
+    if (retaining != wasRetaining) {
+        PlanSet& plans = *m_plans;
+        BOOST_FOREACH (boost::shared_ptr<ExecutorVector> ev_guard, plans) {
+            ev_guard->setRetainsWorkingSet(retaining);
+            if ( ! retaining) {
+                ev_guard->releaseWorkingSet();
+            }
+        }
+        m_workingSetMemory = 0;
+        return;
+    }
+    releaseWorkingSetsOverLimit();
+}
+
+void VoltDBEngine::accountWorkingSet(ExecutorVector* executorVector) {
+    int64_t previousSize = executorVector->workingSetSize();
+    m_workingSetMemory += executorVector->measureWorkingSet() - previousSize;
+    if (m_workingSetMemory > m_workingSetMemoryLimit) {
+        releaseWorkingSetsOverLimit();
+    }
+}
+
+void VoltDBEngine::releaseWorkingSetsOverLimit() {
+    if ( ! m_plans) {
+        return;
+    }
+    // Reused plans move to the front, so the least recently used are at
+    // the back. The fragment just run goes too if it alone is too big.
+    PlanSet& plans = *m_plans;
+    for (PlanSet::reverse_iterator iter = plans.rbegin();
+            iter != plans.rend() && m_workingSetMemory > m_workingSetMemoryLimit; ++iter) {
+        m_workingSetMemory -= (*iter)->workingSetSize();
+        (*iter)->releaseWorkingSet();
+    }
+}
+
+void VoltDBEngine::setTempTableBlockPool(int64_t memoryLimit, int32_t prefaultBlocks) {
+    m_tempTableBlockPool.setMemoryLimit(memoryLimit);
+    m_tempTableBlockPool.prefault(TempTable::blockAllocationSize(), prefaultBlocks);
+}
+
 void VoltDBEngine::setCurrentUndoQuantum(voltdb::UndoQuantum* undoQuantum) {
     m_currentUndoQuantum = undoQuantum;
     m_executorContext->setupForPlanFragments(m_currentUndoQuantum);
@@ -1648,6 +1914,13 @@ bool VoltDBEngine::activateTableStream(
     }
     setUndoToken(undoToken);
 
+    // One point-in-time read per table id at a time, even if the table
+    // it started on has since been truncated away.
+    if (tableStreamTypeIsSnapshotRead(streamType) &&
+            m_snapshotReadTables.find(tableId) != m_snapshotReadTables.end()) {
+        return false;
+    }
+
     // Crank up the necessary persistent table streaming mechanism(s).
     if (!table->activateStream(streamType, m_partitionId, tableId, serializeIn)) {
         return false;
@@ -1664,6 +1937,10 @@ bool VoltDBEngine::activateTableStream(
         table->incrementRefcount();
         m_snapshottingTables[tableId] = table;
     }
+    else if (tableStreamTypeIsSnapshotRead(streamType)) {
+        table->incrementRefcount();
+        m_snapshotReadTables[tableId] = table;
+    }
 
     return true;
 }
@@ -1762,6 +2039,18 @@ int64_t VoltDBEngine::tableStreamSerializeMore(
             table->decrementRefcount();
         }
     }
+    else if (tableStreamTypeIsSnapshotRead(streamType)) {
+        table = findInMapOrNull(tableId, m_snapshotReadTables);
+        if (table == NULL) {
+            return TABLE_STREAM_SERIALIZATION_ERROR;
+        }
+
+        remaining = table->streamMore(outputStreams, streamType, retPositions);
+        if (remaining <= 0) {
+            m_snapshotReadTables.erase(tableId);
+            table->decrementRefcount();
+        }
+    }
     else if (tableStreamTypeIsStreamIndexing(streamType)) {
         Table* found = getTableById(tableId);
         if (found == NULL) {
@@ -2027,6 +2316,26 @@ void VoltDBEngine::executeTask(TaskType taskType, ReferenceSerializeInputBE &tas
         }
         break;
     }
+    case TASK_TYPE_SET_FRAGMENT_RESULT_CACHE_MEMORY_LIMIT:
+        setFragmentResultCacheMemoryLimit(taskInfo.readLong());
+        m_resultOutput.writeInt(0);
+        break;
+    case TASK_TYPE_SET_PARALLEL_SCAN_THREAD_COUNT:
+        ParallelScanPool::instance().setThreadCount(taskInfo.readInt());
+        m_resultOutput.writeInt(0);
+        break;
+    case TASK_TYPE_SET_COMPACTION_BUDGET: {
+        int64_t tuplesPerTick = taskInfo.readLong();
+        setCompactionBudget(tuplesPerTick, taskInfo.readInt());
+        m_resultOutput.writeInt(0);
+        break;
+    }
+    case TASK_TYPE_SET_COLD_TIER: {
+        int32_t coldAfterTicks = taskInfo.readInt();
+        setColdTier(taskInfo.readTextString(), coldAfterTicks);
+        m_resultOutput.writeInt(0);
+        break;
+    }
     default:
         throwFatalException("Unknown task type %d", taskType);
     }
@@ -59,6 +59,7 @@
 #include "stats/StatsAgent.h"
 
 #include "storage/BinaryLogSinkWrapper.h"
+#include "storage/TempTableBlockPool.h"
 
 #include "boost/scoped_ptr.hpp"
 #include "boost/unordered_map.hpp"
@@ -89,6 +90,7 @@ class AbstractPlanNode;
 class EnginePlanSet;  // Locally defined in VoltDBEngine.cpp
 class ExecutorContext;
 class ExecutorVector;
+class FragmentResultCache;
 class PersistentTable;
 class RecoveryProtoMsg;
 class StreamedTable;
@@ -209,6 +211,22 @@ class __attribute__((visibility("default"))) VoltDBEngine {
         UniqueTempTableResult executePlanFragment(ExecutorVector* executorVector,
                                                   int64_t* tuplesModified = NULL);
 
+        /**
+         * Run a batch of gets, puts, deletes and increments by primary key
+         * on a persistent table (see KeyValueBatch) without going through a
+         * plan fragment. The result buffer is reset and the results are
+         * written to it. Changes are made under the undo token, as a
+         * fragment's would be, and ENGINE_ERRORCODE_ERROR is returned, with
+         * the exception serialized, if any operation fails.
+         */
+        int executeKeyValueBatch(int32_t tableId,
+                                 ReferenceSerializeInputBE& serialInput,
+                                 int64_t txnId,
+                                 int64_t spHandle,
+                                 int64_t lastCommittedSpHandle,
+                                 int64_t uniqueId,
+                                 int64_t undoToken);
+
         // Created to transition existing unit tests to context abstraction.
         // If using this somewhere new, consider if you're being lazy.
         void updateExecutorContextUndoQuantumForTest();
@@ -348,6 +366,22 @@ class __attribute__((visibility("default"))) VoltDBEngine {
         /** flush active work (like EL buffers) */
         void quiesce(int64_t lastCommittedSpHandle);
 
+        /**
+         * Compact tables a slice at a time from tick(), moving at most
+         * tuplesPerTick tuples and spending about millisPerTick each time,
+         * instead of compacting a table fully when the deletes that call
+         * for it are released. A tuple budget of zero goes back to that.
+         */
+        void setCompactionBudget(int64_t tuplesPerTick, int32_t millisPerTick);
+
+        /**
+         * Let every persistent table, including ones added later, move blocks
+         * that go coldAfterTicks ticks without being scanned or changed to a
+         * file of its own in the given directory, from which they are paged
+         * back in when reached. An empty directory stops it.
+         */
+        void setColdTier(const std::string& directory, int32_t coldAfterTicks);
+
         std::string debug(void) const;
 
         /** DML executors call this to indicate how many tuples
@@ -377,6 +411,47 @@ class __attribute__((visibility("default"))) VoltDBEngine {
                 bool interval,
                 int64_t now);
 
+        // -------------------------------------------------
+        // Fragment result cache
+        // -------------------------------------------------
+
+        /**
+         * Set the memory budget in bytes for caching the results of
+         * read-only plan fragments. The cache is off by default and a
+         * budget of zero turns it off again.
+         */
+        void setFragmentResultCacheMemoryLimit(int64_t memoryLimit);
+
+        const FragmentResultCache& getFragmentResultCache() const { return *m_fragmentResultCache; }
+
+        // -------------------------------------------------
+        // Temp table block pool
+        // -------------------------------------------------
+
+        /**
+         * Set how much freed temp table block storage is kept for reuse
+         * by later executions, and allocate and touch prefaultBlocks
+         * blocks of it now so the first executions don't page fault.
+         */
+        void setTempTableBlockPool(int64_t memoryLimit, int32_t prefaultBlocks);
+
+        TempTableBlockPool* getTempTableBlockPool() { return &m_tempTableBlockPool; }
+
+        // -------------------------------------------------
+        // Fragment working sets
+        // -------------------------------------------------
+
+        /**
+         * Set how much memory cached plan fragments may keep between
+         * executions in output table blocks, hash tables, sort buffers and
+         * pools, so that frequently run fragments reuse them instead of
+         * allocating them again. The least recently used fragments free
+         * theirs first once over the limit. A limit of zero keeps none.
+         */
+        void setWorkingSetMemoryLimit(int64_t memoryLimit);
+
+        int64_t workingSetMemory() const { return m_workingSetMemory; }
+
         Pool* getStringPool() { return &m_stringPool; }
 
         LogManager* getLogManager() { return &m_logManager; }
@@ -515,6 +590,8 @@ class __attribute__((visibility("default"))) VoltDBEngine {
          */
         int executePlanFragment(int64_t planfragmentId,
                                 int64_t inputDependencyId,
+                                const char* params,
+                                size_t paramsLength,
                                 bool first,
                                 bool last,
                                 bool traceOn);
@@ -529,6 +606,18 @@ class __attribute__((visibility("default"))) VoltDBEngine {
 
         bool checkTempTableCleanup(ExecutorVector* execsForFrag);
 
+        /**
+         * Account for what a fragment kept after executing, freeing the
+         * least recently used fragments' working sets if over the limit.
+         */
+        void accountWorkingSet(ExecutorVector* executorVector);
+
+        /** Free the least recently used fragments' working sets down to the limit. */
+        void releaseWorkingSetsOverLimit();
+
+        /** Spend one tick's compaction budget on the tables that need it most */
+        void compactTablesIncrementally();
+
         // -------------------------------------------------
         // Data Members
         // -------------------------------------------------
@@ -537,8 +626,29 @@ class __attribute__((visibility("default"))) VoltDBEngine {
 
         int m_currentIndexInBatch;
 
+        /**
+         * Storage of freed temp table blocks. Declared ahead of the plans
+         * and their temp tables so that it is destroyed after them.
+         */
+        TempTableBlockPool m_tempTableBlockPool;
+
         boost::scoped_ptr<EnginePlanSet> m_plans;
 
+        /** Results of read-only fragments, keyed by fragment id and parameters */
+        boost::scoped_ptr<FragmentResultCache> m_fragmentResultCache;
+
+        /** Memory the cached fragments keep between executions, and its limit */
+        int64_t m_workingSetMemoryLimit;
+        int64_t m_workingSetMemory;
+
+        /** Incremental compaction budget per tick; no tuples means compaction is not incremental */
+        int64_t m_compactionTuplesPerTick;
+        int32_t m_compactionMillisPerTick;
+
+        /** Where persistent tables move their cold blocks; empty for nowhere */
+        std::string m_coldTierDirectory;
+        int32_t m_coldAfterTicks;
+
         voltdb::UndoLog m_undoLog;
 
         voltdb::UndoQuantum* m_currentUndoQuantum;
@@ -580,6 +690,13 @@ class __attribute__((visibility("default"))) VoltDBEngine {
          */
         std::map<int32_t, PersistentTable*> m_snapshottingTables;
 
+        /*
+         * Map of catalog table ids to tables being streamed for a
+         * point-in-time read. As with snapshots, the reference keeps
+         * the table the read started on alive across a truncate.
+         */
+        std::map<int32_t, PersistentTable*> m_snapshotReadTables;
+
         /*
          * Map of table signatures to exporting tables.
          */
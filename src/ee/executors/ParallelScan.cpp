@@ -0,0 +1,350 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "executors/ParallelScan.h"
+
+#include "common/FatalException.hpp"
+#include "executors/aggregateexecutor.h"
+#include "expressions/abstractexpression.h"
+#include "storage/persistenttable.h"
+
+#include <algorithm>
+
+namespace voltdb {
+
+ParallelScanPool& ParallelScanPool::instance() {
+    static ParallelScanPool pool;
+    return pool;
+}
+
+ParallelScanPool::ParallelScanPool() : m_stopping(false), m_threadCount(0) {
+    pthread_mutex_init(&m_mutex, NULL);
+    pthread_cond_init(&m_workAvailable, NULL);
+    pthread_cond_init(&m_jobDone, NULL);
+    pthread_mutex_init(&m_resizeMutex, NULL);
+}
+
+ParallelScanPool::~ParallelScanPool() {
+    stopThreads();
+    pthread_mutex_destroy(&m_resizeMutex);
+    pthread_cond_destroy(&m_jobDone);
+    pthread_cond_destroy(&m_workAvailable);
+    pthread_mutex_destroy(&m_mutex);
+}
+
+void ParallelScanPool::setThreadCount(int threadCount) {
+    pthread_mutex_lock(&m_resizeMutex);
+    if (threadCount != static_cast<int>(m_threads.size())) {
+        stopThreads();
+        for (int i = 0; i < threadCount; i++) {
+            pthread_t thread;
+            if (pthread_create(&thread, NULL, workerMain, this) != 0) {
+                pthread_mutex_unlock(&m_resizeMutex);
+                throwFatalException("Failed to start a parallel scan thread");
+            }
+            m_threads.push_back(thread);
+        }
+        pthread_mutex_lock(&m_mutex);
+        m_threadCount = threadCount;
+        pthread_mutex_unlock(&m_mutex);
+    }
+    pthread_mutex_unlock(&m_resizeMutex);
+}
+
+int ParallelScanPool::threadCount() {
+    pthread_mutex_lock(&m_mutex);
+    int threadCount = m_threadCount;
+    pthread_mutex_unlock(&m_mutex);
+    return threadCount;
+}
+
+void ParallelScanPool::stopThreads() {
+    pthread_mutex_lock(&m_mutex);
+    m_stopping = true;
+    m_threadCount = 0;
+    pthread_cond_broadcast(&m_workAvailable);
+    pthread_mutex_unlock(&m_mutex);
+    for (size_t i = 0; i < m_threads.size(); i++) {
+        pthread_join(m_threads[i], NULL);
+    }
+    m_threads.clear();
+    pthread_mutex_lock(&m_mutex);
+    m_stopping = false;
+    pthread_mutex_unlock(&m_mutex);
+}
+
+void* ParallelScanPool::workerMain(void* pool) {
+    static_cast<ParallelScanPool*>(pool)->work();
+    return NULL;
+}
+
+ParallelScanTask* ParallelScanPool::claimTask(Job& job) {
+    if (job.nextTask < job.tasks->size()) {
+        return (*job.tasks)[job.nextTask++];
+    }
+    return NULL;
+}
+
+void ParallelScanPool::work() {
+    pthread_mutex_lock(&m_mutex);
+    while (true) {
+        Job* job = NULL;
+        ParallelScanTask* task = NULL;
+        for (size_t i = 0; task == NULL && i < m_jobs.size(); i++) {
+            job = m_jobs[i];
+            task = claimTask(*job);
+        }
+        if (task == NULL) {
+            if (m_stopping) {
+                break;
+            }
+            pthread_cond_wait(&m_workAvailable, &m_mutex);
+            continue;
+        }
+        pthread_mutex_unlock(&m_mutex);
+        task->run();
+        pthread_mutex_lock(&m_mutex);
+        if (--job->unfinishedTasks == 0) {
+            pthread_cond_broadcast(&m_jobDone);
+        }
+    }
+    pthread_mutex_unlock(&m_mutex);
+}
+
+void ParallelScanPool::runAll(const std::vector<ParallelScanTask*>& tasks) {
+    if (threadCount() == 0 || tasks.size() < 2) {
+        for (size_t i = 0; i < tasks.size(); i++) {
+            tasks[i]->run();
+        }
+        return;
+    }
+
+    Job job;
+    job.tasks = &tasks;
+    job.nextTask = 0;
+    job.unfinishedTasks = tasks.size();
+
+    pthread_mutex_lock(&m_mutex);
+    m_jobs.push_back(&job);
+    pthread_cond_broadcast(&m_workAvailable);
+    // Work on our own job rather than sit idle
+    while (ParallelScanTask* task = claimTask(job)) {
+        pthread_mutex_unlock(&m_mutex);
+        task->run();
+        pthread_mutex_lock(&m_mutex);
+        --job.unfinishedTasks;
+    }
+    while (job.unfinishedTasks > 0) {
+        pthread_cond_wait(&m_jobDone, &m_mutex);
+    }
+    for (std::deque<Job*>::iterator it = m_jobs.begin(); it != m_jobs.end(); ++it) {
+        if (*it == &job) {
+            m_jobs.erase(it);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&m_mutex);
+}
+
+void BlockRangeTask::run() {
+    try {
+        TableTuple tuple(m_schema);
+        for (size_t i = 0; i < m_blocks.size(); i++) {
+            char* address = m_blocks[i].first;
+            for (uint32_t slot = 0; slot < m_blocks[i].second; slot++, address += m_tupleLength) {
+                tuple.move(address);
+                // Skip the same tuples that a TableIterator would skip
+                if ( ! tuple.isActive() || tuple.isPendingDelete() || tuple.isPendingDeleteOnUndoRelease()) {
+                    continue;
+                }
+                if (m_predicate == NULL || m_predicate->eval(&tuple, NULL).isTrue()) {
+                    visit(tuple);
+                }
+            }
+        }
+    }
+    catch (...) {
+        m_error = std::current_exception();
+    }
+}
+
+std::vector<std::vector<std::pair<char*, uint32_t> > >
+BlockRangeTask::splitBlocks(const PersistentTable* table, size_t rangeCount) {
+    std::vector<std::pair<char*, uint32_t> > blocks = table->getBlockExtents();
+    rangeCount = std::max(static_cast<size_t>(1), std::min(blocks.size(), rangeCount));
+    size_t blocksPerRange = (blocks.size() + rangeCount - 1) / rangeCount;
+    std::vector<std::vector<std::pair<char*, uint32_t> > > ranges;
+    for (size_t first = 0; first < blocks.size(); first += blocksPerRange) {
+        size_t last = std::min(first + blocksPerRange, blocks.size());
+        ranges.push_back(std::vector<std::pair<char*, uint32_t> >(blocks.begin() + first,
+                                                                  blocks.begin() + last));
+    }
+    return ranges;
+}
+
+// Several tasks per thread, so that a thread that draws a sparse range of
+// blocks can pick up another one.
+static size_t rangeCountForPool() {
+    return static_cast<size_t>(ParallelScanPool::instance().threadCount() + 1) * 4;
+}
+
+ParallelScanFilter::ParallelScanFilter() : m_task(0), m_match(0) { }
+
+bool ParallelScanFilter::isParallelSafe(const AbstractExpression* expression) {
+    if (expression == NULL) {
+        return true;
+    }
+    switch (expression->getExpressionType()) {
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+    case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+    case EXPRESSION_TYPE_COMPARE_NOTDISTINCT:
+    case EXPRESSION_TYPE_CONJUNCTION_AND:
+    case EXPRESSION_TYPE_CONJUNCTION_OR:
+    case EXPRESSION_TYPE_OPERATOR_NOT:
+    case EXPRESSION_TYPE_OPERATOR_IS_NULL:
+    case EXPRESSION_TYPE_VALUE_TUPLE:
+    case EXPRESSION_TYPE_VALUE_PARAMETER:
+    case EXPRESSION_TYPE_VALUE_CONSTANT:
+        return isParallelSafe(expression->getLeft()) && isParallelSafe(expression->getRight());
+    default:
+        return false;
+    }
+}
+
+bool ParallelScanFilter::isWorthSplitting(Table* table) {
+    PersistentTable* persistentTable = dynamic_cast<PersistentTable*>(table);
+    return ParallelScanPool::instance().threadCount() > 0 && persistentTable != NULL &&
+            persistentTable->allocatedBlockCount() >= MIN_BLOCKS;
+}
+
+bool ParallelScanFilter::filter(Table* table, const AbstractExpression* predicate) {
+    if (predicate == NULL || ! isWorthSplitting(table) || ! isParallelSafe(predicate)) {
+        return false;
+    }
+
+    PersistentTable* persistentTable = static_cast<PersistentTable*>(table);
+    std::vector<std::vector<std::pair<char*, uint32_t> > > ranges =
+            BlockRangeTask::splitBlocks(persistentTable, rangeCountForPool());
+    std::vector<ParallelScanTask*> tasks;
+    for (size_t i = 0; i < ranges.size(); i++) {
+        FilterTask* task = new FilterTask(table->schema(), persistentTable->getTupleLength(),
+                                          predicate, ranges[i]);
+        m_tasks.push_back(task);
+        tasks.push_back(task);
+    }
+
+    ParallelScanPool::instance().runAll(tasks);
+    return true;
+}
+
+bool ParallelScanAggregate::isMergeable(ExpressionType aggType) {
+    switch (aggType) {
+    case EXPRESSION_TYPE_AGGREGATE_COUNT_STAR:
+    case EXPRESSION_TYPE_AGGREGATE_COUNT:
+    case EXPRESSION_TYPE_AGGREGATE_SUM:
+    case EXPRESSION_TYPE_AGGREGATE_MIN:
+    case EXPRESSION_TYPE_AGGREGATE_MAX:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool ParallelScanAggregate::aggregate(Table* table, const AbstractExpression* predicate,
+                                      const std::vector<ExpressionType>& aggTypes,
+                                      const std::vector<const AbstractExpression*>& inputs) {
+    assert(aggTypes.size() == inputs.size());
+    if ( ! ParallelScanFilter::isWorthSplitting(table) ||
+            ! ParallelScanFilter::isParallelSafe(predicate)) {
+        return false;
+    }
+    for (size_t i = 0; i < aggTypes.size(); i++) {
+        if ( ! isMergeable(aggTypes[i]) || ! ParallelScanFilter::isParallelSafe(inputs[i])) {
+            return false;
+        }
+    }
+
+    PersistentTable* persistentTable = static_cast<PersistentTable*>(table);
+    std::vector<std::vector<std::pair<char*, uint32_t> > > ranges =
+            BlockRangeTask::splitBlocks(persistentTable, rangeCountForPool());
+    std::vector<ParallelScanTask*> tasks;
+    for (size_t i = 0; i < ranges.size(); i++) {
+        AggregateTask* task = new AggregateTask(table->schema(), persistentTable->getTupleLength(),
+                                                predicate, ranges[i], aggTypes, inputs);
+        m_tasks.push_back(task);
+        tasks.push_back(task);
+    }
+
+    ParallelScanPool::instance().runAll(tasks);
+
+    // The serial scan would have stopped at the error earliest in table order
+    for (size_t i = 0; i < m_tasks.size(); i++) {
+        if (m_tasks[i].failed()) {
+            m_tasks[i].rethrowError();
+        }
+    }
+    return true;
+}
+
+bool ParallelScanAggregate::firstMatch(TableTuple& out) const {
+    for (size_t i = 0; i < m_tasks.size(); i++) {
+        if (m_tasks[i].m_firstMatch != NULL) {
+            out.move(m_tasks[i].m_firstMatch);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<AggregateRow*> ParallelScanAggregate::partials() const {
+    std::vector<AggregateRow*> rows;
+    for (size_t i = 0; i < m_tasks.size(); i++) {
+        rows.push_back(m_tasks[i].m_aggregateRow);
+    }
+    return rows;
+}
+
+ParallelScanAggregate::AggregateTask::AggregateTask(const TupleSchema* schema, uint32_t tupleLength,
+        const AbstractExpression* predicate,
+        const std::vector<std::pair<char*, uint32_t> >& blocks,
+        const std::vector<ExpressionType>& aggTypes,
+        const std::vector<const AbstractExpression*>& inputs)
+    : BlockRangeTask(schema, tupleLength, predicate, blocks)
+    , m_inputs(inputs)
+    , m_aggregateRow(newPartialAggregateRow(m_memoryPool, aggTypes))
+    , m_firstMatch(NULL)
+{ }
+
+ParallelScanAggregate::AggregateTask::~AggregateTask() {
+    delete m_aggregateRow;
+}
+
+void ParallelScanAggregate::AggregateTask::visit(const TableTuple& tuple) {
+    if (m_firstMatch == NULL) {
+        m_firstMatch = tuple.address();
+    }
+    for (size_t i = 0; i < m_inputs.size(); i++) {
+        // COUNT(*) accepts a dummy NValue, as in AggregateExecutorBase::advanceAggs
+        m_aggregateRow->m_aggregates[i]->advance(m_inputs[i] ? m_inputs[i]->eval(&tuple) : NValue());
+    }
+}
+
+}
@@ -0,0 +1,277 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PARALLELSCAN_H_
+#define PARALLELSCAN_H_
+
+#include "common/Pool.hpp"
+#include "common/tabletuple.h"
+#include "common/types.h"
+
+#include <boost/ptr_container/ptr_vector.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include <deque>
+#include <exception>
+#include <pthread.h>
+#include <vector>
+
+namespace voltdb {
+
+class AbstractExpression;
+struct AggregateRow;
+class PersistentTable;
+class Table;
+
+/**
+ * One unit of work handed to the ParallelScanPool. run() is called on a
+ * helper thread or on the submitting thread, and must not throw.
+ */
+class ParallelScanTask {
+public:
+    virtual ~ParallelScanTask() { }
+    virtual void run() = 0;
+};
+
+/**
+ * A process-wide pool of helper threads that site threads can use to split
+ * a read-only scan. The pool starts with no threads, in which case the
+ * submitting thread does all of the work itself.
+ */
+class ParallelScanPool {
+public:
+    static ParallelScanPool& instance();
+
+    /**
+     * Replace the helper threads with the given number of new ones, unless
+     * the pool already has that many. Every site asks for the same count,
+     * and a scan that is using the pool meanwhile finishes its remaining
+     * tasks on its own thread.
+     */
+    void setThreadCount(int threadCount);
+
+    int threadCount();
+
+    /**
+     * Run every task, on the helper threads and on the calling thread,
+     * and return once all of them have finished.
+     */
+    void runAll(const std::vector<ParallelScanTask*>& tasks);
+
+private:
+    struct Job {
+        const std::vector<ParallelScanTask*>* tasks;
+        size_t nextTask;
+        size_t unfinishedTasks;
+    };
+
+    ParallelScanPool();
+    ~ParallelScanPool();
+
+    static void* workerMain(void* pool);
+    void work();
+    void stopThreads();
+
+    // Claim a task from the job, with m_mutex held; NULL if none is left
+    static ParallelScanTask* claimTask(Job& job);
+
+    pthread_mutex_t m_mutex;
+    pthread_cond_t m_workAvailable;
+    pthread_cond_t m_jobDone;
+    std::deque<Job*> m_jobs;
+    bool m_stopping;
+    // The size of m_threads, read under m_mutex
+    int m_threadCount;
+    // Serializes changes to m_threads
+    pthread_mutex_t m_resizeMutex;
+    std::vector<pthread_t> m_threads;
+};
+
+/**
+ * A ParallelScanTask that visits the tuples of a range of a persistent
+ * table's blocks that pass a predicate. The first error raised in the
+ * range ends the visit, and is kept to be raised again on the site thread.
+ */
+class BlockRangeTask : public ParallelScanTask {
+public:
+    BlockRangeTask(const TupleSchema* schema, uint32_t tupleLength,
+                   const AbstractExpression* predicate,
+                   const std::vector<std::pair<char*, uint32_t> >& blocks)
+        : m_schema(schema), m_tupleLength(tupleLength), m_predicate(predicate), m_blocks(blocks) { }
+
+    void run();
+
+    bool failed() const { return static_cast<bool>(m_error); }
+
+    /** Raise the error that ended the visit on the calling thread */
+    void rethrowError() const { std::rethrow_exception(m_error); }
+
+    /**
+     * Split the blocks of a table into about the given number of ranges of
+     * consecutive blocks, in table order.
+     */
+    static std::vector<std::vector<std::pair<char*, uint32_t> > >
+    splitBlocks(const PersistentTable* table, size_t rangeCount);
+
+protected:
+    /** Called for each tuple in the range that passes the predicate */
+    virtual void visit(const TableTuple& tuple) = 0;
+
+private:
+    const TupleSchema* m_schema;
+    uint32_t m_tupleLength;
+    const AbstractExpression* m_predicate;
+    std::vector<std::pair<char*, uint32_t> > m_blocks;
+    std::exception_ptr m_error;
+};
+
+/**
+ * Evaluates a scan predicate over the blocks of a persistent table on the
+ * ParallelScanPool, and then hands back the matching tuples in table order
+ * on the site thread, which can treat them as if it had scanned the table
+ * itself. The site thread waits for the helpers, so nothing can modify the
+ * table while they read it.
+ *
+ * Only predicates made of comparisons, AND/OR/NOT, IS NULL, columns,
+ * parameters and constants are evaluated this way, because those neither
+ * allocate from the site's temp string pool nor depend on other
+ * thread-local state.
+ */
+class ParallelScanFilter {
+public:
+    /** The fewest blocks a table must have before its scan is split */
+    static const size_t MIN_BLOCKS = 4;
+
+    ParallelScanFilter();
+
+    /**
+     * Filter the table if it is worth doing on the helper threads.
+     * Returns false, having done nothing, otherwise.
+     */
+    bool filter(Table* table, const AbstractExpression* predicate);
+
+    /**
+     * Get the next tuple that passed the predicate. An error that the
+     * predicate raised on a helper thread is raised here, once the tuples
+     * that came before it in table order have been handed back, just as a
+     * serial scan would have raised it.
+     */
+    bool next(TableTuple& out);
+
+    static bool isParallelSafe(const AbstractExpression* expression);
+
+    /**
+     * The table and pool state that decide whether a scan of the table
+     * is worth splitting, whatever is evaluated over its tuples.
+     */
+    static bool isWorthSplitting(Table* table);
+
+private:
+    class FilterTask : public BlockRangeTask {
+    public:
+        FilterTask(const TupleSchema* schema, uint32_t tupleLength,
+                   const AbstractExpression* predicate,
+                   const std::vector<std::pair<char*, uint32_t> >& blocks)
+            : BlockRangeTask(schema, tupleLength, predicate, blocks) { }
+
+        std::vector<char*> m_matches;
+
+    protected:
+        void visit(const TableTuple& tuple) { m_matches.push_back(tuple.address()); }
+    };
+
+    boost::ptr_vector<FilterTask> m_tasks;
+    size_t m_task;
+    size_t m_match;
+};
+
+inline bool ParallelScanFilter::next(TableTuple& out) {
+    while (m_task < m_tasks.size()) {
+        const std::vector<char*>& matches = m_tasks[m_task].m_matches;
+        if (m_match < matches.size()) {
+            out.move(matches[m_match++]);
+            return true;
+        }
+        if (m_tasks[m_task].failed()) {
+            m_tasks[m_task].rethrowError();
+        }
+        ++m_task;
+        m_match = 0;
+    }
+    return false;
+}
+
+/**
+ * Computes partial aggregates of the tuples of a persistent table that
+ * pass a predicate on the ParallelScanPool, one per range of blocks, for
+ * the site thread to merge. Only aggregates without DISTINCT whose partial
+ * results can be combined (COUNT, SUM, MIN and MAX) are computed this way,
+ * over inputs and predicates that ParallelScanFilter::isParallelSafe
+ * accepts.
+ */
+class ParallelScanAggregate {
+public:
+    ParallelScanAggregate() { }
+
+    static bool isMergeable(ExpressionType aggType);
+
+    /**
+     * Aggregate the table if it is worth doing on the helper threads.
+     * Returns false, having done nothing, otherwise. An error raised on a
+     * helper thread is raised here, the one earliest in table order first.
+     * The inputs are evaluated on the table's tuples and may be NULL for
+     * COUNT(*).
+     */
+    bool aggregate(Table* table, const AbstractExpression* predicate,
+                   const std::vector<ExpressionType>& aggTypes,
+                   const std::vector<const AbstractExpression*>& inputs);
+
+    /** Get the first tuple in table order that passed the predicate */
+    bool firstMatch(TableTuple& out) const;
+
+    /**
+     * The partial aggregates of each range of blocks, in table order.
+     * They stay valid until this object is destroyed.
+     */
+    std::vector<AggregateRow*> partials() const;
+
+private:
+    class AggregateTask : public BlockRangeTask {
+    public:
+        AggregateTask(const TupleSchema* schema, uint32_t tupleLength,
+                      const AbstractExpression* predicate,
+                      const std::vector<std::pair<char*, uint32_t> >& blocks,
+                      const std::vector<ExpressionType>& aggTypes,
+                      const std::vector<const AbstractExpression*>& inputs);
+        ~AggregateTask();
+
+        const std::vector<const AbstractExpression*> m_inputs;
+        // Each task has a pool of its own, for MIN and MAX to copy values into
+        Pool m_memoryPool;
+        AggregateRow* m_aggregateRow;
+        char* m_firstMatch;
+
+    protected:
+        void visit(const TableTuple& tuple);
+    };
+
+    boost::ptr_vector<AggregateTask> m_tasks;
+};
+
+}
+
+#endif // PARALLELSCAN_H_
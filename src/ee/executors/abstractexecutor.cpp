@@ -180,6 +180,27 @@ void AbstractExecutor::setDMLCountOutputTable(TempTableLimits* limits) {
 
 AbstractExecutor::~AbstractExecutor() {}
 
+// An inline executor's output table, if any, belongs to its parent
+void AbstractExecutor::setRetainsWorkingSet(bool retainsWorkingSet) {
+    m_retainsWorkingSet = retainsWorkingSet;
+    if (m_tmpOutputTable != NULL && ! m_abstractNode->isInline()) {
+        m_tmpOutputTable->setRetainsBlocks(retainsWorkingSet);
+    }
+}
+
+int64_t AbstractExecutor::workingSetSize() const {
+    if (m_tmpOutputTable != NULL && ! m_abstractNode->isInline()) {
+        return m_tmpOutputTable->retainedBlockMemory();
+    }
+    return 0;
+}
+
+void AbstractExecutor::releaseWorkingSet() {
+    if (m_tmpOutputTable != NULL && ! m_abstractNode->isInline()) {
+        m_tmpOutputTable->releaseRetainedBlocks();
+    }
+}
+
 AbstractExecutor::TupleComparer::TupleComparer(const std::vector<AbstractExpression*>& keys,
     const std::vector<SortDirectionType>& dirs) : m_keys(keys), m_dirs(dirs), m_keyCount(keys.size())
 {
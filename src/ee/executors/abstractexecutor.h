@@ -75,6 +75,38 @@ class AbstractExecutor {
     /** Invoke a plannode's associated executor */
     bool execute(const NValueArray& params);
 
+    /**
+     * Pipelined execution. An executor that can produce its output a batch
+     * at a time may be driven by a parent that reads its first input through
+     * a PipelinedInput. Such an executor does nothing when the executor list
+     * reaches it; its parent pulls batches through startBatches() and
+     * nextBatch() instead, so the full output is never materialized.
+     */
+    virtual bool canProduceBatches() const { return false; }
+
+    /** Whether this executor reads its first input through a PipelinedInput */
+    virtual bool consumesBatches() const { return false; }
+
+    /** Reset batch production at the start of each execution */
+    virtual void startBatches(const NValueArray& params) { }
+
+    /**
+     * Replace the contents of the output table with the next batch.
+     * Returns false, leaving the output table empty, once the output is
+     * exhausted.
+     */
+    virtual bool nextBatch() { return false; }
+
+    /** Drop any batch state once the parent has read all it needs */
+    virtual void finishBatches() { }
+
+    void setDrivenByParent(bool drivenByParent) { m_drivenByParent = drivenByParent; }
+
+    bool isDrivenByParent() const { return m_drivenByParent; }
+
+    /** The number of tuples a producer puts in each batch */
+    static const int PIPELINE_BATCH_SIZE = 1024;
+
     /** The temp output table for this executor.  May be null for a
      *  SEND node! */
     const TempTable* getTempOutputTable() const {
@@ -106,6 +138,18 @@ class AbstractExecutor {
         // LEAVE as blank on purpose
     }
 
+    /**
+     * Keep what the executor fills on every execution, starting with its
+     * output table, cleared rather than freed between executions.
+     */
+    virtual void setRetainsWorkingSet(bool retainsWorkingSet);
+
+    /** The memory kept between executions beyond what is always kept */
+    virtual int64_t workingSetSize() const;
+
+    /** Free the memory kept between executions; later executions keep it again */
+    virtual void releaseWorkingSet();
+
     inline bool outputTempTableIsEmpty() const {
         if (m_tmpOutputTable != NULL) {
             return m_tmpOutputTable->activeTupleCount() == 0;
@@ -133,6 +177,8 @@ class AbstractExecutor {
         m_abstractNode = abstractNode;
         m_tmpOutputTable = NULL;
         m_engine = engine;
+        m_drivenByParent = false;
+        m_retainsWorkingSet = false;
     }
 
     /** Concrete executor classes implement initialization in p_init() */
@@ -161,6 +207,12 @@ class AbstractExecutor {
     /** reference to the engine to call up to the top end */
     VoltDBEngine* m_engine;
 
+    /** Set when the parent pulls this executor's output in batches */
+    bool m_drivenByParent;
+
+    /** Set when what is filled on every execution is kept between them */
+    bool m_retainsWorkingSet;
+
 };
 
 
@@ -169,6 +221,11 @@ inline bool AbstractExecutor::execute(const NValueArray& params)
     assert(m_abstractNode);
     VOLT_TRACE("Starting execution of plannode(id=%d)...",  m_abstractNode->getPlanNodeId());
 
+    // The parent will run this executor a batch at a time
+    if (m_drivenByParent) {
+        return true;
+    }
+
     // run the executor
     return p_execute(params);
 }
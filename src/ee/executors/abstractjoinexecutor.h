@@ -64,6 +64,10 @@ class VoltDBEngine;
  *  Abstract base class for all join executors
  */
 class AbstractJoinExecutor : public AbstractExecutor {
+    public:
+        // The outer table is read once, front to back
+        bool consumesBatches() const { return true; }
+
     protected:
         // Constructor
         AbstractJoinExecutor(VoltDBEngine *engine, AbstractPlanNode* abstract_node) :
@@ -49,6 +49,7 @@
 #include "common/common.h"
 #include "common/debuglog.h"
 #include "common/SerializableEEException.h"
+#include "common/TDigest.h"
 #include "expressions/abstractexpression.h"
 #include "plannodes/aggregatenode.h"
 #include "plannodes/limitnode.h"
@@ -254,6 +255,11 @@ public:
         m_count = 0;
     }
 
+    virtual void merge(const Agg& partial)
+    {
+        m_count += static_cast<const CountAgg&>(partial).m_count;
+    }
+
 private:
     D ifDistinct;
     int64_t m_count;
@@ -280,6 +286,11 @@ public:
         m_count = 0;
     }
 
+    virtual void merge(const Agg& partial)
+    {
+        m_count += static_cast<const CountStarAgg&>(partial).m_count;
+    }
+
 private:
     int64_t m_count;
 };
@@ -505,11 +516,100 @@ public:
     }
 };
 
+class ApproxPercentileAgg : public Agg {
+public:
+    explicit ApproxPercentileAgg(double percentile)
+        : m_percentile(percentile)
+    {
+    }
+
+    virtual void advance(const NValue& val)
+    {
+        if (val.isNull()) {
+            return;
+        }
+        // The front end only allows numeric and timestamp inputs.
+        m_digest.add(ValuePeeker::peekDouble(val.castAs(VALUE_TYPE_DOUBLE)));
+    }
+
+    virtual NValue finalize(ValueType type)
+    {
+        if (m_digest.empty()) {
+            return NValue::getNullValue(type);
+        }
+        return ValueFactory::getDoubleValue(m_digest.quantile(m_percentile)).castAs(type);
+    }
+
+    virtual void resetAgg()
+    {
+        m_digest.clear();
+        Agg::resetAgg();
+    }
+
+protected:
+    TDigest& digest() {
+        return m_digest;
+    }
+
+private:
+    // The fraction of the values that fall below the result, 0.5 for APPROX_MEDIAN
+    const double m_percentile;
+    TDigest m_digest;
+};
+
+/// When APPROX_PERCENTILE is split across two fragments of a plan,
+/// this agg represents the bottom half of the agg.  It's advance
+/// method is inherited from the super class, but it's finalize method
+/// produces a serialized t-digest to be accepted by a
+/// QUANTILE_SKETCHES_TO_PERCENTILE agg on the coordinator.
+class ValsToQuantileSketchAgg : public ApproxPercentileAgg {
+public:
+    explicit ValsToQuantileSketchAgg(double percentile)
+        : ApproxPercentileAgg(percentile)
+    {
+    }
+
+    virtual NValue finalize(ValueType type)
+    {
+        assert (type == VALUE_TYPE_VARBINARY);
+        // A digest holds at most a few hundred centroids, so it is
+        // far smaller than the values it summarizes.
+        std::vector<char> buffer(digest().serializedSize());
+        ReferenceSerializeOutput output(&buffer[0], buffer.size());
+        digest().serializeTo(output);
+        return ValueFactory::getTempBinaryValue(&buffer[0], static_cast<int32_t>(output.position()));
+    }
+};
+
+/// When APPROX_PERCENTILE is split across two fragments of a plan,
+/// this agg represents the top half of the agg.  It's finalize method
+/// is inherited from the super class, but it's advance method accepts
+/// serialized t-digests from each partition and merges them.
+class QuantileSketchesToPercentileAgg : public ApproxPercentileAgg {
+public:
+    explicit QuantileSketchesToPercentileAgg(double percentile)
+        : ApproxPercentileAgg(percentile)
+    {
+    }
+
+    virtual void advance(const NValue& val)
+    {
+        assert (ValuePeeker::peekValueType(val) == VALUE_TYPE_VARBINARY);
+        assert (!val.isNull());
+
+        int32_t length;
+        const char* buf = ValuePeeker::peekObject_withoutNull(val, &length);
+        assert (length > 0);
+        ReferenceSerializeInputBE input(buf, length);
+        digest().mergeSerialized(input);
+    }
+};
+
 /*
  * Create an instance of an aggregator for the specified aggregate type and "distinct" flag.
  * The object is allocated from the provided memory pool.
  */
-inline Agg* getAggInstance(Pool& memoryPool, ExpressionType agg_type, bool isDistinct)
+inline Agg* getAggInstance(Pool& memoryPool, ExpressionType agg_type, bool isDistinct, double percentile)
 {
     switch (agg_type) {
     case EXPRESSION_TYPE_AGGREGATE_COUNT_STAR:
@@ -539,6 +639,12 @@ inline Agg* getAggInstance(Pool& memoryPool, ExpressionType agg_type, bool isDis
         return new (memoryPool) ValsToHyperLogLogAgg();
     case EXPRESSION_TYPE_AGGREGATE_HYPERLOGLOGS_TO_CARD:
         return new (memoryPool) HyperLogLogsToCardAgg();
+    case EXPRESSION_TYPE_AGGREGATE_APPROX_PERCENTILE:
+        return new (memoryPool) ApproxPercentileAgg(percentile);
+    case EXPRESSION_TYPE_AGGREGATE_VALS_TO_QUANTILE_SKETCH:
+        return new (memoryPool) ValsToQuantileSketchAgg(percentile);
+    case EXPRESSION_TYPE_AGGREGATE_QUANTILE_SKETCHES_TO_PERCENTILE:
+        return new (memoryPool) QuantileSketchesToPercentileAgg(percentile);
     default:
         {
             char message[128];
@@ -548,6 +654,15 @@ inline Agg* getAggInstance(Pool& memoryPool, ExpressionType agg_type, bool isDis
     }
 }
 
+AggregateRow* newPartialAggregateRow(Pool& memoryPool, const std::vector<ExpressionType>& aggTypes)
+{
+    AggregateRow* aggregateRow = new (memoryPool, aggTypes.size()) AggregateRow();
+    for (int ii = 0; ii < aggTypes.size(); ii++) {
+        aggregateRow->m_aggregates[ii] = getAggInstance(memoryPool, aggTypes[ii], false, 0.0);
+    }
+    return aggregateRow;
+}
+
 bool AggregateExecutorBase::p_init(AbstractPlanNode*, TempTableLimits* limits)
 {
     AggregatePlanNode* node = dynamic_cast<AggregatePlanNode*>(m_abstractNode);
@@ -585,6 +700,7 @@ bool AggregateExecutorBase::p_init(AbstractPlanNode*, TempTableLimits* limits)
 
     m_aggTypes = node->getAggregates();
     m_distinctAggs = node->getDistinctAggregates();
+    m_aggPercentiles = node->getAggregatePercentiles();
     m_groupByExpressions = node->getGroupByExpressions();
     node->collectOutputExpressions(m_outputColumnExpressions);
 
@@ -708,7 +824,7 @@ inline void AggregateExecutorBase::initAggInstances(AggregateRow* aggregateRow)
 {
     Agg** aggs = aggregateRow->m_aggregates;
     for (int ii = 0; ii < m_aggTypes.size(); ii++) {
-        aggs[ii] = getAggInstance(m_memoryPool, m_aggTypes[ii], m_distinctAggs[ii]);
+        aggs[ii] = getAggInstance(m_memoryPool, m_aggTypes[ii], m_distinctAggs[ii], m_aggPercentiles[ii]);
     }
 }
 
@@ -772,6 +888,30 @@ void AggregateExecutorBase::p_execute_finish()
     m_memoryPool.purge();
 }
 
+// Oversize allocations are still freed on every purge.
+void AggregateExecutorBase::setRetainsWorkingSet(bool retainsWorkingSet)
+{
+    AbstractExecutor::setRetainsWorkingSet(retainsWorkingSet);
+    m_memoryPool.setMaxChunkCount(retainsWorkingSet ? std::numeric_limits<std::size_t>::max() : 1);
+}
+
+int64_t AggregateExecutorBase::workingSetSize() const
+{
+    // The first chunk is always kept
+    int64_t poolSize = m_memoryPool.getAllocatedMemory() - TEMP_POOL_CHUNK_SIZE;
+    return AbstractExecutor::workingSetSize() + std::max<int64_t>(poolSize, 0);
+}
+
+void AggregateExecutorBase::releaseWorkingSet()
+{
+    AbstractExecutor::releaseWorkingSet();
+    m_memoryPool.setMaxChunkCount(1);
+    m_memoryPool.purge();
+    if (m_retainsWorkingSet) {
+        m_memoryPool.setMaxChunkCount(std::numeric_limits<std::size_t>::max());
+    }
+}
+
 AggregateHashExecutor::~AggregateHashExecutor() {}
 
 TableTuple AggregateHashExecutor::p_execute_init(const NValueArray& params,
@@ -866,6 +1006,18 @@ void AggregateHashExecutor::p_execute_finish() {
     AggregateExecutorBase::p_execute_finish();
 }
 
+// Clearing the hash keeps its buckets, so they count as kept too.
+int64_t AggregateHashExecutor::workingSetSize() const
+{
+    return AggregateExecutorBase::workingSetSize() + static_cast<int64_t>(m_hash.bucket_count() * sizeof(void*));
+}
+
+void AggregateHashExecutor::releaseWorkingSet()
+{
+    AggregateExecutorBase::releaseWorkingSet();
+    m_hash.rehash(0);
+}
+
 AggregateSerialExecutor::~AggregateSerialExecutor() {}
 
 
@@ -952,6 +1104,49 @@ void AggregateSerialExecutor::p_execute_tuple(const TableTuple& nextTuple) {
     advanceAggs(m_aggregateRow, nextTuple);
 }
 
+bool AggregateSerialExecutor::canMergePartials() const
+{
+    if ( ! m_groupByExpressions.empty() || m_prePredicate != NULL) {
+        return false;
+    }
+    for (int ii = 0; ii < m_aggTypes.size(); ii++) {
+        if (m_distinctAggs[ii]) {
+            return false;
+        }
+        switch (m_aggTypes[ii]) {
+        case EXPRESSION_TYPE_AGGREGATE_COUNT_STAR:
+        case EXPRESSION_TYPE_AGGREGATE_COUNT:
+        case EXPRESSION_TYPE_AGGREGATE_MIN:
+        case EXPRESSION_TYPE_AGGREGATE_MAX:
+            break;
+        case EXPRESSION_TYPE_AGGREGATE_SUM:
+            // A floating point sum depends on the order of its terms
+            if (m_inputExpressions[ii]->getValueType() == VALUE_TYPE_DOUBLE) {
+                return false;
+            }
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+void AggregateSerialExecutor::p_execute_partials(const TableTuple& firstTuple,
+                                                 const std::vector<AggregateRow*>& partials)
+{
+    assert(m_noInputRows && canMergePartials());
+    initGroupByKeyTuple(firstTuple);
+    initAggInstances(m_aggregateRow);
+    m_aggregateRow->recordPassThroughTuple(m_passThroughTupleSource, firstTuple);
+    for (int jj = 0; jj < partials.size(); jj++) {
+        for (int ii = 0; ii < m_aggTypes.size(); ii++) {
+            m_aggregateRow->m_aggregates[ii]->merge(*partials[jj]->m_aggregates[ii]);
+        }
+    }
+    m_noInputRows = false;
+}
+
 void AggregateSerialExecutor::p_execute_finish()
 {
     if (m_postfilter.isUnderLimit()) {
@@ -986,6 +1181,17 @@ void AggregateSerialExecutor::p_execute_finish()
 //
 AggregatePartialExecutor::~AggregatePartialExecutor() {}
 
+int64_t AggregatePartialExecutor::workingSetSize() const
+{
+    return AggregateExecutorBase::workingSetSize() + static_cast<int64_t>(m_hash.bucket_count() * sizeof(void*));
+}
+
+void AggregatePartialExecutor::releaseWorkingSet()
+{
+    AggregateExecutorBase::releaseWorkingSet();
+    m_hash.rehash(0);
+}
+
 TableTuple AggregatePartialExecutor::p_execute_init(const NValueArray& params,
         ProgressMonitorProxy* pmp, const TupleSchema * schema, TempTable* newTempTable, CountingPostfilter* parentPostfilter)
 {
@@ -91,6 +91,16 @@ public:
         m_inlineCopiedToOutline = false;
     }
 
+    /**
+     * Fold in the result of the same aggregate over other input rows.
+     * Advancing by that result suits SUM, MIN and MAX; COUNT overrides it.
+     * Only aggregates without DISTINCT can be merged.
+     */
+    virtual void merge(const Agg& partial)
+    {
+        advance(partial.m_value);
+    }
+
 protected:
     NValue m_value;
     /**
@@ -195,6 +205,10 @@ public:
         AggregateExecutorBase::p_execute_finish();
     }
 
+    virtual void setRetainsWorkingSet(bool retainsWorkingSet);
+    virtual int64_t workingSetSize() const;
+    virtual void releaseWorkingSet();
+
 protected:
     virtual bool p_init(AbstractPlanNode*, TempTableLimits*);
 
@@ -234,6 +248,7 @@ protected:
     TupleSchema* m_groupByKeySchema;
     std::vector<ExpressionType> m_aggTypes;
     std::vector<bool> m_distinctAggs;
+    std::vector<double> m_aggPercentiles;
     std::vector<AbstractExpression*> m_groupByExpressions;
     std::vector<AbstractExpression*> m_inputExpressions;
     std::vector<AbstractExpression*> m_outputColumnExpressions;
@@ -284,6 +299,9 @@ public:
     void p_execute_tuple(const TableTuple& nextTuple);
     void p_execute_finish();
 
+    int64_t workingSetSize() const;
+    void releaseWorkingSet();
+
 private:
     virtual bool p_execute(const NValueArray& params);
     HashAggregateMapType m_hash;
@@ -309,6 +327,23 @@ public:
     void p_execute_tuple(const TableTuple& nextTuple);
     void p_execute_finish();
 
+    /**
+     * True if the aggregation has no GROUP BY and its aggregates can be
+     * computed over disjoint parts of the input and then merged.
+     */
+    bool canMergePartials() const;
+
+    /**
+     * Take in the whole input at once as partial aggregates over disjoint
+     * parts of it, instead of tuple by tuple. firstTuple is the first input
+     * tuple, the source of any pass-through columns. Only valid right after
+     * p_execute_init, when canMergePartials().
+     */
+    void p_execute_partials(const TableTuple& firstTuple, const std::vector<AggregateRow*>& partials);
+
+    const std::vector<ExpressionType>& getAggTypes() const { return m_aggTypes; }
+    const std::vector<AbstractExpression*>& getInputExpressions() const { return m_inputExpressions; }
+
 protected:
     AggregateRow * m_aggregateRow;
     // State variables for iteration on input table
@@ -335,6 +370,9 @@ public:
     void p_execute_tuple(const TableTuple& nextTuple);
     void p_execute_finish();
 
+    int64_t workingSetSize() const;
+    void releaseWorkingSet();
+
 private:
     virtual bool p_execute(const NValueArray& params);
     void initPartialHashGroupByKeyTuple(const TableTuple& nextTuple);
@@ -345,6 +383,12 @@ private:
 };
 
 
+/**
+ * Allocate from the pool a row of aggregates of the given types, without
+ * DISTINCT, to accumulate a partial result away from an executor.
+ */
+AggregateRow* newPartialAggregateRow(Pool& memoryPool, const std::vector<ExpressionType>& aggTypes);
+
 inline AggregateExecutorBase* getInlineAggregateExecutor(const AbstractPlanNode* node) {
     AbstractPlanNode* aggNode = NULL;
     AggregateExecutorBase* aggExec = NULL;
@@ -45,6 +45,12 @@
 
 #include "executorutil.h"
 
+#include "executors/abstractexecutor.h"
+#include "plannodes/abstractplannode.h"
+
+#include <algorithm>
+#include <limits>
+
 namespace voltdb {
 
 CountingPostfilter::CountingPostfilter(const TempTable* table, const AbstractExpression * postPredicate, int limit, int offset,
@@ -69,4 +75,85 @@ CountingPostfilter::CountingPostfilter() :
     m_under_limit(false)
 {}
 
+TopNTupleHeap::TopNTupleHeap(const TupleSchema* schema,
+                             const std::vector<AbstractExpression*>& keys,
+                             const std::vector<SortDirectionType>& dirs,
+                             int64_t capacity) :
+    m_schema(schema),
+    m_keys(keys),
+    m_dirs(dirs),
+    m_capacity(capacity),
+    m_heap(),
+    m_slots()
+{}
+
+int64_t TopNTupleHeap::capacityFor(int limit, int offset) {
+    if (limit < 0) {
+        return std::numeric_limits<int64_t>::max();
+    }
+    return static_cast<int64_t>(limit) + std::max(offset, 0);
+}
+
+void TopNTupleHeap::offer(const TableTuple& tuple) {
+    AbstractExecutor::TupleComparer comparer(m_keys, m_dirs);
+    if (size() < m_capacity) {
+        TableTuple slot(static_cast<char*>(m_slots.allocate(m_schema->tupleLength() + TUPLE_HEADER_SIZE)),
+                        m_schema);
+        slot.copy(tuple);
+        m_heap.push_back(slot);
+        std::push_heap(m_heap.begin(), m_heap.end(), comparer);
+        return;
+    }
+    // Ties keep the tuple already held
+    if (m_heap.empty() || ! comparer(tuple, m_heap.front())) {
+        return;
+    }
+    // Evict the last kept tuple and reuse its slot for the new one
+    std::pop_heap(m_heap.begin(), m_heap.end(), comparer);
+    m_heap.back().copy(tuple);
+    std::push_heap(m_heap.begin(), m_heap.end(), comparer);
+}
+
+void TopNTupleHeap::drainTo(TempTable* output, int offset) {
+    AbstractExecutor::TupleComparer comparer(m_keys, m_dirs);
+    std::sort_heap(m_heap.begin(), m_heap.end(), comparer);
+    for (int64_t ii = std::max(offset, 0); ii < size(); ++ii) {
+        output->insertTempTuple(m_heap[ii]);
+    }
+    m_heap.clear();
+    m_slots.purge();
+}
+
+PipelinedInput::PipelinedInput(AbstractPlanNode* node, const NValueArray& params) :
+    m_table(node->getInputTable()),
+    m_producer(NULL),
+    m_iterator(firstBatch(node, params))
+{}
+
+PipelinedInput::~PipelinedInput() {
+    if (m_producer != NULL) {
+        m_producer->finishBatches();
+    }
+}
+
+TableIterator& PipelinedInput::firstBatch(AbstractPlanNode* node, const NValueArray& params) {
+    const std::vector<AbstractPlanNode*>& children = node->getChildren();
+    if ( ! children.empty() && children[0]->getExecutor()->isDrivenByParent()) {
+        m_producer = children[0]->getExecutor();
+        m_producer->startBatches(params);
+        m_producer->nextBatch();
+    }
+    return m_table->iteratorDeletingAsWeGo();
+}
+
+bool PipelinedInput::nextFromNextBatch(TableTuple& out) {
+    while (m_producer != NULL && m_producer->nextBatch()) {
+        m_iterator = m_table->iteratorDeletingAsWeGo();
+        if (m_iterator.next(out)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 }
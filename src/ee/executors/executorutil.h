@@ -46,15 +46,21 @@
 #ifndef HSTOREEXECUTORUTIL_H
 #define HSTOREEXECUTORUTIL_H
 
+#include "common/Pool.hpp"
 #include "common/tabletuple.h"
+#include "common/valuevector.h"
 #include "expressions/abstractexpression.h"
 #include "storage/temptable.h"
 
 #include <cstddef> // for NULL !
 #include <cassert>
+#include <vector>
 
 namespace voltdb {
 
+class AbstractExecutor;
+class AbstractPlanNode;
+
 // Helper struct to evaluate a postfilter and count the number of tuples that
 // successfully passed the evaluation
 struct CountingPostfilter {
@@ -123,6 +129,73 @@ bool CountingPostfilter::eval(const TableTuple* outer_tuple, const TableTuple* i
     return false;
 }
 
+// Keeps the first "capacity" tuples, in ORDER BY order, of all the tuples
+// offered to it, as for ORDER BY ... LIMIT ... OFFSET. The kept tuples are
+// held in a bounded max-heap whose top is the last of them, so memory stays
+// proportional to LIMIT + OFFSET rather than to the input, and a tuple that
+// sorts after the top is turned away with a single comparison.
+// Like TempTable::insertTempTuple, a tuple is copied without its uninlined
+// values, which stay owned by their table or by the temp string pool. So
+// the uninlined values of every offered tuple must outlive both the heap
+// and the output table it is drained into: offer tuples from a persistent
+// or input temp table, never from a scratch tuple whose strings are freed
+// or overwritten before drainTo.
+class TopNTupleHeap {
+public:
+    TopNTupleHeap(const TupleSchema* schema,
+                  const std::vector<AbstractExpression*>& keys,
+                  const std::vector<SortDirectionType>& dirs,
+                  int64_t capacity);
+
+    // How many tuples to keep for the given LIMIT and OFFSET, either of
+    // which may be missing (negative)
+    static int64_t capacityFor(int limit, int offset);
+
+    // Keep a copy of the tuple if it is among the first "capacity" so far
+    void offer(const TableTuple& tuple);
+
+    int64_t size() const {
+        return static_cast<int64_t>(m_heap.size());
+    }
+
+    // Insert the kept tuples into the output table in order, after skipping
+    // the first "offset" of them, and empty the heap
+    void drainTo(TempTable* output, int offset);
+
+private:
+    const TupleSchema* m_schema;
+    const std::vector<AbstractExpression*>& m_keys;
+    const std::vector<SortDirectionType>& m_dirs;
+    const int64_t m_capacity;
+    std::vector<TableTuple> m_heap;
+    // Backs the tuple copies; the slot of an evicted tuple is reused
+    Pool m_slots;
+};
+
+// Iterates over the first input table of a plan node. If the child that
+// fills that table is driven by its parent, the table only ever holds one
+// batch, and the next batch is pulled from the child whenever the current
+// one runs out. Otherwise this is a plain delete-as-we-go iteration.
+class PipelinedInput {
+public:
+    PipelinedInput(AbstractPlanNode* node, const NValueArray& params);
+
+    ~PipelinedInput();
+
+    bool next(TableTuple& out) {
+        return m_iterator.next(out) || nextFromNextBatch(out);
+    }
+
+private:
+    TableIterator& firstBatch(AbstractPlanNode* node, const NValueArray& params);
+
+    bool nextFromNextBatch(TableTuple& out);
+
+    Table* m_table;
+    AbstractExecutor* m_producer;
+    TableIterator m_iterator;
+};
+
 }
 
 #endif
@@ -47,6 +47,7 @@
 #include "common/debuglog.h"
 #include "common/common.h"
 #include "common/tabletuple.h"
+#include "executors/executorutil.h"
 #include "plannodes/limitnode.h"
 #include "storage/table.h"
 #include "storage/temptable.h"
@@ -97,7 +98,7 @@ LimitExecutor::p_execute(const NValueArray &params)
     // we have copy enough tuples for the limit specified by the node
     //
     TableTuple tuple(input_table->schema());
-    TableIterator iterator = input_table->iteratorDeletingAsWeGo();
+    PipelinedInput input(node, params);
 
     int tuple_ctr = 0;
     int tuples_skipped = 0;
@@ -105,7 +106,7 @@ LimitExecutor::p_execute(const NValueArray &params)
     int offset = -1;
     node->getLimitAndOffsetByReference(params, limit, offset);
 
-    while ((limit == -1 || tuple_ctr < limit) && iterator.next(tuple))
+    while ((limit == -1 || tuple_ctr < limit) && input.next(tuple))
     {
         // TODO: need a way to skip / iterate N items.
         if (tuples_skipped < offset)
@@ -64,6 +64,8 @@ namespace voltdb
         ~LimitExecutor() {
         }
 
+        bool consumesBatches() const { return true; }
+
     private:
         bool p_init(AbstractPlanNode*,
                     TempTableLimits* limits);
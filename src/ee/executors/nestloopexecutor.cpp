@@ -161,7 +161,7 @@ bool NestLoopExecutor::p_execute(const NValueArray &params) {
     TableTuple inner_tuple(node->getInputTable(1)->schema());
     const TableTuple& null_inner_tuple = m_null_inner_tuple.tuple();
 
-    TableIterator iterator0 = outer_table->iteratorDeletingAsWeGo();
+    PipelinedInput iterator0(node, params);
     ProgressMonitorProxy pmp(m_engine->getExecutorContext(), this);
     // Init the postfilter
     CountingPostfilter postfilter(m_tmpOutputTable, wherePredicate, limit, offset);
@@ -72,6 +72,7 @@
 
 #include "indexes/tableindex.h"
 
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <stack>
@@ -82,6 +83,36 @@ using namespace voltdb;
 const static int8_t UNMATCHED_TUPLE(TableTupleFilter::ACTIVE_TUPLE);
 const static int8_t MATCHED_TUPLE(TableTupleFilter::ACTIVE_TUPLE + 1);
 
+namespace {
+
+// Orders the outer tuples of a probe batch by their search keys
+struct ProbeKeyLess {
+    ProbeKeyLess(const std::vector<char>& keyStorage, size_t keyLength, const TupleSchema* keySchema)
+        : m_keyStorage(keyStorage), m_keyLength(keyLength), m_keySchema(keySchema) { }
+
+    bool operator()(int lhs, int rhs) const {
+        TableTuple lhsKey(const_cast<char*>(&m_keyStorage[lhs * m_keyLength]), m_keySchema);
+        TableTuple rhsKey(const_cast<char*>(&m_keyStorage[rhs * m_keyLength]), m_keySchema);
+        return lhsKey.compare(rhsKey) < 0;
+    }
+
+    const std::vector<char>& m_keyStorage;
+    size_t m_keyLength;
+    const TupleSchema* m_keySchema;
+};
+
+// Hand out the single inner tuple that a batched probe found, once
+inline bool nextProbedMatch(char*& match, TableTuple* innerTuple) {
+    if (match == NULL) {
+        return false;
+    }
+    innerTuple->move(match);
+    match = NULL;
+    return true;
+}
+
+}
+
 bool NestLoopIndexExecutor::p_init(AbstractPlanNode* abstractNode,
                                    TempTableLimits* limits)
 {
@@ -150,6 +181,135 @@ bool NestLoopIndexExecutor::p_init(AbstractPlanNode* abstractNode,
     return true;
 }
 
+bool NestLoopIndexExecutor::canBatchProbes(const TableIndex* index) const
+{
+    // Only when each outer tuple can find at most one inner tuple,
+    // so that the matches of a whole batch fit in one slot each.
+    int num_of_searchkeys = static_cast <int> (m_indexNode->getSearchKeyExpressions().size());
+    return m_lookupType == INDEX_LOOKUP_TYPE_EQ &&
+           index->isUniqueIndex() &&
+           num_of_searchkeys > 0 &&
+           num_of_searchkeys == index->getKeySchema()->columnCount();
+}
+
+bool NestLoopIndexExecutor::nextProbedOuterTuple(PipelinedInput& outerInput,
+                                                 TableTuple& outerTuple,
+                                                 bool& hasKey,
+                                                 char*& match,
+                                                 const AbstractExpression* prejoinExpression,
+                                                 const TableIndex* index,
+                                                 IndexCursor& indexCursor,
+                                                 int& batchSize)
+{
+    ProbeBatch& batch = m_probeBatch;
+    if (batch.m_position == batch.m_size) {
+        if ( ! fillProbeBatch(outerInput, outerTuple.getSchema(), prejoinExpression,
+                              index, indexCursor, batchSize)) {
+            return false;
+        }
+        batchSize = std::min(batchSize * 2, static_cast<int>(PROBE_BATCH_SIZE));
+    }
+    int slot = batch.m_position++;
+    size_t outerLength = outerTuple.getSchema()->tupleLength() + TUPLE_HEADER_SIZE;
+    outerTuple.move(&batch.m_outerStorage[slot * outerLength]);
+    hasKey = batch.m_hasKey[slot];
+    match = batch.m_matches[slot];
+    // The matches are scattered over the inner table; start fetching a few ahead
+    if (slot + PROBE_PREFETCH_DISTANCE < batch.m_size &&
+            batch.m_matches[slot + PROBE_PREFETCH_DISTANCE] != NULL) {
+        __builtin_prefetch(batch.m_matches[slot + PROBE_PREFETCH_DISTANCE]);
+    }
+    return true;
+}
+
+bool NestLoopIndexExecutor::fillProbeBatch(PipelinedInput& outerInput,
+                                           const TupleSchema* outerSchema,
+                                           const AbstractExpression* prejoinExpression,
+                                           const TableIndex* index,
+                                           IndexCursor& indexCursor,
+                                           int batchSize)
+{
+    ProbeBatch& batch = m_probeBatch;
+    const TupleSchema* keySchema = index->getKeySchema();
+    size_t outerLength = outerSchema->tupleLength() + TUPLE_HEADER_SIZE;
+    size_t keyLength = keySchema->tupleLength() + TUPLE_HEADER_SIZE;
+    if (batch.m_outerStorage.size() < batchSize * outerLength) {
+        batch.m_outerStorage.resize(batchSize * outerLength);
+        batch.m_keyStorage.resize(batchSize * keyLength);
+        batch.m_matches.resize(batchSize);
+        batch.m_hasKey.resize(batchSize);
+    }
+    batch.m_keyOrder.clear();
+    batch.m_size = 0;
+    batch.m_position = 0;
+
+    const std::vector<AbstractExpression*>& searchKeys = m_indexNode->getSearchKeyExpressions();
+    const std::vector<bool>& compareNotDistinct = m_indexNode->getCompareNotDistinctFlags();
+    int num_of_searchkeys = static_cast <int> (searchKeys.size());
+    TableTuple input(outerSchema);
+    TableTuple outer(outerSchema);
+    TableTuple key(keySchema);
+    while (batch.m_size < batchSize && outerInput.next(input)) {
+        int slot = batch.m_size++;
+        // Copy the tuple, because a delete-as-we-go input frees its
+        // blocks once the iterator has left them.
+        outer.move(&batch.m_outerStorage[slot * outerLength]);
+        outer.copy(input);
+        batch.m_matches[slot] = NULL;
+        batch.m_hasKey[slot] = false;
+        if (prejoinExpression != NULL && ! prejoinExpression->eval(&outer, NULL).isTrue()) {
+            continue;
+        }
+
+        // Same as the unbatched equality lookup: a NULL key component or
+        // one that doesn't fit in the key column can't match anything.
+        key.move(&batch.m_keyStorage[slot * keyLength]);
+        key.setAllNulls();
+        bool keyException = false;
+        for (int ctr = 0; ctr < num_of_searchkeys; ctr++) {
+            NValue candidateValue = searchKeys[ctr]->eval(&outer, NULL);
+            if (candidateValue.isNull() && compareNotDistinct[ctr] == false) {
+                keyException = true;
+                break;
+            }
+            try {
+                key.setNValue(ctr, candidateValue);
+            }
+            catch (const SQLException &e) {
+                if ((e.getInternalFlags() & (SQLException::TYPE_OVERFLOW | SQLException::TYPE_UNDERFLOW | SQLException::TYPE_VAR_LENGTH_MISMATCH)) == 0) {
+                    throw e;
+                }
+                keyException = true;
+                break;
+            }
+        }
+        if ( ! keyException) {
+            batch.m_hasKey[slot] = true;
+            batch.m_keyOrder.push_back(slot);
+        }
+    }
+
+    // Probe each distinct key once, in key order
+    std::sort(batch.m_keyOrder.begin(), batch.m_keyOrder.end(),
+              ProbeKeyLess(batch.m_keyStorage, keyLength, keySchema));
+    TableTuple previousKey(keySchema);
+    char* previousMatch = NULL;
+    for (size_t i = 0; i < batch.m_keyOrder.size(); i++) {
+        int slot = batch.m_keyOrder[i];
+        key.move(&batch.m_keyStorage[slot * keyLength]);
+        if (i > 0 && key.compare(previousKey) == 0) {
+            batch.m_matches[slot] = previousMatch;
+            continue;
+        }
+        index->moveToKey(&key, indexCursor);
+        TableTuple inner = index->nextValueAtKey(indexCursor);
+        previousMatch = inner.isNullTuple() ? NULL : inner.address();
+        batch.m_matches[slot] = previousMatch;
+        previousKey.move(key.address());
+    }
+    return batch.m_size > 0;
+}
+
 bool NestLoopIndexExecutor::p_execute(const NValueArray &params)
 {
     assert(dynamic_cast<NestLoopIndexPlanNode*>(m_abstractNode));
@@ -228,12 +388,27 @@ bool NestLoopIndexExecutor::p_execute(const NValueArray &params)
     // Init the postfilter
     CountingPostfilter postfilter(m_tmpOutputTable, where_expression, limit, offset);
 
+    // Batched key access: look up the keys of a batch of outer tuples in
+    // key order, then join the batch in outer order as usual.
+    bool batchedProbes = canBatchProbes(index);
+    int probeBatchSize = PROBE_BATCH_SIZE;
+    if (batchedProbes && limit != CountingPostfilter::NO_LIMIT) {
+        // Don't look far past an inlined limit. The batches grow if the
+        // where predicate turns out to reject most of the rows.
+        int64_t rowsNeeded = static_cast<int64_t>(limit) + std::max(offset, 0) + 1;
+        probeBatchSize = static_cast<int>(std::min(static_cast<int64_t>(PROBE_BATCH_SIZE), rowsNeeded));
+    }
+    m_probeBatch.m_size = 0;
+    m_probeBatch.m_position = 0;
+    bool probedKey = false;
+    char* probedMatch = NULL;
+
     //
     // OUTER TABLE ITERATION
     //
     TableTuple outer_tuple(outer_table->schema());
     TableTuple inner_tuple(inner_table->schema());
-    TableIterator outer_iterator = outer_table->iteratorDeletingAsWeGo();
+    PipelinedInput outer_iterator(node, params);
     int num_of_outer_cols = outer_table->columnCount();
     assert (outer_tuple.sizeInValues() == outer_table->columnCount());
     assert (inner_tuple.sizeInValues() == inner_table->columnCount());
@@ -280,7 +455,11 @@ bool NestLoopIndexExecutor::p_execute(const NValueArray &params)
     }
 
     VOLT_TRACE("<num_of_outer_cols>: %d\n", num_of_outer_cols);
-    while (postfilter.isUnderLimit() && outer_iterator.next(outer_tuple)) {
+    while (postfilter.isUnderLimit() &&
+           (batchedProbes ?
+            nextProbedOuterTuple(outer_iterator, outer_tuple, probedKey, probedMatch,
+                                 prejoin_expression, index, indexCursor, probeBatchSize) :
+            outer_iterator.next(outer_tuple))) {
         VOLT_TRACE("outer_tuple:%s",
                    outer_tuple.debug(outer_table->name()).c_str());
         pmp.countdownProgress();
@@ -294,8 +473,10 @@ bool NestLoopIndexExecutor::p_execute(const NValueArray &params)
         // For outer joins if outer tuple fails pre-join predicate
         // (join expression based on the outer table only)
         // it can't match any of inner tuples
-        if (prejoin_expression == NULL || prejoin_expression->eval(&outer_tuple, NULL).isTrue()) {
-            int activeNumOfSearchKeys = num_of_searchkeys;
+        if (batchedProbes ? probedKey :
+                (prejoin_expression == NULL || prejoin_expression->eval(&outer_tuple, NULL).isTrue())) {
+            // A batched probe has already built its key and looked it up
+            int activeNumOfSearchKeys = batchedProbes ? 0 : num_of_searchkeys;
             VOLT_TRACE ("<Nested Loop Index exec, WHILE-LOOP...> Number of searchKeys: %d \n", num_of_searchkeys);
             IndexLookupType localLookupType = m_lookupType;
             SortDirectionType localSortDirection = m_sortDirection;
@@ -425,7 +606,10 @@ bool NestLoopIndexExecutor::p_execute(const NValueArray &params)
                 //
                 // Essentially cut and pasted this if ladder from
                 // index scan executor
-                if (num_of_searchkeys > 0) {
+                if (batchedProbes) {
+                    // The match, if any, is in probedMatch
+                }
+                else if (num_of_searchkeys > 0) {
                     if (localLookupType == INDEX_LOOKUP_TYPE_EQ) {
                         index->moveToKey(&index_values, indexCursor);
                     }
@@ -475,11 +659,13 @@ bool NestLoopIndexExecutor::p_execute(const NValueArray &params)
                 AbstractExpression* skipNullExprIteration = skipNullExpr;
 
                 while (postfilter.isUnderLimit() &&
-                       IndexScanExecutor::getNextTuple(localLookupType,
-                                                       &inner_tuple,
-                                                       index,
-                                                       &indexCursor,
-                                                       num_of_searchkeys)) {
+                       (batchedProbes ?
+                        nextProbedMatch(probedMatch, &inner_tuple) :
+                        IndexScanExecutor::getNextTuple(localLookupType,
+                                                        &inner_tuple,
+                                                        index,
+                                                        &indexCursor,
+                                                        num_of_searchkeys))) {
                     if (inner_tuple.isPendingDelete()) {
                         continue;
                     }
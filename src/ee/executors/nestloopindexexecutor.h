@@ -52,6 +52,8 @@
 #include "expressions/abstractexpression.h"
 #include "executors/abstractjoinexecutor.h"
 
+#include <vector>
+
 
 namespace voltdb {
 
@@ -60,6 +62,9 @@ class IndexScanPlanNode;
 class AggregateExecutorBase;
 class ProgressMonitorProxy;
 class TableTuple;
+class TableIndex;
+class IndexCursor;
+class PipelinedInput;
 
 /**
  * Nested loop for IndexScan.
@@ -91,6 +96,64 @@ protected:
     std::vector<AbstractExpression*> m_outputExpressions;
     SortDirectionType m_sortDirection;
     StandAloneTupleStorage m_indexValues;
+
+private:
+    /**
+     * Outer tuples read ahead for batched key access, when each outer tuple
+     * can match at most one inner tuple (an equality lookup on the whole
+     * key of a unique index). Their search keys are looked up in key order
+     * rather than outer order, so that consecutive probes walk mostly the
+     * same part of the index, and the matches are then handed back in
+     * outer order.
+     */
+    struct ProbeBatch {
+        ProbeBatch() : m_size(0), m_position(0) { }
+
+        /** Copies of the outer tuples, which may not outlive the input's iterator */
+        std::vector<char> m_outerStorage;
+        std::vector<char> m_keyStorage;
+        /** Per outer tuple: the inner tuple its key found, or NULL */
+        std::vector<char*> m_matches;
+        /** Per outer tuple: false if it failed the pre-join predicate or had no usable key */
+        std::vector<bool> m_hasKey;
+        /** Outer tuples with keys, sorted by key */
+        std::vector<int> m_keyOrder;
+        int m_size;
+        int m_position;
+    };
+
+    static const int PROBE_BATCH_SIZE = 1024;
+    // How many matches ahead of the current outer tuple to prefetch
+    static const int PROBE_PREFETCH_DISTANCE = 4;
+
+    bool canBatchProbes(const TableIndex* index) const;
+
+    /**
+     * Get the next outer tuple from m_probeBatch, refilling it from the
+     * input as needed, along with whether it had a key and what that key
+     * found in the index. Batches double in size up to PROBE_BATCH_SIZE.
+     */
+    bool nextProbedOuterTuple(PipelinedInput& outerInput,
+                              TableTuple& outerTuple,
+                              bool& hasKey,
+                              char*& match,
+                              const AbstractExpression* prejoinExpression,
+                              const TableIndex* index,
+                              IndexCursor& indexCursor,
+                              int& batchSize);
+
+    /**
+     * Read up to batchSize outer tuples into m_probeBatch and look up their keys.
+     * Returns false when the input is exhausted.
+     */
+    bool fillProbeBatch(PipelinedInput& outerInput,
+                        const TupleSchema* outerSchema,
+                        const AbstractExpression* prejoinExpression,
+                        const TableIndex* index,
+                        IndexCursor& indexCursor,
+                        int batchSize);
+
+    ProbeBatch m_probeBatch;
 };
 
 }
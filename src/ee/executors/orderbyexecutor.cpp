@@ -49,6 +49,7 @@
 #include "common/tabletuple.h"
 #include "common/FatalException.hpp"
 #include "execution/ProgressMonitorProxy.h"
+#include "executors/executorutil.h"
 #include "plannodes/orderbynode.h"
 #include "plannodes/limitnode.h"
 #include "storage/table.h"
@@ -133,8 +134,27 @@ OrderByExecutor::p_execute(const NValueArray &params)
     // or to fetch the vector of tuples from the input.  If limit < 0 we
     // need to do the loop below, though.  The only case where we can skip
     // is if limit == 0.
-    if (limit != 0) {
-        vector<TableTuple> xs;
+    if (limit > 0) {
+        //
+        // OPTIMIZATION: TOP-N
+        // Only the first limit + offset tuples in order can make it into
+        // the output, so keep just those in a bounded heap rather than
+        // gathering and sorting the whole input.
+        //
+        ProgressMonitorProxy pmp(m_engine->getExecutorContext(), this);
+        TopNTupleHeap topN(input_table->schema(),
+                           node->getSortExpressions(), node->getSortDirections(),
+                           TopNTupleHeap::capacityFor(limit, offset));
+        while (iterator.next(tuple))
+        {
+            pmp.countdownProgress();
+            assert(tuple.isActive());
+            topN.offer(tuple);
+        }
+        topN.drainTo(output_table, offset);
+    }
+    else if (limit != 0) {
+        vector<TableTuple>& xs = m_sortedTuples;
         ProgressMonitorProxy pmp(m_engine->getExecutorContext(), this);
         while (iterator.next(tuple))
         {
@@ -146,24 +166,12 @@ OrderByExecutor::p_execute(const NValueArray &params)
                    input_table->debug().c_str());
 
 
-        if (limit >= 0 && xs.begin() + limit + offset < xs.end()) {
-            // partial sort
-            partial_sort(xs.begin(), xs.begin() + limit + offset, xs.end(),
-                    AbstractExecutor::TupleComparer(node->getSortExpressions(), node->getSortDirections()));
-        } else {
-            // full sort
-            sort(xs.begin(), xs.end(),
-                    AbstractExecutor::TupleComparer(node->getSortExpressions(), node->getSortDirections()));
-        }
+        // There is no limit here, so sort it all
+        sort(xs.begin(), xs.end(),
+                AbstractExecutor::TupleComparer(node->getSortExpressions(), node->getSortDirections()));
 
-        int tuple_ctr = 0;
         int tuple_skipped = 0;
-        // If (limit < 0), so we don't have a limit at all, then just compare
-        // the iterator with the end.  Otherwise check that the tuple_counter is
-        // not over the limit.
-        for (vector<TableTuple>::iterator it = xs.begin();
-             ((limit < 0) || (tuple_ctr < limit)) && it != xs.end();
-             it++)
+        for (vector<TableTuple>::iterator it = xs.begin(); it != xs.end(); it++)
         {
             //
             // Check if has gone past the offset
@@ -177,7 +185,12 @@ OrderByExecutor::p_execute(const NValueArray &params)
                        input_table->debug().c_str());
             output_table->insertTempTuple(*it);
             pmp.countdownProgress();
-            tuple_ctr += 1;
+        }
+        if (m_retainsWorkingSet) {
+            xs.clear();
+        }
+        else {
+            vector<TableTuple>().swap(xs);
         }
     }
     VOLT_TRACE("Result of OrderBy:\n '%s'", output_table->debug().c_str());
@@ -187,5 +200,14 @@ OrderByExecutor::p_execute(const NValueArray &params)
     return true;
 }
 
+int64_t OrderByExecutor::workingSetSize() const {
+    return AbstractExecutor::workingSetSize() + static_cast<int64_t>(m_sortedTuples.capacity() * sizeof(TableTuple));
+}
+
+void OrderByExecutor::releaseWorkingSet() {
+    AbstractExecutor::releaseWorkingSet();
+    vector<TableTuple>().swap(m_sortedTuples);
+}
+
 OrderByExecutor::~OrderByExecutor() {
 }
@@ -66,6 +66,9 @@ namespace voltdb {
             { }
         ~OrderByExecutor();
 
+        int64_t workingSetSize() const;
+        void releaseWorkingSet();
+
     protected:
         bool p_init(AbstractPlanNode* abstract_node,
                     TempTableLimits* limits);
@@ -73,6 +76,8 @@ namespace voltdb {
 
     private:
         LimitPlanNode *limit_node;
+        // the tuples being sorted, kept between executions if retaining the working set
+        std::vector<TableTuple> m_sortedTuples;
     };
 
 }
@@ -130,31 +130,10 @@ bool ProjectionExecutor::p_execute(const NValueArray &params) {
     // expression This will generate new tuple values that we will insert into
     // our output table
     //
-    TableIterator iterator = input_table->iteratorDeletingAsWeGo();
+    PipelinedInput input(m_abstractNode, params);
     assert (tuple.sizeInValues() == input_table->columnCount());
-    while (iterator.next(tuple)) {
-        //
-        // Project (or replace) values from input tuple
-        //
-        TableTuple &temp_tuple = output_table->tempTuple();
-        if (all_tuple_array != NULL) {
-            VOLT_TRACE("sweet, all tuples");
-            for (int ctr = m_columnCount - 1; ctr >= 0; --ctr) {
-                temp_tuple.setNValue(ctr, tuple.getNValue(all_tuple_array[ctr]));
-            }
-        } else if (all_param_array != NULL) {
-            VOLT_TRACE("sweet, all params");
-            for (int ctr = m_columnCount - 1; ctr >= 0; --ctr) {
-                temp_tuple.setNValue(ctr, params[all_param_array[ctr]]);
-            }
-        } else {
-            for (int ctr = m_columnCount - 1; ctr >= 0; --ctr) {
-                temp_tuple.setNValue(ctr, expression_array[ctr]->eval(&tuple, NULL));
-            }
-        }
-        output_table->insertTempTuple(temp_tuple);
-
-        VOLT_TRACE("OUTPUT TABLE: %s\n", output_table->debug().c_str());
+    while (input.next(tuple)) {
+        projectTuple(params);
     }
 
     cleanupInputTempTable(input_table);
@@ -162,6 +141,55 @@ bool ProjectionExecutor::p_execute(const NValueArray &params) {
     return (true);
 }
 
+void ProjectionExecutor::projectTuple(const NValueArray &params) {
+    //
+    // Project (or replace) values from input tuple
+    //
+    TableTuple &temp_tuple = output_table->tempTuple();
+    if (all_tuple_array != NULL) {
+        VOLT_TRACE("sweet, all tuples");
+        for (int ctr = m_columnCount - 1; ctr >= 0; --ctr) {
+            temp_tuple.setNValue(ctr, tuple.getNValue(all_tuple_array[ctr]));
+        }
+    } else if (all_param_array != NULL) {
+        VOLT_TRACE("sweet, all params");
+        for (int ctr = m_columnCount - 1; ctr >= 0; --ctr) {
+            temp_tuple.setNValue(ctr, params[all_param_array[ctr]]);
+        }
+    } else {
+        for (int ctr = m_columnCount - 1; ctr >= 0; --ctr) {
+            temp_tuple.setNValue(ctr, expression_array[ctr]->eval(&tuple, NULL));
+        }
+    }
+    output_table->insertTempTuple(temp_tuple);
+
+    VOLT_TRACE("OUTPUT TABLE: %s\n", output_table->debug().c_str());
+}
+
+void ProjectionExecutor::startBatches(const NValueArray &params) {
+    m_batchParams = &params;
+    m_batchInput.reset(new PipelinedInput(m_abstractNode, params));
+}
+
+bool ProjectionExecutor::nextBatch() {
+    cleanupTempOutputTable();
+    if (m_batchInput.get() == NULL) {
+        return false;
+    }
+    while (output_table->tempTableTupleCount() < PIPELINE_BATCH_SIZE && m_batchInput->next(tuple)) {
+        projectTuple(*m_batchParams);
+    }
+    if (output_table->isTempTableEmpty()) {
+        cleanupInputTempTable(m_abstractNode->getInputTable());
+        return false;
+    }
+    return true;
+}
+
+void ProjectionExecutor::finishBatches() {
+    m_batchInput.reset();
+}
+
 ProjectionExecutor::~ProjectionExecutor() {
 }
 
@@ -47,11 +47,13 @@
 #define HSTOREPROJECTIONEXECUTOR_H
 
 #include <vector>
+#include "boost/scoped_ptr.hpp"
 #include "boost/shared_array.hpp"
 #include "common/common.h"
 #include "common/valuevector.h"
 #include "common/tabletuple.h"
 #include "executors/abstractexecutor.h"
+#include "executors/executorutil.h"
 
 namespace voltdb {
 
@@ -66,14 +68,24 @@ class ProjectionExecutor : public AbstractExecutor {
     public:
         ProjectionExecutor(VoltDBEngine *engine, AbstractPlanNode* abstract_node) : AbstractExecutor(engine, abstract_node) {
             output_table = NULL;
+            m_batchParams = NULL;
         }
         ~ProjectionExecutor();
+
+        bool canProduceBatches() const { return true; }
+        bool consumesBatches() const { return true; }
+        void startBatches(const NValueArray& params);
+        bool nextBatch();
+        void finishBatches();
+
     protected:
         bool p_init(AbstractPlanNode*,
                     TempTableLimits* limits);
         bool p_execute(const NValueArray &params);
 
     private:
+        void projectTuple(const NValueArray &params);
+
         TempTable* output_table;
         int m_columnCount;
         boost::shared_array<int> all_tuple_array_ptr;
@@ -86,6 +98,10 @@ class ProjectionExecutor : public AbstractExecutor {
 
         boost::shared_array<AbstractExpression*> expression_array_ptr;
         AbstractExpression** expression_array;
+
+        // Input state kept between batches when driven by a parent
+        const NValueArray* m_batchParams;
+        boost::scoped_ptr<PipelinedInput> m_batchInput;
 };
 
 }
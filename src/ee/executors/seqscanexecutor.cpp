@@ -50,8 +50,10 @@
 #include "common/FatalException.hpp"
 #include "executors/aggregateexecutor.h"
 #include "executors/executorutil.h"
+#include "executors/ParallelScan.h"
 #include "execution/ProgressMonitorProxy.h"
 #include "expressions/abstractexpression.h"
+#include "expressions/tuplevalueexpression.h"
 #include "plannodes/aggregatenode.h"
 #include "plannodes/seqscannode.h"
 #include "plannodes/projectionnode.h"
@@ -106,6 +108,30 @@ bool SeqScanExecutor::p_init(AbstractPlanNode* abstract_node,
     return true;
 }
 
+/*
+ * Express the inputs of an inline aggregate in terms of the scanned table's
+ * columns, looking through an inline projection. Returns false if an input
+ * is computed from the projection's output rather than copied from it.
+ */
+static bool getAggregateInputsOverTable(const AggregateSerialExecutor* aggExec,
+                                        const ProjectionPlanNode* projectionNode,
+                                        std::vector<const AbstractExpression*>& inputs)
+{
+    const std::vector<AbstractExpression*>& aggInputs = aggExec->getInputExpressions();
+    for (size_t i = 0; i < aggInputs.size(); i++) {
+        const AbstractExpression* input = aggInputs[i];
+        if (input != NULL && projectionNode != NULL) {
+            const TupleValueExpression* column = dynamic_cast<const TupleValueExpression*>(input);
+            if (column == NULL) {
+                return false;
+            }
+            input = projectionNode->getOutputColumnExpressions()[column->getColumnId()];
+        }
+        inputs.push_back(input);
+    }
+    return true;
+}
+
 bool SeqScanExecutor::p_execute(const NValueArray &params) {
     SeqScanPlanNode* node = dynamic_cast<SeqScanPlanNode*>(m_abstractNode);
     assert(node);
@@ -176,13 +202,38 @@ bool SeqScanExecutor::p_execute(const NValueArray &params) {
             VOLT_TRACE("SCAN PREDICATE :\n%s\n", predicate->debug(true).c_str());
         }
 
+        //
+        // OPTIMIZATION: PARALLEL AGGREGATE
+        //
+        // On a large persistent table, an inline aggregate without GROUP BY
+        // whose partial results can be merged may be computed on helper
+        // threads, one partial result per range of blocks, leaving only the
+        // merge to do here.
+        //
+        ParallelScanAggregate preaggregated;
+        AggregateSerialExecutor* serialAgg = dynamic_cast<AggregateSerialExecutor*>(m_aggExec);
+        std::vector<const AbstractExpression*> aggInputs;
+        bool isPreaggregated = serialAgg != NULL && serialAgg->canMergePartials() &&
+                getAggregateInputsOverTable(serialAgg, projection_node, aggInputs) &&
+                preaggregated.aggregate(input_table, predicate, serialAgg->getAggTypes(), aggInputs);
+
+        //
+        // OPTIMIZATION: PARALLEL PREDICATE
+        //
+        // Otherwise the predicate may be evaluated on helper threads first,
+        // leaving only the matching tuples to go through the rest of the
+        // scan here.
+        //
+        ParallelScanFilter prefiltered;
+        bool isPrefiltered = ! isPreaggregated && prefiltered.filter(input_table, predicate);
+
         int limit = CountingPostfilter::NO_LIMIT;
         int offset = CountingPostfilter::NO_OFFSET;
         if (limit_node) {
             limit_node->getLimitAndOffsetByReference(params, limit, offset);
         }
         // Initialize the postfilter
-        CountingPostfilter postfilter(m_tmpOutputTable, predicate, limit, offset);
+        CountingPostfilter postfilter(m_tmpOutputTable, isPrefiltered ? NULL : predicate, limit, offset);
 
         ProgressMonitorProxy pmp(m_engine->getExecutorContext(), this);
         TableTuple temp_tuple;
@@ -198,7 +249,22 @@ bool SeqScanExecutor::p_execute(const NValueArray &params) {
             temp_tuple = m_tmpOutputTable->tempTuple();
         }
 
-        while (postfilter.isUnderLimit() && iterator.next(tuple))
+        if (isPreaggregated && preaggregated.firstMatch(tuple)) {
+            // The first input tuple supplies any pass-through columns
+            if (projection_node != NULL) {
+                for (int ctr = 0; ctr < num_of_columns; ctr++) {
+                    NValue value = projection_node->getOutputColumnExpressions()[ctr]->eval(&tuple, NULL);
+                    temp_tuple.setNValue(ctr, value);
+                }
+                serialAgg->p_execute_partials(temp_tuple, preaggregated.partials());
+            }
+            else {
+                serialAgg->p_execute_partials(tuple, preaggregated.partials());
+            }
+        }
+
+        while ( ! isPreaggregated && postfilter.isUnderLimit() &&
+               (isPrefiltered ? prefiltered.next(tuple) : iterator.next(tuple)))
         {
 #if   defined(VOLT_TRACE_ENABLED)
             int tuple_ctr = 0;
@@ -248,6 +314,65 @@ bool SeqScanExecutor::p_execute(const NValueArray &params) {
     return true;
 }
 
+// Only a scan that filters or projects into its own output table, and that
+// needs neither an inline LIMIT (counted against the whole output table) nor
+// an inline aggregate, can hand its output over in batches.
+bool SeqScanExecutor::canProduceBatches() const {
+    return m_tmpOutputTable != NULL && m_aggExec == NULL &&
+           m_abstractNode->getInlinePlanNode(PLAN_NODE_TYPE_LIMIT) == NULL;
+}
+
+void SeqScanExecutor::startBatches(const NValueArray &params) {
+    SeqScanPlanNode* node = static_cast<SeqScanPlanNode*>(m_abstractNode);
+    if (node->isEmptyScan()) {
+        m_batchInputTable = NULL;
+        m_batchIterator.reset();
+        return;
+    }
+    m_batchInputTable = (node->isSubQuery()) ?
+            node->getChildren()[0]->getOutputTable():
+            node->getTargetTable();
+    assert(m_batchInputTable);
+    m_batchIterator.reset(new TableIterator(m_batchInputTable->iteratorDeletingAsWeGo()));
+}
+
+bool SeqScanExecutor::nextBatch() {
+    cleanupTempOutputTable();
+    if (m_batchIterator.get() == NULL) {
+        return false;
+    }
+    SeqScanPlanNode* node = static_cast<SeqScanPlanNode*>(m_abstractNode);
+    AbstractExpression *predicate = node->getPredicate();
+    ProjectionPlanNode* projection_node = static_cast<ProjectionPlanNode*>(node->getInlinePlanNode(PLAN_NODE_TYPE_PROJECTION));
+
+    ProgressMonitorProxy pmp(m_engine->getExecutorContext(), this);
+    TableTuple tuple(m_batchInputTable->schema());
+    TableTuple &temp_tuple = m_tmpOutputTable->tempTuple();
+    while (m_tmpOutputTable->tempTableTupleCount() < PIPELINE_BATCH_SIZE &&
+           m_batchIterator->next(tuple)) {
+        pmp.countdownProgress();
+        if (predicate != NULL && !predicate->eval(&tuple, NULL).isTrue()) {
+            continue;
+        }
+        if (projection_node != NULL) {
+            const std::vector<AbstractExpression*>& columns = projection_node->getOutputColumnExpressions();
+            int num_of_columns = static_cast<int>(columns.size());
+            for (int ctr = 0; ctr < num_of_columns; ctr++) {
+                temp_tuple.setNValue(ctr, columns[ctr]->eval(&tuple, NULL));
+            }
+            m_tmpOutputTable->insertTempTuple(temp_tuple);
+        }
+        else {
+            m_tmpOutputTable->insertTempTuple(tuple);
+        }
+    }
+    return ! m_tmpOutputTable->isTempTableEmpty();
+}
+
+void SeqScanExecutor::finishBatches() {
+    m_batchIterator.reset();
+}
+
 void SeqScanExecutor::outputTuple(CountingPostfilter& postfilter, TableTuple& tuple) {
     if (m_aggExec != NULL) {
         m_aggExec->p_execute_tuple(tuple);
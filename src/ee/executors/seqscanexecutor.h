@@ -51,6 +51,8 @@
 #include "executors/abstractexecutor.h"
 #include "execution/VoltDBEngine.h"
 
+#include <boost/scoped_ptr.hpp>
+
 namespace voltdb
 {
     class AggregateExecutorBase;
@@ -61,7 +63,14 @@ namespace voltdb
         SeqScanExecutor(VoltDBEngine *engine, AbstractPlanNode* abstract_node)
             : AbstractExecutor(engine, abstract_node)
             , m_aggExec(NULL)
+            , m_batchInputTable(NULL)
         {}
+
+        bool canProduceBatches() const;
+        void startBatches(const NValueArray& params);
+        bool nextBatch();
+        void finishBatches();
+
     protected:
         bool p_init(AbstractPlanNode* abstract_node,
                     TempTableLimits* limits);
@@ -72,6 +81,10 @@ namespace voltdb
         void outputTuple(CountingPostfilter& postfilter, TableTuple& tuple);
 
         AggregateExecutorBase* m_aggExec;
+
+        // Scan state kept between batches when driven by a parent
+        Table* m_batchInputTable;
+        boost::scoped_ptr<TableIterator> m_batchIterator;
     };
 }
 
@@ -45,26 +45,140 @@
 
 #include "unionexecutor.h"
 
+#include "common/SerializableEEException.h"
+#include "common/executorcontext.hpp"
+#include "common/serializeio.h"
 #include "common/tabletuple.h"
 #include "plannodes/unionnode.h"
 #include "storage/temptable.h"
 #include "storage/tableiterator.h"
 #include "storage/tablefactory.h"
+#include "storage/TempTableLimits.h"
 
+#include "boost/ptr_container/ptr_vector.hpp"
+#include "boost/scoped_ptr.hpp"
 #include "boost/unordered_set.hpp"
 #include "boost/unordered_map.hpp"
 
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+
 namespace voltdb {
 
 namespace detail {
 
+/**
+ * A tuple along with its hash, so that the hash tables below hash each
+ * tuple's contents once, and compare the contents of two tuples only when
+ * their hashes match.
+ */
+struct HashedTuple {
+    explicit HashedTuple(const TableTuple& tuple) : m_tuple(tuple), m_hash(tuple.hashCode()) { }
+
+    TableTuple m_tuple;
+    size_t m_hash;
+};
+
+struct HashedTupleHasher : std::unary_function<HashedTuple, std::size_t>
+{
+    inline size_t operator()(const HashedTuple& tuple) const
+    {
+        return tuple.m_hash;
+    }
+};
+
+class HashedTupleEqualityChecker {
+public:
+    inline bool operator()(const HashedTuple& lhs, const HashedTuple& rhs) const {
+        return lhs.m_hash == rhs.m_hash && lhs.m_tuple.equalsNoSchemaCheck(rhs.m_tuple);
+    }
+};
+
+/**
+ * Charges the memory of a hash table to the temp table limits for as long
+ * as the table is in scope.
+ */
+class HashTableMemory {
+public:
+    HashTableMemory(TempTableLimits* limits, int64_t bytes)
+        : m_limits(limits)
+        , m_bytes(static_cast<int>(std::min<int64_t>(bytes, std::numeric_limits<int>::max())))
+    {
+        if (m_limits == NULL) {
+            return;
+        }
+        try {
+            m_limits->increaseAllocated(m_bytes);
+        }
+        catch (...) {
+            // increaseAllocated counts the bytes before it throws
+            m_limits->reduceAllocated(m_bytes);
+            throw;
+        }
+    }
+
+    ~HashTableMemory()
+    {
+        if (m_limits != NULL) {
+            m_limits->reduceAllocated(m_bytes);
+        }
+    }
+
+private:
+    TempTableLimits* const m_limits;
+    int const m_bytes;
+};
+
+/**
+ * Temporary files that the inputs are partitioned into when they are too
+ * big to hash in memory. The files are deleted when they are closed.
+ */
+class SpillFiles {
+public:
+    explicit SpillFiles(size_t count) : m_files(count, static_cast<FILE*>(NULL)) { }
+
+    ~SpillFiles()
+    {
+        for (size_t ii = 0; ii < m_files.size(); ++ii) {
+            if (m_files[ii] != NULL) {
+                fclose(m_files[ii]);
+            }
+        }
+    }
+
+    bool open()
+    {
+        for (size_t ii = 0; ii < m_files.size(); ++ii) {
+            m_files[ii] = tmpfile();
+            if (m_files[ii] == NULL) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    FILE* operator[](size_t ii) const { return m_files[ii]; }
+
+private:
+    std::vector<FILE*> m_files;
+};
+
 struct SetOperator {
-    typedef boost::unordered_set<TableTuple, TableTupleHasher, TableTupleEqualityChecker>
+    typedef boost::unordered_set<HashedTuple, HashedTupleHasher, HashedTupleEqualityChecker>
         TupleSet;
-    typedef boost::unordered_map<TableTuple, size_t, TableTupleHasher, TableTupleEqualityChecker>
+    typedef boost::unordered_map<HashedTuple, size_t, HashedTupleHasher, HashedTupleEqualityChecker>
         TupleMap;
     typedef AbstractPlanNode::TableReference TableReference;
 
+    // Approximate size of a hash table entry: the value, the node's link
+    // and its share of the bucket array
+    static const int64_t SET_ENTRY_BYTES = sizeof(TupleSet::value_type) + 3 * sizeof(void*);
+    static const int64_t MAP_ENTRY_BYTES = sizeof(TupleMap::value_type) + 3 * sizeof(void*);
+
+    // The most files that each input is split into when it must be spilled
+    static const size_t MAX_SPILL_PARTITIONS = 64;
+
     SetOperator(const std::vector<TableReference>& input_tablerefs,
                 TempTable* output_table,
                 bool is_all)
@@ -72,7 +186,7 @@ struct SetOperator {
     { }
     virtual ~SetOperator() {}
 
-    virtual bool processTuples() = 0;
+    virtual bool processTuples();
 
     static SetOperator* getSetOperator(UnionPlanNode* node);
 
@@ -81,11 +195,206 @@ struct SetOperator {
     static void printTupleSet(const char* nonce, TupleSet &tuples);
 
 protected:
+    /** Apply the operation to the inputs with in-memory hash tables */
+    virtual void processTables(const std::vector<Table*>& inputs, TempTable* output) = 0;
+
+    /** Memory that processTables() will charge for its hash tables */
+    virtual int64_t hashTableBytes(const std::vector<Table*>& inputs) const = 0;
+
+    /**
+     * Given how many times a tuple occurs in each input, return how many
+     * times it occurs in the result.
+     */
+    virtual size_t mergedCount(const std::vector<size_t>& counts) const = 0;
+
     const std::vector<TableReference>& m_input_tablerefs;
     TempTable* const m_output_table;
     bool const m_is_all;
+
+private:
+    static bool isSorted(Table* input);
+    void mergeSortedInputs(const std::vector<Table*>& inputs);
+    bool processInPartitions(const std::vector<Table*>& inputs, size_t partitionCount);
 };
 
+bool SetOperator::processTuples()
+{
+    std::vector<Table*> inputs(m_input_tablerefs.size());
+    for (size_t ctr = 0, cnt = inputs.size(); ctr < cnt; ctr++) {
+        inputs[ctr] = m_input_tablerefs[ctr].getTable();
+        assert(inputs[ctr]);
+    }
+
+    // Inputs that all arrive in order, say from index scans, can be merged
+    // without any hash tables at all.
+    bool sorted = true;
+    for (size_t ctr = 0, cnt = inputs.size(); sorted && ctr < cnt; ctr++) {
+        sorted = isSorted(inputs[ctr]);
+    }
+    if (sorted) {
+        mergeSortedInputs(inputs);
+        return true;
+    }
+
+    TempTableLimits* limits = m_output_table->getTempTableLimits();
+    if (limits != NULL && limits->getMemoryLimit() > 0) {
+        int64_t hashBytes = hashTableBytes(inputs);
+        if (limits->getAllocated() + hashBytes > limits->getMemoryLimit()) {
+            // Each partition is copied out of its spill files and hashed,
+            // so aim for partitions that need half of what is left.
+            int64_t projected = hashBytes;
+            for (size_t ctr = 0, cnt = inputs.size(); ctr < cnt; ctr++) {
+                projected += inputs[ctr]->allocatedTupleMemory();
+            }
+            int64_t budget = limits->getMemoryLimit() - limits->getAllocated();
+            size_t const partitionCountLimit = MAX_SPILL_PARTITIONS;
+            size_t partitionCount = partitionCountLimit;
+            if (budget > 0) {
+                partitionCount = static_cast<size_t>(2 * projected / budget + 1);
+                partitionCount = std::max(std::min(partitionCount, partitionCountLimit), static_cast<size_t>(2));
+            }
+            if (processInPartitions(inputs, partitionCount)) {
+                return true;
+            }
+            // No temporary files to spill to, so try it in memory after all
+        }
+    }
+
+    processTables(inputs, m_output_table);
+    return true;
+}
+
+bool SetOperator::isSorted(Table* input)
+{
+    TableIterator iterator = input->iterator();
+    TableTuple tuple(input->schema());
+    TableTuple previous(input->schema());
+    bool first = true;
+    while (iterator.next(tuple)) {
+        if ( ! first && previous.compare(tuple) > 0) {
+            return false;
+        }
+        previous = tuple;
+        first = false;
+    }
+    return true;
+}
+
+void SetOperator::mergeSortedInputs(const std::vector<Table*>& inputs)
+{
+    size_t cnt = inputs.size();
+    std::vector<TableIterator> iterators;
+    std::vector<TableTuple> current;
+    std::vector<bool> hasCurrent(cnt);
+    for (size_t ctr = 0; ctr < cnt; ctr++) {
+        iterators.push_back(inputs[ctr]->iterator());
+        current.push_back(TableTuple(inputs[ctr]->schema()));
+        hasCurrent[ctr] = iterators[ctr].next(current[ctr]);
+    }
+
+    std::vector<size_t> counts(cnt);
+    while (true) {
+        // Find the smallest tuple at the head of any input
+        int minCtr = -1;
+        for (size_t ctr = 0; ctr < cnt; ctr++) {
+            if (hasCurrent[ctr] && (minCtr < 0 || current[ctr].compare(current[minCtr]) < 0)) {
+                minCtr = static_cast<int>(ctr);
+            }
+        }
+        if (minCtr < 0) {
+            break;
+        }
+
+        // Count its copies in every input, moving each one past them
+        TableTuple tuple = current[minCtr];
+        for (size_t ctr = 0; ctr < cnt; ctr++) {
+            counts[ctr] = 0;
+            while (hasCurrent[ctr] && current[ctr].compare(tuple) == 0) {
+                ++counts[ctr];
+                hasCurrent[ctr] = iterators[ctr].next(current[ctr]);
+            }
+        }
+
+        for (size_t ii = 0, copies = mergedCount(counts); ii < copies; ++ii) {
+            m_output_table->insertTempTuple(tuple);
+        }
+    }
+}
+
+bool SetOperator::processInPartitions(const std::vector<Table*>& inputs, size_t partitionCount)
+{
+    size_t cnt = inputs.size();
+    SpillFiles files(cnt * partitionCount);
+    if ( ! files.open()) {
+        return false;
+    }
+
+    // Equal tuples have equal hashes, so they land in the same partition
+    // of every input, and each partition can be processed on its own.
+    size_t maxTupleSize = 0;
+    for (size_t ctr = 0; ctr < cnt; ctr++) {
+        maxTupleSize = std::max(maxTupleSize, inputs[ctr]->schema()->getMaxSerializedTupleSize());
+    }
+    std::vector<char> buffer(maxTupleSize);
+    for (size_t ctr = 0; ctr < cnt; ctr++) {
+        TableIterator iterator = inputs[ctr]->iterator();
+        TableTuple tuple(inputs[ctr]->schema());
+        while (iterator.next(tuple)) {
+            ReferenceSerializeOutput output(&buffer[0], buffer.size());
+            tuple.serializeTo(output);
+            FILE* file = files[ctr * partitionCount + tuple.hashCode() % partitionCount];
+            if (fwrite(&buffer[0], 1, output.position(), file) != output.position()) {
+                throw SerializableEEException(VOLT_EE_EXCEPTION_TYPE_EEEXCEPTION,
+                                              "Could not write a set operation's spill file");
+            }
+        }
+    }
+
+    TempTableLimits* limits = m_output_table->getTempTableLimits();
+    Pool* tempPool = ExecutorContext::getTempStringPool();
+    for (size_t partition = 0; partition < partitionCount; ++partition) {
+        // Holds the out-of-line values of this partition's tuples
+        Pool partitionPool;
+        boost::ptr_vector<TempTable> partitionInputs;
+        std::vector<Table*> partitionTables;
+        for (size_t ctr = 0; ctr < cnt; ctr++) {
+            TempTable* partitionTable = TableFactory::buildCopiedTempTable(inputs[ctr]->name(),
+                                                                           inputs[ctr], limits);
+            partitionInputs.push_back(partitionTable);
+            partitionTables.push_back(partitionTable);
+
+            FILE* file = files[ctr * partitionCount + partition];
+            rewind(file);
+            char length[sizeof(int32_t)];
+            while (fread(length, 1, sizeof(length), file) == sizeof(length)) {
+                ReferenceSerializeInputBE lengthInput(length, sizeof(length));
+                size_t tupleSize = sizeof(length) + lengthInput.readInt();
+                std::copy(length, length + sizeof(length), buffer.begin());
+                if (fread(&buffer[sizeof(length)], 1, tupleSize - sizeof(length), file) !=
+                        tupleSize - sizeof(length)) {
+                    throw SerializableEEException(VOLT_EE_EXCEPTION_TYPE_EEEXCEPTION,
+                                                  "Could not read a set operation's spill file");
+                }
+                ReferenceSerializeInputBE input(&buffer[0], tupleSize);
+                TableTuple& tuple = partitionTable->tempTuple();
+                tuple.deserializeFrom(input, &partitionPool);
+                partitionTable->insertTempTuple(tuple);
+            }
+        }
+
+        boost::scoped_ptr<TempTable> partitionOutput(
+            TableFactory::buildCopiedTempTable(m_output_table->name(), m_output_table, limits));
+        processTables(partitionTables, partitionOutput.get());
+
+        TableIterator iterator = partitionOutput->iterator();
+        TableTuple tuple(partitionOutput->schema());
+        while (iterator.next(tuple)) {
+            m_output_table->insertTempTupleDeepCopy(tuple, tempPool);
+        }
+    }
+    return true;
+}
+
 struct UnionSetOperator : public SetOperator {
     UnionSetOperator(const std::vector<TableReference>& input_tablerefs,
                      TempTable* output_table,
@@ -94,25 +403,20 @@ struct UnionSetOperator : public SetOperator {
     { }
 private:
     bool processTuples();
-
-    bool needToInsert(const TableTuple& tuple, TupleSet& tuples)
-    {
-        bool result = tuples.find(tuple) == tuples.end();
-        if (result) {
-            tuples.insert(tuple);
-        }
-        return result;
-    }
+    void processTables(const std::vector<Table*>& inputs, TempTable* output);
+    int64_t hashTableBytes(const std::vector<Table*>& inputs) const;
+    size_t mergedCount(const std::vector<size_t>& counts) const { return 1; }
 };
 
 bool UnionSetOperator::processTuples()
 {
-    // Set to keep candidate tuples.
-    TupleSet tuples;
+    if ( ! m_is_all) {
+        return SetOperator::processTuples();
+    }
 
     //
     // For each input table, grab their TableIterator and then append all of its tuples
-    // to our ouput table. Only distinct tuples are retained.
+    // to our ouput table.
     //
     for (size_t ctr = 0, cnt = m_input_tablerefs.size(); ctr < cnt; ctr++) {
         Table* input_table = m_input_tablerefs[ctr].getTable();
@@ -120,15 +424,44 @@ bool UnionSetOperator::processTuples()
         TableIterator iterator = input_table->iterator();
         TableTuple tuple(input_table->schema());
         while (iterator.next(tuple)) {
-            if (m_is_all || needToInsert(tuple, tuples)) {
-                // we got tuple to insert
-                m_output_table->insertTempTuple(tuple);
-            }
+            m_output_table->insertTempTuple(tuple);
         }
     }
     return true;
 }
 
+int64_t UnionSetOperator::hashTableBytes(const std::vector<Table*>& inputs) const
+{
+    int64_t tupleCount = 0;
+    for (size_t ctr = 0, cnt = inputs.size(); ctr < cnt; ctr++) {
+        tupleCount += inputs[ctr]->activeTupleCount();
+    }
+    return tupleCount * SET_ENTRY_BYTES;
+}
+
+void UnionSetOperator::processTables(const std::vector<Table*>& inputs, TempTable* output)
+{
+    // Set to keep candidate tuples.
+    int64_t bytes = hashTableBytes(inputs);
+    HashTableMemory memory(output->getTempTableLimits(), bytes);
+    TupleSet tuples;
+    tuples.reserve(bytes / SET_ENTRY_BYTES);
+
+    //
+    // Append all of the tuples of each input to the output table.
+    // Only distinct tuples are retained.
+    //
+    for (size_t ctr = 0, cnt = inputs.size(); ctr < cnt; ctr++) {
+        TableIterator iterator = inputs[ctr]->iterator();
+        TableTuple tuple(inputs[ctr]->schema());
+        while (iterator.next(tuple)) {
+            if (tuples.insert(HashedTuple(tuple)).second) {
+                output->insertTempTuple(tuple);
+            }
+        }
+    }
+}
+
 struct TableSizeLess {
     bool operator()(const Table* t1, const Table* t2) const
     {
@@ -143,17 +476,17 @@ struct ExceptIntersectSetOperator : public SetOperator {
                                bool is_except)
         : SetOperator(input_tablerefs, output_table, is_all)
         , m_is_except(is_except)
-        , m_input_tables(input_tablerefs.size())
     { }
 
 private:
-    bool processTuples();
+    void processTables(const std::vector<Table*>& inputs, TempTable* output);
+    int64_t hashTableBytes(const std::vector<Table*>& inputs) const;
+    size_t mergedCount(const std::vector<size_t>& counts) const;
     void collectTuples(Table& input_table, TupleMap& tuple_map);
     void exceptTupleMaps(TupleMap& tuple_a, TupleMap& tuple_b);
     void intersectTupleMaps(TupleMap& tuple_a, TupleMap& tuple_b);
 
     bool const m_is_except;
-    std::vector<Table*> m_input_tables;
 };
 
 // for debugging - may be unused
@@ -161,7 +494,7 @@ void SetOperator::printTupleMap(const char* nonce, TupleMap &tuples)
 {
     printf("Printing TupleMap (%s): ", nonce);
     for (TupleMap::const_iterator mapIt = tuples.begin(); mapIt != tuples.end(); ++mapIt) {
-        TableTuple tuple = mapIt->first;
+        TableTuple tuple = mapIt->first.m_tuple;
         printf("%s, ", tuple.debugNoHeader().c_str());
     }
     printf("\n");
@@ -173,33 +506,67 @@ void SetOperator::printTupleSet(const char* nonce, TupleSet &tuples)
 {
     printf("Printing TupleSet (%s): ", nonce);
     for (TupleSet::const_iterator setIt = tuples.begin(); setIt != tuples.end(); ++setIt) {
-        printf("%s, ", setIt->debugNoHeader().c_str());
+        printf("%s, ", setIt->m_tuple.debugNoHeader().c_str());
     }
     printf("\n");
     fflush(stdout);
 }
 
-bool ExceptIntersectSetOperator::processTuples()
+int64_t ExceptIntersectSetOperator::hashTableBytes(const std::vector<Table*>& inputs) const
+{
+    // The map of the input that processTables() starts with, and the map
+    // of whichever input is being subtracted from or intersected with it
+    int64_t first = inputs[0]->activeTupleCount();
+    int64_t largestOther = 0;
+    for (size_t ctr = 1, cnt = inputs.size(); ctr < cnt; ctr++) {
+        int64_t tupleCount = inputs[ctr]->activeTupleCount();
+        if ( ! m_is_except && tupleCount < first) {
+            // Intersect starts with the smallest input instead
+            std::swap(first, tupleCount);
+        }
+        largestOther = std::max(largestOther, tupleCount);
+    }
+    return (first + largestOther) * MAP_ENTRY_BYTES;
+}
+
+size_t ExceptIntersectSetOperator::mergedCount(const std::vector<size_t>& counts) const
+{
+    if (m_is_except) {
+        size_t others = 0;
+        for (size_t ctr = 1, cnt = counts.size(); ctr < cnt; ctr++) {
+            others += counts[ctr];
+        }
+        if ( ! m_is_all) {
+            return (counts[0] > 0 && others == 0) ? 1 : 0;
+        }
+        return (counts[0] > others) ? counts[0] - others : 0;
+    }
+    size_t result = *std::min_element(counts.begin(), counts.end());
+    if ( ! m_is_all) {
+        return (result > 0) ? 1 : 0;
+    }
+    return result;
+}
+
+void ExceptIntersectSetOperator::processTables(const std::vector<Table*>& inputs, TempTable* output)
 {
     // Map to keep candidate tuples. The key is the tuple itself
     // The value - tuple's repeat count in the final table.
+    HashTableMemory memory(output->getTempTableLimits(), hashTableBytes(inputs));
     TupleMap tuples;
 
-    assert( ! m_input_tables.empty());
-
-    size_t ii = m_input_tablerefs.size();
-    while (ii--) {
-        m_input_tables[ii] = m_input_tablerefs[ii].getTable();
-    }
+    assert( ! inputs.empty());
 
+    std::vector<Table*> input_tables(inputs);
     if ( ! m_is_except) {
         // For intersect we want to start with the smallest table
         std::vector<Table*>::iterator minTableIt =
-            std::min_element(m_input_tables.begin(), m_input_tables.end(), TableSizeLess());
-        std::swap(m_input_tables[0], *minTableIt);
+            std::min_element(input_tables.begin(), input_tables.end(), TableSizeLess());
+        std::swap(input_tables[0], *minTableIt);
     }
     // Collect all tuples from the first set
-    Table* input_table = m_input_tables[0];
+    Table* input_table = input_tables[0];
+    tuples.reserve(input_table->activeTupleCount());
     collectTuples(*input_table, tuples);
 
     //
@@ -207,9 +574,9 @@ bool ExceptIntersectSetOperator::processTuples()
     // and substract/intersect it from/with the first one
     //
     TupleMap next_tuples;
-    for (size_t ctr = 1, cnt = m_input_tables.size(); ctr < cnt; ctr++) {
+    for (size_t ctr = 1, cnt = input_tables.size(); ctr < cnt; ctr++) {
         next_tuples.clear();
-        input_table = m_input_tables[ctr];
+        input_table = input_tables[ctr];
         assert(input_table);
         collectTuples(*input_table, next_tuples);
         if (m_is_except) {
@@ -221,12 +588,11 @@ bool ExceptIntersectSetOperator::processTuples()
 
     // Insert remaining tuples to the output table
     for (TupleMap::const_iterator mapIt = tuples.begin(); mapIt != tuples.end(); ++mapIt) {
-        TableTuple tuple = mapIt->first;
+        TableTuple tuple = mapIt->first.m_tuple;
         for (size_t i = 0; i < mapIt->second; ++i) {
-            m_output_table->insertTempTuple(tuple);
+            output->insertTempTuple(tuple);
         }
     }
-    return true;
 }
 
 void ExceptIntersectSetOperator::collectTuples(Table& input_table, TupleMap& tuple_map)
@@ -234,11 +600,10 @@ void ExceptIntersectSetOperator::collectTuples(Table& input_table, TupleMap& tup
     TableIterator iterator = input_table.iterator();
     TableTuple tuple(input_table.schema());
     while (iterator.next(tuple)) {
-        TupleMap::iterator mapIt = tuple_map.find(tuple);
-        if (mapIt == tuple_map.end()) {
-            tuple_map.insert(std::make_pair(tuple, 1));
-        } else if (m_is_all) {
-            ++(mapIt->second);
+        std::pair<TupleMap::iterator, bool> inserted =
+            tuple_map.insert(std::make_pair(HashedTuple(tuple), 1));
+        if ( ! inserted.second && m_is_all) {
+            ++(inserted.first->second);
         }
     }
 }
@@ -96,6 +96,14 @@ AbstractExpression::hasParameter() const
     return (m_right && m_right->hasParameter());
 }
 
+bool
+AbstractExpression::isNondeterministic() const
+{
+    if (m_left && m_left->isNondeterministic())
+        return true;
+    return (m_right && m_right->isNondeterministic());
+}
+
 bool
 AbstractExpression::initParamShortCircuits()
 {
@@ -76,6 +76,10 @@ class AbstractExpression {
     /** return true if self or descendent should be substitute()'d */
     virtual bool hasParameter() const;
 
+    /** return true if self or descendent can change value between executions
+        with the same parameters and table contents, as the current time does */
+    virtual bool isNondeterministic() const;
+
     /* debugging methods - some various ways to create a sring
        describing the expression tree */
     std::string debug() const;
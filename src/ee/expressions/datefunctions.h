@@ -72,21 +72,115 @@ static inline void throwOutOfRangeTimestampOutput(const std::string& func) {
 
 
 
-/** Convert from epoch_micros to date **/
-static inline void micros_to_date(int64_t epoch_micros_in, boost::gregorian::date& date_out) {
-    boost::posix_time::ptime input_ptime = EPOCH + boost::posix_time::microseconds(epoch_micros_in);
-    date_out = input_ptime.date();
+/*
+ * Integer civil-calendar kernels. A timestamp is split into whole days since
+ * the epoch and microseconds into that day, and days are converted to and
+ * from year/month/day of the proleptic Gregorian calendar with the
+ * days-from-civil algorithms, so that extracting a field, truncating or
+ * adding an interval does not go through boost ptime and date objects.
+ * Boost is still used to format and parse timestamp strings.
+ */
+
+static const int64_t MICROS_PER_SECOND = 1000000;
+static const int64_t MICROS_PER_MINUTE = MICROS_PER_SECOND * 60;
+static const int64_t MICROS_PER_HOUR = MICROS_PER_MINUTE * 60;
+static const int64_t MICROS_PER_DAY = MICROS_PER_HOUR * 24;
+
+static const int8_t DAYS_IN_MONTH[] = {
+        /*[0] not used*/-1,  31, 28, 31,  30, 31, 30,  31, 31, 30,  31, 30, 31 };
+
+/** A calendar date, both as its fields and as days since 1970-01-01 **/
+struct CivilDate {
+    int32_t year;
+    int32_t month;      // 1-12
+    int32_t day;        // 1-31
+    int64_t epochDays;
+};
+
+/** Division by a positive divisor, rounding towards negative infinity **/
+static inline int64_t floor_div(int64_t value, int64_t divisor) {
+    int64_t quotient = value / divisor;
+    if (value % divisor < 0) {
+        --quotient;
+    }
+    return quotient;
 }
 
-/** Convert from epoch_micros to time **/
-static inline void micros_to_time(int64_t epoch_micros_in, boost::posix_time::time_duration& time_out) {
-    boost::posix_time::ptime input_ptime = EPOCH + boost::posix_time::microseconds(epoch_micros_in);
-    time_out = input_ptime.time_of_day();
+/** Remainder of floor_div, always in [0, divisor) **/
+static inline int64_t floor_mod(int64_t value, int64_t divisor) {
+    int64_t remainder = value % divisor;
+    if (remainder < 0) {
+        remainder += divisor;
+    }
+    return remainder;
+}
+
+static inline bool is_leap_year(int64_t year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+static inline int32_t days_in_month(int64_t year, int32_t month) {
+    return (month == 2 && is_leap_year(year)) ? 29 : DAYS_IN_MONTH[month];
+}
+
+/** Convert from date to days since 1970-01-01 **/
+static inline int64_t days_from_civil(int64_t year, int32_t month, int32_t day) {
+    // Years are counted from March so that the leap day ends the year.
+    year -= (month <= 2);
+    int64_t era = floor_div(year, 400);
+    int64_t yearOfEra = year - era * 400;                                          // [0, 399]
+    int64_t dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1; // [0, 365]
+    int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;  // [0, 146096]
+    return era * 146097 + dayOfEra - 719468;
+}
+
+/** Convert from days since 1970-01-01 to date **/
+static inline void civil_from_days(int64_t epoch_days, CivilDate& date_out) {
+    int64_t days = epoch_days + 719468;    // days since 0000-03-01
+    int64_t era = floor_div(days, 146097);
+    int64_t dayOfEra = days - era * 146097;                                                     // [0, 146096]
+    int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365; // [0, 399]
+    int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);        // [0, 365]
+    int64_t marchMonth = (5 * dayOfYear + 2) / 153;                                             // [0, 11]
+    date_out.day = static_cast<int32_t>(dayOfYear - (153 * marchMonth + 2) / 5 + 1);
+    date_out.month = static_cast<int32_t>(marchMonth < 10 ? marchMonth + 3 : marchMonth - 9);
+    date_out.year = static_cast<int32_t>(yearOfEra + era * 400 + (date_out.month <= 2));
+    date_out.epochDays = epoch_days;
 }
 
-/** Convert from epoch_micros to ptime **/
-static inline void micros_to_ptime(int64_t epoch_micros_in, boost::posix_time::ptime& ptime_out) {
-    ptime_out = EPOCH + boost::posix_time::microseconds(epoch_micros_in);
+/** Convert from epoch_micros to date, returning the microseconds into that day **/
+static inline int64_t civil_from_epoch_micros(int64_t epoch_micros, CivilDate& date_out) {
+    int64_t epochDays = floor_div(epoch_micros, MICROS_PER_DAY);
+    civil_from_days(epochDays, date_out);
+    return epoch_micros - epochDays * MICROS_PER_DAY;
+}
+
+/**
+ * Convert a column of epoch_micros to dates. The values must already be
+ * known to be in the supported range.
+ */
+static inline void civil_from_epoch_micros(const int64_t* epoch_micros, size_t count, CivilDate* dates_out) {
+    for (size_t i = 0; i < count; ++i) {
+        civil_from_days(floor_div(epoch_micros[i], MICROS_PER_DAY), dates_out[i]);
+    }
+}
+
+/** Day of the week as boost numbers them, Sunday-0 ... Saturday-6 **/
+static inline int32_t day_of_week(const CivilDate& date) {
+    // 1970-01-01 was a Thursday
+    return static_cast<int32_t>(floor_mod(date.epochDays + 4, 7));
+}
+
+static inline int32_t day_of_year(const CivilDate& date) {
+    return static_cast<int32_t>(date.epochDays - days_from_civil(date.year, 1, 1) + 1);
+}
+
+/** ISO-8601 week number: weeks start on Monday and week 1 holds the first Thursday of its year **/
+static inline int32_t iso_week_number(const CivilDate& date) {
+    int64_t thursday = date.epochDays - floor_mod(date.epochDays + 3, 7) + 3;
+    CivilDate thursdayDate;
+    civil_from_days(thursday, thursdayDate);
+    return static_cast<int32_t>((thursday - days_from_civil(thursdayDate.year, 1, 1)) / 7 + 1);
 }
 
 /** Convert from epoch_micros to date and time **/
@@ -109,17 +203,23 @@ static inline int64_t epoch_microseconds_from_components(unsigned short int year
     return epoch_seconds * 1000000;
 }
 
+/**
+ * Add months the way boost::gregorian::months does: a day past the end of
+ * the resulting month is clamped to it, and the last day of a month stays
+ * the last day of the resulting month.
+ */
 static inline int64_t addMonths(int64_t epoch_micros, int64_t months) {
-    boost::posix_time::ptime ts;
-    micros_to_ptime(epoch_micros, ts);
-
-    try {
-        ts += boost::gregorian::months(static_cast<int>(months));
-    } catch (std::out_of_range &e) {
-        throw voltdb::SQLException(voltdb::SQLException::data_exception_numeric_value_out_of_range, "interval is too large for DATEADD function");
-    }
-    boost::posix_time::time_duration td = ts - EPOCH;
-    return td.total_microseconds();
+    CivilDate date;
+    int64_t micros_of_day = civil_from_epoch_micros(epoch_micros, date);
+    int64_t monthIndex = date.year * 12 + (date.month - 1) + months;
+    int64_t year = floor_div(monthIndex, 12);
+    int32_t month = static_cast<int32_t>(monthIndex - year * 12) + 1;
+    int32_t endOfMonth = days_in_month(year, month);
+    int32_t day = date.day;
+    if (day > endOfMonth || day == days_in_month(date.year, date.month)) {
+        day = endOfMonth;
+    }
+    return days_from_civil(year, month, day) * MICROS_PER_DAY + micros_of_day;
 }
 
 namespace voltdb {
@@ -146,9 +246,9 @@ template<> inline NValue NValue::callUnary<FUNC_EXTRACT_YEAR>() const {
         throwOutOfRangeTimestampInput("YEAR");
     }
 
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    return getIntegerValue(as_date.year());
+    CivilDate as_date;
+    civil_from_epoch_micros(epoch_micros, as_date);
+    return getIntegerValue(as_date.year);
 }
 
 /** implement the timestamp MONTH extract function **/
@@ -166,9 +266,9 @@ template<> inline NValue NValue::callUnary<FUNC_EXTRACT_MONTH>() const {
         throwOutOfRangeTimestampInput("MONTH");
     }
 
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    return getTinyIntValue((int8_t)as_date.month());
+    CivilDate as_date;
+    civil_from_epoch_micros(epoch_micros, as_date);
+    return getTinyIntValue((int8_t)as_date.month);
 }
 
 /** implement the timestamp DAY extract function **/
@@ -186,9 +286,9 @@ template<> inline NValue NValue::callUnary<FUNC_EXTRACT_DAY>() const {
         throwOutOfRangeTimestampInput("DAY");
     }
 
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    return getTinyIntValue((int8_t)as_date.day());
+    CivilDate as_date;
+    civil_from_epoch_micros(epoch_micros, as_date);
+    return getTinyIntValue((int8_t)as_date.day);
 }
 
 /** implement the timestamp DAY OF WEEK extract function **/
@@ -206,9 +306,9 @@ template<> inline NValue NValue::callUnary<FUNC_EXTRACT_DAY_OF_WEEK>() const {
         throwOutOfRangeTimestampInput("DAY_OF_WEEK");
     }
 
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    return getTinyIntValue((int8_t)(as_date.day_of_week() + 1)); // Have 0-based, want 1-based.
+    CivilDate as_date;
+    civil_from_epoch_micros(epoch_micros, as_date);
+    return getTinyIntValue((int8_t)(day_of_week(as_date) + 1)); // Have 0-based, want 1-based.
 }
 
 /** implement the timestamp WEEKDAY extract function **/
@@ -228,9 +328,9 @@ template<> inline NValue NValue::callUnary<FUNC_EXTRACT_WEEKDAY>() const {
         throwOutOfRangeTimestampInput("WEEKDAY");
     }
 
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    return getTinyIntValue((int8_t)((as_date.day_of_week() + 6) % 7));
+    CivilDate as_date;
+    civil_from_epoch_micros(epoch_micros, as_date);
+    return getTinyIntValue((int8_t)((day_of_week(as_date) + 6) % 7));
 }
 
 /** implement the timestamp WEEK OF YEAR extract function **/
@@ -248,9 +348,9 @@ template<> inline NValue NValue::callUnary<FUNC_EXTRACT_WEEK_OF_YEAR>() const {
         throwOutOfRangeTimestampInput("WEEK_OF_YEAR");
     }
 
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    return getTinyIntValue((int8_t)as_date.week_number());
+    CivilDate as_date;
+    civil_from_epoch_micros(epoch_micros, as_date);
+    return getTinyIntValue((int8_t)iso_week_number(as_date));
 }
 
 /** implement the timestamp DAY OF YEAR extract function **/
@@ -268,9 +368,9 @@ template<> inline NValue NValue::callUnary<FUNC_EXTRACT_DAY_OF_YEAR>() const {
         throwOutOfRangeTimestampInput("DAY_OF_YEAR");
     }
 
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    return getSmallIntValue((int16_t)as_date.day_of_year());
+    CivilDate as_date;
+    civil_from_epoch_micros(epoch_micros, as_date);
+    return getSmallIntValue((int16_t)day_of_year(as_date));
 }
 
 /** implement the timestamp QUARTER extract function **/
@@ -288,9 +388,9 @@ template<> inline NValue NValue::callUnary<FUNC_EXTRACT_QUARTER>() const {
         throwOutOfRangeTimestampInput("QUARTER");
     }
 
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    return getTinyIntValue((int8_t)((as_date.month() + 2) / 3));
+    CivilDate as_date;
+    civil_from_epoch_micros(epoch_micros, as_date);
+    return getTinyIntValue((int8_t)((as_date.month + 2) / 3));
 }
 
 /** implement the timestamp HOUR extract function **/
@@ -308,9 +408,8 @@ template<> inline NValue NValue::callUnary<FUNC_EXTRACT_HOUR>() const {
         throwOutOfRangeTimestampInput("HOUR");
     }
 
-    boost::posix_time::time_duration as_time;
-    micros_to_time(epoch_micros, as_time);
-    return getTinyIntValue((int8_t)as_time.hours());
+    int64_t micros_of_day = floor_mod(epoch_micros, MICROS_PER_DAY);
+    return getTinyIntValue((int8_t)(micros_of_day / MICROS_PER_HOUR));
 }
 
 /** implement the timestamp MINUTE extract function **/
@@ -328,9 +427,8 @@ template<> inline NValue NValue::callUnary<FUNC_EXTRACT_MINUTE>() const {
         throwOutOfRangeTimestampInput("MINUTE");
     }
 
-    boost::posix_time::time_duration as_time;
-    micros_to_time(epoch_micros, as_time);
-    return getTinyIntValue((int8_t)as_time.minutes());
+    int64_t micros_of_day = floor_mod(epoch_micros, MICROS_PER_DAY);
+    return getTinyIntValue((int8_t)(micros_of_day / MICROS_PER_MINUTE % 60));
 }
 
 /** implement the timestamp SECOND extract function **/
@@ -348,9 +446,8 @@ template<> inline NValue NValue::callUnary<FUNC_EXTRACT_SECOND>() const {
         throwOutOfRangeTimestampInput("SECOND");
     }
 
-    boost::posix_time::time_duration as_time;
-    micros_to_time(epoch_micros, as_time);
-    int second = as_time.seconds();
+    int64_t micros_of_day = floor_mod(epoch_micros, MICROS_PER_DAY);
+    int second = static_cast<int>(micros_of_day / MICROS_PER_SECOND % 60);
     int fraction = static_cast<int>(epoch_micros % 1000000);
     if (epoch_micros < 0 && fraction != 0) {
         fraction = 1000000 + fraction;
@@ -480,6 +577,76 @@ template<> inline NValue NValue::callUnary<FUNC_TO_TIMESTAMP_MICROSECOND>() cons
     return getTimestampValue(epoch_micros);
 }
 
+/**
+ * TRUNCATE kernels, for epoch_micros already known to be in the supported
+ * range. Units of a day or less line up with the epoch, so truncating to
+ * them needs no calendar at all.
+ */
+template<int F> inline int64_t truncate_epoch_micros(int64_t epoch_micros);
+
+template<> inline int64_t truncate_epoch_micros<FUNC_TRUNCATE_YEAR>(int64_t epoch_micros) {
+    CivilDate as_date;
+    civil_from_epoch_micros(epoch_micros, as_date);
+    return days_from_civil(as_date.year, 1, 1) * MICROS_PER_DAY;
+}
+
+template<> inline int64_t truncate_epoch_micros<FUNC_TRUNCATE_QUARTER>(int64_t epoch_micros) {
+    CivilDate as_date;
+    civil_from_epoch_micros(epoch_micros, as_date);
+    return days_from_civil(as_date.year, QUARTER_START_MONTH_BY_MONTH[as_date.month], 1) * MICROS_PER_DAY;
+}
+
+template<> inline int64_t truncate_epoch_micros<FUNC_TRUNCATE_MONTH>(int64_t epoch_micros) {
+    CivilDate as_date;
+    civil_from_epoch_micros(epoch_micros, as_date);
+    return days_from_civil(as_date.year, as_date.month, 1) * MICROS_PER_DAY;
+}
+
+template<> inline int64_t truncate_epoch_micros<FUNC_TRUNCATE_DAY>(int64_t epoch_micros) {
+    return epoch_micros - floor_mod(epoch_micros, MICROS_PER_DAY);
+}
+
+template<> inline int64_t truncate_epoch_micros<FUNC_TRUNCATE_HOUR>(int64_t epoch_micros) {
+    return epoch_micros - floor_mod(epoch_micros, MICROS_PER_HOUR);
+}
+
+template<> inline int64_t truncate_epoch_micros<FUNC_TRUNCATE_MINUTE>(int64_t epoch_micros) {
+    return epoch_micros - floor_mod(epoch_micros, MICROS_PER_MINUTE);
+}
+
+template<> inline int64_t truncate_epoch_micros<FUNC_TRUNCATE_SECOND>(int64_t epoch_micros) {
+    return epoch_micros - floor_mod(epoch_micros, MICROS_PER_SECOND);
+}
+
+template<> inline int64_t truncate_epoch_micros<FUNC_TRUNCATE_MILLISECOND>(int64_t epoch_micros) {
+    int64_t epoch_millis = static_cast<int64_t>(epoch_micros / 1000);
+    if (epoch_micros < 0) {
+        epoch_millis -= 1;
+    }
+    return epoch_millis * 1000;
+}
+
+template<> inline int64_t truncate_epoch_micros<FUNC_TRUNCATE_MICROSECOND>(int64_t epoch_micros) {
+    return epoch_micros;
+}
+
+/**
+ * Truncate a column of timestamps in place, as TRUNCATE does to each one.
+ * Null timestamps are left as they are; any other value outside the
+ * supported range throws just as TRUNCATE would.
+ */
+template<int F> inline void truncate_epoch_micros(int64_t* epoch_micros, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (epoch_micros[i] == INT64_NULL) {
+            continue;
+        }
+        if (epochMicrosOutOfRange(epoch_micros[i])) {
+            throwOutOfRangeTimestampInput("TRUNCATE");
+        }
+        epoch_micros[i] = truncate_epoch_micros<F>(epoch_micros[i]);
+    }
+}
+
 /** implement the timestamp TRUNCATE to YEAR function **/
 template<> inline NValue NValue::callUnary<FUNC_TRUNCATE_YEAR>() const {
     if (isNull()) {
@@ -495,10 +662,7 @@ template<> inline NValue NValue::callUnary<FUNC_TRUNCATE_YEAR>() const {
         throwOutOfRangeTimestampInput("TRUNCATE");
     }
 
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    int64_t truncate_epoch_micros = epoch_microseconds_from_components(as_date.year());
-    return getTimestampValue(truncate_epoch_micros);
+    return getTimestampValue(truncate_epoch_micros<FUNC_TRUNCATE_YEAR>(epoch_micros));
 }
 
 /** implement the timestamp TRUNCATE to QUARTER function **/
@@ -516,11 +680,7 @@ template<> inline NValue NValue::callUnary<FUNC_TRUNCATE_QUARTER>() const {
         throwOutOfRangeTimestampInput("TRUNCATE");
     }
 
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    int8_t quarter_start_month = QUARTER_START_MONTH_BY_MONTH[as_date.month()];
-    int64_t truncate_epoch_micros = epoch_microseconds_from_components(as_date.year(), quarter_start_month);
-    return getTimestampValue(truncate_epoch_micros);
+    return getTimestampValue(truncate_epoch_micros<FUNC_TRUNCATE_QUARTER>(epoch_micros));
 }
 
 /** implement the timestamp TRUNCATE to MONTH function **/
@@ -538,10 +698,7 @@ template<> inline NValue NValue::callUnary<FUNC_TRUNCATE_MONTH>() const {
         throwOutOfRangeTimestampInput("TRUNCATE");
     }
 
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    int64_t truncate_epoch_micros = epoch_microseconds_from_components(as_date.year(),as_date.month());
-    return getTimestampValue(truncate_epoch_micros);
+    return getTimestampValue(truncate_epoch_micros<FUNC_TRUNCATE_MONTH>(epoch_micros));
 }
 
 /** implement the timestamp TRUNCATE to DAY function **/
@@ -559,11 +716,7 @@ template<> inline NValue NValue::callUnary<FUNC_TRUNCATE_DAY>() const {
         throwOutOfRangeTimestampInput("TRUNCATE");
     }
 
-    boost::gregorian::date as_date;
-    micros_to_date(epoch_micros, as_date);
-    int64_t truncate_epoch_micros =
-            epoch_microseconds_from_components(as_date.year(),as_date.month(), as_date.day());
-    return getTimestampValue(truncate_epoch_micros);
+    return getTimestampValue(truncate_epoch_micros<FUNC_TRUNCATE_DAY>(epoch_micros));
 }
 
 /** implement the timestamp TRUNCATE to HOUR function **/
@@ -581,12 +734,7 @@ template<> inline NValue NValue::callUnary<FUNC_TRUNCATE_HOUR>() const {
         throwOutOfRangeTimestampInput("TRUNCATE");
     }
 
-    boost::gregorian::date as_date;
-    boost::posix_time::time_duration as_time;
-    micros_to_date_and_time(epoch_micros, as_date, as_time);
-    int64_t truncate_epoch_micros = epoch_microseconds_from_components(as_date.year(),as_date.month(),
-            as_date.day(), as_time.hours());
-    return getTimestampValue(truncate_epoch_micros);
+    return getTimestampValue(truncate_epoch_micros<FUNC_TRUNCATE_HOUR>(epoch_micros));
 }
 
 /** implement the timestamp TRUNCATE to MINUTE function **/
@@ -604,12 +752,7 @@ template<> inline NValue NValue::callUnary<FUNC_TRUNCATE_MINUTE>() const {
         throwOutOfRangeTimestampInput("TRUNCATE");
     }
 
-    boost::gregorian::date as_date;
-    boost::posix_time::time_duration as_time;
-    micros_to_date_and_time(epoch_micros, as_date, as_time);
-    int64_t truncate_epoch_micros = epoch_microseconds_from_components(as_date.year(),as_date.month(),
-            as_date.day(), as_time.hours(), as_time.minutes());
-    return getTimestampValue(truncate_epoch_micros);
+    return getTimestampValue(truncate_epoch_micros<FUNC_TRUNCATE_MINUTE>(epoch_micros));
 }
 
 /** implement the timestamp TRUNCATE to SECOND function **/
@@ -627,12 +770,7 @@ template<> inline NValue NValue::callUnary<FUNC_TRUNCATE_SECOND>() const {
         throwOutOfRangeTimestampInput("TRUNCATE");
     }
 
-    boost::gregorian::date as_date;
-    boost::posix_time::time_duration as_time;
-    micros_to_date_and_time(epoch_micros, as_date, as_time);
-    int64_t truncate_epoch_micros = epoch_microseconds_from_components(as_date.year(),as_date.month(),
-            as_date.day(), as_time.hours(), as_time.minutes(),as_time.seconds());
-    return getTimestampValue(truncate_epoch_micros);
+    return getTimestampValue(truncate_epoch_micros<FUNC_TRUNCATE_SECOND>(epoch_micros));
 }
 
 /** implement the timestamp TRUNCATE to MILLIS function **/
@@ -650,11 +788,7 @@ template<> inline NValue NValue::callUnary<FUNC_TRUNCATE_MILLISECOND>() const {
         throwOutOfRangeTimestampInput("TRUNCATE");
     }
 
-    int64_t epoch_millis = static_cast<int64_t>(epoch_micros / 1000);
-    if (epoch_micros < 0) {
-        epoch_millis -= 1;
-    }
-    return getTimestampValue(epoch_millis * 1000);
+    return getTimestampValue(truncate_epoch_micros<FUNC_TRUNCATE_MILLISECOND>(epoch_micros));
 }
 
 /** implement the timestamp TRUNCATE to MICROS function **/
@@ -672,7 +806,7 @@ template<> inline NValue NValue::callUnary<FUNC_TRUNCATE_MICROSECOND>() const {
         throwOutOfRangeTimestampInput("TRUNCATE");
     }
 
-    return getTimestampValue(epoch_micros);
+    return getTimestampValue(truncate_epoch_micros<FUNC_TRUNCATE_MICROSECOND>(epoch_micros));
 }
 
 template<> inline NValue NValue::callConstant<FUNC_CURRENT_TIMESTAMP>() {
@@ -703,26 +837,17 @@ template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_YEAR>(const std::vector<
         throwCastSQLException(date.getValueType(), VALUE_TYPE_TIMESTAMP);
     }
 
-    boost::posix_time::ptime ts;
     int64_t epochMicrosIn = date.getTimestamp();
     if (epochMicrosOutOfRange(epochMicrosIn)) {
         throwOutOfRangeTimestampInput("DATEADD");
     }
 
-    micros_to_ptime(date.getTimestamp(), ts);
-
-    try {
-        ts += boost::gregorian::years(static_cast<int>(interval));
-        boost::posix_time::time_duration td = ts - EPOCH;
-        int64_t epochMicros = td.total_microseconds();
-        if (epochMicrosOutOfRange(epochMicros)) {
-            throwOutOfRangeTimestampOutput("DATEADD");
-        }
-
-        return getTimestampValue(epochMicros);
-    } catch (std::out_of_range &e) {
-        throw SQLException(SQLException::data_exception_numeric_value_out_of_range, "interval is too large for DATEADD function");
+    int64_t epochMicros = addMonths(epochMicrosIn, 12 * interval);
+    if (epochMicrosOutOfRange(epochMicros)) {
+        throwOutOfRangeTimestampOutput("DATEADD");
     }
+
+    return getTimestampValue(epochMicros);
 }
 
 template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_QUARTER>(const std::vector<NValue>& arguments) {
@@ -752,7 +877,7 @@ template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_QUARTER>(const std::vect
         throwOutOfRangeTimestampInput("DATEADD");
     }
 
-    int64_t epochMicros = addMonths(date.getTimestamp(), 3 * interval);
+    int64_t epochMicros = addMonths(epochMicrosIn, 3 * interval);
     if (epochMicrosOutOfRange(epochMicros)) {
         throwOutOfRangeTimestampOutput("DATEADD");
     }
@@ -787,7 +912,7 @@ template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_MONTH>(const std::vector
         throwOutOfRangeTimestampInput("DATEADD");
     }
 
-    int64_t epochMicros = addMonths(date.getTimestamp(), interval);
+    int64_t epochMicros = addMonths(epochMicrosIn, interval);
     if (epochMicrosOutOfRange(epochMicros)) {
         throwOutOfRangeTimestampOutput("DATEADD");
     }
@@ -822,21 +947,12 @@ template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_DAY>(const std::vector<N
         throwOutOfRangeTimestampInput("DATEADD");
     }
 
-    boost::posix_time::ptime ts;
-    micros_to_ptime(date.getTimestamp(), ts);
-
-    try {
-        ts += boost::gregorian::days(interval);
-        boost::posix_time::time_duration td = ts - EPOCH;
-        int64_t epochMicros = td.total_microseconds();
-        if (epochMicrosOutOfRange(epochMicros)) {
-            throwOutOfRangeTimestampOutput("DATEADD");
-        }
-
-        return getTimestampValue(epochMicros);
-    } catch (std::out_of_range &e) {
-        throw SQLException(SQLException::data_exception_numeric_value_out_of_range, "interval is too large for DATEADD function");
+    int64_t epochMicros = epochMicrosIn + interval * MICROS_PER_DAY;
+    if (epochMicrosOutOfRange(epochMicros)) {
+        throwOutOfRangeTimestampOutput("DATEADD");
     }
+
+    return getTimestampValue(epochMicros);
 }
 
 template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_HOUR>(const std::vector<NValue>& arguments) {
@@ -866,21 +982,12 @@ template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_HOUR>(const std::vector<
         throwOutOfRangeTimestampInput("DATEADD");
     }
 
-    boost::posix_time::ptime ts;
-    micros_to_ptime(epochMicrosIn, ts);
-
-    try {
-        ts += boost::posix_time::hours(interval);
-        boost::posix_time::time_duration td = ts - EPOCH;
-        int64_t epochMicros = td.total_microseconds();
-        if (epochMicrosOutOfRange(epochMicros)) {
-            throwOutOfRangeTimestampOutput("DATEADD");
-        }
-
-        return getTimestampValue(epochMicros);
-    } catch (std::out_of_range &e) {
-        throw SQLException(SQLException::data_exception_numeric_value_out_of_range, "interval is too large for DATEADD function");
+    int64_t epochMicros = epochMicrosIn + interval * MICROS_PER_HOUR;
+    if (epochMicrosOutOfRange(epochMicros)) {
+        throwOutOfRangeTimestampOutput("DATEADD");
     }
+
+    return getTimestampValue(epochMicros);
 }
 
 template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_MINUTE>(const std::vector<NValue>& arguments) {
@@ -910,21 +1017,12 @@ template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_MINUTE>(const std::vecto
         throwOutOfRangeTimestampInput("DATEADD");
     }
 
-    boost::posix_time::ptime ts;
-    micros_to_ptime(epochMicrosIn, ts);
-
-    try {
-        ts += boost::posix_time::minutes(interval);
-        boost::posix_time::time_duration td = ts - EPOCH;
-        int64_t epochMicros = td.total_microseconds();
-        if (epochMicrosOutOfRange(epochMicros)) {
-            throwOutOfRangeTimestampOutput("DATEADD");
-        }
-
-        return getTimestampValue(epochMicros);
-    } catch (std::out_of_range &e) {
-        throw SQLException(SQLException::data_exception_numeric_value_out_of_range, "interval is too large for DATEADD function");
+    int64_t epochMicros = epochMicrosIn + interval * MICROS_PER_MINUTE;
+    if (epochMicrosOutOfRange(epochMicros)) {
+        throwOutOfRangeTimestampOutput("DATEADD");
     }
+
+    return getTimestampValue(epochMicros);
 }
 
 template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_SECOND>(const std::vector<NValue>& arguments) {
@@ -954,21 +1052,12 @@ template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_SECOND>(const std::vecto
         throwOutOfRangeTimestampInput("DATEADD");
     }
 
-    boost::posix_time::ptime ts;
-    micros_to_ptime(epochMicrosIn, ts);
-
-    try {
-        ts += boost::posix_time::seconds(interval);
-        boost::posix_time::time_duration td = ts - EPOCH;
-        int64_t epochMicros = td.total_microseconds();
-        if (epochMicrosOutOfRange(epochMicros)) {
-            throwOutOfRangeTimestampOutput("DATEADD");
-        }
-
-        return getTimestampValue(epochMicros);
-    } catch (std::out_of_range &e) {
-        throw SQLException(SQLException::data_exception_numeric_value_out_of_range, "interval is too large in DATEADD function");
+    int64_t epochMicros = epochMicrosIn + interval * MICROS_PER_SECOND;
+    if (epochMicrosOutOfRange(epochMicros)) {
+        throwOutOfRangeTimestampOutput("DATEADD");
     }
+
+    return getTimestampValue(epochMicros);
 }
 
 template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_MILLISECOND>(const std::vector<NValue>& arguments) {
@@ -998,21 +1087,12 @@ template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_MILLISECOND>(const std::
         throwOutOfRangeTimestampInput("DATEADD");
     }
 
-    boost::posix_time::ptime ts;
-    micros_to_ptime(epochMicrosIn, ts);
-
-    try {
-        ts += boost::posix_time::milliseconds(interval);
-        boost::posix_time::time_duration td = ts - EPOCH;
-        int64_t epochMicros = td.total_microseconds();
-        if (epochMicrosOutOfRange(epochMicros)) {
-            throwOutOfRangeTimestampOutput("DATEADD");
-        }
-
-        return getTimestampValue(epochMicros);
-    } catch (std::out_of_range &e) {
-        throw SQLException(SQLException::data_exception_numeric_value_out_of_range, "interval is too large in DATEADD function");
+    int64_t epochMicros = epochMicrosIn + interval * 1000;
+    if (epochMicrosOutOfRange(epochMicros)) {
+        throwOutOfRangeTimestampOutput("DATEADD");
     }
+
+    return getTimestampValue(epochMicros);
 }
 
 template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_MICROSECOND>(const std::vector<NValue>& arguments) {
@@ -1042,21 +1122,12 @@ template<> inline NValue NValue::call<FUNC_VOLT_DATEADD_MICROSECOND>(const std::
         throwOutOfRangeTimestampInput("DATEADD");
     }
 
-    boost::posix_time::ptime ts;
-    micros_to_ptime(epochMicrosIn, ts);
-
-    try {
-        ts += boost::posix_time::microseconds(interval);
-        boost::posix_time::time_duration td = ts - EPOCH;
-        int64_t epochMicros = td.total_microseconds();
-        if (epochMicrosOutOfRange(epochMicros)) {
-            throwOutOfRangeTimestampOutput("DATEADD");
-        }
-
-        return getTimestampValue(epochMicros);
-    } catch (std::out_of_range &e) {
-        throw SQLException(SQLException::data_exception_numeric_value_out_of_range, "interval is too large in DATEADD function");
+    int64_t epochMicros = epochMicrosIn + interval;
+    if (epochMicrosOutOfRange(epochMicros)) {
+        throwOutOfRangeTimestampOutput("DATEADD");
     }
+
+    return getTimestampValue(epochMicros);
 }
 
 const int64_t MIN_VALID_TIMESTAMP_VALUE = GREGORIAN_EPOCH;
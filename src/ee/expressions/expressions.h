@@ -59,6 +59,7 @@
 #include "expressions/tupleaddressexpression.h"
 #include "expressions/tuplevalueexpression.h"
 #include "expressions/hashrangeexpression.h"
+#include "expressions/inlistexpression.h"
 #include "expressions/subqueryexpression.h"
 #include "expressions/scalarvalueexpression.h"
 #include "expressions/vectorcomparisonexpression.hpp"
@@ -277,6 +277,11 @@ ExpressionUtil::comparisonFactory(PlannerDomValue obj, ExpressionType et, Abstra
 {
     assert(lc);
 
+    // An IN list that can't change from row to row is looked up, not scanned.
+    if (et == EXPRESSION_TYPE_COMPARE_IN && rc != NULL && InListExpression::isInvariantList(rc)) {
+        return new InListExpression(lc, rc);
+    }
+
     // more specialization available?
     ConstantValueExpression *l_const =
       dynamic_cast<ConstantValueExpression*>(lc);
@@ -97,6 +97,10 @@ public:
         : AbstractExpression(EXPRESSION_TYPE_FUNCTION) {
     };
 
+    virtual bool isNondeterministic() const {
+        return F == FUNC_CURRENT_TIMESTAMP;
+    }
+
     NValue eval(const TableTuple *, const TableTuple *) const {
         return NValue::callConstant<F>();
     }
@@ -129,6 +133,10 @@ public:
         return m_child->hasParameter();
     }
 
+    virtual bool isNondeterministic() const {
+        return m_child->isNondeterministic();
+    }
+
     NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const {
         assert (m_child);
         return (m_child->eval(tuple1, tuple2)).callUnary<F>();
@@ -168,6 +176,15 @@ public:
         return false;
     }
 
+    virtual bool isNondeterministic() const {
+        for (size_t i = 0; i < m_args.size(); i++) {
+            if (m_args[i]->isNondeterministic()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const {
         //TODO: Could make this vector a member, if the memory management implications
         // (of the NValue internal state) were clear -- is there a penalty for longer-lived
@@ -185,10 +202,39 @@ public:
         return (buffer.str());
     }
 
-private:
+protected:
     const std::vector<AbstractExpression *>& m_args;
 };
 
+/*
+ * N-ary JSON functions taking a path argument (field, set_field).
+ * The path is almost always a constant or a parameter, so the most recently
+ * resolved path is kept and reused for as long as the path text is unchanged.
+ */
+template <int F>
+class JsonPathFunctionExpression : public GeneralFunctionExpression<F> {
+public:
+    JsonPathFunctionExpression(const std::vector<AbstractExpression *>& args)
+        : GeneralFunctionExpression<F>(args) {}
+
+    NValue eval(const TableTuple *tuple1, const TableTuple *tuple2) const {
+        std::vector<NValue> nValue(this->m_args.size());
+        for (int i = 0; i < this->m_args.size(); ++i) {
+            nValue[i] = this->m_args[i]->eval(tuple1, tuple2);
+        }
+        return NValue::call<F>(nValue, m_pathCache);
+    }
+
+    std::string debugInfo(const std::string &spacer) const {
+        std::stringstream buffer;
+        buffer << spacer << "JsonPathFunctionExpression " << F << std::endl;
+        return (buffer.str());
+    }
+
+private:
+    mutable JsonPathCache m_pathCache;
+};
+
 }
 
 using namespace functionexpression;
@@ -525,7 +571,7 @@ ExpressionUtil::functionFactory(int functionId, const std::vector<AbstractExpres
             ret = new GeneralFunctionExpression<FUNC_VOLT_DATEADD_MICROSECOND>(*arguments);
             break;
         case FUNC_VOLT_FIELD:
-            ret = new GeneralFunctionExpression<FUNC_VOLT_FIELD>(*arguments);
+            ret = new JsonPathFunctionExpression<FUNC_VOLT_FIELD>(*arguments);
             break;
         case FUNC_VOLT_FORMAT_CURRENCY:
             ret = new GeneralFunctionExpression<FUNC_VOLT_FORMAT_CURRENCY>(*arguments);
@@ -540,7 +586,7 @@ ExpressionUtil::functionFactory(int functionId, const std::vector<AbstractExpres
             ret = new GeneralFunctionExpression<FUNC_VOLT_REGEXP_POSITION>(*arguments);
             break;
         case FUNC_VOLT_SET_FIELD:
-            ret = new GeneralFunctionExpression<FUNC_VOLT_SET_FIELD>(*arguments);
+            ret = new JsonPathFunctionExpression<FUNC_VOLT_SET_FIELD>(*arguments);
             break;
         case FUNC_VOLT_SQL_ERROR:
             ret = new GeneralFunctionExpression<FUNC_VOLT_SQL_ERROR>(*arguments);
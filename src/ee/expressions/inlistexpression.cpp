@@ -0,0 +1,175 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "expressions/inlistexpression.h"
+
+#include "common/executorcontext.hpp"
+#include "common/SQLException.h"
+#include "common/ValuePeeker.hpp"
+#include "expressions/vectorexpression.h"
+
+#include <algorithm>
+
+namespace voltdb {
+
+static bool isTotallyOrdered(ValueType type) {
+    switch (type) {
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_TIMESTAMP:
+    case VALUE_TYPE_DOUBLE:
+    case VALUE_TYPE_DECIMAL:
+    case VALUE_TYPE_VARCHAR:
+    case VALUE_TYPE_VARBINARY:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void InListLookup::build(const NValue& list)
+{
+    if (list.isNull()) {
+        m_integers.clear();
+        m_values.clear();
+        m_isNullList = true;
+        m_hasNullElement = false;
+        return;
+    }
+    if (ValuePeeker::peekValueType(list) != VALUE_TYPE_ARRAY) {
+        throwDynamicSQLException("rhs of IN expression is of a non-list type %s",
+                                 getTypeName(ValuePeeker::peekValueType(list)).c_str());
+    }
+
+    int length = list.arrayLength();
+    std::vector<NValue> values;
+    values.reserve(length);
+    for (int i = 0; i < length; i++) {
+        values.push_back(list.itemAtIndex(i));
+    }
+    build(values);
+}
+
+void InListLookup::build(const std::vector<NValue>& values)
+{
+    m_integers.clear();
+    m_values.clear();
+    m_values.reserve(values.size());
+    m_isNullList = false;
+    m_hasNullElement = false;
+    m_integersOnly = true;
+    m_isSorted = true;
+    for (size_t i = 0; i < values.size(); i++) {
+        const NValue& item = values[i];
+        if (item.isNull()) {
+            m_hasNullElement = true;
+            continue;
+        }
+        m_integersOnly = m_integersOnly && isIntegralType(ValuePeeker::peekValueType(item));
+        m_isSorted = m_isSorted && isTotallyOrdered(ValuePeeker::peekValueType(item));
+        m_values.push_back(static_cast<const StlFriendlyNValue&>(item));
+    }
+    if (m_integersOnly) {
+        for (size_t i = 0; i < m_values.size(); i++) {
+            m_integers.insert(ValuePeeker::peekAsRawInt64(m_values[i]));
+        }
+    }
+    if (m_isSorted) {
+        std::sort(m_values.begin(), m_values.end());
+    }
+}
+
+bool InListLookup::contains(const NValue& value) const
+{
+    assert( ! value.isNull());
+    if (m_integersOnly && isIntegralType(ValuePeeker::peekValueType(value))) {
+        return m_integers.find(ValuePeeker::peekAsRawInt64(value)) != m_integers.end();
+    }
+    const StlFriendlyNValue& key = static_cast<const StlFriendlyNValue&>(value);
+    if (m_isSorted && isTotallyOrdered(ValuePeeker::peekValueType(value))) {
+        return std::binary_search(m_values.begin(), m_values.end(), key);
+    }
+    return std::find(m_values.begin(), m_values.end(), key) != m_values.end();
+}
+
+InListExpression::InListExpression(AbstractExpression* left, AbstractExpression* right)
+    : AbstractExpression(EXPRESSION_TYPE_COMPARE_IN, left, right)
+    , m_listHasParameter(right->hasParameter())
+    , m_isBuilt(false)
+    , m_builtAtParameterChange(0)
+{ }
+
+bool InListExpression::isInvariantList(const AbstractExpression* list)
+{
+    if (list->getExpressionType() == EXPRESSION_TYPE_VALUE_PARAMETER) {
+        return true;
+    }
+    const VectorExpression* vector = dynamic_cast<const VectorExpression*>(list);
+    if (vector == NULL) {
+        return false;
+    }
+    const std::vector<AbstractExpression*>& args = vector->getArgs();
+    for (size_t i = 0; i < args.size(); i++) {
+        ExpressionType type = args[i]->getExpressionType();
+        if (type != EXPRESSION_TYPE_VALUE_CONSTANT && type != EXPRESSION_TYPE_VALUE_PARAMETER) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const InListLookup& InListExpression::getLookup(const TableTuple* tuple1, const TableTuple* tuple2) const
+{
+    if ( ! m_listHasParameter) {
+        if ( ! m_isBuilt) {
+            m_lookup.build(m_right->eval(tuple1, tuple2));
+            m_isBuilt = true;
+        }
+        return m_lookup;
+    }
+    ExecutorContext* context = ExecutorContext::getExecutorContext();
+    assert(context);
+    int64_t parameterChange = context->getParameterChangeCount();
+    if ( ! m_isBuilt || m_builtAtParameterChange != parameterChange) {
+        m_lookup.build(m_right->eval(tuple1, tuple2));
+        m_isBuilt = true;
+        m_builtAtParameterChange = parameterChange;
+    }
+    return m_lookup;
+}
+
+NValue InListExpression::eval(const TableTuple* tuple1, const TableTuple* tuple2) const
+{
+    NValue lnv = m_left->eval(tuple1, tuple2);
+    if (lnv.isNull()) {
+        return NValue::getNullValue(VALUE_TYPE_BOOLEAN);
+    }
+    const InListLookup& lookup = getLookup(tuple1, tuple2);
+    if (lookup.isNullList()) {
+        return NValue::getNullValue(VALUE_TYPE_BOOLEAN);
+    }
+    return lookup.contains(lnv) ? NValue::getTrue() : NValue::getFalse();
+}
+
+std::string InListExpression::debugInfo(const std::string& spacer) const
+{
+    return spacer + "InListExpression\n";
+}
+
+}
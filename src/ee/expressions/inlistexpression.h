@@ -0,0 +1,97 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INLISTEXPRESSION_H
+#define INLISTEXPRESSION_H
+
+#include "common/StlFriendlyNValue.h"
+#include "expressions/abstractexpression.h"
+
+#include <boost/unordered_set.hpp>
+
+#include <string>
+#include <vector>
+
+namespace voltdb {
+
+/**
+ * The values of an IN list, arranged for lookups: a hash set when all of
+ * them are integers, and a sorted vector in any case, for values of other
+ * types. NULL elements are left out, since they never match.
+ */
+class InListLookup {
+public:
+    InListLookup() : m_isNullList(true), m_hasNullElement(false), m_integersOnly(false), m_isSorted(false) { }
+
+    /** Replace the contents with the values of an ARRAY NValue */
+    void build(const NValue& list);
+
+    /** Replace the contents with the given values, e.g. a column of a subquery result */
+    void build(const std::vector<NValue>& values);
+
+    bool isNullList() const { return m_isNullList; }
+
+    /** Are there no non-NULL values? */
+    bool isEmpty() const { return m_values.empty(); }
+
+    /** Was one of the values left out because it was NULL? */
+    bool hasNullElement() const { return m_hasNullElement; }
+
+    /** Same answer as value.inList(list), for a non-NULL value */
+    bool contains(const NValue& value) const;
+
+private:
+    bool m_isNullList;
+    bool m_hasNullElement;
+    bool m_integersOnly;
+    // False for element types without a total order (e.g. GEOGRAPHY),
+    // which are searched linearly as before.
+    bool m_isSorted;
+    boost::unordered_set<int64_t> m_integers;
+    std::vector<StlFriendlyNValue> m_values;
+};
+
+/**
+ * "x IN (list)" where the list is made of constants and parameters only,
+ * so it is the same for every row until the parameters change. The list
+ * is arranged into an InListLookup when first needed and again only after
+ * ExecutorContext::parametersChanged(), rather than being rebuilt and
+ * scanned for every row.
+ */
+class InListExpression : public AbstractExpression {
+public:
+    InListExpression(AbstractExpression* left, AbstractExpression* right);
+
+    NValue eval(const TableTuple* tuple1, const TableTuple* tuple2) const;
+
+    std::string debugInfo(const std::string& spacer) const;
+
+    /** Can the right hand side of an IN be looked up this way? */
+    static bool isInvariantList(const AbstractExpression* list);
+
+private:
+    const InListLookup& getLookup(const TableTuple* tuple1, const TableTuple* tuple2) const;
+
+    const bool m_listHasParameter;
+    mutable InListLookup m_lookup;
+    mutable bool m_isBuilt;
+    mutable int64_t m_builtAtParameterChange;
+};
+
+}
+
+#endif // INLISTEXPRESSION_H
@@ -19,10 +19,12 @@
 #define JSONFUNCTIONS_H_
 
 #include <cassert>
+#include <cctype>
 #include <cstring>
 #include <string>
 #include <sstream>
 #include <algorithm>
+#include <vector>
 
 #include <jsoncpp/jsoncpp.h>
 #include <jsoncpp/jsoncpp-forwards.h>
@@ -38,125 +40,41 @@ struct JsonPathNode {
     std::string m_field;
 };
 
-/** representation of a JSON document that can be accessed and updated via
-    our path syntax */
-class JsonDocument {
+/** the vector representation of a path in our path syntax, resolved once so that
+    it can be applied to any number of documents */
+class JsonPath {
 public:
-    JsonDocument(const char* docChars, int32_t lenDoc) : m_head(NULL), m_tail(NULL) {
-        if (docChars == NULL) {
-            // null documents have null everything, but they turn into objects/arrays
-            // if we try to set their properties
-            m_doc = Json::Value::null;
-        } else if (!m_reader.parse(docChars, docChars + lenDoc, m_doc)) {
-            // we have something real, but it isn't JSON
-            throwJsonFormattingError();
-        }
-    }
+    JsonPath() : m_head(NULL), m_tail(NULL), m_pos(-1) {}
 
-    std::string value() { return m_writer.write(m_doc); }
-
-    bool get(const char* pathChars, int32_t lenPath, std::string& serializedValue) {
-        if (m_doc.isNull()) {
-            return false;
-        }
-
-        // get and traverse the path
-        std::vector<JsonPathNode> path = resolveJsonPath(pathChars, lenPath);
-        const Json::Value* node = &m_doc;
-        for (std::vector<JsonPathNode>::const_iterator cit = path.begin(); cit != path.end(); ++cit) {
-            const JsonPathNode& pathNode = *cit;
-            if (pathNode.m_arrayIndex != -1) {
-                // can't access an array index of something that isn't an array
-                if (!node->isArray()) {
-                    return false;
-                }
-                int32_t arrayIndex = pathNode.m_arrayIndex;
-                if (arrayIndex == ARRAY_TAIL) {
-                    unsigned int arraySize = node->size();
-                    arrayIndex = arraySize > 0 ? arraySize - 1 : 0;
-                }
-                node = &((*node)[arrayIndex]);
-                if (node->isNull()) {
-                    return false;
-                }
-            } else {
-                // this is a field. only objects have fields
-                if (!node->isObject()) {
-                    return false;
-                }
-                node = &((*node)[pathNode.m_field]);
-                if (node->isNull()) {
-                    return false;
-                }
-            }
-        }
+    JsonPath(const char* pathChars, int32_t lenPath, bool enforceArrayIndexLimitForSet = false)
+        : m_head(NULL), m_tail(NULL), m_pos(-1)
+    {
+        resolve(pathChars, lenPath, enforceArrayIndexLimitForSet);
+    }
 
-        // return the string representation of what we have obtained
-        if (node->isConvertibleTo(Json::stringValue)) {
-            // 'append' is to standardize that there's something to remove. quicker
-            // than substr on the other one, which incurs an extra copy
-            serializedValue = node->asString().append(1, '\n');
-        } else {
-            serializedValue = m_writer.write(*node);
-        }
-        return true;
+    /** an array element path, as used by ARRAY_ELEMENT */
+    explicit JsonPath(int32_t arrayIndex) : m_head(NULL), m_tail(NULL), m_pos(-1) {
+        m_nodes.push_back(JsonPathNode(arrayIndex));
     }
 
-    void set(const char* pathChars, int32_t lenPath, const char* valueChars, int32_t lenValue) {
-        // translate database nulls into JSON nulls, because that's really all that makes
-        // any semantic sense. otherwise, parse the value as JSON
-        Json::Value value;
-        if (lenValue <= 0) {
-            value = Json::Value::null;
-        } else if (!m_reader.parse(valueChars, valueChars + lenValue, value)) {
-            throwJsonFormattingError();
-        }
+    std::vector<JsonPathNode>::const_iterator begin() const { return m_nodes.begin(); }
+    std::vector<JsonPathNode>::const_iterator end() const { return m_nodes.end(); }
 
-        std::vector<JsonPathNode> path = resolveJsonPath(pathChars, lenPath, true /*enforceArrayIndexLimitForSet*/);
-        // the non-const version of the Json::Value [] operator creates a new, null node on attempted
-        // access if none already exists
-        Json::Value* node = &m_doc;
-        for (std::vector<JsonPathNode>::const_iterator cit = path.begin(); cit != path.end(); ++cit) {
-            const JsonPathNode& pathNode = *cit;
-            if (pathNode.m_arrayIndex != -1) {
-                if (!node->isNull() && !node->isArray()) {
-                    // no-op if the update is impossible, I guess?
-                    return;
-                }
-                int32_t arrayIndex = pathNode.m_arrayIndex;
-                if (arrayIndex == ARRAY_TAIL) {
-                    arrayIndex = node->size();
-                }
-                // get or create the specified node
-                node = &((*node)[arrayIndex]);
-            } else {
-                if (!node->isNull() && !node->isObject()) {
-                    return;
-                }
-                node = &((*node)[pathNode.m_field]);
-            }
-        }
-        *node = value;
-    }
+    static const int32_t ARRAY_TAIL = -10;
 
 private:
-    Json::Value m_doc;
-    Json::Reader m_reader;
-    Json::FastWriter m_writer;
+    std::vector<JsonPathNode> m_nodes;
 
     const char* m_head;
     const char* m_tail;
     int32_t m_pos;
 
-    static const int32_t ARRAY_TAIL = -10;
-
     /** parse our path to its vector representation */
-    std::vector<JsonPathNode> resolveJsonPath(const char* pathChars, int32_t lenPath,
-                                              bool enforceArrayIndexLimitForSet = false) {
-        std::vector<JsonPathNode> path;
+    void resolve(const char* pathChars, int32_t lenPath, bool enforceArrayIndexLimitForSet) {
+        std::vector<JsonPathNode>& path = m_nodes;
         // NULL path refers directly to the doc root
         if (pathChars == NULL) {
-            return path;
+            return;
         }
         m_head = pathChars;
         m_tail = m_head + lenPath;
@@ -274,7 +192,6 @@ private:
 
         m_head = NULL;
         m_tail = NULL;
-        return path;
     }
 
     bool readChar(char& c) {
@@ -294,20 +211,496 @@ private:
                            data_exception_invalid_parameter,
                            msg);
     }
+};
+
+/** remembers the most recently resolved path, so that a path argument that is a
+    constant or a parameter is resolved once rather than once per row */
+class JsonPathCache {
+public:
+    JsonPathCache() : m_resolved(false) {}
+
+    const JsonPath& resolve(const char* pathChars, int32_t lenPath, bool enforceArrayIndexLimitForSet = false) {
+        if ( ! m_resolved ||
+             m_pathText.size() != static_cast<size_t>(lenPath) ||
+             ::memcmp(m_pathText.data(), pathChars, lenPath) != 0) {
+            m_resolved = false;
+            // resolving may throw, leaving the cache empty
+            m_path = JsonPath(pathChars, lenPath, enforceArrayIndexLimitForSet);
+            m_pathText.assign(pathChars, lenPath);
+            m_resolved = true;
+        }
+        return m_path;
+    }
+
+private:
+    JsonPath m_path;
+    std::string m_pathText;
+    bool m_resolved;
+};
+
+/** finds the value at a path by scanning the raw document text, skipping over
+    everything off the path without building a Json::Value for it. The whole
+    document is scanned, so a document that is not well-formed anywhere is never
+    answered from the part before the damage. Anything the scanner does not handle
+    itself (comments, escaped field names, input that is not well-formed) is
+    reported as UNRESOLVED, and the caller falls back to a full parse, so error
+    reporting for bad documents is unchanged. */
+class JsonScanner {
+public:
+    enum Outcome {
+        FOUND,
+        NOT_FOUND,
+        UNRESOLVED
+    };
+
+    JsonScanner(const char* docChars, int32_t lenDoc) : m_cursor(docChars), m_end(docChars + lenDoc) {}
+
+    /** on FOUND, [valueBegin, valueEnd) is the text of a non-null value */
+    Outcome find(const JsonPath& path, const char*& valueBegin, const char*& valueEnd) {
+        skipSpaces();
+        Outcome outcome = scanValue(path.begin(), path.end(), valueBegin, valueEnd);
+        skipSpaces();
+        if (outcome == UNRESOLVED || m_cursor != m_end) {
+            return UNRESOLVED;
+        }
+        return outcome;
+    }
+
+private:
+    typedef std::vector<JsonPathNode>::const_iterator PathIterator;
+
+    const char* m_cursor;
+    const char* const m_end;
+
+    /** advance past the value at the cursor, locating the value at the rest of the path within it */
+    Outcome scanValue(PathIterator step, PathIterator last, const char*& valueBegin, const char*& valueEnd) {
+        if (step == last) {
+            valueBegin = m_cursor;
+            if ( ! skipValue()) {
+                return UNRESOLVED;
+            }
+            valueEnd = m_cursor;
+            // JSON nulls are indistinguishable from missing values
+            return (*valueBegin == 'n') ? NOT_FOUND : FOUND;
+        }
+        if (m_cursor != m_end && step->m_arrayIndex != -1 && *m_cursor == '[') {
+            return scanElements(step, last, valueBegin, valueEnd);
+        }
+        if (m_cursor != m_end && step->m_arrayIndex == -1 && *m_cursor == '{') {
+            return scanFields(step, last, valueBegin, valueEnd);
+        }
+        return skipValue() ? NOT_FOUND : UNRESOLVED;
+    }
 
-    void throwJsonFormattingError() const {
+    /** advance past the array at the cursor, locating the path within its given element */
+    Outcome scanElements(PathIterator step, PathIterator last, const char*& valueBegin, const char*& valueEnd) {
+        ++m_cursor;
+        skipSpaces();
+        if (m_cursor != m_end && *m_cursor == ']') {
+            ++m_cursor;
+            return NOT_FOUND;
+        }
+        const int32_t arrayIndex = step->m_arrayIndex;
+        Outcome outcome = NOT_FOUND;
+        for (int32_t i = 0; ; ++i) {
+            skipSpaces();
+            // any element may turn out to be the tail
+            if (i == arrayIndex || arrayIndex == JsonPath::ARRAY_TAIL) {
+                outcome = scanValue(step + 1, last, valueBegin, valueEnd);
+                if (outcome == UNRESOLVED) {
+                    return UNRESOLVED;
+                }
+            } else if ( ! skipValue()) {
+                return UNRESOLVED;
+            }
+            skipSpaces();
+            if (m_cursor == m_end) {
+                return UNRESOLVED;
+            }
+            if (*m_cursor == ']') {
+                ++m_cursor;
+                return outcome;
+            }
+            if (*m_cursor != ',') {
+                return UNRESOLVED;
+            }
+            ++m_cursor;
+        }
+    }
+
+    /**
+     * advance past the object at the cursor, locating the path within its given field.
+     * As in jsoncpp, the last of any duplicated fields wins.
+     */
+    Outcome scanFields(PathIterator step, PathIterator last, const char*& valueBegin, const char*& valueEnd) {
+        ++m_cursor;
+        skipSpaces();
+        if (m_cursor != m_end && *m_cursor == '}') {
+            ++m_cursor;
+            return NOT_FOUND;
+        }
+        const std::string& field = step->m_field;
+        Outcome outcome = NOT_FOUND;
+        while (true) {
+            skipSpaces();
+            if (m_cursor == m_end || *m_cursor != '"') {
+                return UNRESOLVED;
+            }
+            const char* name = m_cursor + 1;
+            if ( ! skipString()) {
+                return UNRESOLVED;
+            }
+            size_t lenName = m_cursor - name - 1;
+            if (std::find(name, name + lenName, '\\') != name + lenName) {
+                // leave escaped names to the full parse
+                return UNRESOLVED;
+            }
+            skipSpaces();
+            if (m_cursor == m_end || *m_cursor != ':') {
+                return UNRESOLVED;
+            }
+            ++m_cursor;
+            skipSpaces();
+            if (lenName == field.size() && ::memcmp(name, field.data(), lenName) == 0) {
+                outcome = scanValue(step + 1, last, valueBegin, valueEnd);
+                if (outcome == UNRESOLVED) {
+                    return UNRESOLVED;
+                }
+            } else if ( ! skipValue()) {
+                return UNRESOLVED;
+            }
+            skipSpaces();
+            if (m_cursor == m_end) {
+                return UNRESOLVED;
+            }
+            if (*m_cursor == '}') {
+                ++m_cursor;
+                return outcome;
+            }
+            if (*m_cursor != ',') {
+                return UNRESOLVED;
+            }
+            ++m_cursor;
+        }
+    }
+
+    void skipSpaces() {
+        while (m_cursor != m_end &&
+               (*m_cursor == ' ' || *m_cursor == '\t' || *m_cursor == '\r' || *m_cursor == '\n')) {
+            ++m_cursor;
+        }
+    }
+
+    /** advance past one complete value, returning false if it is not one we can vouch for */
+    bool skipValue() {
+        if (m_cursor == m_end) {
+            return false;
+        }
+        switch (*m_cursor) {
+        case '{':
+        case '[': {
+            const char close = (*m_cursor == '{') ? '}' : ']';
+            ++m_cursor;
+            skipSpaces();
+            if (m_cursor != m_end && *m_cursor == close) {
+                ++m_cursor;
+                return true;
+            }
+            while (true) {
+                skipSpaces();
+                if (close == '}') {
+                    if (m_cursor == m_end || *m_cursor != '"' || ! skipString()) {
+                        return false;
+                    }
+                    skipSpaces();
+                    if (m_cursor == m_end || *m_cursor != ':') {
+                        return false;
+                    }
+                    ++m_cursor;
+                    skipSpaces();
+                }
+                if ( ! skipValue()) {
+                    return false;
+                }
+                skipSpaces();
+                if (m_cursor == m_end) {
+                    return false;
+                }
+                if (*m_cursor == close) {
+                    ++m_cursor;
+                    return true;
+                }
+                if (*m_cursor != ',') {
+                    return false;
+                }
+                ++m_cursor;
+            }
+        }
+        case '"':
+            return skipString();
+        case 't':
+            return skipLiteral("true", 4);
+        case 'f':
+            return skipLiteral("false", 5);
+        case 'n':
+            return skipLiteral("null", 4);
+        default:
+            return skipNumber();
+        }
+    }
+
+    /** advance past a string with valid escapes, from its opening quote */
+    bool skipString() {
+        assert(*m_cursor == '"');
+        ++m_cursor;
+        while (m_cursor != m_end) {
+            char c = *m_cursor++;
+            if (c == '"') {
+                return true;
+            }
+            if (c == '\0') {
+                return false;
+            }
+            if (c == '\\') {
+                if (m_cursor == m_end) {
+                    return false;
+                }
+                c = *m_cursor++;
+                if (c == 'u') {
+                    if (m_end - m_cursor < 4 || ! isxdigit(m_cursor[0]) || ! isxdigit(m_cursor[1]) ||
+                        ! isxdigit(m_cursor[2]) || ! isxdigit(m_cursor[3])) {
+                        return false;
+                    }
+                    // surrogate pairs get validated by the full parse
+                    if ((m_cursor[0] == 'd' || m_cursor[0] == 'D') && strchr("89abAB", m_cursor[1]) != NULL) {
+                        return false;
+                    }
+                    m_cursor += 4;
+                } else if (strchr("\"\\/bfnrt", c) == NULL || c == '\0') {
+                    return false;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool skipLiteral(const char* literal, int32_t lenLiteral) {
+        if (m_end - m_cursor < lenLiteral || ::memcmp(m_cursor, literal, lenLiteral) != 0) {
+            return false;
+        }
+        m_cursor += lenLiteral;
+        return true;
+    }
+
+    bool skipNumber() {
+        if (m_cursor != m_end && *m_cursor == '-') {
+            ++m_cursor;
+        }
+        if ( ! skipDigits()) {
+            return false;
+        }
+        if (m_cursor != m_end && *m_cursor == '.') {
+            ++m_cursor;
+            if ( ! skipDigits()) {
+                return false;
+            }
+        }
+        if (m_cursor != m_end && (*m_cursor == 'e' || *m_cursor == 'E')) {
+            ++m_cursor;
+            if (m_cursor != m_end && (*m_cursor == '+' || *m_cursor == '-')) {
+                ++m_cursor;
+            }
+            if ( ! skipDigits()) {
+                return false;
+            }
+        }
+        // anything that still looks like part of a number is for the full parse to judge
+        return m_cursor == m_end || strchr("0123456789.eE+-", *m_cursor) == NULL || *m_cursor == '\0';
+    }
+
+    bool skipDigits() {
+        const char* start = m_cursor;
+        while (m_cursor != m_end && *m_cursor >= '0' && *m_cursor <= '9') {
+            ++m_cursor;
+        }
+        return m_cursor != start;
+    }
+};
+
+/** representation of a JSON document that can be accessed and updated via
+    our path syntax */
+class JsonDocument {
+public:
+    JsonDocument(const char* docChars, int32_t lenDoc) {
+        if (docChars == NULL) {
+            // null documents have null everything, but they turn into objects/arrays
+            // if we try to set their properties
+            m_doc = Json::Value::null;
+        } else if (!m_reader.parse(docChars, docChars + lenDoc, m_doc)) {
+            // we have something real, but it isn't JSON
+            throwJsonFormattingError(m_reader);
+        }
+    }
+
+    std::string value() { return m_writer.write(m_doc); }
+
+    bool get(const JsonPath& path, std::string& serializedValue) {
+        if (m_doc.isNull()) {
+            return false;
+        }
+
+        // traverse the path
+        const Json::Value* node = &m_doc;
+        for (std::vector<JsonPathNode>::const_iterator cit = path.begin(); cit != path.end(); ++cit) {
+            const JsonPathNode& pathNode = *cit;
+            if (pathNode.m_arrayIndex != -1) {
+                // can't access an array index of something that isn't an array
+                if (!node->isArray()) {
+                    return false;
+                }
+                int32_t arrayIndex = pathNode.m_arrayIndex;
+                if (arrayIndex == JsonPath::ARRAY_TAIL) {
+                    unsigned int arraySize = node->size();
+                    arrayIndex = arraySize > 0 ? arraySize - 1 : 0;
+                }
+                node = &((*node)[arrayIndex]);
+                if (node->isNull()) {
+                    return false;
+                }
+            } else {
+                // this is a field. only objects have fields
+                if (!node->isObject()) {
+                    return false;
+                }
+                node = &((*node)[pathNode.m_field]);
+                if (node->isNull()) {
+                    return false;
+                }
+            }
+        }
+
+        serialize(*node, m_writer, serializedValue);
+        return true;
+    }
+
+    void set(const JsonPath& path, const char* valueChars, int32_t lenValue) {
+        // translate database nulls into JSON nulls, because that's really all that makes
+        // any semantic sense. otherwise, parse the value as JSON
+        Json::Value value;
+        if (lenValue <= 0) {
+            value = Json::Value::null;
+        } else if (!m_reader.parse(valueChars, valueChars + lenValue, value)) {
+            throwJsonFormattingError(m_reader);
+        }
+
+        // the non-const version of the Json::Value [] operator creates a new, null node on attempted
+        // access if none already exists
+        Json::Value* node = &m_doc;
+        for (std::vector<JsonPathNode>::const_iterator cit = path.begin(); cit != path.end(); ++cit) {
+            const JsonPathNode& pathNode = *cit;
+            if (pathNode.m_arrayIndex != -1) {
+                if (!node->isNull() && !node->isArray()) {
+                    // no-op if the update is impossible, I guess?
+                    return;
+                }
+                int32_t arrayIndex = pathNode.m_arrayIndex;
+                if (arrayIndex == JsonPath::ARRAY_TAIL) {
+                    arrayIndex = node->size();
+                }
+                // get or create the specified node
+                node = &((*node)[arrayIndex]);
+            } else {
+                if (!node->isNull() && !node->isObject()) {
+                    return;
+                }
+                node = &((*node)[pathNode.m_field]);
+            }
+        }
+        *node = value;
+    }
+
+    /**
+     * Get the value at a path without parsing the whole document when possible.
+     * Returns false for missing values and JSON nulls. Otherwise the value is either
+     * a plain string or boolean pointed to directly within the document, or has been
+     * serialized into 'buffer', which like get() leaves a trailing newline that is not
+     * counted in lenValue.
+     */
+    static bool extract(const char* docChars, int32_t lenDoc, const JsonPath& path,
+                        const char*& valueChars, int32_t& lenValue, std::string& buffer) {
+        const char* valueBegin;
+        const char* valueEnd;
+        JsonScanner scanner(docChars, lenDoc);
+        switch (scanner.find(path, valueBegin, valueEnd)) {
+        case JsonScanner::NOT_FOUND:
+            return false;
+        case JsonScanner::FOUND:
+            if (*valueBegin == '"' && std::find(valueBegin, valueEnd, '\\') == valueEnd) {
+                // no escapes, so the string is its own decoding
+                valueChars = valueBegin + 1;
+                lenValue = static_cast<int32_t>(valueEnd - valueBegin - 2);
+                return true;
+            }
+            if (*valueBegin == 't' || *valueBegin == 'f') {
+                valueChars = valueBegin;
+                lenValue = static_cast<int32_t>(valueEnd - valueBegin);
+                return true;
+            }
+            {
+                // only the found value needs a full parse, to normalize it exactly as before
+                Json::Value node;
+                Json::Reader reader;
+                if (reader.parse(valueBegin, valueEnd, node)) {
+                    Json::FastWriter writer;
+                    serialize(node, writer, buffer);
+                    valueChars = buffer.c_str();
+                    lenValue = static_cast<int32_t>(buffer.length() - 1);
+                    return true;
+                }
+            }
+            break;
+        case JsonScanner::UNRESOLVED:
+            break;
+        }
+        JsonDocument doc(docChars, lenDoc);
+        if (doc.get(path, buffer)) {
+            valueChars = buffer.c_str();
+            lenValue = static_cast<int32_t>(buffer.length() - 1);
+            return true;
+        }
+        return false;
+    }
+
+private:
+    Json::Value m_doc;
+    Json::Reader m_reader;
+    Json::FastWriter m_writer;
+
+    /** the string representation of a node, with a trailing newline */
+    static void serialize(const Json::Value& node, Json::FastWriter& writer, std::string& serializedValue) {
+        if (node.isConvertibleTo(Json::stringValue)) {
+            // 'append' is to standardize that there's something to remove. quicker
+            // than substr on the other one, which incurs an extra copy
+            serializedValue = node.asString().append(1, '\n');
+        } else {
+            serializedValue = writer.write(node);
+        }
+    }
+
+    static void throwJsonFormattingError(const Json::Reader& reader) {
         char msg[1024];
         // getFormatedErrorMessages returns concise message about location
         // of the error rather than the malformed document itself
-        snprintf(msg, sizeof(msg), "Invalid JSON %s", m_reader.getFormatedErrorMessages().c_str());
+        snprintf(msg, sizeof(msg), "Invalid JSON %s", reader.getFormatedErrorMessages().c_str());
         throw SQLException(SQLException::
                            data_exception_invalid_parameter,
                            msg);
     }
 };
 
-/** implement the 2-argument SQL FIELD function */
-template<> inline NValue NValue::call<FUNC_VOLT_FIELD>(const std::vector<NValue>& arguments) {
+/** implement the 2-argument SQL FIELD function, reusing the path resolved by an earlier call */
+template<> inline NValue NValue::call<FUNC_VOLT_FIELD, JsonPathCache>(const std::vector<NValue>& arguments,
+                                                                     JsonPathCache& pathCache) {
     assert(arguments.size() == 2);
 
     const NValue& docNVal = arguments[0];
@@ -327,19 +720,27 @@ template<> inline NValue NValue::call<FUNC_VOLT_FIELD>(const std::vector<NValue>
         throwCastSQLException(pathNVal.getValueType(), VALUE_TYPE_VARCHAR);
     }
 
-    int32_t lenDoc;
-    const char* docChars = docNVal.getObject_withoutNull(&lenDoc);
-    JsonDocument doc(docChars, lenDoc);
-
     int32_t lenPath;
     const char* pathChars = pathNVal.getObject_withoutNull(&lenPath);
-    std::string result;
-    if (doc.get(pathChars, lenPath, result)) {
-        return getTempStringValue(result.c_str(), result.length() - 1);
+    const JsonPath& path = pathCache.resolve(pathChars, lenPath);
+
+    int32_t lenDoc;
+    const char* docChars = docNVal.getObject_withoutNull(&lenDoc);
+    const char* valueChars;
+    int32_t lenValue;
+    std::string buffer;
+    if (JsonDocument::extract(docChars, lenDoc, path, valueChars, lenValue, buffer)) {
+        return getTempStringValue(valueChars, lenValue);
     }
     return getNullStringValue();
 }
 
+/** implement the 2-argument SQL FIELD function */
+template<> inline NValue NValue::call<FUNC_VOLT_FIELD>(const std::vector<NValue>& arguments) {
+    JsonPathCache pathCache;
+    return call<FUNC_VOLT_FIELD>(arguments, pathCache);
+}
+
 /** implement the 2-argument SQL ARRAY_ELEMENT function */
 template<> inline NValue NValue::call<FUNC_VOLT_ARRAY_ELEMENT>(const std::vector<NValue>& arguments) {
     assert(arguments.size() == 2);
@@ -358,52 +759,25 @@ template<> inline NValue NValue::call<FUNC_VOLT_ARRAY_ELEMENT>(const std::vector
     }
     int32_t lenDoc;
     const char* docChars = docNVal.getObject_withoutNull(&lenDoc);
-    const std::string doc(docChars, lenDoc);
 
     int32_t index = indexNVal.castAsIntegerAndGetValue();
 
-    Json::Value root;
-    Json::Reader reader;
-
-    if ( ! reader.parse(doc, root)) {
-        char msg[1024];
-        // getFormatedErrorMessages returns concise message about location
-        // of the error rather than the malformed document itself
-        snprintf(msg, sizeof(msg), "Invalid JSON %s", reader.getFormatedErrorMessages().c_str());
-        throw SQLException(SQLException::
-                           data_exception_invalid_parameter,
-                           msg);
-    }
-
-    // only array type contains elements. objects, primitives do not
-    if ( ! root.isArray()) {
-        return getNullStringValue();
-    }
-
-    // Sure, root[-1].isNull() would return true just like we want it to
-    // -- but only in production with asserts turned off.
-    // Turn on asserts for debugging and you'll want this guard up front.
-    // Forcing the null return for a negative index seems more consistent than crashing in debug mode
-    // or even throwing an SQL error in any mode. It's the same handling that a too large index gets.
+    // Forcing the null return for a negative index seems more consistent than
+    // throwing an SQL error. It's the same handling that a too large index gets.
     if (index < 0) {
+        // still report a malformed document, as for any other index
+        JsonDocument validated(docChars, lenDoc);
         return getNullStringValue();
     }
 
-    Json::Value fieldValue = root[index];
-
-    if (fieldValue.isNull()) {
-        return getNullStringValue();
-    }
-
-    if (fieldValue.isConvertibleTo(Json::stringValue)) {
-        std::string stringValue(fieldValue.asString());
-        return getTempStringValue(stringValue.c_str(), stringValue.length());
+    // only array type contains elements. objects, primitives do not
+    const char* valueChars;
+    int32_t lenValue;
+    std::string buffer;
+    if (JsonDocument::extract(docChars, lenDoc, JsonPath(index), valueChars, lenValue, buffer)) {
+        return getTempStringValue(valueChars, lenValue);
     }
-
-    Json::FastWriter writer;
-    std::string serializedValue(writer.write(fieldValue));
-    // writer always appends a trailing new line \n
-    return getTempStringValue(serializedValue.c_str(), serializedValue.length() -1);
+    return getNullStringValue();
 }
 
 /** implement the 1-argument SQL ARRAY_LENGTH function */
@@ -444,8 +818,9 @@ template<> inline NValue NValue::callUnary<FUNC_VOLT_ARRAY_LENGTH>() const {
     return result;
 }
 
-/** implement the 3-argument SQL SET_FIELD function */
-template<> inline NValue NValue::call<FUNC_VOLT_SET_FIELD>(const std::vector<NValue>& arguments) {
+/** implement the 3-argument SQL SET_FIELD function, reusing the path resolved by an earlier call */
+template<> inline NValue NValue::call<FUNC_VOLT_SET_FIELD, JsonPathCache>(const std::vector<NValue>& arguments,
+                                                                         JsonPathCache& pathCache) {
     assert(arguments.size() == 3);
 
     const NValue& docNVal = arguments[0];
@@ -482,11 +857,12 @@ template<> inline NValue NValue::call<FUNC_VOLT_SET_FIELD>(const std::vector<NVa
 
     int32_t lenPath;
     const char* pathChars = pathNVal.getObject_withoutNull(&lenPath);
+    const JsonPath& path = pathCache.resolve(pathChars, lenPath, true /*enforceArrayIndexLimitForSet*/);
     int32_t lenValue;
     const char* valueChars = valueNVal.getObject_withoutNull(&lenValue);
 
     try {
-        doc.set(pathChars, lenPath, valueChars, lenValue);
+        doc.set(path, valueChars, lenValue);
         std::string value = doc.value();
         return getTempStringValue(value.c_str(), value.length() - 1);
     }
@@ -498,6 +874,12 @@ template<> inline NValue NValue::call<FUNC_VOLT_SET_FIELD>(const std::vector<NVa
     }
 }
 
+/** implement the 3-argument SQL SET_FIELD function */
+template<> inline NValue NValue::call<FUNC_VOLT_SET_FIELD>(const std::vector<NValue>& arguments) {
+    JsonPathCache pathCache;
+    return call<FUNC_VOLT_SET_FIELD>(arguments, pathCache);
+}
+
 }
 
 
@@ -67,6 +67,7 @@ public:
 
     // Constructor to use for testing purposes
     ParameterValueExpression(int value_idx, voltdb::NValue* paramValue) :
+        AbstractExpression(EXPRESSION_TYPE_VALUE_PARAMETER),
         m_valueIdx(value_idx), m_paramValue(paramValue) {
     }
 
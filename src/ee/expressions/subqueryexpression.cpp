@@ -24,8 +24,14 @@
 #include "common/NValue.hpp"
 #include "common/ValueFactory.hpp"
 #include "common/tabletuple.h"
+#include "executors/abstractexecutor.h"
+#include "expressions/inlistexpression.h"
+#include "expressions/subqueryresultmemo.h"
+#include "expressions/vectorcomparisonexpression.hpp"
+#include "plannodes/abstractplannode.h"
 #include "storage/table.h"
 #include "storage/tableiterator.h"
+#include "storage/temptable.h"
 
 
 namespace voltdb {
@@ -91,6 +97,7 @@ NValue SubqueryExpression::eval(const TableTuple *tuple1, const TableTuple *tupl
             }
             // Update the value stored in the executor context's parameter container:
             prevParam = param.copyNValue();
+            exeContext->parametersChanged();
         }
     }
 
@@ -119,6 +126,27 @@ NValue SubqueryExpression::eval(const TableTuple *tuple1, const TableTuple *tupl
         }
     }
 
+    // A correlated subquery may have been run with these parameters before,
+    // just not most recently.
+    SubqueryResultMemo::Key memoKey;
+    TempTable* outputTable = NULL;
+    if (m_tveParams.get() != NULL) {
+        outputTable = exeContext->getExecutors(m_subqueryId).back()->getPlanNode()->getTempOutputTable();
+        memoKey.reserve(m_paramIdxs.size() + m_otherParamIdxs.size());
+        for (size_t i = 0; i < m_paramIdxs.size(); ++i) {
+            memoKey.push_back(parameterContainer[m_paramIdxs[i]]);
+        }
+        for (size_t i = 0; i < m_otherParamIdxs.size(); ++i) {
+            memoKey.push_back(parameterContainer[m_otherParamIdxs[i]].copyNValue());
+        }
+        if (context != NULL && context->getMemo() != NULL && outputTable != NULL &&
+                context->getMemo()->restore(memoKey, outputTable)) {
+            NValue retval = ValueFactory::getIntegerValue(m_subqueryId);
+            context->setResult(retval);
+            return retval;
+        }
+    }
+
     // Out of luck. Need to run the executors. Clean up the output tables with cached results
     exeContext->cleanupExecutorsForSubquery(m_subqueryId);
     UniqueTempTableResult result = exeContext->executeExecutors(m_subqueryId);
@@ -139,12 +167,68 @@ NValue SubqueryExpression::eval(const TableTuple *tuple1, const TableTuple *tupl
         context = exeContext->setSubqueryContext(m_subqueryId, lastParams);
     }
 
+    if (outputTable != NULL) {
+        if (context->getMemo() == NULL) {
+            context->setMemo(boost::shared_ptr<SubqueryResultMemo>(new SubqueryResultMemo()));
+        }
+        context->getMemo()->remember(memoKey, outputTable);
+    }
+
     // Update the cached result for the current params. All params are already updated
     NValue retval = ValueFactory::getIntegerValue(m_subqueryId);
     context->setResult(retval);
     return retval;
 }
 
+template <>
+bool lookupAnyInSubqueryResult<CmpEq, NValueExtractor, TupleExtractor>(const NValue& lvalue,
+                                                                       const NValue& rvalue,
+                                                                       NValue& result)
+{
+    int subqueryId = ValuePeeker::peekInteger(rvalue);
+    ExecutorContext* exeContext = ExecutorContext::getExecutorContext();
+    SubqueryContext* context = exeContext->getSubqueryContext(subqueryId);
+    if (context == NULL || ! context->hasValidResult()) {
+        return false;
+    }
+    InListLookup* lookup = context->getResultLookup();
+    if (lookup == NULL) {
+        // A result that is only searched once is cheaper to scan
+        Table* table = exeContext->getSubqueryOutputTable(subqueryId);
+        if (table->columnCount() != 1 || context->noteResultProbe() < 2) {
+            return false;
+        }
+        std::vector<NValue> values;
+        values.reserve(table->activeTupleCount());
+        TableTuple tuple(table->schema());
+        TableIterator& iterator = table->iterator();
+        while (iterator.next(tuple)) {
+            values.push_back(tuple.getNValue(0));
+        }
+        lookup = new InListLookup();
+        context->setResultLookup(boost::shared_ptr<InListLookup>(lookup));
+        lookup->build(values);
+    }
+
+    // The same answers as the scan in VectorComparisonExpression::eval
+    if (lookup->isEmpty() && ! lookup->hasNullElement()) {
+        result = NValue::getFalse();
+    }
+    else if (lvalue.isNull()) {
+        result = NValue::getNullValue(VALUE_TYPE_BOOLEAN);
+    }
+    else if (lookup->contains(lvalue)) {
+        result = NValue::getTrue();
+    }
+    else if (lookup->hasNullElement()) {
+        result = NValue::getNullValue(VALUE_TYPE_BOOLEAN);
+    }
+    else {
+        result = NValue::getFalse();
+    }
+    return true;
+}
+
 std::string SubqueryExpression::debugInfo(const std::string &spacer) const
 {
     std::ostringstream buffer;
@@ -0,0 +1,88 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "expressions/subqueryresultmemo.h"
+
+#include "storage/temptable.h"
+#include "storage/tableiterator.h"
+
+#include <cassert>
+#include <cstring>
+
+namespace voltdb {
+
+SubqueryResultMemo::SubqueryResultMemo(int64_t memoryBudget)
+    : m_memoryBudget(memoryBudget)
+    , m_memoryUsed(0)
+{ }
+
+bool SubqueryResultMemo::restore(const Key& key, TempTable* table)
+{
+    EntryMap::iterator it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        return false;
+    }
+    table->deleteAllTempTuples();
+    Rows& rows = it->second;
+    m_uses.splice(m_uses.begin(), m_uses, rows.use);
+    const size_t tupleLength = table->schema()->tupleLength() + TUPLE_HEADER_SIZE;
+    TableTuple tuple(table->schema());
+    for (int64_t i = 0; i < rows.count; i++) {
+        tuple.move(&rows.data[i * tupleLength]);
+        table->insertTempTuple(tuple);
+    }
+    return true;
+}
+
+void SubqueryResultMemo::remember(const Key& key, TempTable* table)
+{
+    const size_t tupleLength = table->schema()->tupleLength() + TUPLE_HEADER_SIZE;
+    const int64_t rowCount = table->activeTupleCount();
+    const int64_t footprint = rowCount * tupleLength + key.size() * sizeof(NValue) + sizeof(Rows);
+    if (footprint > m_memoryBudget) {
+        return;
+    }
+    while ( ! m_uses.empty() &&
+            (m_entries.size() >= MAX_ENTRIES || m_memoryUsed + footprint > m_memoryBudget)) {
+        evictLeastRecentlyUsed();
+    }
+
+    Rows& rows = m_entries[key];
+    rows.count = rowCount;
+    rows.footprint = footprint;
+    rows.data.resize(rowCount * tupleLength);
+    rows.use = m_uses.insert(m_uses.begin(), key);
+    TableTuple tuple(table->schema());
+    TableIterator& iterator = table->iterator();
+    char* target = rows.data.empty() ? NULL : &rows.data[0];
+    while (iterator.next(tuple)) {
+        ::memcpy(target, tuple.address(), tupleLength);
+        target += tupleLength;
+    }
+    m_memoryUsed += footprint;
+}
+
+void SubqueryResultMemo::evictLeastRecentlyUsed()
+{
+    EntryMap::iterator it = m_entries.find(m_uses.back());
+    assert(it != m_entries.end());
+    m_memoryUsed -= it->second.footprint;
+    m_entries.erase(it);
+    m_uses.pop_back();
+}
+
+}
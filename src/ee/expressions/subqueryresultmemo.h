@@ -0,0 +1,117 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SUBQUERYRESULTMEMO_H
+#define SUBQUERYRESULTMEMO_H
+
+#include "common/NValue.hpp"
+
+#include <boost/unordered_map.hpp>
+
+#include <list>
+#include <vector>
+
+namespace voltdb {
+
+class TempTable;
+
+/**
+ * The results of a correlated subquery for each of the parameter values it
+ * has been run with during a fragment, so that outer rows with a value seen
+ * before, but not just before, need not run the subquery again.
+ *
+ * Rows are kept as shallow copies of the output tuples, which is fine because
+ * the memo lives only as long as the fragment's temp strings. The memo has a
+ * memory budget of its own, apart from the fragment's TempTableLimits, so it
+ * never crowds out the temp tables of the query. Once it holds MAX_ENTRIES or
+ * its budget is spent, the least recently used entries are evicted to make
+ * room for new ones.
+ */
+class SubqueryResultMemo {
+public:
+    /** Values of the subquery's parameters, correlated ones first */
+    typedef std::vector<NValue> Key;
+
+    static const size_t MAX_ENTRIES = 4096;
+    static const int64_t DEFAULT_MEMORY_BUDGET = 16 * 1024 * 1024;
+
+    SubqueryResultMemo(int64_t memoryBudget = DEFAULT_MEMORY_BUDGET);
+
+    /**
+     * Replace the contents of the table with the rows remembered for the key,
+     * and mark them as recently used.
+     * Returns false, leaving the table alone, if there are none.
+     */
+    bool restore(const Key& key, TempTable* table);
+
+    /**
+     * Remember the rows of the table for the key, evicting the least recently
+     * used entries if needed. A result bigger than the whole budget is not kept.
+     */
+    void remember(const Key& key, TempTable* table);
+
+    size_t entryCount() const { return m_entries.size(); }
+    int64_t memoryUsed() const { return m_memoryUsed; }
+
+private:
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const {
+            std::size_t seed = 0;
+            for (size_t i = 0; i < key.size(); i++) {
+                key[i].hashCombine(seed);
+            }
+            return seed;
+        }
+    };
+
+    struct KeyEqual {
+        bool operator()(const Key& lhs, const Key& rhs) const {
+            if (lhs.size() != rhs.size()) {
+                return false;
+            }
+            for (size_t i = 0; i < lhs.size(); i++) {
+                if (lhs[i].compare(rhs[i]) != VALUE_COMPARE_EQUAL) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    /** Keys from the most to the least recently used */
+    typedef std::list<Key> UseList;
+
+    struct Rows {
+        int64_t count;
+        int64_t footprint;
+        std::vector<char> data;
+        UseList::iterator use;
+    };
+
+    typedef boost::unordered_map<Key, Rows, KeyHash, KeyEqual> EntryMap;
+
+    void evictLeastRecentlyUsed();
+
+    EntryMap m_entries;
+    UseList m_uses;
+    const int64_t m_memoryBudget;
+    int64_t m_memoryUsed;
+};
+
+}
+
+#endif // SUBQUERYRESULTMEMO_H
@@ -280,6 +280,27 @@ private:
     int64_t m_size;
 };
 
+/**
+ * Try to answer "outer_expr OP ANY inner_expr" without scanning the subquery
+ * result, setting result and returning true if that was possible. Only
+ * "value = ANY (SELECT column ...)" can be looked up; see the specialization.
+ */
+template <typename OP, typename ValueExtractorOuter, typename ValueExtractorInner>
+inline bool lookupAnyInSubqueryResult(const NValue& lvalue, const NValue& rvalue, NValue& result)
+{
+    return false;
+}
+
+/**
+ * Once a subquery result has been searched more than once, its values are
+ * arranged into an InListLookup kept in its SubqueryContext, so that an
+ * uncorrelated IN (SELECT ...) becomes a hash semi-join.
+ */
+template <>
+bool lookupAnyInSubqueryResult<CmpEq, NValueExtractor, TupleExtractor>(const NValue& lvalue,
+                                                                       const NValue& rvalue,
+                                                                       NValue& result);
+
 template <typename OP, typename ValueExtractorOuter, typename ValueExtractorInner>
 NValue VectorComparisonExpression<OP, ValueExtractorOuter, ValueExtractorInner>::eval(const TableTuple *tuple1, const TableTuple *tuple2) const
 {
@@ -320,6 +341,12 @@ NValue VectorComparisonExpression<OP, ValueExtractorOuter, ValueExtractorInner>:
 
     // Evaluate the inner_expr. The return value is a subquery id or a value as well
     NValue rvalue = m_right->eval(tuple1, tuple2);
+    if (m_quantifier == QUANTIFIER_TYPE_ANY) {
+        NValue result;
+        if (lookupAnyInSubqueryResult<OP, ValueExtractorOuter, ValueExtractorInner>(lvalue, rvalue, result)) {
+            return result;
+        }
+    }
     ValueExtractorInner innerExtractor(rvalue);
     if (m_quantifier == QUANTIFIER_TYPE_NONE && innerExtractor.resultSize() > 1) {
         // throw runtime exception
@@ -766,6 +766,87 @@ private:
     const TupleSchema *m_keySchema;
 };
 
+struct PrefixedTupleKeyComparator;
+
+/*
+ * PrefixedTupleKey is the TupleKey for indexes whose first key column is
+ * a VARCHAR table column (not an expression). Each key also carries the
+ * first bytes of that column's value as an integer whose order agrees
+ * with the order of the full strings, so that most comparisons of long
+ * string keys are settled without reading either tuple or its
+ * out-of-line string.
+ *
+ * TableIndexPicker chooses it only for such indexes; every other TupleKey
+ * index keeps the plain, smaller key.
+ */
+struct PrefixedTupleKey : public TupleKey
+{
+    typedef PrefixedTupleKeyComparator KeyComparator;
+
+    friend struct PrefixedTupleKeyComparator;
+
+    inline PrefixedTupleKey() : TupleKey(), m_prefix(0), m_hasPrefix(false) {}
+
+    // Set a key from a key-schema tuple.
+    PrefixedTupleKey(const TableTuple *tuple) : TupleKey(tuple) {
+        setPrefix(tuple->getNValue(0));
+    }
+
+    // Set a key from a table-schema tuple.
+    PrefixedTupleKey(const TableTuple *tuple, const std::vector<int> &indices,
+                     const std::vector<AbstractExpression*> &indexed_expressions,
+                     const TupleSchema *keySchema)
+        : TupleKey(tuple, indices, indexed_expressions, keySchema) {
+        assert(indexed_expressions.size() == 0);
+        setPrefix(tuple->getNValue(indices[0]));
+    }
+
+    // Pack the first bytes of a VARCHAR value, up to any NUL, into the
+    // high-order end of an integer. NValue compares strings with strncmp,
+    // which stops at a NUL, and then by length, so two values whose
+    // prefixes differ compare in the same order as their prefixes.
+    static uint64_t normalizedPrefix(const NValue &value) {
+        int32_t length;
+        const char *bytes = ValuePeeker::peekObject_withoutNull(value, &length);
+        uint64_t prefix = 0;
+        bool ended = false;
+        for (int ii = 0; ii < static_cast<int>(sizeof(prefix)); ++ii) {
+            ended = ended || ii >= length || bytes[ii] == '\0';
+            prefix = (prefix << 8) | (ended ? 0 : static_cast<unsigned char>(bytes[ii]));
+        }
+        return prefix;
+    }
+
+private:
+    // NULLs get no prefix and are left to NValue
+    void setPrefix(const NValue &value) {
+        assert(ValuePeeker::peekValueType(value) == VALUE_TYPE_VARCHAR);
+        m_hasPrefix = ! value.isNull();
+        m_prefix = m_hasPrefix ? normalizedPrefix(value) : 0;
+    }
+
+    uint64_t m_prefix;
+    bool m_hasPrefix;
+};
+
+/**
+ * Required by CompactingMap keyed by PrefixedTupleKey
+ */
+struct PrefixedTupleKeyComparator : public TupleKeyComparator
+{
+    PrefixedTupleKeyComparator(const TupleSchema *keySchema) : TupleKeyComparator(keySchema) {}
+
+    // return -1/0/1 if lhs </==/> rhs
+    inline int operator()(const PrefixedTupleKey &lhs, const PrefixedTupleKey &rhs) const {
+        // Different prefixes order the first column, and so the keys;
+        // only a tie needs the values themselves.
+        if (lhs.m_hasPrefix && rhs.m_hasPrefix && lhs.m_prefix != rhs.m_prefix) {
+            return lhs.m_prefix < rhs.m_prefix ? VALUE_COMPARE_LESSTHAN : VALUE_COMPARE_GREATERTHAN;
+        }
+        return TupleKeyComparator::operator()(lhs, rhs);
+    }
+};
+
 static inline int comparePointer(const void *lhs, const void *rhs) {
     const uintptr_t l = reinterpret_cast<const uintptr_t>(lhs);
     const uintptr_t r = reinterpret_cast<const uintptr_t>(rhs);
@@ -830,6 +911,29 @@ struct KeyWithPointer<TupleKey> : public TupleKey {
     }
 };
 
+template <>
+struct KeyWithPointer<PrefixedTupleKey> : public PrefixedTupleKey {
+    typedef ComparatorWithPointer<PrefixedTupleKey> KeyComparator;
+    friend struct ComparatorWithPointer<PrefixedTupleKey>;
+
+    KeyWithPointer() : PrefixedTupleKey() {}
+
+    KeyWithPointer(const TableTuple *tuple) : PrefixedTupleKey(tuple) {}
+
+    KeyWithPointer(const TableTuple *tuple, const std::vector<int> &indices,
+                   const std::vector<AbstractExpression*> &indexed_expressions,
+                   const TupleSchema *keySchema)
+        : PrefixedTupleKey(tuple, indices, indexed_expressions, keySchema) {}
+
+    const void * const& getValue() const { return m_keyTuple; }
+    void setValue(const void * const &value) { m_keyTuple = value; }
+    const void *setPointerValue(const void * &value) {
+        const void *rv = m_keyTuple;
+        m_keyTuple = value;
+        return rv;
+    }
+};
+
 template <typename KeyType>
 struct ComparatorWithPointer : public KeyType::KeyComparator {
     ComparatorWithPointer(const TupleSchema *keySchema)
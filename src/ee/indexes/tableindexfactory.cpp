@@ -85,6 +85,23 @@ class TableIndexPicker
         }
     }
 
+    template <class TKeyType>
+    TableIndex *getInstanceForTupleKeyType() const
+    {
+        if (m_scheme.unique) {
+            if (m_scheme.countable) {
+                return new CompactingTreeUniqueIndex<NormalKeyValuePair<TKeyType>, true >(m_keySchema, m_scheme);
+            } else {
+                return new CompactingTreeUniqueIndex<NormalKeyValuePair<TKeyType>, false>(m_keySchema, m_scheme);
+            }
+        }
+        if (m_scheme.countable) {
+            return new CompactingTreeMultiMapIndex<PointerKeyValuePair<TKeyType>, true >(m_keySchema, m_scheme);
+        } else {
+            return new CompactingTreeMultiMapIndex<PointerKeyValuePair<TKeyType>, false>(m_keySchema, m_scheme);
+        }
+    }
+
     template <std::size_t KeySize>
     TableIndex *getInstanceIfKeyFits()
     {
@@ -183,18 +200,12 @@ public:
             return result;
         }
 
-        if (m_scheme.unique) {
-            if (m_scheme.countable) {
-                return new CompactingTreeUniqueIndex<NormalKeyValuePair<TupleKey>, true >(m_keySchema, m_scheme);
-            } else {
-                return new CompactingTreeUniqueIndex<NormalKeyValuePair<TupleKey>, false>(m_keySchema, m_scheme);
-            }
-        }
-        if (m_scheme.countable) {
-            return new CompactingTreeMultiMapIndex<PointerKeyValuePair<TupleKey>, true >(m_keySchema, m_scheme);
-        } else {
-            return new CompactingTreeMultiMapIndex<PointerKeyValuePair<TupleKey>, false>(m_keySchema, m_scheme);
+        // Keys led by a VARCHAR column also carry a prefix of its value
+        if (m_scheme.indexedExpressions.size() == 0 &&
+                m_keySchema->columnType(0) == VALUE_TYPE_VARCHAR) {
+            return getInstanceForTupleKeyType<PrefixedTupleKey>();
         }
+        return getInstanceForTupleKeyType<TupleKey>();
     }
 
     TableIndexPicker(const TupleSchema *keySchema, bool intsOnly, bool inlinesOrColumnsOnly,
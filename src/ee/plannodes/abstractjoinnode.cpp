@@ -110,6 +110,14 @@ std::string AbstractJoinPlanNode::debugInfo(const std::string& spacer) const
     return (buffer.str());
 }
 
+void AbstractJoinPlanNode::collectExpressions(std::vector<const AbstractExpression*>& expressions) const
+{
+    AbstractPlanNode::collectExpressions(expressions);
+    addExpression(m_preJoinPredicate.get(), expressions);
+    addExpression(m_joinPredicate.get(), expressions);
+    addExpression(m_wherePredicate.get(), expressions);
+}
+
 void
 AbstractJoinPlanNode::loadFromJSONObject(PlannerDomValue obj)
 {
@@ -58,6 +58,7 @@ public:
     AbstractJoinPlanNode();
     ~AbstractJoinPlanNode();
     std::string debugInfo(const std::string& spacer) const;
+    void collectExpressions(std::vector<const AbstractExpression*>& expressions) const;
 
     JoinType getJoinType() const { return m_joinType; }
     AbstractExpression* getPreJoinPredicate() const { return m_preJoinPredicate.get(); }
@@ -145,6 +145,30 @@ void AbstractPlanNode::setOutputTable(Table* table)
     }
 }
 
+void AbstractPlanNode::collectExpressions(std::vector<const AbstractExpression*>& expressions) const
+{
+    // Only a node that defines its own output schema can compute its columns
+    for (int ii = 0; ii < m_validOutputColumnCount; ++ii) {
+        addExpression(m_outputSchema[ii]->getExpression(), expressions);
+    }
+}
+
+void AbstractPlanNode::addExpression(const AbstractExpression* expression,
+                                     std::vector<const AbstractExpression*>& expressions)
+{
+    if (expression != NULL) {
+        expressions.push_back(expression);
+    }
+}
+
+void AbstractPlanNode::addExpressions(const std::vector<AbstractExpression*>& source,
+                                      std::vector<const AbstractExpression*>& expressions)
+{
+    for (size_t ii = 0; ii < source.size(); ++ii) {
+        addExpression(source[ii], expressions);
+    }
+}
+
 const vector<SchemaColumn*>& AbstractPlanNode::getOutputSchema() const
 {
     // Test for a valid output schema defined at this plan node.
@@ -197,6 +197,12 @@ public:
     std::string debug(const std::string& spacer) const;
     virtual std::string debugInfo(const std::string& spacer) const = 0;
 
+    /**
+     * Add the expressions this node evaluates, not counting those of its
+     * inline nodes, to the given list.
+     */
+    virtual void collectExpressions(std::vector<const AbstractExpression*>& expressions) const;
+
     void setPlanNodeIdForTest(int32_t plannode_id) { m_planNodeId = plannode_id; }
 
     /**
@@ -243,6 +249,12 @@ protected:
     static AbstractExpression* loadExpressionFromJSONObject(const char* label,
                                                             PlannerDomValue obj);
 
+    // Helpers for collectExpressions that skip absent expressions
+    static void addExpression(const AbstractExpression* expression,
+                              std::vector<const AbstractExpression*>& expressions);
+    static void addExpressions(const std::vector<AbstractExpression*>& source,
+                               std::vector<const AbstractExpression*>& expressions);
+
     // Every PlanNode will have a unique id assigned to it at compile time
     int32_t m_planNodeId;
 
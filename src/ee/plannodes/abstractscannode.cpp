@@ -67,6 +67,12 @@ std::string AbstractScanPlanNode::debugInfo(const std::string &spacer) const
     return buffer.str();
 }
 
+void AbstractScanPlanNode::collectExpressions(std::vector<const AbstractExpression*>& expressions) const
+{
+    AbstractPlanNode::collectExpressions(expressions);
+    addExpression(m_predicate.get(), expressions);
+}
+
 void AbstractScanPlanNode::loadFromJSONObject(PlannerDomValue obj)
 {
     m_target_table_name = obj.valueForKey("TARGET_TABLE_NAME").asStr();
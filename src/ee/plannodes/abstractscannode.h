@@ -59,9 +59,11 @@ class AbstractScanPlanNode : public AbstractPlanNode
 public:
     ~AbstractScanPlanNode();
     std::string debugInfo(const std::string& spacer) const;
+    void collectExpressions(std::vector<const AbstractExpression*>& expressions) const;
 
     Table* getTargetTable() const;
     void setTargetTableDelegate(TableCatalogDelegate* tcd) { m_tcd = tcd; } // DEPRECATED?
+    TableCatalogDelegate* getTargetTableDelegate() const { return m_tcd; }
 
     std::string getTargetTableName() const { return m_target_table_name; } // DEPRECATED?
     AbstractExpression* getPredicate() const { return m_predicate.get(); }
@@ -86,6 +86,15 @@ std::string AggregatePlanNode::debugInfo(const std::string &spacer) const
     return buffer.str();
 }
 
+void AggregatePlanNode::collectExpressions(std::vector<const AbstractExpression*>& expressions) const
+{
+    AbstractPlanNode::collectExpressions(expressions);
+    addExpressions(m_aggregateInputExpressions, expressions);
+    addExpressions(m_groupByExpressions, expressions);
+    addExpression(m_prePredicate.get(), expressions);
+    addExpression(m_postPredicate.get(), expressions);
+}
+
 void AggregatePlanNode::loadFromJSONObject(PlannerDomValue obj)
 {
     PlannerDomValue aggregateColumnsArray = obj.valueForKey("AGGREGATE_COLUMNS");
@@ -115,6 +124,12 @@ void AggregatePlanNode::loadFromJSONObject(PlannerDomValue obj)
             PlannerDomValue exprDom = aggregateColumnValue.valueForKey("AGGREGATE_EXPRESSION");
             m_aggregateInputExpressions.push_back(AbstractExpression::buildExpressionTree(exprDom));
         }
+        if (aggregateColumnValue.hasNonNullKey("AGGREGATE_PERCENTILE")) {
+            m_aggregatePercentiles.push_back(aggregateColumnValue.valueForKey("AGGREGATE_PERCENTILE").asDouble());
+        }
+        else {
+            m_aggregatePercentiles.push_back(0.5);
+        }
 
         if(!(containsType && containsDistinct && containsOutputColumn)) {
             throw SerializableEEException(VOLT_EE_EXCEPTION_TYPE_EEEXCEPTION,
@@ -58,6 +58,7 @@ public:
         , m_distinctAggregates()
         , m_aggregateOutputColumns()
         , m_aggregateInputExpressions()
+        , m_aggregatePercentiles()
         , m_groupByExpressions()
         , m_partialGroupByColumns()
         , m_type(type)
@@ -69,6 +70,7 @@ public:
     ~AggregatePlanNode();
     PlanNodeType getPlanNodeType() const;
     std::string debugInfo(const std::string &spacer) const;
+    void collectExpressions(std::vector<const AbstractExpression*>& expressions) const;
 
     const std::vector<ExpressionType> getAggregates() const { return m_aggregates; }
 
@@ -89,6 +91,14 @@ public:
     const std::vector<AbstractExpression*>& getAggregateInputExpressions() const
     { return m_aggregateInputExpressions; }
 
+    /*
+     * Returns the fraction of values each APPROX_PERCENTILE aggregation
+     * (or either half of one) estimates the value below; 0.5 for the
+     * median and for aggregations that take no percentile.
+     */
+    const std::vector<double>& getAggregatePercentiles() const
+    { return m_aggregatePercentiles; }
+
     const std::vector<AbstractExpression*>& getGroupByExpressions() const
     { return m_groupByExpressions; }
 
@@ -107,6 +117,7 @@ protected:
     std::vector<bool> m_distinctAggregates;
     std::vector<int> m_aggregateOutputColumns;
     OwningExpressionVector m_aggregateInputExpressions;
+    std::vector<double> m_aggregatePercentiles;
 
     //
     // What columns to group by on
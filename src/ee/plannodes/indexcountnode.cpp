@@ -59,6 +59,14 @@ std::string IndexCountPlanNode::debugInfo(const std::string &spacer) const
     return buffer.str();
 }
 
+void IndexCountPlanNode::collectExpressions(std::vector<const AbstractExpression*>& expressions) const
+{
+    AbstractScanPlanNode::collectExpressions(expressions);
+    addExpressions(m_searchkey_expressions, expressions);
+    addExpressions(m_endkey_expressions, expressions);
+    addExpression(m_skip_null_predicate.get(), expressions);
+}
+
 void IndexCountPlanNode::loadFromJSONObject(PlannerDomValue obj)
 {
     AbstractScanPlanNode::loadFromJSONObject(obj);
@@ -98,6 +98,15 @@ std::string IndexScanPlanNode::debugInfo(const std::string &spacer) const
     return buffer.str();
 }
 
+void IndexScanPlanNode::collectExpressions(std::vector<const AbstractExpression*>& expressions) const
+{
+    AbstractScanPlanNode::collectExpressions(expressions);
+    addExpressions(m_searchkey_expressions, expressions);
+    addExpression(m_end_expression.get(), expressions);
+    addExpression(m_initial_expression.get(), expressions);
+    addExpression(m_skip_null_predicate.get(), expressions);
+}
+
 void IndexScanPlanNode::loadFromJSONObject(PlannerDomValue obj)
 {
     AbstractScanPlanNode::loadFromJSONObject(obj);
@@ -70,6 +70,7 @@ public:
     ~IndexScanPlanNode();
     PlanNodeType getPlanNodeType() const;
     std::string debugInfo(const std::string &spacer) const;
+    void collectExpressions(std::vector<const AbstractExpression*>& expressions) const;
 
     IndexLookupType getLookupType() const { return m_lookup_type; }
 
@@ -106,6 +106,12 @@ std::string LimitPlanNode::debugInfo(const std::string &spacer) const
     return (buffer.str());
 }
 
+void LimitPlanNode::collectExpressions(std::vector<const AbstractExpression*>& expressions) const
+{
+    AbstractPlanNode::collectExpressions(expressions);
+    addExpression(limitExpression, expressions);
+}
+
 void LimitPlanNode::loadFromJSONObject(PlannerDomValue obj)
 {
     limit = obj.valueForKey("LIMIT").asInt();
@@ -76,6 +76,7 @@ public:
     void getLimitAndOffsetByReference(const NValueArray &params, int &limit, int &offset);
 
     std::string debugInfo(const std::string &spacer) const;
+    void collectExpressions(std::vector<const AbstractExpression*>& expressions) const;
 
 private:
     void loadFromJSONObject(PlannerDomValue obj);
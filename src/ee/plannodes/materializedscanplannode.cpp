@@ -37,6 +37,12 @@ std::string MaterializedScanPlanNode::debugInfo(const std::string &spacer) const
     return buffer.str();
 }
 
+void MaterializedScanPlanNode::collectExpressions(std::vector<const AbstractExpression*>& expressions) const
+{
+    AbstractPlanNode::collectExpressions(expressions);
+    addExpression(m_tableRowsExpression, expressions);
+}
+
 void MaterializedScanPlanNode::loadFromJSONObject(PlannerDomValue obj)
 {
     PlannerDomValue rowExpressionObj = obj.valueForKey("TABLE_DATA");
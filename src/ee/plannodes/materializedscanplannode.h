@@ -37,6 +37,7 @@ public:
     ~MaterializedScanPlanNode();
     PlanNodeType getPlanNodeType() const;
     std::string debugInfo(const std::string &spacer) const;
+    void collectExpressions(std::vector<const AbstractExpression*>& expressions) const;
 
     AbstractExpression* getTableRowsExpression() const { return m_tableRowsExpression; }
 
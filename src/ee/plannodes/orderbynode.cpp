@@ -65,6 +65,12 @@ std::string OrderByPlanNode::debugInfo(const std::string& spacer) const
     return buffer.str();
 }
 
+void OrderByPlanNode::collectExpressions(std::vector<const AbstractExpression*>& expressions) const
+{
+    AbstractPlanNode::collectExpressions(expressions);
+    addExpressions(m_sortExpressions, expressions);
+}
+
 void OrderByPlanNode::loadFromJSONObject(PlannerDomValue obj)
 {
     loadSortListFromJSONObject(obj, &m_sortExpressions, &m_sortDirections);
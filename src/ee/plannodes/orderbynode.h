@@ -61,6 +61,7 @@ public:
     ~OrderByPlanNode();
     PlanNodeType getPlanNodeType() const;
     std::string debugInfo(const std::string &spacer) const;
+    void collectExpressions(std::vector<const AbstractExpression*>& expressions) const;
 
     const std::vector<AbstractExpression*>& getSortExpressions() const { return m_sortExpressions; }
     const std::vector<SortDirectionType>& getSortDirections() const { return m_sortDirections; }
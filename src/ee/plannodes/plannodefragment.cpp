@@ -61,13 +61,15 @@ using namespace voltdb;
 PlanNodeFragment::PlanNodeFragment() :
     m_serializedType("org.voltdb.plannodes.PlanNodeList"),
     m_idToNodeMap(),
-    m_stmtExecutionListMap()
+    m_stmtExecutionListMap(),
+    m_cachesResult(false)
 {}
 
 PlanNodeFragment::PlanNodeFragment(AbstractPlanNode *root_node) :
     m_serializedType("org.voltdb.plannodes.PlanNodeList"),
     m_idToNodeMap(),
-    m_stmtExecutionListMap()
+    m_stmtExecutionListMap(),
+    m_cachesResult(false)
 {
     std::auto_ptr<std::vector<AbstractPlanNode*> > executeNodeList(new std::vector<AbstractPlanNode*>());
     m_stmtExecutionListMap.insert(std::make_pair(0, executeNodeList.get()));
@@ -145,6 +147,9 @@ PlanNodeFragment::fromJSONObject(PlannerDomValue obj)
     else {
         retval->nodeListFromJSONObject(obj.valueForKey("PLAN_NODES"), obj.valueForKey("EXECUTE_LIST"), 0);
     }
+    if (obj.hasNonNullKey("CACHE_RESULT")) {
+        retval->m_cachesResult = obj.valueForKey("CACHE_RESULT").asBool();
+    }
     pnf.release();
     return retval;
 }
@@ -109,6 +109,10 @@ class PlanNodeFragment {
     // as part of the horrible ENG-1333 hack.
     bool hasDelete() const;
 
+    // true if the planner asked for this fragment's result to be kept
+    // in the engine's fragment result cache.
+    bool cachesResult() const { return m_cachesResult; }
+
     // produce a string describing pnf's content
     std::string debug();
 
@@ -126,6 +130,7 @@ class PlanNodeFragment {
     // Pointers to nodes in execution order grouped by substatement
     // The statement id is the key. The top statement (parent) always has id = 0
     std::map<int, std::vector<AbstractPlanNode*>* > m_stmtExecutionListMap;
+    bool m_cachesResult;
 };
 
 
@@ -67,6 +67,16 @@ std::string WindowFunctionPlanNode::debugInfo(const std::string &spacer) const
     return buffer.str();
 }
 
+void WindowFunctionPlanNode::collectExpressions(std::vector<const AbstractExpression*>& expressions) const
+{
+    AbstractPlanNode::collectExpressions(expressions);
+    for (size_t ii = 0; ii < m_aggregateInputExpressions.size(); ++ii) {
+        addExpressions(m_aggregateInputExpressions[ii], expressions);
+    }
+    addExpressions(m_partitionByExpressions, expressions);
+    addExpressions(m_orderByExpressions, expressions);
+}
+
 void WindowFunctionPlanNode::loadFromJSONObject(PlannerDomValue obj) {
     PlannerDomValue aggregateColumnsArray = obj.valueForKey("AGGREGATE_COLUMNS");
     bool containsType = false;
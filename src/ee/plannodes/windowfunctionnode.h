@@ -40,6 +40,7 @@ public:
 
     PlanNodeType getPlanNodeType() const;
     std::string debugInfo(const std::string &spacer) const;
+    void collectExpressions(std::vector<const AbstractExpression*>& expressions) const;
 
     const std::vector<ExpressionType>& getAggregates() const {
         return m_aggregates;
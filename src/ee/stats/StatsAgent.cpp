@@ -20,7 +20,9 @@
 #include "common/ids.h"
 #include "common/tabletuple.h"
 #include "common/TupleSchema.h"
+#include "execution/FragmentResultCacheStats.h"
 #include "indexes/IndexStats.h"
+#include "storage/CompactionStats.h"
 #include "storage/TableStats.h"
 #include "storage/temptable.h"
 
@@ -43,6 +45,10 @@ namespace
             return TableStats::generateEmptyTableStatsTable();
         case STATISTICS_SELECTOR_TYPE_INDEX:
             return IndexStats::generateEmptyIndexStatsTable();
+        case STATISTICS_SELECTOR_TYPE_FRAGMENT_RESULT_CACHE:
+            return FragmentResultCacheStats::generateEmptyFragmentResultCacheStatsTable();
+        case STATISTICS_SELECTOR_TYPE_COMPACTION:
+            return CompactionStats::generateEmptyCompactionStatsTable();
         default:
             throwFatalException("Attempted to get unsupported stats type");
         }
@@ -0,0 +1,120 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/ColdBlockStore.h"
+
+#include "common/FatalException.hpp"
+#include "common/SerializableEEException.h"
+#include "logging/LogManager.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace voltdb {
+
+ColdBlockStore::ColdBlockStore(const std::string& directory, const std::string& tableName, size_t blockSize)
+    : m_fd(-1), m_blockSize(blockSize), m_slotCount(0)
+{
+    std::string path = directory + "/" + tableName + ".cold.XXXXXX";
+    std::vector<char> pathBuffer(path.begin(), path.end());
+    pathBuffer.push_back('\0');
+    m_fd = ::mkstemp(&pathBuffer[0]);
+    if (m_fd < 0) {
+        char msg[1024];
+        snprintf(msg, sizeof(msg), "Could not create a cold block file for table %s in %s: %s",
+                 tableName.c_str(), directory.c_str(), strerror(errno));
+        throw SerializableEEException(VOLT_EE_EXCEPTION_TYPE_EEEXCEPTION, msg);
+    }
+    ::unlink(&pathBuffer[0]);
+}
+
+ColdBlockStore::~ColdBlockStore() {
+    ::close(m_fd);
+}
+
+size_t ColdBlockStore::blockSizeFor(size_t allocationSize) {
+    size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return (allocationSize + pageSize - 1) / pageSize * pageSize;
+}
+
+int64_t ColdBlockStore::write(const char* storage) {
+    int64_t slot;
+    if (m_freeSlots.empty()) {
+        slot = m_slotCount;
+    }
+    else {
+        slot = m_freeSlots.back();
+    }
+    off_t offset = static_cast<off_t>(slot * m_blockSize);
+    size_t written = 0;
+    while (written < m_blockSize) {
+        ssize_t rc = ::pwrite(m_fd, storage + written, m_blockSize - written, offset + written);
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            char msg[1024];
+            snprintf(msg, sizeof(msg), "Could not write a block to a cold block file: %s", strerror(errno));
+            LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_WARN, msg);
+            return -1;
+        }
+        written += rc;
+    }
+    if (m_freeSlots.empty()) {
+        ++m_slotCount;
+    }
+    else {
+        m_freeSlots.pop_back();
+    }
+    return slot;
+}
+
+void ColdBlockStore::mapAt(char* address, int64_t slot) {
+    void* mapped = ::mmap(address, m_blockSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+                          m_fd, static_cast<off_t>(slot * m_blockSize));
+    if (mapped == MAP_FAILED) {
+        throwFatalException("Failed to map a cold block: %s", strerror(errno));
+    }
+}
+
+void ColdBlockStore::startWriteback(int64_t slot) {
+#if defined(LINUX) && defined(SYNC_FILE_RANGE_WRITE)
+    ::sync_file_range(m_fd, static_cast<off_t>(slot * m_blockSize), m_blockSize, SYNC_FILE_RANGE_WRITE);
+#endif
+}
+
+void ColdBlockStore::dropCachedPages(int64_t slot) {
+#ifdef LINUX
+    ::posix_fadvise(m_fd, static_cast<off_t>(slot * m_blockSize), m_blockSize, POSIX_FADV_DONTNEED);
+#endif
+}
+
+void ColdBlockStore::release(int64_t slot) {
+#if defined(LINUX) && defined(FALLOC_FL_PUNCH_HOLE)
+    // Give the disk space back too; a later write fills the hole again
+    ::fallocate(m_fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                static_cast<off_t>(slot * m_blockSize), m_blockSize);
+#endif
+    m_freeSlots.push_back(slot);
+}
+
+}
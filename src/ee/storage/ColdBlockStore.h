@@ -0,0 +1,86 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COLDBLOCKSTORE_H_
+#define COLDBLOCKSTORE_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace voltdb {
+
+/**
+ * A local file that holds the storage of a table's cold TupleBlocks, one
+ * block per fixed-size slot. A block that is moved here has the slot mapped
+ * over its own storage, so its tuples keep their addresses and are paged in
+ * from the file when something reaches them, while the memory the block
+ * used to occupy is given back.
+ *
+ * The file is unlinked as soon as it is created. It only extends memory,
+ * and is never read back after a restart.
+ */
+class ColdBlockStore {
+public:
+    /**
+     * Create the file in the given directory for blocks of blockSize bytes,
+     * as returned by blockSizeFor(). Throws if the file cannot be created.
+     */
+    ColdBlockStore(const std::string& directory, const std::string& tableName, size_t blockSize);
+    ~ColdBlockStore();
+
+    /** The size of a block's storage rounded up to whole pages */
+    static size_t blockSizeFor(size_t allocationSize);
+
+    size_t blockSize() const { return m_blockSize; }
+
+    /**
+     * Copy a block's storage into a free slot and return the slot, or -1 if
+     * it could not be written, in which case the block should stay in memory.
+     */
+    int64_t write(const char* storage);
+
+    /** Map the slot over the block storage at address, replacing its pages */
+    void mapAt(char* address, int64_t slot);
+
+    /**
+     * Start writing the slot's dirty pages back to the file, without
+     * waiting for the writes to finish
+     */
+    void startWriteback(int64_t slot);
+
+    /**
+     * Ask the kernel to drop the slot's pages from its cache. Pages that
+     * have not been written back yet are left for the kernel to evict later.
+     */
+    void dropCachedPages(int64_t slot);
+
+    /** Give back the slot of a block that is no longer in use */
+    void release(int64_t slot);
+
+    int64_t slotsInUse() const { return m_slotCount - static_cast<int64_t>(m_freeSlots.size()); }
+
+private:
+    int m_fd;
+    size_t m_blockSize;
+    int64_t m_slotCount;
+    std::vector<int64_t> m_freeSlots;
+};
+
+}
+
+#endif // COLDBLOCKSTORE_H_
@@ -0,0 +1,163 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/CompactionStats.h"
+#include "stats/StatsSource.h"
+#include "common/TupleSchema.h"
+#include "common/ValueFactory.hpp"
+#include "common/tabletuple.h"
+#include "storage/persistenttable.h"
+#include "storage/tablefactory.h"
+#include <vector>
+#include <string>
+#include <sstream>
+
+using namespace voltdb;
+using namespace std;
+
+vector<string> CompactionStats::generateCompactionStatsColumnNames() {
+    vector<string> columnNames = StatsSource::generateBaseStatsColumnNames();
+    columnNames.push_back("TABLE_NAME");
+    columnNames.push_back("BLOCK_COUNT");
+    columnNames.push_back("FRAGMENTATION_PERCENT");
+    columnNames.push_back("RECLAIMABLE_BLOCKS");
+    columnNames.push_back("BLOCK_LOAD_HISTOGRAM");
+    columnNames.push_back("TUPLES_MOVED");
+    columnNames.push_back("BLOCKS_RECLAIMED");
+    columnNames.push_back("MEMORY_RECLAIMED");
+    columnNames.push_back("COMPACTION_TIME");
+    return columnNames;
+}
+
+void CompactionStats::populateCompactionStatsSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes) {
+    StatsSource::populateBaseSchema(types, columnLengths, allowNull, inBytes);
+    types.push_back(VALUE_TYPE_VARCHAR); columnLengths.push_back(4096); allowNull.push_back(false);inBytes.push_back(false);
+    types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    types.push_back(VALUE_TYPE_INTEGER); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_INTEGER)); allowNull.push_back(false);inBytes.push_back(false);
+    types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    types.push_back(VALUE_TYPE_VARCHAR); columnLengths.push_back(4096); allowNull.push_back(false);inBytes.push_back(false);
+    for (int ii = 0; ii < 4; ii++) {
+        types.push_back(VALUE_TYPE_BIGINT); columnLengths.push_back(NValue::getTupleStorageSize(VALUE_TYPE_BIGINT)); allowNull.push_back(false);inBytes.push_back(false);
+    }
+}
+
+TempTable* CompactionStats::generateEmptyCompactionStatsTable() {
+    string name = "Persistent Table compaction stats temp table";
+    vector<string> columnNames = CompactionStats::generateCompactionStatsColumnNames();
+    vector<ValueType> columnTypes;
+    vector<int32_t> columnLengths;
+    vector<bool> columnAllowNull;
+    vector<bool> columnInBytes;
+    CompactionStats::populateCompactionStatsSchema(columnTypes, columnLengths,
+                                                   columnAllowNull, columnInBytes);
+    TupleSchema *schema =
+        TupleSchema::createTupleSchema(columnTypes, columnLengths,
+                                       columnAllowNull, columnInBytes);
+
+    return TableFactory::buildTempTable(name,
+                                        schema,
+                                        columnNames,
+                                        NULL);
+}
+
+CompactionStats::CompactionStats(PersistentTable* table)
+    : StatsSource(), m_table(table), m_lastTuplesMoved(0),
+      m_lastBlocksReclaimed(0), m_lastCompactionMicros(0)
+{
+}
+
+CompactionStats::~CompactionStats() {
+    m_tableName.free();
+    m_histogram.free();
+}
+
+void CompactionStats::configure(string name) {
+    StatsSource::configure(name);
+    m_tableName = ValueFactory::getStringValue(m_table->name());
+}
+
+vector<string> CompactionStats::generateStatsColumnNames() {
+    return CompactionStats::generateCompactionStatsColumnNames();
+}
+
+/**
+ * Update the stats tuple with the latest statistics available to this StatsSource.
+ * The block counts, fragmentation and histogram describe the table as it is
+ * now; the work done by compaction is counted since the last interval when
+ * one was asked for. Reclaimed memory is reported in KB, like the table stats.
+ */
+void CompactionStats::updateStatsTuple(TableTuple *tuple) {
+    int64_t allocatedTuples = m_table->allocatedTupleCount();
+    int32_t fragmentation = 0;
+    if (allocatedTuples > 0) {
+        fragmentation = static_cast<int32_t>(
+                (allocatedTuples - m_table->activeTupleCount()) * 100 / allocatedTuples);
+    }
+
+    std::vector<size_t> histogram;
+    m_table->blockLoadHistogram(histogram);
+    std::ostringstream histogramString;
+    for (size_t ii = 0; ii < histogram.size(); ii++) {
+        if (ii > 0) {
+            histogramString << ',';
+        }
+        histogramString << histogram[ii];
+    }
+
+    int64_t tuplesMoved = m_table->compactionTuplesMoved();
+    int64_t blocksReclaimed = m_table->compactionBlocksReclaimed();
+    int64_t compactionMicros = m_table->compactionMicros();
+    if (interval()) {
+        tuplesMoved -= m_lastTuplesMoved;
+        m_lastTuplesMoved = m_table->compactionTuplesMoved();
+        blocksReclaimed -= m_lastBlocksReclaimed;
+        m_lastBlocksReclaimed = m_table->compactionBlocksReclaimed();
+        compactionMicros -= m_lastCompactionMicros;
+        m_lastCompactionMicros = m_table->compactionMicros();
+    }
+
+    tuple->setNValue(StatsSource::m_columnName2Index["TABLE_NAME"], m_tableName);
+    tuple->setNValue(StatsSource::m_columnName2Index["BLOCK_COUNT"],
+            ValueFactory::getBigIntValue(m_table->allocatedBlockCount()));
+    tuple->setNValue(StatsSource::m_columnName2Index["FRAGMENTATION_PERCENT"],
+            ValueFactory::getIntegerValue(fragmentation));
+    tuple->setNValue(StatsSource::m_columnName2Index["RECLAIMABLE_BLOCKS"],
+            ValueFactory::getBigIntValue(m_table->reclaimableBlockCount()));
+    m_histogram.free();
+    m_histogram = ValueFactory::getStringValue(histogramString.str());
+    tuple->setNValue(StatsSource::m_columnName2Index["BLOCK_LOAD_HISTOGRAM"], m_histogram);
+    tuple->setNValue(StatsSource::m_columnName2Index["TUPLES_MOVED"],
+            ValueFactory::getBigIntValue(tuplesMoved));
+    tuple->setNValue(StatsSource::m_columnName2Index["BLOCKS_RECLAIMED"],
+            ValueFactory::getBigIntValue(blocksReclaimed));
+    tuple->setNValue(StatsSource::m_columnName2Index["MEMORY_RECLAIMED"],
+            ValueFactory::getBigIntValue(blocksReclaimed * m_table->getTableAllocationSize() / 1024));
+    tuple->setNValue(StatsSource::m_columnName2Index["COMPACTION_TIME"],
+            ValueFactory::getBigIntValue(compactionMicros));
+}
+
+void CompactionStats::populateSchema(
+        vector<ValueType> &types,
+        vector<int32_t> &columnLengths,
+        vector<bool> &allowNull,
+        vector<bool> &inBytes) {
+    CompactionStats::populateCompactionStatsSchema(types, columnLengths, allowNull, inBytes);
+}
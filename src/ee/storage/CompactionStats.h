@@ -0,0 +1,90 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COMPACTIONSTATS_H_
+#define COMPACTIONSTATS_H_
+
+#include "stats/StatsSource.h"
+
+namespace voltdb {
+class PersistentTable;
+class TableTuple;
+class TempTable;
+
+/**
+ * StatsSource extension reporting how fragmented a persistent table's
+ * blocks are and how much work compaction has done on it.
+ */
+class CompactionStats : public voltdb::StatsSource {
+public:
+    /**
+     * Static method to generate the column names for the tables which
+     * contain compaction stats.
+     */
+    static std::vector<std::string> generateCompactionStatsColumnNames();
+
+    /**
+     * Static method to generate the remaining schema information for
+     * the tables which contain compaction stats.
+     */
+    static void populateCompactionStatsSchema(std::vector<voltdb::ValueType>& types,
+                                              std::vector<int32_t>& columnLengths,
+                                              std::vector<bool>& allowNull,
+                                              std::vector<bool>& inBytes);
+
+    /**
+     * Return an empty CompactionStats table
+     */
+    static TempTable* generateEmptyCompactionStatsTable();
+
+    /*
+     * Constructor caches reference to the table that will be generating the statistics
+     */
+    CompactionStats(voltdb::PersistentTable* table);
+
+    ~CompactionStats();
+
+    void configure(std::string name);
+
+protected:
+
+    /**
+     * Update the stats tuple with the latest statistics available to this StatsSource.
+     */
+    virtual void updateStatsTuple(voltdb::TableTuple *tuple);
+
+    virtual std::vector<std::string> generateStatsColumnNames();
+
+    virtual void populateSchema(std::vector<voltdb::ValueType> &types, std::vector<int32_t> &columnLengths,
+            std::vector<bool> &allowNull, std::vector<bool> &inBytes);
+
+private:
+    voltdb::PersistentTable* m_table;
+
+    voltdb::NValue m_tableName;
+
+    // The last histogram reported, kept until the next one replaces it
+    voltdb::NValue m_histogram;
+
+    int64_t m_lastTuplesMoved;
+    int64_t m_lastBlocksReclaimed;
+    int64_t m_lastCompactionMicros;
+};
+
+}
+
+#endif /* COMPACTIONSTATS_H_ */
@@ -17,10 +17,158 @@
 
 #include "ElasticIndex.h"
 #include "persistenttable.h"
+#include <algorithm>
 
 namespace voltdb
 {
 
+ElasticIndex::ElasticIndex(size_t expectedKeys) :
+    m_size(0),
+    m_unsortedCount(0),
+    m_version(0)
+{
+    int bits = MIN_PARTITION_BITS;
+    while (bits < MAX_PARTITION_BITS && (expectedKeys >> bits) > KEYS_PER_PARTITION) {
+        bits++;
+    }
+    m_partitions.resize(static_cast<size_t>(1) << bits);
+    m_shift = 32 - bits;
+}
+
+ElasticIndex::Partition &ElasticIndex::sortedPartition(size_t index) const
+{
+    Partition &partition = m_partitions[index];
+    if (partition.sortedCount < partition.keys.size()) {
+        std::vector<ElasticIndexKey>::iterator tail = partition.keys.begin() + partition.sortedCount;
+        std::sort(tail, partition.keys.end(), ElasticIndexComparator());
+        std::inplace_merge(partition.keys.begin(), tail, partition.keys.end(), ElasticIndexComparator());
+        m_unsortedCount -= partition.keys.size() - partition.sortedCount;
+        std::vector<ElasticIndexKey>::iterator last = std::unique(partition.keys.begin(),
+                                                                  partition.keys.end());
+        m_size -= partition.keys.end() - last;
+        partition.keys.erase(last, partition.keys.end());
+        partition.sortedCount = partition.keys.size();
+    }
+    return partition;
+}
+
+bool ElasticIndex::exists(const ElasticIndexKey &key) const
+{
+    const Partition &partition = sortedPartition(partitionFor(key.getHash()));
+    return std::binary_search(partition.keys.begin(), partition.keys.end(), key,
+                              ElasticIndexComparator());
+}
+
+/**
+ * Add key to index (direct).
+ * Return true if it wasn't present and needed to be added.
+ */
+bool ElasticIndex::add(const ElasticIndexKey &key)
+{
+    Partition &partition = m_partitions[partitionFor(key.getHash())];
+    if (partition.sortedCount == partition.keys.size() &&
+            (partition.keys.empty() || ElasticIndexComparator()(partition.keys.back(), key))) {
+        // Past the last key of a sorted partition, so it stays sorted.
+        partition.keys.push_back(key);
+        partition.sortedCount++;
+    }
+    else {
+        if (std::binary_search(partition.keys.begin(), partition.keys.begin() + partition.sortedCount,
+                               key, ElasticIndexComparator())) {
+            return false;
+        }
+        partition.keys.push_back(key);
+        m_unsortedCount++;
+    }
+    m_size++;
+    m_version++;
+    if (m_size > m_partitions.size() * KEYS_PER_PARTITION * SPLIT_FACTOR &&
+            m_shift > 32 - MAX_PARTITION_BITS) {
+        split();
+    }
+    return true;
+}
+
+void ElasticIndex::split()
+{
+    const int shift = m_shift - 1;
+    std::vector<Partition> partitions(m_partitions.size() * 2);
+    for (size_t i = 0; i < m_partitions.size(); i++) {
+        const Partition &partition = sortedPartition(i);
+        Partition &lower = partitions[2 * i];
+        Partition &upper = partitions[2 * i + 1];
+        // The new bit splits the sorted keys into a lower and an upper run.
+        for (size_t j = 0; j < partition.keys.size(); j++) {
+            const ElasticIndexKey &key = partition.keys[j];
+            if (((static_cast<uint32_t>(key.getHash()) ^ 0x80000000U) >> shift) & 1) {
+                upper.keys.push_back(key);
+            }
+            else {
+                lower.keys.push_back(key);
+            }
+        }
+        lower.sortedCount = lower.keys.size();
+        upper.sortedCount = upper.keys.size();
+    }
+    m_partitions.swap(partitions);
+    m_shift = shift;
+    m_version++;
+}
+
+size_t ElasticIndex::erase(const ElasticIndexKey &key)
+{
+    Partition &partition = sortedPartition(partitionFor(key.getHash()));
+    std::vector<ElasticIndexKey>::iterator pos =
+        std::lower_bound(partition.keys.begin(), partition.keys.end(), key, ElasticIndexComparator());
+    if (pos == partition.keys.end() || !(*pos == key)) {
+        return 0;
+    }
+    partition.keys.erase(pos);
+    partition.sortedCount--;
+    m_size--;
+    m_version++;
+    return 1;
+}
+
+void ElasticIndex::clear()
+{
+    for (size_t i = 0; i < m_partitions.size(); i++) {
+        Partition().keys.swap(m_partitions[i].keys);
+        m_partitions[i].sortedCount = 0;
+    }
+    m_size = 0;
+    m_unsortedCount = 0;
+    m_version++;
+}
+
+void ElasticIndex::compact()
+{
+    for (size_t i = 0; i < m_partitions.size(); i++) {
+        Partition &partition = sortedPartition(i);
+        if (partition.keys.capacity() > partition.keys.size()) {
+            std::vector<ElasticIndexKey>(partition.keys).swap(partition.keys);
+        }
+    }
+}
+
+ElasticIndex::const_iterator ElasticIndex::lower_bound(const ElasticIndexKey &key) const
+{
+    size_t index = partitionFor(key.getHash());
+    const Partition &partition = sortedPartition(index);
+    return const_iterator(this, index,
+                          std::lower_bound(partition.keys.begin(), partition.keys.end(), key,
+                                           ElasticIndexComparator()) - partition.keys.begin());
+}
+
+ElasticIndex::const_iterator ElasticIndex::upper_bound(const ElasticIndexKey &key) const
+{
+    size_t index = partitionFor(key.getHash());
+    const Partition &partition = sortedPartition(index);
+    return const_iterator(this, index,
+                          std::upper_bound(partition.keys.begin(), partition.keys.end(), key,
+                                           ElasticIndexComparator()) - partition.keys.begin());
+}
+
 /**
  * Generate hash value for key.
  */
@@ -44,14 +192,33 @@ void ElasticIndexTupleRangeIterator::reset()
 {
     m_iter = m_index.createLowerBoundIterator(m_range.getLowerBound());
     m_end = m_index.createUpperBoundIterator(m_range.getUpperBound());
+    m_indexVersion = m_index.version();
+    m_started = false;
+}
+
+void ElasticIndexTupleRangeIterator::reposition()
+{
+    if (m_started) {
+        m_iter = m_index.upper_bound(m_lastKey);
+    }
+    else {
+        m_iter = m_index.createLowerBoundIterator(m_range.getLowerBound());
+    }
+    m_end = m_index.createUpperBoundIterator(m_range.getUpperBound());
+    m_indexVersion = m_index.version();
 }
 
 bool ElasticIndexTupleRangeIterator::next(TableTuple &tuple)
 {
-    if (m_iter == m_end) {
+    if (m_indexVersion != m_index.version()) {
+        reposition();
+    }
+    if (m_iter == m_end || m_iter == m_index.end()) {
         return false;
     }
-    tuple = TableTuple(m_iter++->getTupleAddress(), &m_schema);
+    m_lastKey = *m_iter++;
+    m_started = true;
+    tuple = TableTuple(m_lastKey.getTupleAddress(), &m_schema);
     return true;
 }
 
@@ -19,14 +19,13 @@
 
 #include <iostream>
 #include <limits>
-#include <stx/btree.h>
+#include <vector>
 #include <boost/iterator/iterator_facade.hpp>
 #include "storage/TupleBlock.h"
 #include "common/tabletuple.h"
 
 namespace voltdb {
 
-class ElasticIndexIterator;
 class PersistentTable;
 
 /// Hash value type.
@@ -98,17 +97,137 @@ class ElasticIndexComparator
 };
 
 /**
- * The elastic index (set)
- */
-class ElasticIndex : public stx::btree_set<ElasticIndexKey, ElasticIndexComparator,
-                                    stx::btree_default_set_traits<ElasticIndexKey> >
+ * The elastic index (set), ordered by hash and then tuple address.
+ *
+ * Keys are radix-partitioned on the top bits of the hash into arrays, so
+ * that a hash range maps onto a run of consecutive partitions that can be
+ * walked independently of the others. The scan that builds the index
+ * visits tuples in address order, so the hashes arrive at random; keys are
+ * appended to the unsorted tail of their partition and the tail is only
+ * sorted in the next time the partition is read. The partition count is
+ * picked from the expected number of keys and doubled whenever the
+ * partitions grow well past that, which keeps the arrays short enough
+ * that removing keys and sorting in new ones, as the table changes while
+ * rebalancing, stays cheap.
+ */
+class ElasticIndex
 {
-    friend class ElasticIndexIterator;
-
   public:
 
+    /**
+     * Forward iterator over the keys in order. Any change to the index
+     * invalidates it.
+     */
+    class const_iterator : public boost::iterator_facade<const_iterator,
+                                                         const ElasticIndexKey,
+                                                         boost::forward_traversal_tag>
+    {
+        friend class ElasticIndex;
+        friend class boost::iterator_core_access;
+
+      public:
+
+        const_iterator() : m_index(NULL), m_partition(0), m_offset(0) {}
+
+      private:
+
+        const_iterator(const ElasticIndex *index, size_t partition, size_t offset) :
+            m_index(index), m_partition(partition), m_offset(offset)
+        {
+            skipExhaustedPartitions();
+        }
+
+        void skipExhaustedPartitions()
+        {
+            while (m_partition < m_index->m_partitions.size() &&
+                   m_offset >= m_index->sortedPartition(m_partition).keys.size()) {
+                ++m_partition;
+                m_offset = 0;
+            }
+        }
+
+        void increment()
+        {
+            ++m_offset;
+            skipExhaustedPartitions();
+        }
+
+        bool equal(const const_iterator &other) const
+        {
+            return m_partition == other.m_partition && m_offset == other.m_offset;
+        }
+
+        const ElasticIndexKey &dereference() const
+        {
+            return m_index->m_partitions[m_partition].keys[m_offset];
+        }
+
+        const ElasticIndex *m_index;
+        size_t m_partition;
+        size_t m_offset;
+    };
+
+    /// Keys can't be modified in place, so both iterators are the same.
+    typedef const_iterator iterator;
+
+    /**
+     * Constructor, sizing the partitions for about the expected number of keys.
+     */
+    explicit ElasticIndex(size_t expectedKeys = 0);
+
     virtual ~ElasticIndex() {}
 
+    /**
+     * Number of keys.
+     */
+    size_t size() const;
+
+    /**
+     * Number of partitions the keys are spread across.
+     */
+    size_t partitionCount() const;
+
+    /**
+     * Number of changes made so far, for detecting invalidated iterators.
+     */
+    int64_t version() const;
+
+    /**
+     * Return true if the key is in the index (direct).
+     */
+    bool exists(const ElasticIndexKey &key) const;
+
+    /**
+     * Remove key from index (direct).
+     * Return the number of keys removed.
+     */
+    size_t erase(const ElasticIndexKey &key);
+
+    /**
+     * Remove all keys.
+     */
+    void clear();
+
+    /**
+     * Give back the spare capacity of the partitions, e.g. once the
+     * scan that built the index is complete.
+     */
+    void compact();
+
+    const_iterator begin() const;
+
+    const_iterator end() const;
+
+    /**
+     * First key that is not less than the given key.
+     */
+    const_iterator lower_bound(const ElasticIndexKey &key) const;
+
+    /**
+     * First key that is greater than the given key.
+     */
+    const_iterator upper_bound(const ElasticIndexKey &key) const;
+
     /**
      * Return true if key is in the index (indirect from tuple).
      */
@@ -128,7 +247,9 @@ class ElasticIndex : public stx::btree_set<ElasticIndexKey, ElasticIndexComparat
 
     /**
      * Add key to index (direct).
-     * Return true if it wasn't present and got added.
+     * Return true if it wasn't present and got added. A key that is
+     * added again before its partition was next read is not detected
+     * here, but is only kept once.
      */
     bool add(const ElasticIndexKey &key);
 
@@ -141,43 +262,71 @@ class ElasticIndex : public stx::btree_set<ElasticIndexKey, ElasticIndexComparat
     /**
      * Get full iterator.
      */
-    iterator createIterator();
+    const_iterator createIterator() const;
 
     /**
      * Get partial iterator based on lower bound.
      */
-    iterator createLowerBoundIterator(ElasticHash lowerBound);
+    const_iterator createLowerBoundIterator(ElasticHash lowerBound) const;
 
     /**
      * Get partial iterator based on upper bound.
      */
-    iterator createUpperBoundIterator(ElasticHash upperBound);
+    const_iterator createUpperBoundIterator(ElasticHash upperBound) const;
 
     /**
-     * Get full const_iterator.
+     * Print the keys in the index
      */
-    const_iterator createIterator() const;
+    void printKeys(std::ostream &os, int32_t limit, const TupleSchema *schema, const PersistentTable &table) const;
+
+    /// Partition counts are powers of two between these bounds.
+    static const int MIN_PARTITION_BITS = 8;
+    static const int MAX_PARTITION_BITS = 16;
+
+    /// Target number of keys per partition when sizing the index.
+    static const size_t KEYS_PER_PARTITION = 256;
+
+    /// The partition count doubles once the average partition holds this
+    /// many times the target number of keys.
+    static const size_t SPLIT_FACTOR = 4;
+
+  private:
+
+    struct Partition {
+        Partition() : sortedCount(0) {}
+
+        std::vector<ElasticIndexKey> keys;
+        /// Keys before this offset are sorted, the rest were appended since.
+        size_t sortedCount;
+    };
 
     /**
-     * Get partial const_iterator based on lower bound.
+     * Partition holding the hash. Partitions are ordered like signed hashes.
      */
-    const_iterator createLowerBoundIterator(ElasticHash lowerBound) const;
+    size_t partitionFor(ElasticHash hash) const;
 
     /**
-     * Get partial const_iterator based on upper bound.
+     * Sort the unsorted tail of a partition in with its other keys,
+     * dropping duplicates, and return it.
      */
-    const_iterator createUpperBoundIterator(ElasticHash upperBound) const;
+    Partition &sortedPartition(size_t index) const;
 
     /**
-     * Print the keys in the index
+     * Double the partition count, keeping the keys sorted.
      */
-    void printKeys(std::ostream &os, int32_t limit, const TupleSchema *schema, const PersistentTable &table) const;
-
-  private:
+    void split();
 
     static ElasticHash generateHash(const PersistentTable &table, const TableTuple &tuple);
 
     static ElasticIndexKey generateKey(const PersistentTable &table, const TableTuple &tuple);
+
+    // Sorting a partition's tail doesn't change the set of keys, so reads do it.
+    mutable std::vector<Partition> m_partitions;
+    int m_shift;
+    mutable size_t m_size;
+    /// Total number of keys in the unsorted tails of the partitions.
+    mutable size_t m_unsortedCount;
+    int64_t m_version;
 };
 
 /**
@@ -260,11 +409,20 @@ public:
 
 private:
 
+    /**
+     * Position the iterators after the last key returned, because the
+     * index has changed since they were made.
+     */
+    void reposition();
+
     ElasticIndex &m_index;
     const TupleSchema &m_schema;
     ElasticIndexHashRange m_range;
     ElasticIndex::iterator m_iter;
     ElasticIndex::iterator m_end;
+    int64_t m_indexVersion;
+    ElasticIndexKey m_lastKey;
+    bool m_started;
 };
 
 
@@ -351,6 +509,43 @@ inline ElasticIndexKey ElasticIndex::generateKey(const PersistentTable &table, c
     return ElasticIndexKey(generateHash(table, tuple), tuple.address());
 }
 
+inline size_t ElasticIndex::partitionFor(ElasticHash hash) const
+{
+    // Flip the sign bit so that the partitions sort like signed hashes.
+    return static_cast<size_t>((static_cast<uint32_t>(hash) ^ 0x80000000U) >> m_shift);
+}
+
+inline size_t ElasticIndex::size() const
+{
+    // Keys added twice are only dropped once their partition is sorted.
+    if (m_unsortedCount > 0) {
+        for (size_t i = 0; i < m_partitions.size(); i++) {
+            sortedPartition(i);
+        }
+    }
+    return m_size;
+}
+
+inline size_t ElasticIndex::partitionCount() const
+{
+    return m_partitions.size();
+}
+
+inline int64_t ElasticIndex::version() const
+{
+    return m_version;
+}
+
+inline ElasticIndex::const_iterator ElasticIndex::begin() const
+{
+    return const_iterator(this, 0, 0);
+}
+
+inline ElasticIndex::const_iterator ElasticIndex::end() const
+{
+    return const_iterator(this, m_partitions.size(), 0);
+}
+
 /**
  * Return true if key is in the index (indirect from tuple).
  */
@@ -383,68 +578,25 @@ inline bool ElasticIndex::add(const PersistentTable &table, const TableTuple &tu
     return add(generateKey(table, tuple));
 }
 
-/**
- * Add key to index (direct).
- * Return true if it wasn't present and needed to be added.
- */
-inline bool ElasticIndex::add(const ElasticIndexKey &key)
-{
-    bool inserted = false;
-    if (!exists(key)) {
-        inserted = insert(key).second;
-        assert(inserted);
-    }
-    return inserted;
-}
-
 /**
  * Remove key from index.
  * Return true if the key was present and removed.
  */
 inline bool ElasticIndex::remove(const PersistentTable &table, const TableTuple &tuple)
 {
-    bool removed = false;
-    ElasticIndexKey key = generateKey(table, tuple);
-    if (exists(key)) {
-        removed = this->erase(key);
-    }
-    return removed;
+    return erase(generateKey(table, tuple)) > 0;
 }
 
 /**
  * Get full iterator.
  */
-inline ElasticIndex::iterator ElasticIndex::createIterator()
-{
-    return begin();
-}
-
-/**
- * Get partial iterator based on lower bound.
- */
-inline ElasticIndex::iterator ElasticIndex::createLowerBoundIterator(ElasticHash lowerBound)
-{
-    return lower_bound(ElasticIndexKey(lowerBound, (uintptr_t) 0));
-}
-
-/**
- * Get partial iterator based on upper bound.
- */
-inline ElasticIndex::iterator ElasticIndex::createUpperBoundIterator(ElasticHash upperBound)
-{
-    return upper_bound(ElasticIndexKey(upperBound, std::numeric_limits<uintptr_t>::max()));
-}
-
-/**
- * Get full const_iterator.
- */
 inline ElasticIndex::const_iterator ElasticIndex::createIterator() const
 {
     return begin();
 }
 
 /**
- * Get partial const_iterator based on lower bound.
+ * Get partial iterator based on lower bound.
  */
 inline ElasticIndex::const_iterator ElasticIndex::createLowerBoundIterator(ElasticHash lowerBound) const
 {
@@ -452,7 +604,7 @@ inline ElasticIndex::const_iterator ElasticIndex::createLowerBoundIterator(Elast
 }
 
 /**
- * Get partial const_iterator based on upper bound.
+ * Get partial iterator based on upper bound.
  */
 inline ElasticIndex::const_iterator ElasticIndex::createUpperBoundIterator(ElasticHash upperBound) const
 {
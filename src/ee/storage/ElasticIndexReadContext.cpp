@@ -67,13 +67,15 @@ ElasticIndexReadContext::handleActivation(TableStreamType streamType)
         return ACTIVATION_FAILED;
     }
 
-    ElasticIndexHashRange range;
-    if (!parseHashRange(m_predicateStrings, range)) {
+    std::vector<ElasticIndexHashRange> ranges;
+    if (!parseHashRanges(m_predicateStrings, ranges)) {
         LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_ERROR, "Activation failed because parsing the hash range showed a conflict.");
         return ACTIVATION_FAILED;
     }
 
-    m_iter = m_surgeon.getIndexTupleRangeIterator(range);
+    for (size_t i = 0; i < ranges.size(); i++) {
+        m_iters.push_back(m_surgeon.getIndexTupleRangeIterator(ranges[i]));
+    }
     return ACTIVATION_SUCCEEDED;
 }
 
@@ -93,7 +95,7 @@ bool ElasticIndexReadContext::handleDeactivation(TableStreamType streamType)
 }
 
 /*
- * Serialize to output stream. Receive a list of streams, but expect only 1.
+ * Serialize to output streams. Receive a list of streams, one per hash range.
  * Return 1 if tuples remain, 0 if done, or TABLE_STREAM_SERIALIZATION_ERROR on error.
  */
 int64_t ElasticIndexReadContext::handleStreamMore(
@@ -104,23 +106,29 @@ int64_t ElasticIndexReadContext::handleStreamMore(
     int64_t remaining = 1;
 
     // Check that activation happened.
-    if (m_iter == NULL) {
+    if (m_iters.empty()) {
         LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_ERROR,
             "Attempted to begin serialization without activating the context.");
         remaining = TABLE_STREAM_SERIALIZATION_ERROR;
     }
 
     // Need to initialize the output stream list.
-    else if (outputStreams.size() != 1) {
+    else if (outputStreams.size() != m_iters.size()) {
         LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_ERROR,
-            "serializeMore() expects exactly one output stream.");
+            "serializeMore() expects exactly one output stream per hash range.");
         remaining = TABLE_STREAM_SERIALIZATION_ERROR;
     }
 
     else {
         // Anything left?
-        TableTuple tuple;
-        if (!m_iter->next(tuple)) {
+        std::vector<TableTuple> pending(m_iters.size());
+        std::vector<bool> hasPending(m_iters.size(), false);
+        bool anyPending = false;
+        for (size_t i = 0; i < m_iters.size(); i++) {
+            hasPending[i] = m_iters[i]->next(pending[i]);
+            anyPending = anyPending || hasPending[i];
+        }
+        if (!anyPending) {
             remaining = 0;
         }
 
@@ -132,26 +140,30 @@ int64_t ElasticIndexReadContext::handleStreamMore(
                                getPredicates(),
                                getPredicateDeleteFlags());
 
-            // Set to true to break out of the loop after the tuples dry up
-            // or the byte count threshold is hit.
-            bool yield = false;
-            while (!yield) {
-                // If the tuple is pending delete, it's held on by COW but
-                // shouldn't be accessable anymore. So don't write it to the
-                // output.
-                if (!tuple.isPendingDelete()) {
-                    // Write the tuple.
-                    yield = outputStreams.writeRow(tuple);
-                } else {
-                    throwFatalException("Materializing a deleted tuple from the elastic context.");
-                }
-
-                if (!yield) {
-                    if (!m_iter->next(tuple)) {
-                        yield = true;
-                        remaining = 0;
+            // Fill each range's stream until it is full or the range runs dry.
+            bool rangesRemain = false;
+            for (size_t i = 0; i < m_iters.size(); i++) {
+                TupleOutputStream &outputStream = outputStreams.at(i);
+                TableTuple &tuple = pending[i];
+                bool more = hasPending[i];
+                while (more) {
+                    // If the tuple is pending delete, it's held on by COW but
+                    // shouldn't be accessable anymore. So don't write it to the
+                    // output.
+                    if (tuple.isPendingDelete()) {
+                        throwFatalException("Materializing a deleted tuple from the elastic context.");
                     }
+                    outputStream.writeRow(tuple);
+                    // Yield this range when the buffer can't take another tuple.
+                    if (!outputStream.canFit(getMaxTupleLength())) {
+                        break;
+                    }
+                    more = m_iters[i]->next(tuple);
                 }
+                rangesRemain = rangesRemain || more;
+            }
+            if (!rangesRemain) {
+                remaining = 0;
             }
 
             // Need to close the output streams and insert row counts.
@@ -165,7 +177,7 @@ int64_t ElasticIndexReadContext::handleStreamMore(
          */
         /*
         std::ostringstream os;
-        ElasticIndexHashRange range = m_iter->range();
+        ElasticIndexHashRange range = m_iters[0]->range();
         os << "Moved " << outputStreams.at(0).getSerializedRowCount() << " rows for range ["
            << range.getLowerBound() << ", " << range.getUpperBound()
            << "], elastic index size is " << m_surgeon.indexSize();
@@ -173,8 +185,10 @@ int64_t ElasticIndexReadContext::handleStreamMore(
         LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_INFO, os.str().c_str());
          */
 
-        // If more was streamed copy current position for return (exactly one stream).
-        retPositions.push_back((int)outputStreams.at(0).position());
+        // If more was streamed copy current positions for return (one per range).
+        for (size_t i = 0; i < outputStreams.size(); i++) {
+            retPositions.push_back((int)outputStreams.at(i).position());
+        }
 
         // After the index is completely consumed delete index entries and referenced tuples.
         if (remaining <= 0) {
@@ -187,40 +201,55 @@ int64_t ElasticIndexReadContext::handleStreamMore(
 }
 
 /**
- * Parse and validate the hash range.
+ * Parse and validate the hash ranges.
  */
-bool ElasticIndexReadContext::parseHashRange(
+bool ElasticIndexReadContext::parseHashRanges(
         const std::vector<std::string> &predicateStrings,
-        ElasticIndexHashRange &rangeOut)
+        std::vector<ElasticIndexHashRange> &rangesOut)
 {
-    bool success = false;
-    if (predicateStrings.size() != 1) {
-        char errMsg[1024 * 16];
-        snprintf(errMsg, 1024 * 16,
-                 "Too many ElasticIndexReadContext predicates (>1): %ld",
-                 predicateStrings.size());
-        LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_ERROR, errMsg);
+    if (predicateStrings.empty()) {
+        LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_ERROR,
+            "No ElasticIndexReadContext predicates were supplied.");
+        return false;
     }
-    else {
-        std::vector<std::string> rangeStrings = MiscUtil::splitToTwoString(predicateStrings.at(0), ':');
-        if (rangeStrings.size() == 2) {
-            try {
-                rangeOut = ElasticIndexHashRange(boost::lexical_cast<int32_t>(rangeStrings[0]),
-                                                 boost::lexical_cast<int32_t>(rangeStrings[1]));
-                success = true;
+    for (size_t i = 0; i < predicateStrings.size(); i++) {
+        std::vector<std::string> rangeStrings = MiscUtil::splitToTwoString(predicateStrings.at(i), ':');
+        if (rangeStrings.size() != 2) {
+            LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_ERROR, "Hash range did not have two entries");
+            return false;
+        }
+        try {
+            rangesOut.push_back(ElasticIndexHashRange(boost::lexical_cast<int32_t>(rangeStrings[0]),
+                                                      boost::lexical_cast<int32_t>(rangeStrings[1])));
+        }
+        catch(boost::bad_lexical_cast) {
+            char errMsg[1024 * 16];
+            snprintf(errMsg, 1024 * 16,
+                     "Unable to parse ElasticIndexReadContext predicate \"%s\".",
+                     predicateStrings.at(i).c_str());
+            LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_ERROR, errMsg);
+            return false;
+        }
+    }
+    if (rangesOut.size() > 1) {
+        // Ranges are walked inclusively from lower bound to upper bound.
+        for (size_t i = 0; i < rangesOut.size(); i++) {
+            if (rangesOut[i].getLowerBound() > rangesOut[i].getUpperBound()) {
+                LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_ERROR,
+                    "Hash ranges that wrap around can't be streamed alongside other ranges.");
+                return false;
             }
-            catch(boost::bad_lexical_cast) {
-                char errMsg[1024 * 16];
-                snprintf(errMsg, 1024 * 16,
-                         "Unable to parse ElasticIndexReadContext predicate \"%s\".",
-                         predicateStrings.at(0).c_str());
-                LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_ERROR, errMsg);
+            for (size_t j = 0; j < i; j++) {
+                if (rangesOut[i].getLowerBound() <= rangesOut[j].getUpperBound() &&
+                        rangesOut[j].getLowerBound() <= rangesOut[i].getUpperBound()) {
+                    LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_ERROR,
+                        "Hash ranges streamed side by side must not overlap.");
+                    return false;
+                }
             }
-        } else {
-            LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_ERROR, "Hash range did not have two entries");
         }
     }
-    return success;
+    return true;
 }
 
 /**
@@ -232,11 +261,13 @@ void ElasticIndexReadContext::deleteStreamedTuples()
     // Undo token release will cause the index to delete the corresponding items
     // via notifications.
     DRTupleStreamDisableGuard guard(ExecutorContext::getExecutorContext());
-    m_iter->reset();
-    TableTuple tuple;
-    while (m_iter->next(tuple)) {
-        if (!tuple.isPendingDelete()) {
-            m_surgeon.deleteTuple(tuple);
+    for (size_t i = 0; i < m_iters.size(); i++) {
+        m_iters[i]->reset();
+        TableTuple tuple;
+        while (m_iters[i]->next(tuple)) {
+            if (!tuple.isPendingDelete()) {
+                m_surgeon.deleteTuple(tuple);
+            }
         }
     }
 }
@@ -71,13 +71,14 @@ private:
                             const std::vector<std::string> &predicateStrings);
 
     /**
-     * Parse and validate the hash range.
-     * Checks that only one predicate string is provided.
-     * Update rangeOut with parsed hash range.
+     * Parse and validate the hash ranges, one per predicate string.
+     * Several ranges are streamed side by side, one per output stream,
+     * so they must not overlap or wrap around.
+     * Update rangesOut with parsed hash ranges.
      * Return true for success and false for failure.
      */
-    static bool parseHashRange(const std::vector<std::string> &predicateStrings,
-                               ElasticIndexHashRange &rangeOut);
+    static bool parseHashRanges(const std::vector<std::string> &predicateStrings,
+                                std::vector<ElasticIndexHashRange> &rangesOut);
 
     /**
      * Clean up after consuming indexed tuples.
@@ -87,8 +88,8 @@ private:
     /// Predicate strings (parsed in handleActivation()/handleReactivation()).
     const std::vector<std::string> &m_predicateStrings;
 
-    /// Elastic index iterator
-    boost::shared_ptr<ElasticIndexTupleRangeIterator> m_iter;
+    /// Elastic index iterators, one per range and output stream
+    std::vector<boost::shared_ptr<ElasticIndexTupleRangeIterator> > m_iters;
 
     /// Set to true after index was completely materialized.
     bool m_materialized;
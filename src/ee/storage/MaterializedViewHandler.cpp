@@ -363,6 +363,7 @@ namespace voltdb {
         }
         backups[m_groupByColumnCount] = params[m_groupByColumnCount];
         params[m_groupByColumnCount] = m_existingTuple.getNValue(columnIndex);
+        ec->parametersChanged();
         // Then we get the executor vectors we need to run:
         vector<AbstractExecutor*> executorList = m_minMaxExecutorVectors[minMaxColumnIndex]->getExecutorList();
         UniqueTempTableResult resultTable = ec->executeExecutors(executorList);
@@ -375,6 +376,7 @@ namespace voltdb {
         for (int i=0; i<=m_groupByColumnCount; i++) {
             params[i] = backups[i];
         }
+        ec->parametersChanged();
         return newValue;
     }
 
@@ -359,6 +359,7 @@ NValue MaterializedViewTriggerForWrite::findFallbackValueUsingPlan(const TableTu
     }
     backups[colindex] = params[colindex];
     params[colindex] = oldValue;
+    context->parametersChanged();
     // executing the stored plan.
     vector<AbstractExecutor*> executorList = m_fallbackExecutorVectors[minMaxAggIdx]->getExecutorList();
     UniqueTempTableResult tbl = context->executeExecutors(executorList, 0);
@@ -379,6 +380,7 @@ NValue MaterializedViewTriggerForWrite::findFallbackValueUsingPlan(const TableTu
     for (colindex = 0; colindex <= m_groupByColumnCount; colindex++) {
         params[colindex] = backups[colindex];
     }
+    context->parametersChanged();
     return newVal;
 }
 
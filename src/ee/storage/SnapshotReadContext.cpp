@@ -0,0 +1,231 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/SnapshotReadContext.h"
+#include "storage/persistenttable.h"
+#include "storage/tablefactory.h"
+#include "storage/temptable.h"
+#include "storage/TupleIterator.h"
+#include "common/TupleOutputStream.h"
+#include "common/TupleOutputStreamProcessor.h"
+#include "common/FatalException.hpp"
+#include "logging/LogManager.h"
+#include <algorithm>
+
+namespace voltdb {
+
+/**
+ * Constructor.
+ */
+SnapshotReadContext::SnapshotReadContext(
+        PersistentTable &table,
+        PersistentTableSurgeon &surgeon,
+        int32_t partitionId) :
+    TableStreamerContext(table, surgeon, partitionId),
+    m_scanAddress(NULL),
+    m_blockEnd(NULL),
+    m_backedUpTuples(TableFactory::buildCopiedTempTable("Snapshot read of " + table.name(),
+                                                        &table, NULL)),
+    m_tupleLength(table.getTupleLength()),
+    m_blockSize(table.getTableAllocationSize()),
+    m_finishedTableScan(false),
+    m_tuplesRemaining(0)
+{}
+
+/**
+ * Destructor.
+ */
+SnapshotReadContext::~SnapshotReadContext()
+{}
+
+/**
+ * Activation handler.
+ */
+TableStreamerContext::ActivationReturnCode
+SnapshotReadContext::handleActivation(TableStreamType streamType)
+{
+    if (streamType != TABLE_STREAM_SNAPSHOT_READ) {
+        return ACTIVATION_UNSUPPORTED;
+    }
+
+    // Capture the blocks as they are now. Blocks allocated later only ever
+    // hold tuples that are not part of the image.
+    m_blocks = m_surgeon.getData();
+    m_blockIterator = m_blocks.begin();
+    m_tuplesRemaining = getTable().activeTupleCount();
+    return ACTIVATION_SUCCEEDED;
+}
+
+/**
+ * Reactivation handler.
+ */
+TableStreamerContext::ActivationReturnCode
+SnapshotReadContext::handleReactivation(TableStreamType streamType)
+{
+    if (streamType != TABLE_STREAM_SNAPSHOT_READ) {
+        return ACTIVATION_UNSUPPORTED;
+    }
+    LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_WARN,
+        "Snapshot read activation is not allowed while another read of the table is in progress.");
+    return ACTIVATION_FAILED;
+}
+
+/*
+ * Serialize to multiple output streams.
+ * Return remaining tuple count (an estimate while tuples remain), 0 if done.
+ */
+int64_t SnapshotReadContext::handleStreamMore(TupleOutputStreamProcessor &outputStreams,
+                                              std::vector<int> &retPositions)
+{
+    if (outputStreams.empty()) {
+        throwFatalException("serializeMore() expects at least one output stream.");
+    }
+    outputStreams.open(getTable(),
+                       getMaxTupleLength(),
+                       getPartitionId(),
+                       getPredicates(),
+                       getPredicateDeleteFlags());
+
+    TableTuple tuple(getTable().schema());
+    bool yield = false;
+    bool done = false;
+    while (!yield) {
+        bool hasMore;
+        if (!m_finishedTableScan) {
+            hasMore = nextScannedTuple(tuple);
+            if (!hasMore) {
+                // Nothing is ahead of the scan any more, so no further
+                // pre-images will be taken. Let go of the captured blocks.
+                m_finishedTableScan = true;
+                m_skippedSlots.clear();
+                m_blocks.clear();
+                m_backedUpIterator.reset(m_backedUpTuples->makeIterator());
+                continue;
+            }
+        }
+        else {
+            hasMore = m_backedUpIterator->next(tuple);
+        }
+        if (!hasMore) {
+            done = true;
+            break;
+        }
+        if (m_tuplesRemaining > 0) {
+            m_tuplesRemaining--;
+        }
+        yield = outputStreams.writeRow(tuple);
+    }
+
+    outputStreams.close();
+    for (size_t i = 0; i < outputStreams.size(); i++) {
+        retPositions.push_back((int)outputStreams.at(i).position());
+    }
+
+    if (done) {
+        return 0;
+    }
+    // The count taken at activation can run out before the pre-images do.
+    return std::max(m_tuplesRemaining, static_cast<int64_t>(1));
+}
+
+bool SnapshotReadContext::nextScannedTuple(TableTuple &tuple)
+{
+    while (true) {
+        if (m_scanAddress == m_blockEnd) {
+            if (m_blockIterator == m_blocks.end()) {
+                return false;
+            }
+            TBPtr block = m_blockIterator.data();
+            m_scanAddress = block->address();
+            m_blockEnd = m_scanAddress + m_tupleLength * block->unusedTupleBoundry();
+            m_blockIterator++;
+            continue;
+        }
+        char *slot = m_scanAddress;
+        m_scanAddress += m_tupleLength;
+        if (!m_skippedSlots.empty() && m_skippedSlots.erase(slot) > 0) {
+            continue;
+        }
+        tuple.move(slot);
+        // Tuples already pending delete when the read started are not part
+        // of the image; any that became so later were preserved and skipped.
+        if (tuple.isActive() && !tuple.isPendingDelete()) {
+            return true;
+        }
+    }
+}
+
+/**
+ * Blocks are scanned in address order, so anything in a captured block
+ * at or beyond the scan address has yet to be read.
+ */
+bool SnapshotReadContext::isAheadOfScan(char *tupleAddress)
+{
+    if (m_finishedTableScan || tupleAddress < m_scanAddress) {
+        return false;
+    }
+    return PersistentTable::findBlock(tupleAddress, m_blocks, m_blockSize).get() != NULL;
+}
+
+void SnapshotReadContext::preserveTuple(TableTuple &tuple)
+{
+    char *slot = tuple.address();
+    if (!isAheadOfScan(slot) || !m_skippedSlots.insert(slot).second) {
+        return;
+    }
+    if (tuple.isActive() && !tuple.isPendingDelete()) {
+        m_backedUpTuples->insertTempTupleDeepCopy(tuple, &m_pool);
+    }
+}
+
+bool SnapshotReadContext::notifyTupleInsert(TableTuple &tuple)
+{
+    if (isAheadOfScan(tuple.address())) {
+        m_skippedSlots.insert(tuple.address());
+    }
+    // The dirty flag belongs to the snapshot, if there is one.
+    return false;
+}
+
+bool SnapshotReadContext::notifyTupleUpdate(TableTuple &tuple)
+{
+    preserveTuple(tuple);
+    return true;
+}
+
+bool SnapshotReadContext::notifyTupleDelete(TableTuple &tuple)
+{
+    preserveTuple(tuple);
+    return true;
+}
+
+void SnapshotReadContext::notifyTupleMovement(TBPtr sourceBlock, TBPtr targetBlock,
+                                              TableTuple &sourceTuple, TableTuple &targetTuple)
+{
+    // The source slot has already been marked inactive, so preserve its
+    // content through the target, which holds an identical copy.
+    char *sourceSlot = sourceTuple.address();
+    if (isAheadOfScan(sourceSlot) && m_skippedSlots.insert(sourceSlot).second &&
+            targetTuple.isActive() && !targetTuple.isPendingDelete()) {
+        m_backedUpTuples->insertTempTupleDeepCopy(targetTuple, &m_pool);
+    }
+    if (isAheadOfScan(targetTuple.address())) {
+        m_skippedSlots.insert(targetTuple.address());
+    }
+}
+
+}
@@ -0,0 +1,165 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SNAPSHOT_READ_CONTEXT_H_
+#define SNAPSHOT_READ_CONTEXT_H_
+
+#include <string>
+#include <vector>
+#include <boost/scoped_ptr.hpp>
+#include <boost/unordered_set.hpp>
+#include "common/Pool.hpp"
+#include "storage/TableStreamer.h"
+#include "storage/TableStreamerContext.h"
+#include "storage/TupleBlock.h"
+
+namespace voltdb {
+class PersistentTableSurgeon;
+class TempTable;
+class TupleIterator;
+class TupleOutputStreamProcessor;
+
+/**
+ * Streams the table as it was when the stream was activated, in slices,
+ * while the site thread keeps committing writes in between. This is only
+ * the stream context; nothing runs read-only fragments against it yet.
+ *
+ * Unlike CopyOnWriteContext this context neither activates the table's
+ * snapshot bookkeeping nor uses the tuple dirty flags, so it can run
+ * alongside a snapshot. It holds on to the blocks that existed at
+ * activation and scans them in address order. Tuples ahead of the scan
+ * that are updated, deleted or moved by compaction have their pre-images
+ * copied aside and the slot is remembered, as are slots ahead of the scan
+ * that are filled after activation. The copies are streamed after the
+ * scan finishes.
+ */
+class SnapshotReadContext : public TableStreamerContext {
+
+    friend bool TableStreamer::activateStream(PersistentTableSurgeon&,
+                                              TableStreamType, const std::vector<std::string>&);
+
+public:
+
+    virtual ~SnapshotReadContext();
+
+    /**
+     * Activation handler.
+     */
+    virtual ActivationReturnCode handleActivation(TableStreamType streamType);
+
+    /**
+     * Reactivation handler. Only one read of a table may be in progress.
+     */
+    virtual ActivationReturnCode handleReactivation(TableStreamType streamType);
+
+    /**
+     * Mandatory TableStreamContext override.
+     */
+    virtual int64_t handleStreamMore(TupleOutputStreamProcessor &outputStreams,
+                                     std::vector<int> &retPositions);
+
+    /**
+     * Tuple insert handler.
+     */
+    virtual bool notifyTupleInsert(TableTuple &tuple);
+
+    /**
+     * Tuple update handler.
+     */
+    virtual bool notifyTupleUpdate(TableTuple &tuple);
+
+    /**
+     * Tuple delete handler.
+     */
+    virtual bool notifyTupleDelete(TableTuple &tuple);
+
+    /**
+     * Tuple compaction handler.
+     */
+    virtual void notifyTupleMovement(TBPtr sourceBlock, TBPtr targetBlock,
+                                     TableTuple &sourceTuple, TableTuple &targetTuple);
+
+private:
+
+    /**
+     * Construct a snapshot read context for the specified table.
+     * Private so that only TableStreamer::activateStream() can call.
+     */
+    SnapshotReadContext(PersistentTable &table,
+                        PersistentTableSurgeon &surgeon,
+                        int32_t partitionId);
+
+    /**
+     * Return true if the tuple lives in a block that was captured at
+     * activation and the scan has not reached it yet.
+     */
+    bool isAheadOfScan(char *tupleAddress);
+
+    /**
+     * Copy a tuple that is still part of the captured image aside before
+     * it changes, and make the scan skip its slot.
+     */
+    void preserveTuple(TableTuple &tuple);
+
+    /**
+     * Get the next tuple of the captured image from the blocks, or return
+     * false when the blocks are exhausted.
+     */
+    bool nextScannedTuple(TableTuple &tuple);
+
+    /**
+     * Blocks of the table at activation. Holding the pointers keeps the
+     * storage of blocks that are compacted away alive until the scan is done.
+     */
+    TBMap m_blocks;
+    TBMapI m_blockIterator;
+
+    /**
+     * Next slot to scan and the end of the used slots of its block.
+     */
+    char *m_scanAddress;
+    char *m_blockEnd;
+
+    /**
+     * Slots ahead of the scan whose content is no longer part of the image.
+     */
+    boost::unordered_set<char*> m_skippedSlots;
+
+    /**
+     * Pre-images of tuples that changed ahead of the scan.
+     */
+    boost::scoped_ptr<TempTable> m_backedUpTuples;
+
+    /**
+     * Memory pool for the pre-images' out-of-line strings.
+     */
+    Pool m_pool;
+
+    boost::scoped_ptr<TupleIterator> m_backedUpIterator;
+
+    const uint32_t m_tupleLength;
+
+    const int m_blockSize;
+
+    bool m_finishedTableScan;
+
+    int64_t m_tuplesRemaining;
+};
+
+}
+
+#endif /* SNAPSHOT_READ_CONTEXT_H_ */
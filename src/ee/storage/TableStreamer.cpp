@@ -23,6 +23,7 @@
 #include "storage/CopyOnWriteContext.h"
 #include "storage/ElasticContext.h"
 #include "storage/ElasticIndexReadContext.h"
+#include "storage/SnapshotReadContext.h"
 #include "common/TupleOutputStream.h"
 #include "common/TupleOutputStreamProcessor.h"
 #include "logging/LogManager.h"
@@ -118,6 +119,10 @@ bool TableStreamer::activateStream(PersistentTableSurgeon &surgeon,
                                                               predicateStrings));
                     break;
 
+                case TABLE_STREAM_SNAPSHOT_READ:
+                    context.reset(new SnapshotReadContext(m_table, surgeon, m_partitionId));
+                    break;
+
                 case TABLE_STREAM_ELASTIC_INDEX_CLEAR:
                     VOLT_DEBUG("Clear elastic index before materializing it.");
                     // not an error
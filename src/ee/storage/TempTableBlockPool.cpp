@@ -0,0 +1,95 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "storage/TempTableBlockPool.h"
+
+#include <cassert>
+#include <cstring>
+
+namespace voltdb {
+
+TempTableBlockPool::TempTableBlockPool()
+  : m_memoryLimit(DEFAULT_MEMORY_LIMIT),
+    m_memoryHeld(0),
+    m_peakMemoryHeld(0),
+    m_hits(0),
+    m_misses(0),
+    m_discards(0)
+{ }
+
+TempTableBlockPool::~TempTableBlockPool() {
+    freeDownTo(0);
+}
+
+char* TempTableBlockPool::acquire(int32_t size) {
+    FreeStorageMap::iterator found = m_freeStorage.find(size);
+    if (found != m_freeStorage.end() && !found->second.empty()) {
+        char* storage = found->second.back();
+        found->second.pop_back();
+        m_memoryHeld -= size;
+        ++m_hits;
+        return storage;
+    }
+    ++m_misses;
+    return new char[size];
+}
+
+void TempTableBlockPool::release(char* storage, int32_t size) {
+    if (m_memoryHeld + size > m_memoryLimit) {
+        ++m_discards;
+        delete [] storage;
+        return;
+    }
+    keep(storage, size);
+}
+
+void TempTableBlockPool::prefault(int32_t size, int32_t count) {
+    for (int32_t i = 0; i < count && m_memoryHeld + size <= m_memoryLimit; ++i) {
+        char* storage = new char[size];
+        // Writing every page is what makes the kernel back it
+        ::memset(storage, 0, size);
+        keep(storage, size);
+    }
+}
+
+void TempTableBlockPool::setMemoryLimit(int64_t memoryLimit) {
+    assert(memoryLimit >= 0);
+    m_memoryLimit = memoryLimit;
+    freeDownTo(memoryLimit);
+}
+
+void TempTableBlockPool::keep(char* storage, int32_t size) {
+    m_freeStorage[size].push_back(storage);
+    m_memoryHeld += size;
+    if (m_memoryHeld > m_peakMemoryHeld) {
+        m_peakMemoryHeld = m_memoryHeld;
+    }
+}
+
+void TempTableBlockPool::freeDownTo(int64_t memoryLimit) {
+    for (FreeStorageMap::iterator i = m_freeStorage.begin();
+            i != m_freeStorage.end() && m_memoryHeld > memoryLimit; ++i) {
+        std::vector<char*>& storage = i->second;
+        while (!storage.empty() && m_memoryHeld > memoryLimit) {
+            delete [] storage.back();
+            storage.pop_back();
+            m_memoryHeld -= i->first;
+        }
+    }
+}
+
+} // namespace voltdb
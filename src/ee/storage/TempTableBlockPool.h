@@ -0,0 +1,97 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _EE_STORAGE_TEMPTABLEBLOCKPOOL_H_
+#define _EE_STORAGE_TEMPTABLEBLOCKPOOL_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "boost/unordered_map.hpp"
+
+namespace voltdb {
+
+/**
+ * Keep the storage of the blocks that temp tables let go of, so that the
+ * next temp tables can reuse it rather than allocating, and page faulting
+ * in, fresh memory on every execution. Storage is kept by size, up to the
+ * memory limit; storage given back beyond the limit is freed.
+ */
+class TempTableBlockPool {
+public:
+    /// How much storage is kept for reuse unless told otherwise
+    static const int64_t DEFAULT_MEMORY_LIMIT = 32 * 1024 * 1024;
+
+    TempTableBlockPool();
+    ~TempTableBlockPool();
+
+    /**
+     * Storage for a block of the given size, reused if some was given
+     * back, otherwise freshly allocated.
+     */
+    char* acquire(int32_t size);
+
+    /**
+     * Give back storage from acquire(). It is kept for reuse if that stays
+     * within the memory limit, otherwise it is freed.
+     */
+    void release(char* storage, int32_t size);
+
+    /**
+     * Allocate and touch count blocks of the given size ahead of time, so
+     * that the first executions do not take the page faults. Stops short
+     * of the memory limit.
+     */
+    void prefault(int32_t size, int32_t count);
+
+    /**
+     * Change how much storage may be kept, freeing storage now held
+     * beyond it. A limit of zero keeps nothing.
+     */
+    void setMemoryLimit(int64_t memoryLimit);
+
+    int64_t memoryLimit() const { return m_memoryLimit; }
+    int64_t memoryHeld() const { return m_memoryHeld; }
+    int64_t peakMemoryHeld() const { return m_peakMemoryHeld; }
+
+    /// Acquisitions served from storage kept for reuse
+    int64_t hits() const { return m_hits; }
+    /// Acquisitions that had to allocate
+    int64_t misses() const { return m_misses; }
+    /// Storage given back that was freed for lack of room
+    int64_t discards() const { return m_discards; }
+
+private:
+    TempTableBlockPool(const TempTableBlockPool&);
+    TempTableBlockPool& operator=(const TempTableBlockPool&);
+
+    void keep(char* storage, int32_t size);
+    void freeDownTo(int64_t memoryLimit);
+
+    typedef boost::unordered_map<int32_t, std::vector<char*> > FreeStorageMap;
+    FreeStorageMap m_freeStorage;
+    int64_t m_memoryLimit;
+    int64_t m_memoryHeld;
+    int64_t m_peakMemoryHeld;
+    int64_t m_hits;
+    int64_t m_misses;
+    int64_t m_discards;
+};
+
+} // namespace voltdb
+
+#endif // _EE_STORAGE_TEMPTABLEBLOCKPOOL_H_
@@ -45,6 +45,7 @@ public:
     void reduceAllocated(int bytes);
 
     int64_t getAllocated() const { return m_currMemoryInBytes; }
+    int64_t getMemoryLimit() const { return m_memoryLimit; }
     int64_t getPeakMemoryInBytes() const { return m_peakMemoryInBytes; }
     void resetPeakMemory() { m_peakMemoryInBytes = m_currMemoryInBytes; }
 
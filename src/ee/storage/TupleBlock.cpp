@@ -15,16 +15,20 @@
  * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "storage/TupleBlock.h"
+#include "storage/ColdBlockStore.h"
+#include "storage/TempTableBlockPool.h"
 #include "storage/table.h"
 #include <sys/mman.h>
 #include <errno.h>
 #include "common/ThreadLocalPool.h"
+#include "logging/LogManager.h"
 
 namespace voltdb {
 
 volatile int tupleBlocksAllocated = 0;
 
-TupleBlock::TupleBlock(Table *table, TBBucketPtr bucket) :
+TupleBlock::TupleBlock(Table *table, TBBucketPtr bucket, bool tierable,
+                       TempTableBlockPool* storagePool) :
         m_storage(NULL),
         m_references(0),
         m_tupleLength(table->m_tupleLength),
@@ -33,8 +37,30 @@ TupleBlock::TupleBlock(Table *table, TBBucketPtr bucket) :
         m_nextFreeTuple(0),
         m_lastCompactionOffset(0),
         m_bucket(bucket),
-        m_bucketIndex(0)
+        m_bucketIndex(0),
+        m_mappedSize(0),
+        m_accessed(true),
+        m_lastAccess(0),
+        m_coldSlot(-1),
+        m_storagePool(NULL),
+        m_storageSize(0)
 {
+    if (tierable) {
+        m_mappedSize = ColdBlockStore::blockSizeFor(table->m_tableAllocationSize);
+        m_storage = static_cast<char*>(::mmap(0, m_mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0));
+        if (m_storage == MAP_FAILED) {
+            throwFatalException("Failed mmap: %s", strerror(errno));
+        }
+        tupleBlocksAllocated++;
+        return;
+    }
+    if (storagePool != NULL) {
+        m_storagePool = storagePool;
+        m_storageSize = table->m_tableAllocationSize;
+        m_storage = storagePool->acquire(m_storageSize);
+        tupleBlocksAllocated++;
+        return;
+    }
 #ifdef USE_MMAP
     size_t tableAllocationSize = static_cast<size_t> (m_tupleLength * m_tuplesPerBlock);
     m_storage = static_cast<char*>(::mmap( 0, tableAllocationSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0 ));
@@ -49,6 +75,21 @@ TupleBlock::TupleBlock(Table *table, TBBucketPtr bucket) :
 }
 
 TupleBlock::~TupleBlock() {
+    if (m_mappedSize != 0) {
+        // Destructors can't throw; a failure here only leaks the mapping
+        if (::munmap(m_storage, m_mappedSize) != 0) {
+            LogManager::getThreadLogger(LOGGERID_HOST)->log(LOGLEVEL_ERROR,
+                    (std::string("Failed munmap of a table block: ") + strerror(errno)).c_str());
+        }
+        if (m_coldStore) {
+            m_coldStore->release(m_coldSlot);
+        }
+        return;
+    }
+    if (m_storagePool != NULL) {
+        m_storagePool->release(m_storage, m_storageSize);
+        return;
+    }
 #ifdef USE_MMAP
     size_t tableAllocationSize = static_cast<size_t> (m_tupleLength * m_tuplesPerBlock);
     if (::munmap( m_storage, tableAllocationSize) != 0) {
@@ -60,7 +101,8 @@ TupleBlock::~TupleBlock() {
 #endif
 }
 
-std::pair<int, int> TupleBlock::merge(Table *table, TBPtr source, TupleMovementListener *listener) {
+std::pair<int, int> TupleBlock::merge(Table *table, TBPtr source, TupleMovementListener *listener,
+                                      uint32_t maxTupleMoves) {
     assert(source != this);
     /*
       std::cout << "Attempting to merge " << static_cast<void*> (this)
@@ -72,7 +114,8 @@ std::pair<int, int> TupleBlock::merge(Table *table, TBPtr source, TupleMovementL
 
     uint32_t m_nextTupleInSourceOffset = source->lastCompactionOffset();
     int sourceTuplesPendingDeleteOnUndoRelease = 0;
-    while (hasFreeTuples() && !source->isEmpty()) {
+    uint32_t tuplesMoved = 0;
+    while (hasFreeTuples() && !source->isEmpty() && tuplesMoved < maxTupleMoves) {
         TableTuple sourceTupleWithNewValues(table->schema());
         TableTuple destinationTuple(table->schema());
 
@@ -116,6 +159,7 @@ std::pair<int, int> TupleBlock::merge(Table *table, TBPtr source, TupleMovementL
         }
 
         source->freeTuple(sourceTupleWithNewValues.address());
+        tuplesMoved++;
     }
     source->lastCompactionOffset(m_nextTupleInSourceOffset);
 
@@ -131,5 +175,37 @@ std::pair<int, int> TupleBlock::merge(Table *table, TBPtr source, TupleMovementL
         return std::pair<int, int>(NO_NEW_BUCKET_INDEX, source->calculateBucketIndex(sourceTuplesPendingDeleteOnUndoRelease));
     }
 }
+
+bool TupleBlock::moveToColdStore(const boost::shared_ptr<ColdBlockStore>& store) {
+    assert(isTierable() && !isCold());
+    assert(store->blockSize() == m_mappedSize);
+    int64_t slot = store->write(m_storage);
+    if (slot < 0) {
+        return false;
+    }
+    // Same contents at the same address, so tuple pointers held by indexes
+    // and iterators stay valid; the anonymous pages are freed.
+    store->mapAt(m_storage, slot);
+    store->startWriteback(slot);
+    m_coldStore = store;
+    m_coldSlot = slot;
+    return true;
+}
+
+void TupleBlock::releaseColdSlot() {
+    assert(isCold());
+    void* mapped = ::mmap(m_storage, m_mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON | MAP_FIXED, -1, 0);
+    if (mapped == MAP_FAILED) {
+        throwFatalException("Failed mmap: %s", strerror(errno));
+    }
+    m_coldStore->release(m_coldSlot);
+    m_coldStore.reset();
+    m_coldSlot = -1;
+}
+
+void TupleBlock::dropCachedPages() {
+    assert(isCold());
+    m_coldStore->dropCachedPages(m_coldSlot);
+}
 }
 
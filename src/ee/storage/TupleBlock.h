@@ -21,6 +21,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <cassert>
+#include <limits>
 
 #include "boost/scoped_array.hpp"
 #include "boost/shared_ptr.hpp"
@@ -46,7 +47,9 @@ void intrusive_ptr_release(voltdb::TupleBlock * p);
 #include "boost/intrusive_ptr.hpp"
 
 namespace voltdb {
+class ColdBlockStore;
 class Table;
+class TempTableBlockPool;
 class TupleMovementListener;
 
 class TruncatedInt {
@@ -89,7 +92,15 @@ class TupleBlock {
     friend void ::intrusive_ptr_add_ref(voltdb::TupleBlock * p);
     friend void ::intrusive_ptr_release(voltdb::TupleBlock * p);
 public:
-    TupleBlock(Table *table, TBBucketPtr bucket);
+    /**
+     * A tierable block has its storage mapped on its own pages, so that it
+     * can later be moved to a ColdBlockStore. Persistent tables allocate all
+     * of their blocks this way, so that any block can go cold once the table
+     * is given a cold tier. A block given a storage pool
+     * takes its storage from the pool and gives it back when destroyed.
+     */
+    TupleBlock(Table *table, TBBucketPtr bucket, bool tierable = false,
+               TempTableBlockPool* storagePool = NULL);
 
     void* operator new(std::size_t sz)
     {
@@ -149,7 +160,13 @@ public:
         return m_bucketIndex;
     }
 
-    std::pair<int, int> merge(Table *table, TBPtr source, TupleMovementListener *listener = NULL);
+    /**
+     * Move tuples from the source block into this one until this block is
+     * full, the source has nothing left to move, or maxTupleMoves tuples
+     * have been moved.
+     */
+    std::pair<int, int> merge(Table *table, TBPtr source, TupleMovementListener *listener = NULL,
+                              uint32_t maxTupleMoves = std::numeric_limits<uint32_t>::max());
 
     /**
      * Find next free tuple storage address and its tupleblock's bucket index,
@@ -168,6 +185,7 @@ public:
             m_nextFreeTuple++;
         }
         m_activeTuples++;
+        m_accessed = true;
         int newBucketIndex = calculateBucketIndex();
         if (newBucketIndex == m_bucketIndex) {
             // tuple block is not too full for its current bucket
@@ -192,6 +210,7 @@ public:
     inline int freeTuple(char *tupleStorage) {
         m_lastCompactionOffset = 0;
         m_activeTuples--;
+        m_accessed = true;
         //Find the offset
         uint32_t offset = static_cast<uint32_t>(tupleStorage - m_storage);
         m_freeList.push_back(offset);
@@ -235,6 +254,54 @@ public:
     inline TBBucketPtr currentBucket() {
         return m_bucket;
     }
+
+    /** Note that the block has been scanned or changed */
+    inline void markAccessed() {
+        m_accessed = true;
+    }
+
+    /**
+     * Return whether the block was accessed since the last call, and stamp
+     * it with the given time if it was.
+     */
+    inline bool checkAccessed(int64_t now) {
+        if (!m_accessed) {
+            return false;
+        }
+        m_accessed = false;
+        m_lastAccess = now;
+        return true;
+    }
+
+    inline int64_t lastAccess() const {
+        return m_lastAccess;
+    }
+
+    inline bool isTierable() const {
+        return m_mappedSize != 0;
+    }
+
+    inline bool isCold() const {
+        return m_coldSlot >= 0;
+    }
+
+    /**
+     * Write the storage of a tierable block to the store and map it from
+     * there. Returns false, leaving the block in memory, if the write failed.
+     * Writing the pages back to the file is started but not waited for, and
+     * they stay in the page cache until dropCachedPages().
+     */
+    bool moveToColdStore(const boost::shared_ptr<ColdBlockStore>& store);
+
+    void dropCachedPages();
+
+    /**
+     * Give a cold block's slot back to its store and back the block with
+     * anonymous memory again. Called when the table drops an empty block,
+     * as the block itself can outlive that (erased btree slots keep
+     * copies of their values until they are reused).
+     */
+    void releaseColdSlot();
 private:
     char*   m_storage;
     uint32_t m_references;
@@ -255,6 +322,17 @@ private:
 
     TBBucketPtr m_bucket;
     int m_bucketIndex;
+
+    // Size of the storage mapping for a tierable block, zero otherwise
+    size_t m_mappedSize;
+    bool m_accessed;
+    int64_t m_lastAccess;
+    boost::shared_ptr<ColdBlockStore> m_coldStore;
+    int64_t m_coldSlot;
+
+    // Where the storage came from and goes back to, if from a pool
+    TempTableBlockPool* m_storagePool;
+    int32_t m_storageSize;
 };
 
 /**
@@ -69,6 +69,7 @@
 #include "common/UndoQuantum.h"
 #include "common/executorcontext.hpp"
 #include "common/FatalException.hpp"
+#include "common/StringDictionary.h"
 #include "common/types.h"
 #include "common/RecoveryProtoMessage.h"
 #include "common/StreamPredicateList.h"
@@ -87,6 +88,7 @@
 #include <boost/scoped_ptr.hpp>
 
 #include <algorithm> // std::find
+#include <atomic>
 #include <cassert>
 #include <cstdio>
 #include <sstream>
@@ -113,6 +115,9 @@ private:
     TableTuple& m_target;
 };
 
+// Tables are created by every site thread, so instance ids come from a shared counter.
+static std::atomic<int64_t> s_nextInstanceId(1);
+
 PersistentTable::PersistentTable(int partitionColumn, char const* signature, bool isMaterialized, int tableAllocationTargetSize, int tupleLimit, bool drEnabled) :
     Table(tableAllocationTargetSize == 0 ? TABLE_BLOCKSIZE : tableAllocationTargetSize),
     m_iter(this),
@@ -121,7 +126,14 @@ PersistentTable::PersistentTable(int partitionColumn, char const* signature, boo
     m_tupleLimit(tupleLimit),
     m_purgeExecutorVector(),
     m_stats(this),
+    m_compactionStats(this),
     m_failedCompactionCount(0),
+    m_incrementalCompaction(false),
+    m_compactionTuplesMoved(0),
+    m_compactionBlocksReclaimed(0),
+    m_compactionMicros(0),
+    m_coldAfterTicks(0),
+    m_coldTierClock(0),
     m_invisibleTuplesPendingDeleteCount(0),
     m_surgeon(*this),
     m_tableForStreamIndexing(NULL),
@@ -134,7 +146,9 @@ PersistentTable::PersistentTable(int partitionColumn, char const* signature, boo
     m_pkeyIndex(NULL),
     m_mvHandler(NULL),
     m_deltaTable(NULL),
-    m_deltaTableActive(false)
+    m_deltaTableActive(false),
+    m_instanceId(s_nextInstanceId++),
+    m_modificationCount(0)
 {
     // this happens here because m_data might not be initialized above
     m_iter.reset(m_data.begin());
@@ -193,6 +207,14 @@ PersistentTable::~PersistentTable() {
         tuple.setActiveFalse();
     }
 
+    // Undo actions may still hold strings from the dictionaries,
+    // which then outlive the table.
+    BOOST_FOREACH (auto dictionary, m_stringDictionaries) {
+        if (dictionary) {
+            dictionary->detach();
+        }
+    }
+
     // note this class has ownership of the views, even if they
     // were allocated by VoltDBEngine
     BOOST_FOREACH (auto view, m_views) {
@@ -520,6 +542,17 @@ void PersistentTable::truncateTable(VoltDBEngine* engine, bool fallible) {
         emptyTable->swapPurgeExecutorVector(evPtr);
     }
 
+    // The new table moves its cold blocks to its own file
+    if (hasColdTier()) {
+        emptyTable->enableColdTier(m_coldTierDirectory, m_coldAfterTicks);
+    }
+    // ... and shares its strings through dictionaries of its own.
+    for (size_t ii = 0; ii < m_stringDictionaries.size(); ii++) {
+        if (m_stringDictionaries[ii]) {
+            emptyTable->enableStringDictionary(m_schema->getUninlinedObjectColumnInfoIndex(static_cast<int>(ii)));
+        }
+    }
+
     engine->rebuildTableCollections();
 
     ExecutorContext* ec = ExecutorContext::getExecutorContext();
@@ -772,7 +805,7 @@ void PersistentTable::insertPersistentTuple(TableTuple& source, bool fallible, b
     //
     // Then copy the source into the target
     //
-    target.copyForPersistentInsert(source); // tuple in freelist must be already cleared
+    target.copyForPersistentInsert(source, NULL, stringDictionaries()); // tuple in freelist must be already cleared
 
     try {
         insertTupleCommon(source, target, fallible);
@@ -789,6 +822,7 @@ void PersistentTable::insertPersistentTuple(TableTuple& source, bool fallible, b
 
 void PersistentTable::insertTupleCommon(TableTuple& source, TableTuple& target,
                                         bool fallible, bool shouldDRStream) {
+    ++m_modificationCount;
     if (fallible) {
         // not null checks at first
         FAIL_IF(!checkNulls(target)) {
@@ -882,6 +916,7 @@ void PersistentTable::insertTupleCommon(TableTuple& source, TableTuple& target,
  * strings or create an UndoAction or update a materialized view.
  */
 void PersistentTable::insertTupleForUndo(char* tuple) {
+    ++m_modificationCount;
     TableTuple target(m_schema);
     target.move(tuple);
     target.setPendingDeleteOnUndoReleaseFalse();
@@ -916,6 +951,11 @@ void PersistentTable::updateTupleWithSpecificIndexes(TableTuple& targetTupleToUp
                                                      std::vector<TableIndex*> const& indexesToUpdate,
                                                      bool fallible,
                                                      bool updateDRTimestamp) {
+    ++m_modificationCount;
+    if (m_coldStore) {
+        // The tuple is changed in place, not through its block
+        findBlock(targetTupleToUpdate.address(), m_data, m_tableAllocationSize)->markAccessed();
+    }
     UndoQuantum* uq = NULL;
     char* oldTupleData = NULL;
     int tupleLength = targetTupleToUpdate.tupleLength();
@@ -1021,7 +1061,6 @@ void PersistentTable::updateTupleWithSpecificIndexes(TableTuple& targetTupleToUp
 
     if (m_schema->getUninlinedObjectColumnCount() != 0) {
         decreaseStringMemCount(targetTupleToUpdate.getNonInlinedMemorySize());
-        increaseStringMemCount(sourceTupleWithNewValues.getNonInlinedMemorySize());
     }
 
     // TODO: This is a little messed up.
@@ -1048,7 +1087,13 @@ void PersistentTable::updateTupleWithSpecificIndexes(TableTuple& targetTupleToUp
     std::vector<char*> newObjects;
 
     // this is the actual write of the new values
-    targetTupleToUpdate.copyForPersistentUpdate(sourceTupleWithNewValues, oldObjects, newObjects);
+    targetTupleToUpdate.copyForPersistentUpdate(sourceTupleWithNewValues, oldObjects, newObjects,
+                                                stringDictionaries());
+
+    // Count the strings as stored, which need not be what the source held
+    if (m_schema->getUninlinedObjectColumnCount() != 0) {
+        increaseStringMemCount(targetTupleToUpdate.getNonInlinedMemorySize());
+    }
 
     if (uq) {
         /*
@@ -1107,6 +1152,7 @@ void PersistentTable::updateTupleWithSpecificIndexes(TableTuple& targetTupleToUp
 void PersistentTable::updateTupleForUndo(char* tupleWithUnwantedValues,
                                          char* sourceTupleDataWithNewValues,
                                          bool revertIndexes) {
+    ++m_modificationCount;
     TableTuple matchable(m_schema);
     // Get the address of the tuple in the table from one of the copies on hand.
     // Any TableScan OR a primary key lookup on an already updated index will find the tuple
@@ -1160,6 +1206,7 @@ void PersistentTable::updateTupleForUndo(char* tupleWithUnwantedValues,
 }
 
 void PersistentTable::deleteTuple(TableTuple& target, bool fallible) {
+    ++m_modificationCount;
     UndoQuantum* uq = ExecutorContext::currentUndoQuantum();
     bool createUndoAction = fallible && (uq != NULL);
 
@@ -1278,6 +1325,7 @@ void PersistentTable::deleteTupleFinalize(TableTuple& target) {
  * Indexes and views have been destroyed first.
  */
 void PersistentTable::deleteTupleForSchemaChange(TableTuple& target) {
+    ++m_modificationCount;
     TBPtr block = findBlock(target.address(), m_data, m_tableAllocationSize);
     // free object columns along with empty tuple block storage
     deleteTupleStorage(target, block, true);
@@ -1297,6 +1345,7 @@ void PersistentTable::deleteTupleForSchemaChange(TableTuple& target) {
  *     can be used directly.
  */
 void PersistentTable::deleteTupleForUndo(char* tupleData, bool skipLookup) {
+    ++m_modificationCount;
     TableTuple matchable(tupleData, m_schema);
     TableTuple target(tupleData, m_schema);
     //* enable for debug */ std::cout << "DEBUG: undoing "
@@ -1521,6 +1570,12 @@ void PersistentTable::processLoadedTuple(TableTuple& tuple,
                                          int32_t& serializedTupleCount,
                                          size_t& tupleCountPosition,
                                          bool shouldDRStreamRows) {
+    for (size_t ii = 0; ii < m_stringDictionaries.size(); ii++) {
+        if (m_stringDictionaries[ii]) {
+            tuple.shareObjectColumn(m_schema->getUninlinedObjectColumnInfoIndex(static_cast<int>(ii)),
+                                    m_stringDictionaries[ii]);
+        }
+    }
     try {
         insertTupleCommon(tuple, tuple, true, shouldDRStreamRows);
     }
@@ -1708,7 +1763,7 @@ void PersistentTable::swapTuples(TableTuple& originalTuple,
     }
 }
 
-bool PersistentTable::doCompactionWithinSubset(TBBucketPtrVector* bucketVector) {
+bool PersistentTable::doCompactionWithinSubset(TBBucketPtrVector* bucketVector, int64_t maxTupleMoves) {
     /**
      * First find the two best candidate blocks
      */
@@ -1729,7 +1784,8 @@ bool PersistentTable::doCompactionWithinSubset(TBBucketPtrVector* bucketVector)
     }
 
     int fullestBucketChange = NO_NEW_BUCKET_INDEX;
-    while (fullest->hasFreeTuples()) {
+    int64_t tupleMovesLeft = maxTupleMoves;
+    while (fullest->hasFreeTuples() && tupleMovesLeft > 0) {
         TBPtr lightest;
         TBBucketI lightestIterator;
         bool foundLightest = false;
@@ -1756,19 +1812,28 @@ bool PersistentTable::doCompactionWithinSubset(TBBucketPtrVector* bucketVector)
             return false;
         }
 
-        std::pair<int, int> bucketChanges = fullest->merge(this, lightest, this);
+        uint32_t lightestTuples = lightest->activeTuples();
+        std::pair<int, int> bucketChanges = fullest->merge(this, lightest, this,
+                static_cast<uint32_t>(std::min<int64_t>(tupleMovesLeft, std::numeric_limits<uint32_t>::max())));
+        int64_t tuplesMoved = lightestTuples - lightest->activeTuples();
+        tupleMovesLeft -= tuplesMoved;
+        m_compactionTuplesMoved += tuplesMoved;
         int tempFullestBucketChange = bucketChanges.first;
         if (tempFullestBucketChange != NO_NEW_BUCKET_INDEX) {
             fullestBucketChange = tempFullestBucketChange;
         }
 
         if (lightest->isEmpty()) {
+            m_compactionBlocksReclaimed++;
             notifyBlockWasCompactedAway(lightest);
             m_data.erase(lightest->address());
             m_blocksWithSpace.erase(lightest);
             m_blocksNotPendingSnapshot.erase(lightest);
             m_blocksPendingSnapshot.erase(lightest);
             lightest->swapToBucket(TBBucketPtr());
+            if (lightest->isCold()) {
+                lightest->releaseColdSlot();
+            }
         }
         else {
             int lightestBucketChange = bucketChanges.second;
@@ -1867,12 +1932,145 @@ bool PersistentTable::doForcedCompaction() {
     assert(!compactionPredicate());
     boost::posix_time::ptime endTime(boost::posix_time::microsec_clock::universal_time());
     boost::posix_time::time_duration duration = endTime - startTime;
+    m_compactionMicros += duration.total_microseconds();
     snprintf(msg, sizeof(msg), "Finished forced compaction of %zd non-snapshot blocks and %zd snapshot blocks with allocated tuple count %zd in %zd ms on table %s",
             ((intmax_t)notPendingCompactions), ((intmax_t)pendingCompactions), ((intmax_t)allocatedTupleCount()), ((intmax_t)duration.total_milliseconds()), m_name.c_str());
     LogManager::getThreadLogger(LOGGERID_SQL)->log(LOGLEVEL_INFO, msg);
     return (notPendingCompactions + pendingCompactions) > 0;
 }
 
+int64_t PersistentTable::doBudgetedCompaction(int64_t maxTupleMoves) {
+    if (m_tableStreamer.get() != NULL && m_tableStreamer->hasStreamType(TABLE_STREAM_RECOVERY)) {
+        return 0;
+    }
+    boost::posix_time::ptime startTime(boost::posix_time::microsec_clock::universal_time());
+    int64_t tuplesMovedBefore = m_compactionTuplesMoved;
+    int64_t tuplesMoved = 0;
+    while (tuplesMoved < maxTupleMoves && compactionPredicate()) {
+        int64_t tuplesMovedBeforePass = m_compactionTuplesMoved;
+        // Blocks that are not pending snapshot first, as a forced compaction does
+        if (!m_blocksNotPendingSnapshot.empty()) {
+            doCompactionWithinSubset(&m_blocksNotPendingSnapshotLoad, maxTupleMoves - tuplesMoved);
+            tuplesMoved = m_compactionTuplesMoved - tuplesMovedBefore;
+        }
+        if (tuplesMoved < maxTupleMoves && !m_blocksPendingSnapshot.empty()) {
+            doCompactionWithinSubset(&m_blocksPendingSnapshotLoad, maxTupleMoves - tuplesMoved);
+            tuplesMoved = m_compactionTuplesMoved - tuplesMovedBefore;
+        }
+        if (m_compactionTuplesMoved == tuplesMovedBeforePass) {
+            // Nothing could be merged; doForcedCompaction() explains how that happens
+            break;
+        }
+    }
+    boost::posix_time::ptime endTime(boost::posix_time::microsec_clock::universal_time());
+    m_compactionMicros += (endTime - startTime).total_microseconds();
+    return tuplesMoved;
+}
+
+void PersistentTable::blockLoadHistogram(std::vector<size_t>& histogram) const {
+    histogram.assign(TUPLE_BLOCK_NUM_BUCKETS + 1, 0);
+    size_t bucketedBlocks = 0;
+    for (int ii = 0; ii < TUPLE_BLOCK_NUM_BUCKETS; ii++) {
+        histogram[ii] = m_blocksNotPendingSnapshotLoad[ii]->size() + m_blocksPendingSnapshotLoad[ii]->size();
+        bucketedBlocks += histogram[ii];
+    }
+    if (m_data.size() > bucketedBlocks) {
+        histogram[TUPLE_BLOCK_NUM_BUCKETS] = m_data.size() - bucketedBlocks;
+    }
+}
+
+int64_t PersistentTable::reclaimableBlockCount() const {
+    // An empty table still keeps one block
+    int64_t neededBlocks = std::max<int64_t>(1, (activeTupleCount() + m_tuplesPerBlock - 1) / m_tuplesPerBlock);
+    return std::max<int64_t>(0, static_cast<int64_t>(m_data.size()) - neededBlocks);
+}
+
+bool PersistentTable::enableStringDictionary(int columnIndex) {
+    if (columnIndex < 0 || columnIndex >= m_schema->columnCount()) {
+        return false;
+    }
+    const TupleSchema::ColumnInfo* columnInfo = m_schema->getColumnInfo(columnIndex);
+    if (columnInfo->getVoltType() != VALUE_TYPE_VARCHAR || columnInfo->inlined) {
+        return false;
+    }
+    const uint16_t uninlinedCount = m_schema->getUninlinedObjectColumnCount();
+    m_stringDictionaries.resize(uninlinedCount, NULL);
+    for (uint16_t ii = 0; ii < uninlinedCount; ii++) {
+        if (m_schema->getUninlinedObjectColumnInfoIndex(ii) == columnIndex) {
+            if (m_stringDictionaries[ii] == NULL) {
+                m_stringDictionaries[ii] = new StringDictionary();
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+const StringDictionary* PersistentTable::stringDictionary(int columnIndex) const {
+    for (size_t ii = 0; ii < m_stringDictionaries.size(); ii++) {
+        if (m_schema->getUninlinedObjectColumnInfoIndex(static_cast<int>(ii)) == columnIndex) {
+            return m_stringDictionaries[ii];
+        }
+    }
+    return NULL;
+}
+
+int64_t PersistentTable::nonInlinedMemorySize() const {
+    int64_t bytes = Table::nonInlinedMemorySize();
+    BOOST_FOREACH (auto dictionary, m_stringDictionaries) {
+        if (dictionary) {
+            bytes += dictionary->memorySize();
+        }
+    }
+    return bytes;
+}
+
+void PersistentTable::enableColdTier(const std::string& directory, int32_t coldAfterTicks) {
+    m_coldTierDirectory = directory;
+    m_coldAfterTicks = coldAfterTicks;
+    m_coldBlocksToDrop.clear();
+    if (directory.empty()) {
+        m_coldStore.reset();
+        return;
+    }
+    m_coldStore.reset(new ColdBlockStore(directory, m_name, ColdBlockStore::blockSizeFor(m_tableAllocationSize)));
+}
+
+int32_t PersistentTable::tierColdBlocks(int32_t maxBlocks) {
+    if (!m_coldStore) {
+        return 0;
+    }
+    ++m_coldTierClock;
+    // The blocks moved last time have had a tick to be written back
+    BOOST_FOREACH (TBPtr block, m_coldBlocksToDrop) {
+        if (block->isCold()) {
+            block->dropCachedPages();
+        }
+    }
+    m_coldBlocksToDrop.clear();
+
+    int32_t movedBlocks = 0;
+    bool writeFailed = false;
+    // Visit every block, even after enough have been moved, so that the
+    // accessed marks are all turned into stamps.
+    for (TBMapI i = m_data.begin(); i != m_data.end(); ++i) {
+        TBPtr block = i.data();
+        if (block->checkAccessed(m_coldTierClock) || !block->isTierable() || block->isCold() ||
+                block->hasFreeTuples() || writeFailed || movedBlocks >= maxBlocks ||
+                m_coldTierClock - block->lastAccess() < m_coldAfterTicks) {
+            continue;
+        }
+        if (block->moveToColdStore(m_coldStore)) {
+            m_coldBlocksToDrop.push_back(block);
+            ++movedBlocks;
+        }
+        else {
+            writeFailed = true;
+        }
+    }
+    return movedBlocks;
+}
+
 void PersistentTable::printBucketInfo() {
     std::cout << std::endl;
     TBMapI iter = m_data.begin();
@@ -2035,6 +2233,16 @@ std::vector<uint64_t> PersistentTable::getBlockAddresses() const {
     return blockAddresses;
 }
 
+std::vector<std::pair<char*, uint32_t> > PersistentTable::getBlockExtents() const {
+    std::vector<std::pair<char*, uint32_t> > blockExtents;
+    blockExtents.reserve(m_data.size());
+    for (TBMap::const_iterator i = m_data.begin(); i != m_data.end(); ++i) {
+        i->second->markAccessed();
+        blockExtents.push_back(std::make_pair(i->second->address(), i->second->unusedTupleBoundry()));
+    }
+    return blockExtents;
+}
+
 #ifdef DEBUG
 static bool isExistingTableIndex(std::vector<TableIndex*>& indexes, TableIndex* index) {
     BOOST_FOREACH (auto existingIndex, indexes) {
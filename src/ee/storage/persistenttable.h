@@ -63,6 +63,8 @@
 #include "storage/ExportTupleStream.h"
 #include "storage/TableStats.h"
 #include "storage/PersistentTableStats.h"
+#include "storage/CompactionStats.h"
+#include "storage/ColdBlockStore.h"
 #include "storage/TableStreamerInterface.h"
 #include "storage/RecoveryContext.h"
 #include "storage/ElasticIndex.h"
@@ -72,6 +74,8 @@
 
 class CompactionTest_BasicCompaction;
 class CompactionTest_CompactionWithCopyOnWrite;
+class CompactionTest_BudgetedCompaction;
+class CompactionTest_ColdTier;
 class CopyOnWriteTest;
 
 namespace catalog {
@@ -82,6 +86,7 @@ namespace voltdb {
 class CoveringCellIndexTest_TableCompaction;
 class MaterializedViewTriggerForWrite;
 class MaterializedViewHandler;
+class StringDictionary;
 class TableIndex;
 
 /**
@@ -205,6 +210,8 @@ class PersistentTable : public Table, public UndoQuantumReleaseInterest,
     friend class ::CopyOnWriteTest;
     friend class ::CompactionTest_BasicCompaction;
     friend class ::CompactionTest_CompactionWithCopyOnWrite;
+    friend class ::CompactionTest_BudgetedCompaction;
+    friend class ::CompactionTest_ColdTier;
     friend class CoveringCellIndexTest_TableCompaction;
     friend class MaterializedViewHandler;
     friend class ScopedDeltaTableContext;
@@ -231,7 +238,8 @@ public:
     }
 
     void notifyQuantumRelease() {
-        if (compactionPredicate()) {
+        // With incremental compaction the engine's tick compacts in slices instead
+        if (!m_incrementalCompaction && compactionPredicate()) {
             doForcedCompaction();
         }
     }
@@ -420,8 +428,73 @@ public:
 
     void doIdleCompaction();
 
+    /**
+     * Merge blocks, moving at most maxTupleMoves tuples, as one slice of an
+     * incremental compaction. Returns the number of tuples moved, which is
+     * zero once the table no longer needs compacting.
+     */
+    int64_t doBudgetedCompaction(int64_t maxTupleMoves);
+
+    /**
+     * Leave the compaction that deletes call for to doBudgetedCompaction()
+     * instead of compacting fully when the undo quantum is released.
+     */
+    void setIncrementalCompaction(bool incremental) {
+        m_incrementalCompaction = incremental;
+    }
+
+    /**
+     * Count the blocks in each load bucket, from the emptiest to the
+     * fullest. The last entry counts the blocks that are in no bucket:
+     * full blocks and blocks a snapshot is scanning.
+     */
+    void blockLoadHistogram(std::vector<size_t>& histogram) const;
+
+    /** How many fewer blocks the table would need if it were fully compacted */
+    int64_t reclaimableBlockCount() const;
+
+    int64_t compactionTuplesMoved() const { return m_compactionTuplesMoved; }
+    int64_t compactionBlocksReclaimed() const { return m_compactionBlocksReclaimed; }
+    int64_t compactionMicros() const { return m_compactionMicros; }
+
+    /**
+     * Move full blocks that go coldAfterTicks calls to tierColdBlocks()
+     * without being scanned or changed to a file in the given directory.
+     * An empty directory stops moving blocks; those already moved stay in
+     * their file.
+     */
+    void enableColdTier(const std::string& directory, int32_t coldAfterTicks);
+
+    bool hasColdTier() const { return m_coldStore.get() != NULL; }
+
+    /**
+     * Move up to maxBlocks blocks that have gone cold to the cold tier,
+     * and return how many were moved. Called once per tick.
+     */
+    int32_t tierColdBlocks(int32_t maxBlocks);
+
+    int64_t coldBlockCount() const { return m_coldStore ? m_coldStore->slotsInUse() : 0; }
+
+    /**
+     * Share the values written to an uninlined VARCHAR column from now on
+     * through a StringDictionary, so that each distinct value is stored
+     * once. Returns false, doing nothing, for any other kind of column.
+     */
+    bool enableStringDictionary(int columnIndex);
+
+    /** The column's StringDictionary, or NULL if it does not have one */
+    const StringDictionary* stringDictionary(int columnIndex) const;
+
+    /** Includes the memory of the shared strings in the table's dictionaries */
+    int64_t nonInlinedMemorySize() const;
+
     void printBucketInfo();
 
+    // The dictionaries to hand to TableTuple's persistent copies, if any
+    StringDictionary* const* stringDictionaries() const {
+        return m_stringDictionaries.empty() ? NULL : &m_stringDictionaries[0];
+    }
+
     void increaseStringMemCount(size_t bytes) {
         m_nonInlinedMemorySize += bytes;
     }
@@ -535,8 +608,23 @@ public:
     // STATS
     TableStats* getTableStats() { return &m_stats; };
 
+    CompactionStats* getCompactionStats() { return &m_compactionStats; }
+
     std::vector<uint64_t> getBlockAddresses() const;
 
+    // The start address and the number of used tuple slots of each block, in
+    // scan order. Lets a read-only scan split the table's blocks between threads.
+    std::vector<std::pair<char*, uint32_t> > getBlockExtents() const;
+
+    // Identifies this table instance for the life of the process. A truncate or
+    // swap replaces the table behind a TableCatalogDelegate, which shows up here
+    // as a different instance id.
+    int64_t instanceId() const { return m_instanceId; }
+
+    // Bumped by every insert, update and delete, including those done by undo.
+    // Used with instanceId() to tell whether cached query results are stale.
+    int64_t modificationCount() const { return m_modificationCount; }
+
 private:
     // Zero allocation size uses defaults.
     PersistentTable(int partitionColumn, char const* signature, bool isMaterialized, int tableAllocationTargetSize = 0, int tuplelimit = INT_MAX, bool drEnabled = false);
@@ -585,7 +673,8 @@ private:
 
     void nextFreeTuple(TableTuple* tuple);
 
-    bool doCompactionWithinSubset(TBBucketPtrVector* bucketVector);
+    bool doCompactionWithinSubset(TBBucketPtrVector* bucketVector,
+                                  int64_t maxTupleMoves = std::numeric_limits<int64_t>::max());
 
     bool doForcedCompaction();  // Returns true if a compaction was performed
 
@@ -711,6 +800,8 @@ private:
     // STATS
     PersistentTableStats m_stats;
 
+    CompactionStats m_compactionStats;
+
     // STORAGE TRACKING
 
     // Map from load to the blocks with level of load
@@ -736,6 +827,27 @@ private:
 
     int m_failedCompactionCount;
 
+    bool m_incrementalCompaction;
+
+    // Work done by compaction over the life of the table
+    int64_t m_compactionTuplesMoved;
+    int64_t m_compactionBlocksReclaimed;
+    int64_t m_compactionMicros;
+
+    // Where blocks that go cold are moved, if anywhere
+    boost::shared_ptr<ColdBlockStore> m_coldStore;
+    std::string m_coldTierDirectory;
+    int32_t m_coldAfterTicks;
+    // Counts calls to tierColdBlocks(); blocks are stamped with it when accessed
+    int64_t m_coldTierClock;
+    // Blocks moved by the last call to tierColdBlocks(), whose pages are
+    // dropped from the page cache by the next one, once written back
+    std::vector<TBPtr> m_coldBlocksToDrop;
+
+    // One per uninlined column, NULL for the columns that do not share
+    // their values, or empty if none of them do.
+    std::vector<StringDictionary*> m_stringDictionaries;
+
     // This is a testability feature not intended for use in product logic.
     int m_invisibleTuplesPendingDeleteCount;
 
@@ -787,6 +899,10 @@ private:
     PersistentTable* m_deltaTable;
 
     bool m_deltaTableActive;
+
+    const int64_t m_instanceId;
+
+    int64_t m_modificationCount;
 };
 
 inline PersistentTableSurgeon::PersistentTableSurgeon(PersistentTable& table) :
@@ -866,11 +982,14 @@ inline bool PersistentTableSurgeon::isIndexingComplete() const {
 inline void PersistentTableSurgeon::setIndexingComplete() {
     assert (m_index != NULL);
     m_indexingComplete = true;
+    // The partitions were grown for the scan; give back their slack.
+    m_index->compact();
 }
 
 inline void PersistentTableSurgeon::createIndex() {
     assert(m_index == NULL);
-    m_index.reset(new ElasticIndex());
+    // Sized for the table as it is now; partitions grow if it grows.
+    m_index.reset(new ElasticIndex(m_table.activeTupleCount()));
     m_indexingComplete = false;
 }
 
@@ -1030,6 +1149,9 @@ inline void PersistentTable::deleteTupleStorage(TableTuple& tuple, TBPtr block,
         assert(m_blocksPendingSnapshot.find(block) == m_blocksPendingSnapshot.end());
         //Eliminates circular reference
         block->swapToBucket(TBBucketPtr());
+        if (block->isCold()) {
+            block->releaseColdSlot();
+        }
     }
     else if (transitioningToBlockWithSpace) {
         m_blocksWithSpace.insert(block);
@@ -1059,7 +1181,7 @@ inline TBPtr PersistentTable::findBlock(char* tuple, TBMap& blocks, int blockSiz
 }
 
 inline TBPtr PersistentTable::allocateNextBlock() {
-    TBPtr block(new TupleBlock(this, m_blocksNotPendingSnapshotLoad[0]));
+    TBPtr block(new TupleBlock(this, m_blocksNotPendingSnapshotLoad[0], true));
     m_data.insert(block->address(), block);
     m_blocksNotPendingSnapshot.insert(block);
     return block;
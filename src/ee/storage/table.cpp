@@ -43,6 +43,7 @@
  * OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <algorithm>
 #include <sstream>
 #include <cassert>
 #include <cstdio>
@@ -52,6 +53,7 @@
 #include "table.h"
 #include "common/debuglog.h"
 #include "common/serializeio.h"
+#include "common/TupleSerializationPlan.h"
 #include "common/TupleSchema.h"
 #include "common/tabletuple.h"
 #include "common/Pool.hpp"
@@ -346,10 +348,11 @@ void Table::serializeTo(SerializeOutput &serialOutput) {
     // active tuple counts
     serialOutput.writeInt(static_cast<int32_t>(m_tupleCount));
     int64_t written_count = 0;
+    TupleSerializationPlan plan(m_schema, false);
     TableIterator titer = iterator();
     TableTuple tuple(m_schema);
     while (titer.next(tuple)) {
-        tuple.serializeTo(serialOutput);
+        plan.serialize(tuple, serialOutput);
         ++written_count;
     }
     assert(written_count == m_tupleCount);
@@ -360,16 +363,56 @@ void Table::serializeTo(SerializeOutput &serialOutput) {
     serialOutput.writeIntAt(pos, sz);
 }
 
+void Table::serializeInChunksTo(FallbackSerializeOutput &serialOutput) {
+    assert(serialOutput.flushedBytes() == 0);
+
+    // a placeholder for the total table size
+    std::size_t pos = serialOutput.position();
+    serialOutput.writeInt(-1);
+
+    serializeColumnHeaderTo(serialOutput);
+
+    // active tuple counts
+    serialOutput.writeInt(static_cast<int32_t>(m_tupleCount));
+
+    // Only whole tuples from here on are pushed, so the placeholders above
+    // stay in the buffer to be filled in.
+    std::size_t chunkStart = serialOutput.position();
+    bool pushChunks = true;
+    std::size_t largestTuple = 0;
+    int64_t written_count = 0;
+    TupleSerializationPlan plan(m_schema, false);
+    TableIterator titer = iterator();
+    TableTuple tuple(m_schema);
+    while (titer.next(tuple)) {
+        if (pushChunks && serialOutput.remaining() < largestTuple && serialOutput.position() > chunkStart) {
+            pushChunks = serialOutput.flushChunkFrom(chunkStart);
+        }
+        std::size_t tupleStart = serialOutput.position();
+        plan.serialize(tuple, serialOutput);
+        largestTuple = std::max(largestTuple, serialOutput.position() - tupleStart);
+        ++written_count;
+    }
+    assert(written_count == m_tupleCount);
+
+    // length prefix is non-inclusive, and counts the pushed tuples
+    int32_t sz = static_cast<int32_t>(serialOutput.position() + serialOutput.flushedBytes()
+                                      - pos - sizeof(int32_t));
+    assert(sz > 0);
+    serialOutput.writeIntAt(pos, sz);
+}
+
 void Table::serializeToWithoutTotalSize(SerializeOutput &serialOutput) {
     serializeColumnHeaderTo(serialOutput);
 
     // active tuple counts
     serialOutput.writeInt(static_cast<int32_t>(m_tupleCount));
     int64_t written_count = 0;
+    TupleSerializationPlan plan(m_schema, false);
     TableIterator titer = iterator();
     TableTuple tuple(m_schema);
     while (titer.next(tuple)) {
-        tuple.serializeTo(serialOutput);
+        plan.serialize(tuple, serialOutput);
         ++written_count;
     }
     assert(written_count == m_tupleCount);
@@ -390,8 +433,9 @@ void Table::serializeTupleTo(SerializeOutput &serialOutput, voltdb::TableTuple *
     serializeColumnHeaderTo(serialOutput);
 
     serialOutput.writeInt(static_cast<int32_t>(numTuples));
+    TupleSerializationPlan plan(tuples[0].getSchema(), false);
     for (int ii = 0; ii < numTuples; ii++) {
-        tuples[ii].serializeTo(serialOutput);
+        plan.serialize(tuples[ii], serialOutput);
     }
 
     serialOutput.writeIntAt(pos, static_cast<int32_t>(serialOutput.position() - pos - sizeof(int32_t)));
@@ -150,7 +150,7 @@ class Table {
     }
 
     // Only counts persistent table usage, currently
-    int64_t nonInlinedMemorySize() const { return m_nonInlinedMemorySize; }
+    virtual int64_t nonInlinedMemorySize() const { return m_nonInlinedMemorySize; }
 
     virtual int tupleLimit() const { return INT_MIN; }
 
@@ -187,6 +187,13 @@ class Table {
 
     void serializeTo(SerializeOutput& serialOutput);
 
+    /*
+     * Serialize as serializeTo does, but push the tuples to the topend in
+     * chunks whenever the output buffer is nearly full. Nothing may have
+     * been pushed from the output yet.
+     */
+    void serializeInChunksTo(FallbackSerializeOutput& serialOutput);
+
     void serializeToWithoutTotalSize(SerializeOutput& serialOutput);
 
     void serializeColumnHeaderTo(SerializeOutput& serialOutput);
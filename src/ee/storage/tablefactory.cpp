@@ -112,6 +112,9 @@ Table* TableFactory::getPersistentTable(
 
     // initialize stats for the table
     configureStats(name, stats);
+    if (persistentTable) {
+        persistentTable->getCompactionStats()->configure(name + " compaction stats");
+    }
 
     return table;
 }
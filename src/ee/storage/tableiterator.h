@@ -235,6 +235,7 @@ inline bool TableIterator::persistentNext(TableTuple &out) {
 //            }
             m_dataPtr = m_blockIterator.key();
             m_currentBlock = m_blockIterator.data();
+            m_currentBlock->markAccessed();
             m_blockOffset = 0;
             m_blockIterator++;
         } else {
@@ -45,6 +45,7 @@
 
 #include "temptable.h"
 #include "common/debuglog.h"
+#include "common/executorcontext.hpp"
 
 #define TABLE_BLOCKSIZE 131072
 
@@ -53,7 +54,8 @@ namespace voltdb {
 TempTable::TempTable()
   : Table(TABLE_BLOCKSIZE),
     m_iter(this),
-    m_limits(NULL)
+    m_limits(NULL),
+    m_retainsBlocks(false)
 {
     // this happens here because m_data might not be initialized above
     m_iter.reset(m_data.begin());
@@ -61,6 +63,34 @@ TempTable::TempTable()
 
 TempTable::~TempTable() {}
 
+int32_t TempTable::blockAllocationSize() {
+    return TABLE_BLOCKSIZE;
+}
+
+TBPtr TempTable::allocateNextBlock() {
+    TBPtr block;
+    if ( ! m_retainedBlocks.empty()) {
+        block = m_retainedBlocks.back();
+        m_retainedBlocks.pop_back();
+    }
+    else {
+#ifdef MEMCHECK
+        // Recycled storage would hide use after free from valgrind
+        TempTableBlockPool* storagePool = NULL;
+#else
+        TempTableBlockPool* storagePool = ExecutorContext::getTempTableBlockPool();
+#endif
+        block = TBPtr(new TupleBlock(this, TBBucketPtr(), false, storagePool));
+    }
+    m_data.push_back(block);
+
+    if (m_limits) {
+        m_limits->increaseAllocated(m_tableAllocationSize);
+    }
+
+    return block;
+}
+
 // ------------------------------------------------------------------
 // OPERATIONS
 // ------------------------------------------------------------------
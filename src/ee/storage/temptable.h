@@ -141,6 +141,26 @@ class TempTable : public Table {
     const TempTableLimits* getTempTableLimits() const {
         return m_limits;
     }
+    TempTableLimits* getTempTableLimits() {
+        return m_limits;
+    }
+
+    /// The size of the blocks of temp tables whose tuples fit several to a block
+    static int32_t blockAllocationSize();
+
+    /**
+     * Keep the blocks that deleteAllTempTuples() empties for this table to
+     * fill again, rather than freeing all but the first. Kept blocks don't
+     * count against the table's limits until they are filled again.
+     */
+    void setRetainsBlocks(bool retainsBlocks) { m_retainsBlocks = retainsBlocks; }
+
+    /// Free the blocks kept for reuse
+    void releaseRetainedBlocks() { m_retainedBlocks.clear(); }
+
+    int64_t retainedBlockMemory() const {
+        return static_cast<int64_t>(m_retainedBlocks.size()) * m_tableAllocationSize;
+    }
 
   protected:
     // can not use this constructor to coerce a cast
@@ -158,6 +178,7 @@ class TempTable : public Table {
 
     virtual void onSetColumns() {
         m_data.clear();
+        m_retainedBlocks.clear();
     };
 
     std::vector<uint64_t> getBlockAddresses() const;
@@ -168,6 +189,10 @@ class TempTable : public Table {
 
     // ptr to global integer tracking temp table memory allocated per frag
     TempTableLimits* m_limits;
+
+    // emptied blocks kept to be filled again, if m_retainsBlocks
+    bool m_retainsBlocks;
+    std::vector<TBPtr> m_retainedBlocks;
 };
 
 inline void TempTable::insertTempTupleDeepCopy(const TableTuple &source, Pool *pool) {
@@ -221,6 +246,10 @@ inline void TempTable::deleteAllTempTuples() {
         if (m_limits && blockPtr) {
             m_limits->reduceAllocated(m_tableAllocationSize);
         }
+        if (m_retainsBlocks && blockPtr) {
+            blockPtr->reset();
+            m_retainedBlocks.push_back(blockPtr);
+        }
     }
 
     // cheap clear of the preserved first block
@@ -229,17 +258,6 @@ inline void TempTable::deleteAllTempTuples() {
     }
 }
 
-inline TBPtr TempTable::allocateNextBlock() {
-    TBPtr block(new TupleBlock(this, TBBucketPtr()));
-    m_data.push_back(block);
-
-    if (m_limits) {
-        m_limits->increaseAllocated(m_tableAllocationSize);
-    }
-
-    return block;
-}
-
 inline void TempTable::nextFreeTuple(TableTuple *tuple) {
 
     if (m_data.empty()) {
@@ -38,6 +38,7 @@
 #include <signal.h>
 #include <sys/socket.h>
 #include <netinet/tcp.h> // for TCP_NODELAY
+#include <vector>
 
 // Please don't make this different from the JNI result buffer size.
 // This determines the size of the EE results buffer and it's nice
@@ -82,6 +83,17 @@ public:
     int loadNextDependency(int32_t dependencyId, voltdb::Pool *stringPool, voltdb::Table* destination);
     void fallbackToEEAllocatedBuffer(char *buffer, size_t length) { }
 
+    /**
+     * The protocol has no way to send results before the batch is done,
+     * so the chunks are kept here and spliced into the results when they
+     * are sent.
+     */
+    bool pushResultChunk(const char *data, size_t length, size_t headLength) {
+        m_resultChunks.insert(m_resultChunks.end(), data, data + length);
+        m_resultChunksOffset = headLength;
+        return true;
+    }
+
     /**
      * Retrieve a dependency from Java via the IPC connection.
      * This method returns null if there are no more dependency tables. Otherwise
@@ -181,6 +193,8 @@ private:
 
     void applyBinaryLog(struct ipc_command*);
 
+    void executeKeyValueBatch(struct ipc_command*);
+
     void executeTask(struct ipc_command*);
 
     void sendPerFragmentStatsBuffer();
@@ -205,6 +219,10 @@ private:
     // The tuple buffer gets expanded (doubled) as needed, but never compacted.
     char *m_tupleBuffer;
     size_t m_tupleBufferSize;
+
+    // Results pushed by the engine during the current batch, and where they go
+    std::vector<char> m_resultChunks;
+    size_t m_resultChunksOffset;
 };
 
 /* java sends all data with this header */
@@ -355,6 +373,17 @@ typedef struct {
     char log[0];
 }__attribute__((packed)) apply_binary_log;
 
+typedef struct {
+    struct ipc_command cmd;
+    int32_t tableId;
+    int64_t txnId;
+    int64_t spHandle;
+    int64_t lastCommittedSpHandle;
+    int64_t uniqueId;
+    int64_t undoToken;
+    char batch[0];
+}__attribute__((packed)) key_value_batch;
+
 
 using namespace voltdb;
 
@@ -405,6 +434,7 @@ VoltDBIPC::VoltDBIPC(int fd) : m_fd(fd) {
     m_perFragmentStatsBuffer = NULL;
     m_tupleBuffer = NULL;
     m_tupleBufferSize = 0;
+    m_resultChunksOffset = 0;
     m_terminate = false;
 
     setupSigHandler();
@@ -515,6 +545,10 @@ bool VoltDBIPC::execute(struct ipc_command *cmd) {
           applyBinaryLog(cmd);
           result = kErrorCode_None;
           break;
+      case 30:
+          executeKeyValueBatch(cmd);
+          result = kErrorCode_None;
+          break;
       default:
         result = stub(cmd);
     }
@@ -795,6 +829,7 @@ void VoltDBIPC::executePlanFragments(struct ipc_command *cmd) {
     // and reset to space for the results output
     m_engine->resetReusedResultOutputBuffer(1, 1); // 1 byte to add status code
     m_engine->resetPerFragmentStatsOutputBuffer(queryCommand->perFragmentTimingEnabled);
+    m_resultChunks.clear();
 
     try {
         errors = m_engine->executePlanFragments(numFrags,
@@ -820,10 +855,19 @@ void VoltDBIPC::executePlanFragments(struct ipc_command *cmd) {
         const int32_t size = m_engine->getResultsSize();
         char *resultBuffer = m_engine->getReusedResultBuffer();
         resultBuffer[0] = kErrorCode_Success;
-        writeOrDie(m_fd, (unsigned char*)resultBuffer, size);
+        if (m_resultChunks.empty()) {
+            writeOrDie(m_fd, (unsigned char*)resultBuffer, size);
+        }
+        else {
+            writeOrDie(m_fd, (unsigned char*)resultBuffer, m_resultChunksOffset);
+            writeOrDie(m_fd, (unsigned char*)&m_resultChunks[0], m_resultChunks.size());
+            writeOrDie(m_fd, (unsigned char*)resultBuffer + m_resultChunksOffset,
+                       size - m_resultChunksOffset);
+        }
     } else {
         sendException(kErrorCode_Error);
     }
+    m_resultChunks.clear();
 }
 
 void VoltDBIPC::sendPerFragmentStatsBuffer() {
@@ -1612,6 +1656,36 @@ void VoltDBIPC::applyBinaryLog(struct ipc_command *cmd) {
     }
 }
 
+void VoltDBIPC::executeKeyValueBatch(struct ipc_command *cmd) {
+    key_value_batch *batch = (key_value_batch*)cmd;
+    int sz = static_cast<int> (ntohl(cmd->msgsize) - sizeof(key_value_batch));
+    ReferenceSerializeInputBE serialize_in(batch->batch, sz);
+    int errors = 0;
+    try {
+        errors = m_engine->executeKeyValueBatch(ntohl(batch->tableId),
+                                                serialize_in,
+                                                ntohll(batch->txnId),
+                                                ntohll(batch->spHandle),
+                                                ntohll(batch->lastCommittedSpHandle),
+                                                ntohll(batch->uniqueId),
+                                                ntohll(batch->undoToken));
+    } catch (const FatalException& e) {
+        crashVoltDB(e);
+    }
+
+    if (errors == 0) {
+        // The engine writes the results from the start of its buffer, so
+        // the status code and their length go out ahead of them
+        char response[5];
+        response[0] = kErrorCode_Success;
+        *reinterpret_cast<int32_t*>(&response[1]) = htonl(m_engine->getResultsSize());
+        writeOrDie(m_fd, (unsigned char*)response, 5);
+        writeOrDie(m_fd, (unsigned char*)m_engine->getReusedResultBuffer(), m_engine->getResultsSize());
+    } else {
+        sendException(kErrorCode_Error);
+    }
+}
+
 int64_t VoltDBIPC::pushDRBuffer(int32_t partitionId, voltdb::StreamBlock *block) {
     if (block != NULL) {
         delete []block->rawPtr();
@@ -1408,6 +1408,44 @@ Java_org_voltdb_jni_ExecutionEngine_nativeApplyBinaryLog (
     return -1L;
 }
 
+/*
+ * Class:     org_voltdb_jni_ExecutionEngine
+ * Method:    nativeExecuteKeyValueBatch
+ * Signature: (JI[BJJJJJ)I
+ */
+SHAREDLIB_JNIEXPORT jint JNICALL
+Java_org_voltdb_jni_ExecutionEngine_nativeExecuteKeyValueBatch (
+    JNIEnv *env, jobject obj, jlong engine_ptr, jint tableId, jbyteArray batch,
+    jlong txnId, jlong spHandle, jlong lastCommittedSpHandle, jlong uniqueId, jlong undoToken)
+{
+    VoltDBEngine *engine = castToEngine(engine_ptr);
+    Topend *topend = static_cast<JNITopend*>(engine->getTopend())->updateJNIEnv(env);
+    if (engine == NULL) {
+        return -1;
+    }
+
+    //JNIEnv pointer can change between calls, must be updated
+    updateJNILogProxy(engine);
+    VOLT_DEBUG("executing key-value batch on table %d in C++...", tableId);
+
+    jsize length = env->GetArrayLength(batch);
+    jbyte *bytes = env->GetByteArrayElements(batch, NULL);
+    ReferenceSerializeInputBE serialize_in(bytes, length);
+    int errors = ENGINE_ERRORCODE_ERROR;
+    try {
+        errors = engine->executeKeyValueBatch(tableId, serialize_in, txnId, spHandle,
+                                              lastCommittedSpHandle, uniqueId, undoToken);
+    } catch (const FatalException &e) {
+        topend->crashVoltDB(e);
+    }
+    env->ReleaseByteArrayElements(batch, bytes, JNI_ABORT);
+
+    if (errors != ENGINE_ERRORCODE_SUCCESS) {
+        return -1;
+    }
+    return static_cast<jint>(engine->getResultsSize());
+}
+
 SHAREDLIB_JNIEXPORT jint JNICALL Java_org_voltdb_jni_ExecutionEngine_nativeExecuteTask
   (JNIEnv *env, jobject obj, jlong engine_ptr) {
     VOLT_DEBUG("nativeHashinate in C++ called");
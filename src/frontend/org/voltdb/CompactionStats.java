@@ -0,0 +1,56 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with VoltDB.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+package org.voltdb;
+
+import java.util.ArrayList;
+import java.util.Iterator;
+
+import org.voltdb.VoltTable.ColumnInfo;
+
+/**
+ * Block fragmentation of each persistent table at a site, and the work
+ * the EE's incremental compaction has done on it.
+ */
+public class CompactionStats extends SiteStatsSource {
+    public CompactionStats(long siteId) {
+        super( siteId, true);
+    }
+
+    @Override
+    protected Iterator<Object> getStatsRowKeyIterator(boolean interval) {
+        return null;
+    }
+
+    // The EE fills in this schema; this copy is only used to fill in an
+    // empty table before the EE has provided one.  Keep it in step with
+    // CompactionStats.cpp.
+    @Override
+    protected void populateColumnSchema(ArrayList<ColumnInfo> columns) {
+        super.populateColumnSchema(columns);
+        columns.add(new ColumnInfo("PARTITION_ID", VoltType.BIGINT));
+        columns.add(new ColumnInfo("TABLE_NAME", VoltType.STRING));
+        columns.add(new ColumnInfo("BLOCK_COUNT", VoltType.BIGINT));
+        columns.add(new ColumnInfo("FRAGMENTATION_PERCENT", VoltType.INTEGER));
+        columns.add(new ColumnInfo("RECLAIMABLE_BLOCKS", VoltType.BIGINT));
+        columns.add(new ColumnInfo("BLOCK_LOAD_HISTOGRAM", VoltType.STRING));
+        columns.add(new ColumnInfo("TUPLES_MOVED", VoltType.BIGINT));
+        columns.add(new ColumnInfo("BLOCKS_RECLAIMED", VoltType.BIGINT));
+        columns.add(new ColumnInfo("MEMORY_RECLAIMED", VoltType.BIGINT));
+        columns.add(new ColumnInfo("COMPACTION_TIME", VoltType.BIGINT));
+    }
+}
@@ -51,6 +51,8 @@ public class SQLStmt {
     byte[] sqlText;
     String sqlTextStr;
     String joinOrder;
+    // planner marks the statement's fragments for the EE result cache
+    boolean cacheResult;
     // hash of the SQL string for determinism checks
     int sqlCRC;
 
@@ -93,15 +95,31 @@ public class SQLStmt {
      * @param joinOrder separated list of tables used by the query specifying the order they should be joined in
      */
     public SQLStmt(String sqlText, String joinOrder) {
-        this(sqlText.getBytes(Constants.UTF8ENCODING), joinOrder);
+        this(sqlText.getBytes(Constants.UTF8ENCODING), joinOrder, false);
+    }
+
+    /**
+     * Construct a SQLStmt instance from a SQL statement.
+     *
+     * @param sqlText Valid VoltDB compliant SQL with question marks as parameter
+     * place holders.
+     * @param joinOrder separated list of tables used by the query specifying the order they should be joined in
+     * @param cacheResult true to let each site keep the statement's results, keyed by
+     * parameter values, until a table it reads changes. Only read-only statements that
+     * do not depend on the current time use the cache, and only when the
+     * FRAGMENT_RESULT_CACHE_SIZE system property gives it a budget.
+     */
+    public SQLStmt(String sqlText, String joinOrder, boolean cacheResult) {
+        this(sqlText.getBytes(Constants.UTF8ENCODING), joinOrder, cacheResult);
     }
 
     /**
      * Construct a SQLStmt instance from a byte array for internal use.
      */
-    private SQLStmt(byte[] sqlText, String joinOrder) {
+    private SQLStmt(byte[] sqlText, String joinOrder, boolean cacheResult) {
         this.sqlText = sqlText;
         this.joinOrder = joinOrder;
+        this.cacheResult = cacheResult;
 
         // create a hash for determinism purposes
         PureJavaCrc32C crc = new PureJavaCrc32C();
@@ -166,7 +184,7 @@ public class SQLStmt {
                                   boolean isReadOnly,
                                   VoltType[] params,
                                   SiteProcedureConnection site) {
-        SQLStmt stmt = new SQLStmt(sqlText, null);
+        SQLStmt stmt = new SQLStmt(sqlText, null, false);
 
         stmt.aggregator = new SQLStmt.Frag(aggFragId, aggPlanHash, isAggTransactional);
 
@@ -213,4 +231,13 @@ public class SQLStmt {
     public String getJoinOrder() {
         return joinOrder;
     }
+
+    /**
+     * Get the result cache hint supplied in the constructor.
+     *
+     * @return true if the statement's results may be cached by the EE.
+     */
+    public boolean getCacheResult() {
+        return cacheResult;
+    }
 }
@@ -568,6 +568,12 @@ public class StatsAgent extends OpsAgent
         case GC:
             stats = collectStats(StatsSelector.GC, interval);
             break;
+        case FRAGMENTRESULTCACHE:
+            stats = collectStats(StatsSelector.FRAGMENTRESULTCACHE, interval);
+            break;
+        case COMPACTION:
+            stats = collectStats(StatsSelector.COMPACTION, interval);
+            break;
         default:
             // Should have been successfully groomed in collectStatsImpl().  Log something
             // for our information but let the null check below return harmlessly
@@ -58,5 +58,7 @@ public enum StatsSelector {
     GC,             // return GC Stats
 
     COMMANDLOG,     // return number of outstanding bytes and txns on this node
-    IMPORTER
+    IMPORTER,
+    FRAGMENTRESULTCACHE, // EE fragment result cache hits, misses and memory use
+    COMPACTION      // EE table block fragmentation and incremental compaction progress
 }
@@ -99,6 +99,7 @@ public class DDLCompiler {
     private static final String REPLICATE = "REPLICATE";
     private static final String ROLE = "ROLE";
     private static final String DR = "DR";
+    private static final String DICTIONARY = "DICTIONARY";
 
     private final HSQLInterface m_hsql;
     private final VoltCompiler m_compiler;
@@ -875,6 +876,37 @@ public class DDLCompiler {
             return true;
         }
 
+        // matches if it is DICTIONARY TABLE <table> ON COLUMN <column>
+        // group 1 -- table name
+        // group 2 -- column name
+        statementMatcher = SQLParser.matchDictionaryTable(statement);
+        if (statementMatcher.matches()) {
+            String tableName = checkIdentifierStart(statementMatcher.group(1), statement);
+            String columnName = checkIdentifierStart(statementMatcher.group(2), statement);
+            VoltXMLElement tableXML = m_schema.findChild("table", tableName.toUpperCase());
+            if (tableXML == null) {
+                throw m_compiler.new VoltCompilerException(String.format(
+                        "Invalid DICTIONARY statement: table %s does not exist", tableName));
+            }
+            VoltXMLElement columnXML = null;
+            for (VoltXMLElement subNode : tableXML.children) {
+                if (subNode.name.equals("columns")) {
+                    columnXML = subNode.findChild("column", columnName.toUpperCase());
+                }
+            }
+            if (columnXML == null) {
+                throw m_compiler.new VoltCompilerException(String.format(
+                        "Invalid DICTIONARY statement: column %s does not exist in table %s",
+                        columnName, tableName));
+            }
+            // Column type check done by addColumnToCatalog
+            columnXML.attributes.put("dictionary", "true");
+
+            // mark the table as dirty for the purposes of caching sql statements
+            m_compiler.markTableAsDirty(tableName);
+            return true;
+        }
+
         statementMatcher = SQLParser.matchSetGlobalParam(statement);
         if (statementMatcher.matches()) {
             String name = statementMatcher.group(1).toUpperCase();
@@ -932,6 +964,13 @@ public class DDLCompiler {
                     statement.substring(0,statement.length()-1))); // remove trailing semicolon
         }
 
+        if (DICTIONARY.equals(commandPrefix)) {
+            throw m_compiler.new VoltCompilerException(String.format(
+                    "Invalid DICTIONARY statement: \"%s\", " +
+                    "expected syntax: DICTIONARY TABLE <table> ON COLUMN <column>",
+                    statement.substring(0,statement.length()-1))); // remove trailing semicolon
+        }
+
         // Not a VoltDB-specific DDL statement.
         return false;
     }
@@ -1841,6 +1880,14 @@ public class DDLCompiler {
         column.setInbytes(inBytes);
         column.setSize(size);
 
+        boolean dictionary = Boolean.valueOf(node.attributes.get("dictionary"));
+        if (dictionary && type != VoltType.STRING) {
+            String msg = "Column " + name + " in table " + table.getTypeName() +
+                    " is " + type.toSQLString() + ", but only VARCHAR columns can use a dictionary";
+            throw compiler.new VoltCompilerException(msg);
+        }
+        column.setDictionary(dictionary);
+
         column.setDefaultvalue(defaultvalue);
         if (defaulttype != null)
             column.setDefaulttype(Integer.parseInt(defaulttype));
@@ -353,7 +353,7 @@ public abstract class ProcedureCompiler {
                                        StatementPartitioning.forceMP();
             boolean cacheHit = StatementCompiler.compileFromSqlTextAndUpdateCatalog(compiler, hsql, db,
                     estimates, catalogStmt, stmt.getText(), stmt.getJoinOrder(),
-                    detMode, partitioning);
+                    detMode, partitioning, stmt.getCacheResult());
 
             // if this was a cache hit or specified single, don't worry about figuring out more partitioning
             if (partitioning.wasSpecifiedAsSingle() || cacheHit) {
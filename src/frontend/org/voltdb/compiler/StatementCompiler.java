@@ -91,6 +91,19 @@ public abstract class StatementCompiler {
             Statement catalogStmt, VoltXMLElement xml, String stmt, String joinOrder,
             DeterminismMode detMode, StatementPartitioning partitioning)
     throws VoltCompiler.VoltCompilerException {
+        return compileStatementAndUpdateCatalog(compiler, hsql, db, estimates, catalogStmt,
+                xml, stmt, joinOrder, detMode, partitioning, false);
+    }
+
+    /**
+     * As above, and when cacheResult is true, mark the statement's plan
+     * fragments so the EE may keep their results in its result cache.
+     */
+    static boolean compileStatementAndUpdateCatalog(VoltCompiler compiler, HSQLInterface hsql,
+            Database db, DatabaseEstimates estimates,
+            Statement catalogStmt, VoltXMLElement xml, String stmt, String joinOrder,
+            DeterminismMode detMode, StatementPartitioning partitioning, boolean cacheResult)
+    throws VoltCompiler.VoltCompilerException {
 
         // Cleanup whitespace newlines for catalog compatibility
         // and to make statement parsing easier.
@@ -104,7 +117,7 @@ public abstract class StatementCompiler {
         }
 
         // if this key + sql is the same, then a cached stmt can be used
-        String keyPrefix = compiler.getKeyPrefix(partitioning, detMode, joinOrder);
+        String keyPrefix = compiler.getKeyPrefix(partitioning, detMode, joinOrder, cacheResult);
 
         // if the key is cache-able, look for a previous statement
         if (keyPrefix != null) {
@@ -276,7 +289,7 @@ public abstract class StatementCompiler {
             // mark a fragment as non-transactional if it never touches a persistent table
             planFragment.setNontransactional(!fragmentReferencesPersistentTable(plan.rootPlanGraph));
             planFragment.setMultipartition(plan.subPlanGraph != null);
-            byte[] planBytes = writePlanBytes(compiler, planFragment, plan.rootPlanGraph);
+            byte[] planBytes = writePlanBytes(compiler, planFragment, plan.rootPlanGraph, cacheResult);
             md.update(planBytes, 0, planBytes.length);
             // compute the 40 bytes of hex from the 20 byte sha1 hash of the plans
             md.reset();
@@ -288,7 +301,7 @@ public abstract class StatementCompiler {
                 planFragment.setHasdependencies(false);
                 planFragment.setNontransactional(false);
                 planFragment.setMultipartition(true);
-                byte[] subBytes = writePlanBytes(compiler, planFragment, plan.subPlanGraph);
+                byte[] subBytes = writePlanBytes(compiler, planFragment, plan.subPlanGraph, cacheResult);
                 // compute the 40 bytes of hex from the 20 byte sha1 hash of the plans
                 md.reset();
                 md.update(subBytes);
@@ -313,19 +326,30 @@ public abstract class StatementCompiler {
             Database db, DatabaseEstimates estimates,
             Statement catalogStmt, String sqlText, String joinOrder,
             DeterminismMode detMode, StatementPartitioning partitioning)
+    throws VoltCompiler.VoltCompilerException {
+        return compileFromSqlTextAndUpdateCatalog(compiler, hsql, db, estimates, catalogStmt,
+                sqlText, joinOrder, detMode, partitioning, false);
+    }
+
+    static boolean compileFromSqlTextAndUpdateCatalog(VoltCompiler compiler, HSQLInterface hsql,
+            Database db, DatabaseEstimates estimates,
+            Statement catalogStmt, String sqlText, String joinOrder,
+            DeterminismMode detMode, StatementPartitioning partitioning, boolean cacheResult)
     throws VoltCompiler.VoltCompilerException {
         return compileStatementAndUpdateCatalog(compiler, hsql, db, estimates, catalogStmt,
-                null, sqlText, joinOrder, detMode, partitioning);
+                null, sqlText, joinOrder, detMode, partitioning, cacheResult);
     }
 
     /**
      * Update the plan fragment and return the bytes of the plan
      */
-    static byte[] writePlanBytes(VoltCompiler compiler, PlanFragment fragment, AbstractPlanNode planGraph)
+    static byte[] writePlanBytes(VoltCompiler compiler, PlanFragment fragment, AbstractPlanNode planGraph,
+            boolean cacheResult)
     throws VoltCompilerException {
         String json = null;
         // get the plan bytes
         PlanNodeList node_list = new PlanNodeList(planGraph);
+        node_list.setCacheResult(cacheResult);
         json = node_list.toJSONString();
         compiler.captureDiagnosticJsonFragment(json);
         // Place serialized version of PlanNodeTree into a PlanFragment
@@ -1997,7 +1997,8 @@ public class VoltCompiler {
      * For example, if the SQL is the same, but the partitioning isn't, then the statements
      * aren't actually interchangeable.
      */
-    String getKeyPrefix(StatementPartitioning partitioning, DeterminismMode detMode, String joinOrder) {
+    String getKeyPrefix(StatementPartitioning partitioning, DeterminismMode detMode, String joinOrder,
+            boolean cacheResult) {
         // no caching for inferred yet
         if (partitioning.isInferred()) {
             return null;
@@ -2010,7 +2011,8 @@ public class VoltCompiler {
 
         boolean partitioned = partitioning.wasSpecifiedAsSingle();
 
-        return joinOrderPrefix + String.valueOf(detMode.toChar()) + (partitioned ? "P#" : "R#");
+        return joinOrderPrefix + String.valueOf(detMode.toChar()) + (cacheResult ? "C" : "") +
+                (partitioned ? "P#" : "R#");
     }
 
     void addStatementToCache(Statement stmt) {
@@ -45,6 +45,8 @@ import org.voltdb.DRIdempotencyResult;
 import org.voltdb.DRLogSegmentId;
 import org.voltdb.DependencyPair;
 import org.voltdb.ExtensibleSnapshotDigestData;
+import org.voltdb.CompactionStats;
+import org.voltdb.FragmentResultCacheStats;
 import org.voltdb.HsqlBackend;
 import org.voltdb.HybridCrc32;
 import org.voltdb.IndexStats;
@@ -163,6 +165,8 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
     // Stats
     final TableStats m_tableStats;
     final IndexStats m_indexStats;
+    final FragmentResultCacheStats m_fragmentResultCacheStats;
+    final CompactionStats m_compactionStats;
     final MemoryStats m_memStats;
 
     // Each execution site manages snapshot using a SnapshotSiteProcessor
@@ -633,11 +637,21 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
             agent.registerStatsSource(StatsSelector.INDEX,
                                       m_siteId,
                                       m_indexStats);
+            m_fragmentResultCacheStats = new FragmentResultCacheStats(m_siteId);
+            agent.registerStatsSource(StatsSelector.FRAGMENTRESULTCACHE,
+                                      m_siteId,
+                                      m_fragmentResultCacheStats);
+            m_compactionStats = new CompactionStats(m_siteId);
+            agent.registerStatsSource(StatsSelector.COMPACTION,
+                                      m_siteId,
+                                      m_compactionStats);
             m_memStats = memStats;
         } else {
             // MPI doesn't need to track these stats
             m_tableStats = null;
             m_indexStats = null;
+            m_fragmentResultCacheStats = null;
+            m_compactionStats = null;
             m_memStats = null;
         }
     }
@@ -702,6 +716,12 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
         ExecutionEngine eeTemp = null;
         Deployment deploy = m_context.cluster.getDeployment().get("deployment");
         final int defaultDrBufferSize = Integer.getInteger("DR_DEFAULT_BUFFER_SIZE", 512 * 1024); // 512KB
+        final long fragmentResultCacheSize = Long.getLong("FRAGMENT_RESULT_CACHE_SIZE", 0); // off
+        final int parallelScanThreads = Integer.getInteger("EE_PARALLEL_SCAN_THREADS", 0); // off
+        final long compactionTuplesPerTick = Long.getLong("EE_COMPACTION_TUPLES_PER_TICK", 0); // off
+        final int compactionMillisPerTick = Integer.getInteger("EE_COMPACTION_MILLIS_PER_TICK", 5);
+        final String coldTierDirectory = System.getProperty("EE_COLD_TIER_DIRECTORY", ""); // off
+        final int coldAfterTicks = Integer.getInteger("EE_COLD_TIER_AFTER_TICKS", 300);
         try {
             if (m_backend == BackendTarget.NATIVE_EE_JNI) {
                 eeTemp =
@@ -754,6 +774,18 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
             eeTemp.loadCatalog(m_startupConfig.m_timestamp, m_startupConfig.m_serializedCatalog);
             eeTemp.setBatchTimeout(m_context.cluster.getDeployment().get("deployment").
                             getSystemsettings().get("systemsettings").getQuerytimeout());
+            if (fragmentResultCacheSize > 0) {
+                eeTemp.setFragmentResultCacheMemoryLimit(fragmentResultCacheSize);
+            }
+            if (parallelScanThreads > 0) {
+                eeTemp.setParallelScanThreadCount(parallelScanThreads);
+            }
+            if (compactionTuplesPerTick > 0) {
+                eeTemp.setCompactionBudget(compactionTuplesPerTick, compactionMillisPerTick);
+            }
+            if (!coldTierDirectory.isEmpty()) {
+                eeTemp.setColdTier(coldTierDirectory, coldAfterTicks);
+            }
         }
         // just print error info an bail if we run into an error here
         catch (final Exception ex) {
@@ -1303,6 +1335,26 @@ public class Site implements Runnable, SiteProcedureConnection, SiteSnapshotConn
                 m_indexStats.resetStatsTable();
             }
 
+            // update fragment result cache stats
+            final VoltTable[] s3 =
+                m_ee.getStats(StatsSelector.FRAGMENTRESULTCACHE, new int[] { 0 }, false, time);
+            if ((s3 != null) && (s3.length > 0)) {
+                m_fragmentResultCacheStats.setStatsTable(s3[0]);
+            }
+            else {
+                m_fragmentResultCacheStats.resetStatsTable();
+            }
+
+            // update compaction stats
+            final VoltTable[] s4 =
+                m_ee.getStats(StatsSelector.COMPACTION, tableIds, false, time);
+            if ((s4 != null) && (s4.length > 0)) {
+                m_compactionStats.setStatsTable(s4[0]);
+            }
+            else {
+                m_compactionStats.resetStatsTable();
+            }
+
             // update the rolled up memory statistics
             if (m_memStats != null) {
                 m_memStats.eeUpdateMemStats(m_siteId,
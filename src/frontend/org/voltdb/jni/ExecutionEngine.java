@@ -42,6 +42,7 @@ import org.voltdb.VoltDB;
 import org.voltdb.VoltTable;
 import org.voltdb.iv2.TxnEgo;
 import org.voltdb.utils.VoltTrace;
+import org.voltdb.common.Constants;
 import org.voltdb.exceptions.EEException;
 import org.voltdb.messaging.FastDeserializer;
 import org.voltdb.planner.ActivePlanRepository;
@@ -69,7 +70,11 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
         GENERATE_DR_EVENT(6),
         RESET_DR_APPLIED_TRACKER(7),
         SET_MERGED_DRID_TRACKER(8),
-        INIT_DRID_TRACKER(9);
+        INIT_DRID_TRACKER(9),
+        SET_FRAGMENT_RESULT_CACHE_MEMORY_LIMIT(10),
+        SET_PARALLEL_SCAN_THREAD_COUNT(11),
+        SET_COMPACTION_BUDGET(12),
+        SET_COLD_TIER(13);
 
         private TaskType(int taskId) {
             this.taskId = taskId;
@@ -177,6 +182,56 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
         return m_batchTimeout;
     }
 
+    /**
+     * Set the memory budget in bytes of the EE's cache of fragment results.
+     * Only fragments the planner marked as cacheable use it, and a budget
+     * of zero, the default, turns it off.
+     */
+    public void setFragmentResultCacheMemoryLimit(long memoryLimit) {
+        ByteBuffer paramBuffer = getParamBufferForExecuteTask(8);
+        paramBuffer.putLong(memoryLimit);
+        executeTask(TaskType.SET_FRAGMENT_RESULT_CACHE_MEMORY_LIMIT, paramBuffer);
+    }
+
+    /**
+     * Set the number of helper threads, shared by all of the sites in the
+     * process, that split large table scans. Zero, the default, leaves
+     * each site to scan on its own thread.
+     */
+    public void setParallelScanThreadCount(int threadCount) {
+        ByteBuffer paramBuffer = getParamBufferForExecuteTask(4);
+        paramBuffer.putInt(threadCount);
+        executeTask(TaskType.SET_PARALLEL_SCAN_THREAD_COUNT, paramBuffer);
+    }
+
+    /**
+     * Compact tables a slice at a time from tick, moving at most
+     * tuplesPerTick tuples and spending about millisPerTick each tick,
+     * instead of compacting a table fully when the deletes that call for
+     * it are released. A tuple budget of zero, the default, goes back to that.
+     */
+    public void setCompactionBudget(long tuplesPerTick, int millisPerTick) {
+        ByteBuffer paramBuffer = getParamBufferForExecuteTask(12);
+        paramBuffer.putLong(tuplesPerTick);
+        paramBuffer.putInt(millisPerTick);
+        executeTask(TaskType.SET_COMPACTION_BUDGET, paramBuffer);
+    }
+
+    /**
+     * Let every persistent table move blocks that go coldAfterTicks ticks
+     * without being scanned or changed to a file in the given directory,
+     * from which they are paged back in when reached. An empty directory,
+     * the default, keeps every block in memory.
+     */
+    public void setColdTier(String directory, int coldAfterTicks) {
+        byte[] directoryBytes = directory.getBytes(Constants.UTF8ENCODING);
+        ByteBuffer paramBuffer = getParamBufferForExecuteTask(8 + directoryBytes.length);
+        paramBuffer.putInt(coldAfterTicks);
+        paramBuffer.putInt(directoryBytes.length);
+        paramBuffer.put(directoryBytes);
+        executeTask(TaskType.SET_COLD_TIER, paramBuffer);
+    }
+
     private boolean shouldTimedOut (long latency) {
         if (m_fragmentContext == FragmentContext.RO_BATCH
                 && m_batchTimeout > NO_BATCH_TIMEOUT_VALUE
@@ -825,6 +880,28 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
                                         int remoteClusterId,
                                         long undoToken) throws EEException;
 
+    /**
+     * Run a batch of gets, puts, deletes and increments by primary key on a
+     * persistent table without going through a plan fragment. The layouts of
+     * the batch and of its results are described by the EE's KeyValueBatch.
+     * @param tableId                  The table to operate on
+     * @param batch                    The serialized operations
+     * @param txnId                    The txnId of the current transaction
+     * @param spHandle                 The spHandle of the current transaction
+     * @param lastCommittedSpHandle    The spHandle of the last committed transaction
+     * @param uniqueId                 The uniqueId of the current transaction
+     * @param undoToken                For undo
+     * @return the serialized results of the operations
+     * @throws EEException
+     */
+    public abstract byte[] executeKeyValueBatch(int tableId,
+                                                byte[] batch,
+                                                long txnId,
+                                                long spHandle,
+                                                long lastCommittedSpHandle,
+                                                long uniqueId,
+                                                long undoToken) throws EEException;
+
     /**
      * Execute an arbitrary non-transactional task that is described by the task id and
      * serialized task parameters. The return value is also opaquely encoded. This means
@@ -1101,6 +1178,19 @@ public abstract class ExecutionEngine implements FastDeserializer.Deserializatio
                                                int remoteClusterId,
                                                long undoToken);
 
+    /**
+     * Run a key-value batch that was serialized into the given array.
+     * @return the size of the results, or -1 if the batch failed
+     */
+    protected native int nativeExecuteKeyValueBatch(long pointer,
+                                                    int tableId,
+                                                    byte[] batch,
+                                                    long txnId,
+                                                    long spHandle,
+                                                    long lastCommittedSpHandle,
+                                                    long uniqueId,
+                                                    long undoToken);
+
     /**
      * Execute an arbitrary task based on the task ID and serialized task parameters.
      * This is a generic entry point into the EE that doesn't need to be updated in the IPC
@@ -127,7 +127,8 @@ public class ExecutionEngineIPC extends ExecutionEngine {
         GetUSOs(25),
         updateHashinator(27),
         executeTask(28),
-        applyBinaryLog(29);
+        applyBinaryLog(29),
+        executeKeyValueBatch(30);
         Commands(final int id) {
             m_id = id;
         }
@@ -1621,6 +1622,58 @@ public class ExecutionEngineIPC extends ExecutionEngine {
         }
     }
 
+    @Override
+    public byte[] executeKeyValueBatch(int tableId, byte[] batch, long txnId, long spHandle,
+                                       long lastCommittedSpHandle, long uniqueId, long undoToken)
+    throws EEException
+    {
+        m_data.clear();
+        m_data.putInt(Commands.executeKeyValueBatch.m_id);
+        m_data.putInt(tableId);
+        m_data.putLong(txnId);
+        m_data.putLong(spHandle);
+        m_data.putLong(lastCommittedSpHandle);
+        m_data.putLong(uniqueId);
+        m_data.putLong(undoToken);
+        if (m_data.remaining() < batch.length) {
+            m_data.flip();
+            final ByteBuffer newBuffer = ByteBuffer.allocate(m_data.remaining() + batch.length);
+            newBuffer.put(m_data);
+            m_data = newBuffer;
+        }
+        m_data.put(batch);
+
+        try {
+            m_data.flip();
+            m_connection.write();
+
+            int result = m_connection.readStatusByte();
+            if (result != ExecutionEngine.ERRORCODE_SUCCESS) {
+                throwExceptionForError(result);
+            }
+            ByteBuffer length = ByteBuffer.allocate(4);
+            while (length.hasRemaining()) {
+                int read = m_connection.m_socketChannel.read(length);
+                if (read <= 0) {
+                    throw new EOFException();
+                }
+            }
+            length.flip();
+
+            ByteBuffer results = ByteBuffer.allocate(length.getInt());
+            while (results.hasRemaining()) {
+                int read = m_connection.m_socketChannel.read(results);
+                if (read <= 0) {
+                    throw new EOFException();
+                }
+            }
+            return results.array();
+        } catch (final IOException e) {
+            System.out.println("Exception: " + e.getMessage());
+            throw new RuntimeException(e);
+        }
+    }
+
     @Override
     public long getThreadLocalPoolAllocations() {
         m_data.clear();
@@ -19,6 +19,7 @@ package org.voltdb.jni;
 
 import java.io.IOException;
 import java.nio.ByteBuffer;
+import java.util.ArrayList;
 import java.util.List;
 
 import org.voltcore.logging.VoltLogger;
@@ -121,6 +122,14 @@ public class ExecutionEngineJNI extends ExecutionEngine {
      */
     private ByteBuffer m_fallbackBuffer = null;
 
+    /*
+     * Results the EE pushed before finishing the current batch, so that it
+     * could reuse its result buffer, and the offset in the results at which
+     * they belong. See pushResultChunk().
+     */
+    private final List<byte[]> m_resultChunks = new ArrayList<byte[]>();
+    private int m_resultChunksOffset = -1;
+
     private final BBContainer m_exceptionBufferOrigin = org.voltcore.utils.DBBPool.allocateDirect(1024 * 1024 * 5);
     private ByteBuffer m_exceptionBuffer = m_exceptionBufferOrigin.b();
 
@@ -428,6 +437,11 @@ public class ExecutionEngineJNI extends ExecutionEngine {
             checkErrorCode(errorCode);
             m_usingFallbackBuffer = m_fallbackBuffer != null;
             FastDeserializer fds = m_usingFallbackBuffer ? new FastDeserializer(m_fallbackBuffer) : targetDeserializer;
+            if (!m_resultChunks.isEmpty()) {
+                // The joined results do not share the EE's buffer either
+                fds = new FastDeserializer(joinResultChunks(fds.buffer()));
+                m_usingFallbackBuffer = true;
+            }
             assert(fds != null);
             try {
                 // check if anything was changed
@@ -440,9 +454,34 @@ public class ExecutionEngineJNI extends ExecutionEngine {
             return fds;
         } finally {
             m_fallbackBuffer = null;
+            m_resultChunks.clear();
+            m_resultChunksOffset = -1;
         }
     }
 
+    /*
+     * Put the result chunks back in their place among the results left in
+     * the EE's buffer, which start with the dirty flag and the length of the
+     * whole batch.
+     */
+    private ByteBuffer joinResultChunks(ByteBuffer results) {
+        final int totalLength = results.getInt(1) + 5;
+        final ByteBuffer joined = ByteBuffer.allocate(totalLength);
+        final ByteBuffer head = results.duplicate();
+        head.position(0);
+        head.limit(m_resultChunksOffset);
+        joined.put(head);
+        for (byte[] chunk : m_resultChunks) {
+            joined.put(chunk);
+        }
+        final ByteBuffer tail = results.duplicate();
+        tail.position(m_resultChunksOffset);
+        tail.limit(m_resultChunksOffset + joined.remaining());
+        joined.put(tail);
+        joined.flip();
+        return joined;
+    }
+
     @Override
     public VoltTable serializeTable(final int tableId) throws EEException {
         if (HOST_TRACE_ENABLED) {
@@ -698,6 +737,27 @@ public class ExecutionEngineJNI extends ExecutionEngine {
         return rowCount;
     }
 
+    @Override
+    public byte[] executeKeyValueBatch(int tableId, byte[] batch, long txnId, long spHandle,
+                                       long lastCommittedSpHandle, long uniqueId, long undoToken) throws EEException
+    {
+        //Clear is destructive, do it before the native call
+        m_nextDeserializer.clear();
+        final int resultSize = nativeExecuteKeyValueBatch(pointer, tableId, batch, txnId, spHandle,
+                                                          lastCommittedSpHandle, uniqueId, undoToken);
+        if (resultSize < 0) {
+            throwExceptionForError(ERRORCODE_ERROR);
+        }
+        try {
+            byte[] results = new byte[resultSize];
+            m_nextDeserializer.readFully(results);
+            return results;
+        } catch (final IOException ex) {
+            LOG.error("Failed to retrieve key-value batch results: " + tableId, ex);
+            throw new EEException(ERRORCODE_WRONG_SERIALIZED_BYTES);
+        }
+    }
+
     @Override
     public long getThreadLocalPoolAllocations() {
         return nativeGetThreadLocalPoolAllocations();
@@ -713,6 +773,19 @@ public class ExecutionEngineJNI extends ExecutionEngine {
         m_fallbackBuffer = buffer;
     }
 
+    /*
+     * Take a chunk of the results of the current batch, which the EE pushes
+     * when its result buffer fills up. The EE reuses the memory, so the
+     * chunk is copied.
+     */
+    public void pushResultChunk(ByteBuffer chunk, int offset) {
+        assert(m_resultChunksOffset == -1 || m_resultChunksOffset == offset);
+        m_resultChunksOffset = offset;
+        byte[] bytes = new byte[chunk.remaining()];
+        chunk.get(bytes);
+        m_resultChunks.add(bytes);
+    }
+
     @Override
     public byte[] executeTask(TaskType taskType, ByteBuffer task) throws EEException {
         try {
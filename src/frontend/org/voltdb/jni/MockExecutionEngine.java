@@ -230,6 +230,13 @@ public class MockExecutionEngine extends ExecutionEngine {
         throw new UnsupportedOperationException();
     }
 
+    @Override
+    public byte[] executeKeyValueBatch(int tableId, byte[] batch, long txnId, long spHandle,
+                                       long lastCommittedSpHandle, long uniqueId, long undoToken) throws EEException
+    {
+        throw new UnsupportedOperationException();
+    }
+
     @Override
     public long getThreadLocalPoolAllocations() {
         return 0L;
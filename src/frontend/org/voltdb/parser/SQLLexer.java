@@ -55,6 +55,7 @@ public class SQLLexer extends SQLPatternFactory
         new VerbToken("export", true),
         new VerbToken("partition", true),
         new VerbToken("dr", true),
+        new VerbToken("dictionary", true),
         new VerbToken("set", true),
         // Unsupported verbs
         new VerbToken("import", false)
@@ -115,6 +115,21 @@ public class SQLParser extends SQLPatternFactory
             SPF.token("on"), SPF.token("column"), SPF.capture(SPF.databaseObjectName())
         ).compile("PAT_PARTITION_TABLE");
 
+    /**
+     * Pattern: DICTIONARY TABLE tablename ON COLUMN columnname
+     *
+     * NB supports only unquoted table and column names
+     *
+     * Capture groups:
+     *  (1) table name
+     *  (2) column name
+     */
+    private static final Pattern PAT_DICTIONARY_TABLE =
+        SPF.statement(
+            SPF.token("dictionary"), SPF.token("table"), SPF.capture(SPF.databaseObjectName()),
+            SPF.token("on"), SPF.token("column"), SPF.capture(SPF.databaseObjectName())
+        ).compile("PAT_DICTIONARY_TABLE");
+
     /**
      * PARTITION PROCEDURE procname ON TABLE tablename COLUMN columnname [PARAMETER paramnum]
      *
@@ -347,6 +362,7 @@ public class SQLParser extends SQLPatternFactory
             "\\AREPLICATE|" +
             "\\AIMPORT|" +
             "\\ADR|" +
+            "\\ADICTIONARY|" +
             "\\ASET" +
             ")" +                                  // end (group 1)
             "\\s" +                                // one required whitespace to terminate keyword
@@ -645,6 +661,16 @@ public class SQLParser extends SQLPatternFactory
         return PAT_DR_TABLE.matcher(statement);
     }
 
+    /**
+     * Match statement against dictionary table pattern
+     * @param statement  statement to match against
+     * @return           pattern matcher object
+     */
+    public static Matcher matchDictionaryTable(String statement)
+    {
+        return PAT_DICTIONARY_TABLE.matcher(statement);
+    }
+
     /**
      * Match statement against import class pattern
      * @param statement  statement to match against
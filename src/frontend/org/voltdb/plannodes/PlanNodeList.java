@@ -33,9 +33,11 @@ import org.json_voltpatches.JSONStringer;
 public class PlanNodeList implements JSONString, Comparable<PlanNodeList> {
     private static final String EXECUTE_LIST_MEMBER_NAME = "EXECUTE_LIST";
     private static final String EXECUTE_LISTS_MEMBER_NAME = "EXECUTE_LISTS";
+    private static final String CACHE_RESULT_MEMBER_NAME = "CACHE_RESULT";
 
     private PlanNodeTree m_tree;
     protected List<List<AbstractPlanNode>> m_executeLists = new ArrayList<>();
+    private boolean m_cacheResult = false;
 
     public PlanNodeList() {
         super();
@@ -54,6 +56,13 @@ public class PlanNodeList implements JSONString, Comparable<PlanNodeList> {
         }
     }
 
+    /**
+     * Ask the EE to keep this fragment's results in its fragment result cache.
+     */
+    public void setCacheResult(boolean cacheResult) {
+        m_cacheResult = cacheResult;
+    }
+
     public List<AbstractPlanNode> getExecutionList() {
         assert(!m_executeLists.isEmpty());
         return m_executeLists.get(0);
@@ -178,6 +187,10 @@ public class PlanNodeList implements JSONString, Comparable<PlanNodeList> {
                 stringer.endArray(); //end execution list
             }
 
+            if (m_cacheResult) {
+                stringer.key(CACHE_RESULT_MEMBER_NAME).value(true);
+            }
+
             stringer.endObject(); //end PlanNodeList
             return stringer.toString();
         }
@@ -120,6 +120,7 @@ public enum ExpressionType {
     AGGREGATE_APPROX_COUNT_DISTINCT(AggregateExpression.class, 46, "APPROX_COUNT_DISTINCT"),
     AGGREGATE_VALS_TO_HYPERLOGLOG (AggregateExpression.class, 47, "VALS_TO_HYPERLOGLOG"),
     AGGREGATE_HYPERLOGLOGS_TO_CARD(AggregateExpression.class, 48, "HYPERLOGLOGS_TO_CARD"),
+    // 49-51 are taken by the EE-only APPROX_PERCENTILE aggregates
     // ----------------------------
     // Windowed Aggregates.  We need to treat these
     // somewhat differently than the non-windowed
@@ -392,6 +392,12 @@ public abstract class CatalogSchemaTools {
             sb.append("DR TABLE ").append(catalog_tbl.getTypeName()).append(";\n");
         }
 
+        for (Column catalog_col : catalog_tbl.getColumns()) {
+            if (catalog_col.getDictionary()) {
+                sb.append("DICTIONARY TABLE ").append(catalog_tbl.getTypeName()).append(" ON COLUMN ").append(catalog_col.getTypeName()).append(";\n");
+            }
+        }
+
         sb.append("\n");
         // Canonical DDL generation for this table is done, now just hand the CREATE TABLE
         // statement to whoever might be interested (DDLCompiler, I'm looking in your direction)
@@ -0,0 +1,296 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Compares DECIMAL arithmetic on native 128-bit integers against the
+ * same operations done with ttmath TTInt/TTLInt, and times the NValue
+ * operators that now use the native fast paths. Values look like money:
+ * up to ten million with two digits of cents, which is what
+ * SUM(price * quantity) sees.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <sys/time.h>
+#include <vector>
+
+#include "common/NValue.hpp"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+
+using namespace voltdb;
+
+static int64_t getMicrosNow() {
+    timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+#define MAXSCALE 10000000
+
+static TTInt s_maxDecimal("99999999999999999999999999999999999999");
+static TTInt s_minDecimal("-99999999999999999999999999999999999999");
+static const NativeDecimal s_maxNativeDecimal =
+        static_cast<NativeDecimal>(10000000000000000000ULL) * 10000000000000000000ULL - 1;
+
+class BenchmarkRecorder {
+public:
+    BenchmarkRecorder(const char* name) : m_name(name), m_start(0), m_total(0) { }
+
+    void start() {
+        m_start = getMicrosNow();
+    }
+
+    void stop() {
+        m_total += getMicrosNow() - m_start;
+    }
+
+    void report(const BenchmarkRecorder& baseline, int64_t operations) const {
+        printf("    %-8s %10lld us  %8.2f ns/op  %6.2fx\n", m_name, (long long)m_total,
+               1000.0 * static_cast<double>(m_total) / static_cast<double>(operations),
+               (m_total == 0) ? 0.0 : static_cast<double>(baseline.m_total) / static_cast<double>(m_total));
+    }
+
+private:
+    const char* m_name;
+    int64_t m_start;
+    int64_t m_total;
+};
+
+static std::vector<NValue> getRandomDecimals(int size) {
+    std::vector<NValue> values;
+    values.reserve(size);
+    char buffer[64];
+    for (int i = 0; i < size; i++) {
+        long long cents = rand() % 1000000000LL;
+        snprintf(buffer, sizeof(buffer), "%s%lld.%02lld", (rand() % 4 == 0) ? "-" : "",
+                 cents / 100, cents % 100);
+        values.push_back(ValueFactory::getDecimalValueFromString(buffer));
+    }
+    return values;
+}
+
+static void runBenchmark(int dataScale, int repeat) {
+    srand(static_cast<unsigned int>(getMicrosNow() % 1000000));
+    std::vector<NValue> lhs = getRandomDecimals(dataScale);
+    std::vector<NValue> rhs = getRandomDecimals(dataScale);
+    std::vector<TTInt> lhsTTInt, rhsTTInt;
+    std::vector<NativeDecimal> lhsNative, rhsNative;
+    for (int i = 0; i < dataScale; i++) {
+        lhsTTInt.push_back(ValuePeeker::peekDecimal(lhs[i]));
+        rhsTTInt.push_back(ValuePeeker::peekDecimal(rhs[i]));
+        lhsNative.push_back(ValuePeeker::peekNativeDecimal(lhs[i]));
+        rhsNative.push_back(ValuePeeker::peekNativeDecimal(rhs[i]));
+    }
+    const int64_t operations = static_cast<int64_t>(dataScale) * repeat;
+    // Accumulated so the compiler cannot discard the work
+    int64_t check = 0;
+
+    // "ttmath" and "native" time the bare arithmetic the way NValue did it
+    // before and does it now; "NValue" times the whole operator as queries see it.
+    printf("SUM (add):\n");
+    {
+        BenchmarkRecorder ttmath("ttmath"), native("native"), nvalue("NValue");
+        ttmath.start();
+        for (int r = 0; r < repeat; r++) {
+            TTInt sum;
+            for (int i = 0; i < dataScale; i++) {
+                if (sum.Add(lhsTTInt[i]) || sum > s_maxDecimal || sum < s_minDecimal) {
+                    abort();
+                }
+            }
+            check += sum.table[0];
+        }
+        ttmath.stop();
+        native.start();
+        for (int r = 0; r < repeat; r++) {
+            NativeDecimal sum = 0;
+            for (int i = 0; i < dataScale; i++) {
+                sum += lhsNative[i];
+                if (sum > s_maxNativeDecimal || sum < -s_maxNativeDecimal) {
+                    abort();
+                }
+            }
+            check += static_cast<int64_t>(sum);
+        }
+        native.stop();
+        nvalue.start();
+        for (int r = 0; r < repeat; r++) {
+            NValue sum = ValueFactory::getDecimalValueFromString("0");
+            for (int i = 0; i < dataScale; i++) {
+                sum = sum.op_add(lhs[i]);
+            }
+            check += static_cast<int64_t>(ValuePeeker::peekNativeDecimal(sum));
+        }
+        nvalue.stop();
+        ttmath.report(ttmath, operations);
+        native.report(ttmath, operations);
+        nvalue.report(ttmath, operations);
+    }
+
+    printf("multiply:\n");
+    {
+        BenchmarkRecorder ttmath("ttmath"), native("native"), nvalue("NValue");
+        ttmath.start();
+        for (int r = 0; r < repeat; r++) {
+            for (int i = 0; i < dataScale; i++) {
+                TTLInt calc;
+                calc.FromInt(lhsTTInt[i]);
+                calc *= rhsTTInt[i];
+                calc /= NValue::kMaxScaleFactor;
+                TTInt product;
+                if (product.FromInt(calc) || product > s_maxDecimal || product < s_minDecimal) {
+                    abort();
+                }
+                check += product.table[0];
+            }
+        }
+        ttmath.stop();
+        native.start();
+        for (int r = 0; r < repeat; r++) {
+            for (int i = 0; i < dataScale; i++) {
+                NativeDecimal product = lhsNative[i] * rhsNative[i] / NValue::kMaxScaleFactor;
+                if (product > s_maxNativeDecimal || product < -s_maxNativeDecimal) {
+                    abort();
+                }
+                check += static_cast<int64_t>(product);
+            }
+        }
+        native.stop();
+        nvalue.start();
+        for (int r = 0; r < repeat; r++) {
+            for (int i = 0; i < dataScale; i++) {
+                check += static_cast<int64_t>(ValuePeeker::peekNativeDecimal(lhs[i].op_multiply(rhs[i])));
+            }
+        }
+        nvalue.stop();
+        ttmath.report(ttmath, operations);
+        native.report(ttmath, operations);
+        nvalue.report(ttmath, operations);
+    }
+
+    printf("divide:\n");
+    {
+        BenchmarkRecorder ttmath("ttmath"), native("native"), nvalue("NValue");
+        ttmath.start();
+        for (int r = 0; r < repeat; r++) {
+            for (int i = 0; i < dataScale; i++) {
+                TTLInt calc;
+                calc.FromInt(lhsTTInt[i]);
+                calc *= NValue::kMaxScaleFactor;
+                if (calc.Div(rhsTTInt[i])) {
+                    continue;
+                }
+                TTInt quotient;
+                if (quotient.FromInt(calc) || quotient > s_maxDecimal || quotient < s_minDecimal) {
+                    continue;
+                }
+                check += quotient.table[0];
+            }
+        }
+        ttmath.stop();
+        native.start();
+        for (int r = 0; r < repeat; r++) {
+            for (int i = 0; i < dataScale; i++) {
+                if (rhsNative[i] == 0) {
+                    continue;
+                }
+                NativeDecimal quotient = lhsNative[i] * NValue::kMaxScaleFactor / rhsNative[i];
+                if (quotient > s_maxNativeDecimal || quotient < -s_maxNativeDecimal) {
+                    continue;
+                }
+                check += static_cast<int64_t>(quotient);
+            }
+        }
+        native.stop();
+        nvalue.start();
+        for (int r = 0; r < repeat; r++) {
+            for (int i = 0; i < dataScale; i++) {
+                if (rhsNative[i] == 0) {
+                    continue;
+                }
+                try {
+                    check += static_cast<int64_t>(ValuePeeker::peekNativeDecimal(lhs[i].op_divide(rhs[i])));
+                } catch (SQLException& ex) {
+                    continue;
+                }
+            }
+        }
+        nvalue.stop();
+        ttmath.report(ttmath, operations);
+        native.report(ttmath, operations);
+        nvalue.report(ttmath, operations);
+    }
+
+    printf("compare:\n");
+    {
+        BenchmarkRecorder ttmath("ttmath"), native("native"), nvalue("NValue");
+        ttmath.start();
+        for (int r = 0; r < repeat; r++) {
+            for (int i = 0; i < dataScale; i++) {
+                check += (lhsTTInt[i] == rhsTTInt[i]) ? 0 : ((lhsTTInt[i] > rhsTTInt[i]) ? 1 : -1);
+            }
+        }
+        ttmath.stop();
+        native.start();
+        for (int r = 0; r < repeat; r++) {
+            for (int i = 0; i < dataScale; i++) {
+                check += (lhsNative[i] == rhsNative[i]) ? 0 : ((lhsNative[i] > rhsNative[i]) ? 1 : -1);
+            }
+        }
+        native.stop();
+        nvalue.start();
+        for (int r = 0; r < repeat; r++) {
+            for (int i = 0; i < dataScale; i++) {
+                check += lhs[i].compare(rhs[i]);
+            }
+        }
+        nvalue.stop();
+        ttmath.report(ttmath, operations);
+        native.report(ttmath, operations);
+        nvalue.report(ttmath, operations);
+    }
+
+    printf("(checksum %lld)\n", (long long)check);
+}
+
+int main(int argc, char *argv[]) {
+    if ((argc > 1 && *argv[1] == '-') || argc <= 2) {
+        printf("To run a benchmark, execute %s with command line arguments. "
+                "Both are required: ("
+                "data_scale<int>, "
+                "repeat<int>)\n",
+                argv[0]);
+        return 0;
+    }
+    int data_scale = std::atoi(argv[1]);
+    if (data_scale > MAXSCALE) {
+        printf("data scale larger than %d is not supported\n", MAXSCALE);
+        return 0;
+    }
+    int repeat = std::atoi(argv[2]);
+
+    runBenchmark(data_scale, repeat);
+
+    return 0;
+}
@@ -1950,6 +1950,105 @@ TEST_F(NValueTest, DecimalQuotients) {
    }
 }
 
+/*
+ * The native 128-bit arithmetic must agree with ttmath on both sides of
+ * each fast path's limits: 64-bit operands for products, 2**86 for
+ * dividends, and the 38-digit range for every result.
+ */
+TEST_F(NValueTest, DecimalNativeAgreesWithTTInt)
+{
+    const char* operands[] = {
+        "0", "1", "-1", "0.000000000001", "-0.5", "218772.11111111", "2.001",
+        "9223372.036854775807",        // 2**63 - 1 unscaled
+        "9223372.036854775808",        // 2**63 unscaled
+        "-9223372.036854775808",
+        "77371252455336.267181195263", // 2**86 - 1 unscaled
+        "77371252455336.267181195264", // 2**86 unscaled
+        "-77371252455336.267181195264",
+        "12345678901234567890.123456789012",
+        "99999999999999999999999999.999999999999",
+        "-99999999999999999999999999.999999999999"
+    };
+    const int operandCount = sizeof(operands) / sizeof(operands[0]);
+    TTInt maxDecimal("99999999999999999999999999999999999999");
+    TTInt minDecimal("-99999999999999999999999999999999999999");
+
+    for (int ii = 0; ii < operandCount; ++ii) {
+        NValue lhs = ValueFactory::getDecimalValueFromString(operands[ii]);
+        TTInt lhsValue = ValuePeeker::peekDecimal(lhs);
+        // Formatted the way it was before there were native decimals
+        TTInt whole(lhsValue);
+        TTInt fractional(lhsValue);
+        whole /= NValue::kMaxScaleFactor;
+        fractional %= NValue::kMaxScaleFactor;
+        if (whole.IsSign()) {
+            whole.ChangeSign();
+        }
+        if (fractional.IsSign()) {
+            fractional.ChangeSign();
+        }
+        std::string fractionalString = fractional.ToString(10);
+        std::string expectedString = std::string(lhsValue.IsSign() ? "-" : "") + whole.ToString(10) + "." +
+                std::string(NValue::kMaxDecScale - fractionalString.size(), '0') + fractionalString;
+        EXPECT_EQ(expectedString, ValuePeeker::peekDecimalString(lhs));
+        for (int jj = 0; jj < operandCount; ++jj) {
+            NValue rhs = ValueFactory::getDecimalValueFromString(operands[jj]);
+            TTInt rhsValue = ValuePeeker::peekDecimal(rhs);
+
+            int expectedCompare = (lhsValue == rhsValue) ? VALUE_COMPARE_EQUAL :
+                    ((lhsValue > rhsValue) ? VALUE_COMPARE_GREATERTHAN : VALUE_COMPARE_LESSTHAN);
+            EXPECT_EQ(expectedCompare, lhs.compare(rhs));
+
+            TTInt sum(lhsValue);
+            bool overflow = sum.Add(rhsValue) || sum > maxDecimal || sum < minDecimal;
+            try {
+                NValue result = lhs.op_add(rhs);
+                EXPECT_FALSE(overflow);
+                EXPECT_EQ(sum, ValuePeeker::peekDecimal(result));
+            } catch (SQLException& ex) {
+                EXPECT_TRUE(overflow);
+            }
+
+            TTInt difference(lhsValue);
+            overflow = difference.Sub(rhsValue) || difference > maxDecimal || difference < minDecimal;
+            try {
+                NValue result = lhs.op_subtract(rhs);
+                EXPECT_FALSE(overflow);
+                EXPECT_EQ(difference, ValuePeeker::peekDecimal(result));
+            } catch (SQLException& ex) {
+                EXPECT_TRUE(overflow);
+            }
+
+            TTLInt calc;
+            calc.FromInt(lhsValue);
+            calc *= rhsValue;
+            calc /= NValue::kMaxScaleFactor;
+            TTInt product;
+            overflow = product.FromInt(calc) || product > maxDecimal || product < minDecimal;
+            try {
+                NValue result = lhs.op_multiply(rhs);
+                EXPECT_FALSE(overflow);
+                EXPECT_EQ(product, ValuePeeker::peekDecimal(result));
+            } catch (SQLException& ex) {
+                EXPECT_TRUE(overflow);
+            }
+
+            calc.FromInt(lhsValue);
+            calc *= NValue::kMaxScaleFactor;
+            TTInt quotient;
+            overflow = calc.Div(rhsValue) || quotient.FromInt(calc) ||
+                    quotient > maxDecimal || quotient < minDecimal;
+            try {
+                NValue result = lhs.op_divide(rhs);
+                EXPECT_FALSE(overflow);
+                EXPECT_EQ(quotient, ValuePeeker::peekDecimal(result));
+            } catch (SQLException& ex) {
+                EXPECT_TRUE(overflow);
+            }
+        }
+    }
+}
+
 TEST_F(NValueTest, SerializeToExport)
 {
     // test basic nvalue elt serialization. Note that
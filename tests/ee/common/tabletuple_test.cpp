@@ -26,6 +26,7 @@
 #include "common/ValueFactory.hpp"
 #include "common/ThreadLocalPool.h"
 #include "common/TupleSchemaBuilder.h"
+#include "common/TupleSerializationPlan.h"
 #include "test_utils/ScopedTupleSchema.hpp"
 
 using namespace voltdb;
@@ -156,6 +157,64 @@ TEST_F(TableTupleTest, ToJsonArray)
     nvalVisibleString.free();
 }
 
+TEST_F(TableTupleTest, SerializationPlan)
+{
+    TupleSchemaBuilder builder(11, 1);
+    builder.setColumnAtIndex(0, VALUE_TYPE_TINYINT);
+    builder.setColumnAtIndex(1, VALUE_TYPE_SMALLINT);
+    builder.setColumnAtIndex(2, VALUE_TYPE_INTEGER);
+    builder.setColumnAtIndex(3, VALUE_TYPE_BIGINT);
+    builder.setColumnAtIndex(4, VALUE_TYPE_VARCHAR, 10);
+    builder.setColumnAtIndex(5, VALUE_TYPE_DOUBLE);
+    builder.setColumnAtIndex(6, VALUE_TYPE_DECIMAL);
+    builder.setColumnAtIndex(7, VALUE_TYPE_TIMESTAMP);
+    builder.setColumnAtIndex(8, VALUE_TYPE_VARCHAR, 300);
+    builder.setColumnAtIndex(9, VALUE_TYPE_VARBINARY, 20);
+    builder.setColumnAtIndex(10, VALUE_TYPE_POINT);
+    builder.setHiddenColumnAtIndex(0, VALUE_TYPE_BIGINT);
+    ScopedTupleSchema schema(builder.build());
+
+    StandAloneTupleStorage autoStorage(schema.get());
+    const TableTuple& tuple = autoStorage.tuple();
+
+    NValue shortString = ValueFactory::getStringValue("dude");
+    NValue longString = ValueFactory::getStringValue(std::string(250, 'x'));
+    NValue binary = ValueFactory::getBinaryValue("DEADBEEF");
+    tuple.setNValue(0, ValueFactory::getTinyIntValue(-7));
+    tuple.setNValue(1, ValueFactory::getSmallIntValue(1234));
+    tuple.setNValue(2, ValueFactory::getIntegerValue(-123456789));
+    tuple.setNValue(3, ValueFactory::getBigIntValue(1234567890123LL));
+    tuple.setNValue(4, shortString);
+    tuple.setNValue(5, ValueFactory::getDoubleValue(-2.5));
+    tuple.setNValue(6, ValueFactory::getDecimalValueFromString("-12345678901234567890.123456789012"));
+    tuple.setNValue(7, ValueFactory::getTimestampValue(1500000000000000LL));
+    tuple.setNValue(8, longString);
+    tuple.setNValue(9, binary);
+    tuple.setNValue(10, NValue::getNullValue(VALUE_TYPE_POINT));
+    tuple.setHiddenNValue(0, ValueFactory::getBigIntValue(-1));
+
+    for (int round = 0; round < 2; round++) {
+        for (int hidden = 0; hidden < 2; hidden++) {
+            CopySerializeOutput expected;
+            tuple.serializeTo(expected, hidden == 1);
+            CopySerializeOutput actual;
+            TupleSerializationPlan plan(tuple.getSchema(), hidden == 1);
+            plan.serialize(tuple, actual);
+            ASSERT_EQ(expected.size(), actual.size());
+            EXPECT_EQ(0, ::memcmp(expected.data(), actual.data(), expected.size()));
+        }
+        // Then all NULLs
+        for (int i = 0; i < schema->columnCount(); i++) {
+            tuple.setNValue(i, NValue::getNullValue(schema->columnType(i)));
+        }
+        tuple.setHiddenNValue(0, NValue::getNullValue(VALUE_TYPE_BIGINT));
+    }
+
+    binary.free();
+    longString.free();
+    shortString.free();
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
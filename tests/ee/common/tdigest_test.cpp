@@ -0,0 +1,148 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "harness.h"
+#include "common/TDigest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace voltdb;
+
+class TDigestTest : public Test {
+public:
+    TDigestTest()
+    {
+        ::srand(42);
+        for (int i = 0; i < VALUE_COUNT; ++i) {
+            m_values.push_back(i);
+        }
+        std::random_shuffle(m_values.begin(), m_values.end());
+    }
+
+    // The exact value below which the fraction of 0 .. VALUE_COUNT - 1 falls
+    static double exactQuantile(double fraction) {
+        return fraction * (VALUE_COUNT - 1);
+    }
+
+protected:
+    static const int VALUE_COUNT = 100000;
+    std::vector<double> m_values;
+};
+
+TEST_F(TDigestTest, Empty) {
+    TDigest digest;
+    ASSERT_TRUE(digest.empty());
+    ASSERT_TRUE(std::isnan(digest.quantile(0.5)));
+    digest.add(7);
+    ASSERT_FALSE(digest.empty());
+    ASSERT_EQ(7, digest.quantile(0.01));
+    ASSERT_EQ(7, digest.quantile(0.99));
+    digest.clear();
+    ASSERT_TRUE(digest.empty());
+}
+
+TEST_F(TDigestTest, Accuracy) {
+    TDigest digest;
+    for (int i = 0; i < VALUE_COUNT; ++i) {
+        digest.add(m_values[i]);
+    }
+    ASSERT_EQ(VALUE_COUNT, digest.totalWeight());
+    // The whole distribution is summarized by a bounded number of centroids
+    ASSERT_TRUE(digest.centroidCount() <= 2 * TDigest::DEFAULT_COMPRESSION);
+
+    ASSERT_EQ(0, digest.quantile(0));
+    ASSERT_EQ(VALUE_COUNT - 1, digest.quantile(1));
+    // The tails are kept more accurate than the middle
+    const double fractions[] = { 0.5, 0.9, 0.99, 0.999, 0.01 };
+    const double tolerances[] = { 0.01, 0.005, 0.001, 0.0005, 0.001 };
+    for (int i = 0; i < 5; ++i) {
+        double error = std::fabs(digest.quantile(fractions[i]) - exactQuantile(fractions[i]));
+        ASSERT_TRUE(error <= tolerances[i] * VALUE_COUNT);
+    }
+}
+
+TEST_F(TDigestTest, Merge) {
+    TDigest whole;
+    TDigest parts[4];
+    for (int i = 0; i < VALUE_COUNT; ++i) {
+        whole.add(m_values[i]);
+        parts[i % 4].add(m_values[i]);
+    }
+    TDigest merged;
+    for (int i = 0; i < 4; ++i) {
+        merged.merge(parts[i]);
+    }
+    ASSERT_EQ(VALUE_COUNT, merged.totalWeight());
+    ASSERT_TRUE(merged.centroidCount() <= 2 * TDigest::DEFAULT_COMPRESSION);
+    const double fractions[] = { 0.5, 0.99 };
+    for (int i = 0; i < 2; ++i) {
+        double error = std::fabs(merged.quantile(fractions[i]) - exactQuantile(fractions[i]));
+        ASSERT_TRUE(error <= 0.01 * VALUE_COUNT);
+    }
+}
+
+TEST_F(TDigestTest, Serialization) {
+    // Each partition ships its digest to the coordinator, which merges them
+    std::vector<char> buffers[3];
+    for (int part = 0; part < 3; ++part) {
+        TDigest digest;
+        for (int i = part; i < VALUE_COUNT; i += 3) {
+            // Skewed, like latencies
+            digest.add(m_values[i] * m_values[i]);
+        }
+        buffers[part].resize(digest.serializedSize());
+        ReferenceSerializeOutput output(&buffers[part][0], buffers[part].size());
+        digest.serializeTo(output);
+        ASSERT_EQ(buffers[part].size(), output.position());
+        // Far smaller than the values summarized
+        ASSERT_TRUE(buffers[part].size() < 8 * VALUE_COUNT / 3 / 10);
+    }
+
+    TDigest coordinator;
+    for (int part = 0; part < 3; ++part) {
+        ReferenceSerializeInputBE input(&buffers[part][0], buffers[part].size());
+        coordinator.mergeSerialized(input);
+    }
+    ASSERT_EQ(VALUE_COUNT, coordinator.totalWeight());
+    ASSERT_EQ(0, coordinator.quantile(0));
+    ASSERT_EQ(exactQuantile(1) * exactQuantile(1), coordinator.quantile(1));
+    double p99 = exactQuantile(0.99) * exactQuantile(0.99);
+    ASSERT_TRUE(std::fabs(coordinator.quantile(0.99) - p99) <= 0.005 * p99);
+
+    // An empty digest merges as nothing
+    TDigest empty;
+    std::vector<char> emptyBuffer(empty.serializedSize());
+    ReferenceSerializeOutput output(&emptyBuffer[0], emptyBuffer.size());
+    empty.serializeTo(output);
+    ReferenceSerializeInputBE input(&emptyBuffer[0], emptyBuffer.size());
+    coordinator.mergeSerialized(input);
+    ASSERT_EQ(VALUE_COUNT, coordinator.totalWeight());
+    ASSERT_EQ(0, coordinator.quantile(0));
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -51,8 +51,12 @@
 
 #include "harness.h"
 
+#include "common/StringDictionary.h"
 #include "common/tabletuple.h"
 #include "common/valuevector.h"
+#include "common/ValueFactory.hpp"
+#include "execution/FragmentResultCache.h"
+#include "execution/KeyValueBatch.h"
 #include "expressions/abstractexpression.h"
 #include "indexes/tableindex.h"
 #include "plannodes/abstractplannode.h"
@@ -384,6 +388,19 @@ public:
     }
 
 protected:
+    /*
+     * Execute a fragment with no parameters and return a copy of the
+     * bytes it wrote to the result buffer.
+     */
+    std::string executeAndCopyResults(fragmentId_t fragmentId) {
+        m_engine->resetReusedResultOutputBuffer();
+        m_engine->resetPerFragmentStatsOutputBuffer();
+        memset(m_parameter_buffer.get(), 0, 4 * 1024);
+        voltdb::ReferenceSerializeInputBE emptyParams(m_parameter_buffer.get(), 4 * 1024);
+        m_engine->executePlanFragments(1, &fragmentId, NULL, emptyParams, 1000, 1000, 1000, 1000, 1, false);
+        return std::string(m_result_buffer.get(), m_engine->getResultsSize());
+    }
+
     voltdb::PersistentTable* m_partitioned_customer_table;
     int m_partitioned_customer_table_id;
 
@@ -578,6 +595,262 @@ TEST_F(ExecutionEngineTest, Execute_PlanFragmentInfo) {
     }
 }
 
+/*
+ * Run the same read-only fragment twice with the result cache enabled.
+ * The second run should come from the cache with identical bytes, and a
+ * write to the scanned table should make the next run execute again.
+ * Only fragments the planner marked with CACHE_RESULT use the cache.
+ */
+TEST_F(ExecutionEngineTest, FragmentResultCache) {
+    initialize(catalog_string, random_seed);
+    // The plan with the planner's opt-in added as its first member
+    ASSERT_EQ(0, plan.find("{\n"));
+    std::string cachedPlan = "{\n    \"CACHE_RESULT\": true,\n" + plan.substr(2);
+    m_topend->addPlan(100, cachedPlan);
+    m_topend->addPlan(101, plan);
+    fragmentId_t fragmentId = 100;
+    fragmentId_t uncachedFragmentId = 101;
+    const voltdb::FragmentResultCache& cache = m_engine->getFragmentResultCache();
+
+    // Off by default
+    executeAndCopyResults(fragmentId);
+    ASSERT_EQ(0, cache.entryCount());
+    ASSERT_EQ(0, cache.misses());
+
+    m_engine->setFragmentResultCacheMemoryLimit(1024 * 1024);
+    executeAndCopyResults(uncachedFragmentId);
+    ASSERT_EQ(0, cache.misses());
+    ASSERT_EQ(0, cache.entryCount());
+
+    std::string executed = executeAndCopyResults(fragmentId);
+    ASSERT_EQ(1, cache.misses());
+    ASSERT_EQ(0, cache.hits());
+    ASSERT_EQ(1, cache.entryCount());
+
+    std::string cached = executeAndCopyResults(fragmentId);
+    ASSERT_EQ(1, cache.hits());
+    ASSERT_TRUE(executed == cached);
+
+    ASSERT_TRUE(voltdb::tableutil::addRandomTuples(m_replicated_customer_table, 1));
+    std::string reexecuted = executeAndCopyResults(fragmentId);
+    ASSERT_EQ(1, cache.hits());
+    ASSERT_EQ(2, cache.misses());
+    ASSERT_EQ(1, cache.invalidations());
+    ASSERT_EQ(1, cache.entryCount());
+    ASSERT_TRUE(reexecuted.size() > cached.size());
+
+    // A budget too small for the result keeps nothing
+    m_engine->setFragmentResultCacheMemoryLimit(64);
+    ASSERT_EQ(0, cache.entryCount());
+    ASSERT_EQ(0, cache.memoryUsed());
+    executeAndCopyResults(fragmentId);
+    ASSERT_EQ(0, cache.entryCount());
+}
+
+/*
+ * A fragment that projects CURRENT_TIMESTAMP is never cached, even when
+ * the planner asked for it.
+ */
+TEST_F(ExecutionEngineTest, FragmentResultCacheSkipsCurrentTimestamp) {
+    initialize(catalog_string, random_seed);
+    std::string timestampPlan = "{\n    \"CACHE_RESULT\": true,\n" + plan.substr(2);
+    // Replace the CID2 expression, CID * 2, with CURRENT_TIMESTAMP
+    size_t start = timestampPlan.find("\"LEFT\"");
+    const std::string lastMember("\"VALUE_TYPE\": 6");
+    size_t end = timestampPlan.find(lastMember, start);
+    ASSERT_TRUE(start != std::string::npos && end != std::string::npos);
+    timestampPlan.replace(start, end + lastMember.size() - start,
+                          "\"ARGS\": [], \"FUNCTION_ID\": 43, \"NAME\": \"current_timestamp\", "
+                          "\"TYPE\": 100, \"VALUE_TYPE\": 11");
+    m_topend->addPlan(100, timestampPlan);
+    fragmentId_t fragmentId = 100;
+    const voltdb::FragmentResultCache& cache = m_engine->getFragmentResultCache();
+
+    m_engine->setFragmentResultCacheMemoryLimit(1024 * 1024);
+    executeAndCopyResults(fragmentId);
+    executeAndCopyResults(fragmentId);
+    ASSERT_EQ(0, cache.misses());
+    ASSERT_EQ(0, cache.hits());
+    ASSERT_EQ(0, cache.entryCount());
+}
+
+/*
+ * Run a fragment whose result does not fit in the result buffer. The
+ * engine should push the result to the topend in chunks that, put back
+ * in place, make up the same bytes as a run with a large enough buffer.
+ */
+TEST_F(ExecutionEngineTest, ResultChunks) {
+    initialize(catalog_string, random_seed);
+    ASSERT_TRUE(voltdb::tableutil::addRandomTuples(m_replicated_customer_table, 500));
+    m_topend->addPlan(100, plan);
+    fragmentId_t fragmentId = 100;
+    std::string whole = executeAndCopyResults(fragmentId);
+    ASSERT_TRUE(m_topend->resultChunks.empty());
+
+    const int smallCapacity = 256;
+    ASSERT_TRUE(whole.size() > 10 * smallCapacity);
+    m_engine->setBuffers(m_parameter_buffer.get(), m_smallBufferSize,
+                         m_per_fragment_stats_buffer.get(), m_smallBufferSize,
+                         NULL, 0,
+                         m_result_buffer.get(), smallCapacity,
+                         m_exception_buffer.get(), m_smallBufferSize);
+    m_topend->acceptResultChunks = true;
+    std::string rest = executeAndCopyResults(fragmentId);
+    ASSERT_TRUE(rest.size() <= smallCapacity);
+    ASSERT_TRUE(m_topend->resultChunks.size() > whole.size() / 2);
+    ASSERT_TRUE(m_topend->resultChunksOffset < rest.size());
+    std::string joined = rest.substr(0, m_topend->resultChunksOffset) +
+                         m_topend->resultChunks +
+                         rest.substr(m_topend->resultChunksOffset);
+    ASSERT_TRUE(joined == whole);
+}
+
+namespace {
+
+void writeParameter(voltdb::SerializeOutput& out, const voltdb::NValue& value) {
+    out.writeByte(voltdb::ValuePeeker::peekValueType(value));
+    value.serializeTo(out);
+}
+
+void writeKeyOp(voltdb::SerializeOutput& out, voltdb::KeyValueOpType op, int32_t key) {
+    out.writeByte(op);
+    writeParameter(out, voltdb::ValueFactory::getIntegerValue(key));
+}
+
+}
+
+/*
+ * Put, get, increment and delete a D_CUSTOMER row by primary key without
+ * any plan fragment, and undo the batch that changed it.
+ */
+TEST_F(ExecutionEngineTest, KeyValueBatch) {
+    initialize(catalog_string, random_seed);
+    const voltdb::TupleSchema* schema = m_partitioned_customer_table->schema();
+    voltdb::Pool pool;
+    char input[4096];
+    voltdb::ReferenceSerializeOutput out(input, sizeof(input));
+
+    // Find a key that belongs to this site and is not in the table. Each
+    // batch starts its results afresh, so only the last one is left.
+    int32_t key = 0;
+    while (true) {
+        ++key;
+        if ( ! m_engine->isLocalSite(voltdb::ValueFactory::getIntegerValue(key))) {
+            continue;
+        }
+        out.initializeWithPosition(input, sizeof(input), 0);
+        out.writeInt(1);
+        writeKeyOp(out, voltdb::KEY_VALUE_OP_GET, key);
+        voltdb::ReferenceSerializeInputBE in(input, out.size());
+        ASSERT_EQ(ENGINE_ERRORCODE_SUCCESS,
+                  m_engine->executeKeyValueBatch(m_partitioned_customer_table_id, in, 1000, 1000, 1000, 1000, 10));
+        ASSERT_EQ(1, m_engine->getResultsSize());
+        if (m_result_buffer[0] == 0) {
+            break;
+        }
+    }
+
+    // Put the row twice, the second time replacing it, then read it back
+    out.initializeWithPosition(input, sizeof(input), 0);
+    out.writeInt(3);
+    for (int zipcode = 10000; zipcode <= 20000; zipcode += 10000) {
+        out.writeByte(voltdb::KEY_VALUE_OP_PUT);
+        writeParameter(out, voltdb::ValueFactory::getIntegerValue(key));
+        writeParameter(out, voltdb::ValueFactory::getTempStringValue("Ada"));
+        writeParameter(out, voltdb::ValueFactory::getTempStringValue("Lovelace"));
+        writeParameter(out, voltdb::ValueFactory::getIntegerValue(zipcode));
+    }
+    writeKeyOp(out, voltdb::KEY_VALUE_OP_GET, key);
+    {
+        voltdb::ReferenceSerializeInputBE in(input, out.size());
+        ASSERT_EQ(ENGINE_ERRORCODE_SUCCESS,
+                  m_engine->executeKeyValueBatch(m_partitioned_customer_table_id, in, 1000, 1000, 1000, 1000, 11));
+    }
+    m_engine->releaseUndoToken(11);
+    {
+        voltdb::ReferenceSerializeInputBE results(m_result_buffer.get(), m_engine->getResultsSize());
+        ASSERT_EQ(0, results.readByte());
+        ASSERT_EQ(1, results.readByte());
+        ASSERT_EQ(1, results.readByte());
+        voltdb::StandAloneTupleStorage storage(schema);
+        voltdb::TableTuple row = storage.tuple();
+        row.deserializeFrom(results, &pool);
+        ASSERT_EQ(key, voltdb::ValuePeeker::peekInteger(row.getNValue(0)));
+        ASSERT_EQ(0, row.getNValue(2).compare(voltdb::ValueFactory::getTempStringValue("Lovelace")));
+        ASSERT_EQ(20000, voltdb::ValuePeeker::peekInteger(row.getNValue(3)));
+        ASSERT_FALSE(results.hasRemaining());
+    }
+
+    // Increment the zipcode and delete the row, then undo both
+    out.initializeWithPosition(input, sizeof(input), 0);
+    out.writeInt(3);
+    writeKeyOp(out, voltdb::KEY_VALUE_OP_INCREMENT, key);
+    out.writeInt(3);
+    writeParameter(out, voltdb::ValueFactory::getBigIntValue(5));
+    writeKeyOp(out, voltdb::KEY_VALUE_OP_DELETE, key);
+    writeKeyOp(out, voltdb::KEY_VALUE_OP_DELETE, key);
+    {
+        voltdb::ReferenceSerializeInputBE in(input, out.size());
+        ASSERT_EQ(ENGINE_ERRORCODE_SUCCESS,
+                  m_engine->executeKeyValueBatch(m_partitioned_customer_table_id, in, 1000, 1000, 1000, 1000, 12));
+    }
+    {
+        voltdb::ReferenceSerializeInputBE results(m_result_buffer.get(), m_engine->getResultsSize());
+        ASSERT_EQ(1, results.readByte());
+        ASSERT_EQ(20005, results.readInt());
+        ASSERT_EQ(1, results.readByte());
+        ASSERT_EQ(0, results.readByte());
+        ASSERT_FALSE(results.hasRemaining());
+    }
+    m_engine->undoUndoToken(12);
+
+    // Incrementing a string column fails the batch
+    out.initializeWithPosition(input, sizeof(input), 0);
+    out.writeInt(1);
+    writeKeyOp(out, voltdb::KEY_VALUE_OP_INCREMENT, key);
+    out.writeInt(1);
+    writeParameter(out, voltdb::ValueFactory::getBigIntValue(5));
+    {
+        voltdb::ReferenceSerializeInputBE in(input, out.size());
+        ASSERT_EQ(ENGINE_ERRORCODE_ERROR,
+                  m_engine->executeKeyValueBatch(m_partitioned_customer_table_id, in, 1000, 1000, 1000, 1000, 13));
+    }
+    m_engine->undoUndoToken(13);
+
+    // The row is back, and the undone increment left its zipcode as it was
+    out.initializeWithPosition(input, sizeof(input), 0);
+    out.writeInt(1);
+    writeKeyOp(out, voltdb::KEY_VALUE_OP_GET, key);
+    {
+        voltdb::ReferenceSerializeInputBE in(input, out.size());
+        ASSERT_EQ(ENGINE_ERRORCODE_SUCCESS,
+                  m_engine->executeKeyValueBatch(m_partitioned_customer_table_id, in, 1000, 1000, 1000, 1000, 14));
+    }
+    {
+        voltdb::ReferenceSerializeInputBE results(m_result_buffer.get(), m_engine->getResultsSize());
+        ASSERT_EQ(1, results.readByte());
+        voltdb::StandAloneTupleStorage storage(schema);
+        voltdb::TableTuple row = storage.tuple();
+        row.deserializeFrom(results, &pool);
+        ASSERT_EQ(20000, voltdb::ValuePeeker::peekInteger(row.getNValue(3)));
+    }
+}
+
+/*
+ * A column the catalog marks as a dictionary column shares its values
+ * through a string dictionary; the others do not.
+ */
+TEST_F(ExecutionEngineTest, DictionaryColumnFromCatalog) {
+    std::string catalog(catalog_string);
+    const std::string lastName("columns#D_LASTNAME index 2\n");
+    catalog.insert(catalog.find(lastName) + lastName.size(), "set $PREV dictionary true\n");
+    initialize(catalog.c_str(), random_seed);
+
+    ASSERT_TRUE(m_partitioned_customer_table->stringDictionary(2) != NULL);
+    ASSERT_TRUE(m_partitioned_customer_table->stringDictionary(1) == NULL);
+    ASSERT_TRUE(m_partitioned_customer_table->stringDictionary(2)->entryCount() > 0);
+}
+
 int main() {
      return TestSuite::globalInstance()->runAll();
 }
@@ -0,0 +1,565 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Times executors, indexes and streams in isolation, so that releases can
+ * be compared scenario by scenario. Plans run through a real VoltDBEngine
+ * set up by PlanTestingBaseClass over generated tables of four integer
+ * columns:
+ *     A = i                 (unique tree index AAA_IDX0 on AAA)
+ *     B = i % 10            (a few groups)
+ *     C = random below rows (a join key into AAA.A, many groups, a sort key)
+ *     D = random below 100  (so that D < p selects p percent)
+ * AAA has the given number of rows and BBB a tenth of them. Each
+ * scenario is run once to warm up and then timed over the given number
+ * of runs. Results are written as CSV, one line per scenario and
+ * parameter, so that runs can be diffed or loaded into a spreadsheet.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/time.h>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "harness.h"
+
+#include "common/TupleOutputStream.h"
+#include "common/TupleOutputStreamProcessor.h"
+#include "storage/DRTupleStream.h"
+#include "storage/ExportTupleStream.h"
+#include "storage/persistenttable.h"
+#include "storage/tableiterator.h"
+#include "storage/temptable.h"
+#include "test_utils/plan_testing_config.h"
+#include "test_utils/LoadTableFrom.hpp"
+#include "test_utils/plan_testing_baseclass.h"
+
+using namespace voltdb;
+
+namespace {
+
+int64_t getMicrosNow() {
+    timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+std::string toString(int64_t value) {
+    std::ostringstream out;
+    out << value;
+    return out.str();
+}
+
+#define MAXSCALE 10000000
+
+const int NUM_TABLE_COLS = 4;
+const char *ColumnNames[] = { "A", "B", "C", "D" };
+
+/**
+ * Times the runs of one scenario and prints them as a line of CSV.
+ */
+class BenchmarkRecorder {
+public:
+    BenchmarkRecorder(const std::string& scenario, const std::string& parameter, int64_t rowsPerRun)
+        : m_scenario(scenario), m_parameter(parameter), m_rowsPerRun(rowsPerRun),
+          m_start(0), m_total(0), m_runs(0) { }
+
+    static void printHeader() {
+        printf("scenario,parameter,rows,runs,total_us,us_per_run,ns_per_row\n");
+    }
+
+    void start() {
+        m_start = getMicrosNow();
+    }
+
+    void stop() {
+        m_total += getMicrosNow() - m_start;
+        m_runs++;
+    }
+
+    void report() const {
+        double perRun = (m_runs == 0) ? 0.0 : static_cast<double>(m_total) / m_runs;
+        double perRow = (m_rowsPerRun == 0) ? 0.0 : 1000.0 * perRun / static_cast<double>(m_rowsPerRun);
+        printf("%s,%s,%lld,%d,%lld,%.2f,%.2f\n", m_scenario.c_str(), m_parameter.c_str(),
+               (long long)m_rowsPerRun, m_runs, (long long)m_total, perRun, perRow);
+        fflush(stdout);
+    }
+
+private:
+    const std::string m_scenario;
+    const std::string m_parameter;
+    const int64_t m_rowsPerRun;
+    int64_t m_start;
+    int64_t m_total;
+    int m_runs;
+};
+
+/*
+ * Catalog text for a replicated table of NUM_TABLE_COLS integer columns
+ * with indexCount tree indexes. Index k is on column k % NUM_TABLE_COLS
+ * and only the first one is unique.
+ */
+std::string tableCatalog(const std::string& name, int indexCount) {
+    const std::string path = "/clusters#cluster/databases#database/tables#" + name;
+    std::string catalog =
+        "add /clusters#cluster/databases#database tables " + name + "\n"
+        "set " + path + " isreplicated true\n"
+        "set $PREV partitioncolumn null\n"
+        "set $PREV estimatedtuplecount 0\n"
+        "set $PREV materializer null\n"
+        "set $PREV signature \"" + name + "|" + std::string(NUM_TABLE_COLS, 'i') + "\"\n"
+        "set $PREV tuplelimit 2147483647\n"
+        "set $PREV isDRed false\n";
+    for (int col = 0; col < NUM_TABLE_COLS; col++) {
+        const std::string column = ColumnNames[col];
+        catalog +=
+            "add " + path + " columns " + column + "\n"
+            "set " + path + "/columns#" + column + " index " + toString(col) + "\n"
+            "set $PREV type 5\n"
+            "set $PREV size 4\n"
+            "set $PREV nullable true\n"
+            "set $PREV name \"" + column + "\"\n"
+            "set $PREV defaultvalue null\n"
+            "set $PREV defaulttype 0\n"
+            "set $PREV aggregatetype 0\n"
+            "set $PREV matviewsource null\n"
+            "set $PREV matview null\n"
+            "set $PREV inbytes false\n";
+    }
+    for (int k = 0; k < indexCount; k++) {
+        const std::string index = name + "_IDX" + toString(k);
+        const std::string column = ColumnNames[k % NUM_TABLE_COLS];
+        catalog +=
+            "add " + path + " indexes " + index + "\n"
+            "set " + path + "/indexes#" + index + " unique " + (k == 0 ? "true" : "false") + "\n"
+            "set $PREV assumeUnique false\n"
+            "set $PREV countable true\n"
+            "set $PREV type 1\n"
+            "set $PREV expressionsjson \"\"\n"
+            "set $PREV predicatejson \"\"\n"
+            "add " + path + "/indexes#" + index + " columns " + column + "\n"
+            "set " + path + "/indexes#" + index + "/columns#" + column + " index 0\n"
+            "set $PREV column " + path + "/columns#" + column + "\n";
+    }
+    return catalog;
+}
+
+std::string databaseCatalog(int writeIndexCount) {
+    return
+        "add / clusters cluster\n"
+        "set /clusters#cluster localepoch 0\n"
+        "set $PREV securityEnabled false\n"
+        "set $PREV httpdportno 0\n"
+        "set $PREV jsonapi false\n"
+        "set $PREV networkpartition false\n"
+        "set $PREV heartbeatTimeout 0\n"
+        "set $PREV useddlschema false\n"
+        "set $PREV drConsumerEnabled false\n"
+        "set $PREV drProducerEnabled false\n"
+        "set $PREV drClusterId 0\n"
+        "set $PREV drProducerPort 0\n"
+        "set $PREV drMasterHost \"\"\n"
+        "set $PREV drFlushInterval 0\n"
+        "add /clusters#cluster databases database\n"
+        "set /clusters#cluster/databases#database schema \"\"\n"
+        "set $PREV isActiveActiveDRed false\n"
+        "set $PREV securityprovider \"\"\n"
+        + tableCatalog("AAA", 1)
+        + tableCatalog("BBB", 0)
+        + tableCatalog("WWW", writeIndexCount);
+}
+
+// Plan fragments
+#define TVE(idx) "{\"COLUMN_IDX\": " #idx ", \"TYPE\": 32, \"VALUE_TYPE\": 5}"
+#define INNER_TVE(idx) "{\"COLUMN_IDX\": " #idx ", \"TABLE_IDX\": 1, \"TYPE\": 32, \"VALUE_TYPE\": 5}"
+#define BIGINT_TVE(idx) "{\"COLUMN_IDX\": " #idx ", \"TYPE\": 32, \"VALUE_TYPE\": 6}"
+#define OUTPUT_COLUMN(name, idx) "{\"COLUMN_NAME\": \"" name "\", \"EXPRESSION\": " TVE(idx) "}"
+#define INNER_OUTPUT_COLUMN(name, idx) "{\"COLUMN_NAME\": \"" name "\", \"EXPRESSION\": " INNER_TVE(idx) "}"
+#define ALL_COLUMNS OUTPUT_COLUMN("A", 0) ", " OUTPUT_COLUMN("B", 1) ", " OUTPUT_COLUMN("C", 2) ", " OUTPUT_COLUMN("D", 3)
+
+std::string constant(int value) {
+    return "{\"TYPE\": 30, \"VALUE_TYPE\": 5, \"ISNULL\": false, \"VALUE\": " + toString(value) + "}";
+}
+
+// A scan of a whole table with an inline projection of all its columns
+std::string scanPlanNode(int id, const std::string& table) {
+    return "{\"ID\": " + toString(id) + ", \"PLAN_NODE_TYPE\": \"SEQSCAN\", "
+        "\"TARGET_TABLE_ALIAS\": \"" + table + "\", \"TARGET_TABLE_NAME\": \"" + table + "\", "
+        "\"INLINE_NODES\": [{\"ID\": " + toString(100 + id) + ", \"PLAN_NODE_TYPE\": \"PROJECTION\", "
+        "\"OUTPUT_SCHEMA\": [" ALL_COLUMNS "]}]}";
+}
+
+// select A from AAA where D < percent;
+std::string seqScanPlan(int percent) {
+    return
+        "{\"EXECUTE_LIST\": [2, 1], \"PLAN_NODES\": ["
+        "{\"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\", \"CHILDREN_IDS\": [2]}, "
+        "{\"ID\": 2, \"PLAN_NODE_TYPE\": \"SEQSCAN\", "
+        "\"TARGET_TABLE_ALIAS\": \"AAA\", \"TARGET_TABLE_NAME\": \"AAA\", "
+        "\"PREDICATE\": {\"TYPE\": 12, \"VALUE_TYPE\": 23, \"LEFT\": " TVE(3) ", \"RIGHT\": " + constant(percent) + "}, "
+        "\"INLINE_NODES\": [{\"ID\": 3, \"PLAN_NODE_TYPE\": \"PROJECTION\", \"OUTPUT_SCHEMA\": [" OUTPUT_COLUMN("A", 0) "]}]}"
+        "]}";
+}
+
+// select A from AAA where A >= firstKey;
+std::string indexScanPlan(int firstKey) {
+    return
+        "{\"EXECUTE_LIST\": [2, 1], \"PLAN_NODES\": ["
+        "{\"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\", \"CHILDREN_IDS\": [2]}, "
+        "{\"ID\": 2, \"PLAN_NODE_TYPE\": \"INDEXSCAN\", "
+        "\"TARGET_TABLE_ALIAS\": \"AAA\", \"TARGET_TABLE_NAME\": \"AAA\", "
+        "\"TARGET_INDEX_NAME\": \"AAA_IDX0\", \"LOOKUP_TYPE\": \"GTE\", \"SORT_DIRECTION\": \"INVALID\", "
+        "\"SEARCHKEY_EXPRESSIONS\": [" + constant(firstKey) + "], \"COMPARE_NOTDISTINCT\": [false], "
+        "\"INLINE_NODES\": [{\"ID\": 3, \"PLAN_NODE_TYPE\": \"PROJECTION\", \"OUTPUT_SCHEMA\": [" OUTPUT_COLUMN("A", 0) "]}]}"
+        "]}";
+}
+
+// select BBB.A, AAA.B from BBB join AAA on AAA.A = BBB.C;
+std::string nestLoopIndexPlan() {
+    return
+        "{\"EXECUTE_LIST\": [3, 2, 1], \"PLAN_NODES\": ["
+        "{\"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\", \"CHILDREN_IDS\": [2]}, "
+        "{\"ID\": 2, \"PLAN_NODE_TYPE\": \"NESTLOOPINDEX\", \"CHILDREN_IDS\": [3], "
+        "\"JOIN_TYPE\": \"INNER\", \"PRE_JOIN_PREDICATE\": null, \"JOIN_PREDICATE\": null, "
+        "\"WHERE_PREDICATE\": null, "
+        "\"OUTPUT_SCHEMA\": [" OUTPUT_COLUMN("A", 0) ", " INNER_OUTPUT_COLUMN("B", 1) "], "
+        "\"INLINE_NODES\": [{\"ID\": 12, \"PLAN_NODE_TYPE\": \"INDEXSCAN\", "
+        "\"TARGET_TABLE_ALIAS\": \"AAA\", \"TARGET_TABLE_NAME\": \"AAA\", "
+        "\"TARGET_INDEX_NAME\": \"AAA_IDX0\", \"LOOKUP_TYPE\": \"EQ\", \"SORT_DIRECTION\": \"INVALID\", "
+        "\"SEARCHKEY_EXPRESSIONS\": [" TVE(2) "], \"COMPARE_NOTDISTINCT\": [false], "
+        "\"OUTPUT_SCHEMA\": [" ALL_COLUMNS "]}]}, "
+        + scanPlanNode(3, "BBB") +
+        "]}";
+}
+
+// select <groupColumn>, SUM(D), COUNT(*) from AAA group by <groupColumn>;
+std::string hashAggregatePlan(int groupColumn) {
+    const std::string group = "{\"COLUMN_IDX\": " + toString(groupColumn) + ", \"TYPE\": 32, \"VALUE_TYPE\": 5}";
+    return
+        "{\"EXECUTE_LIST\": [3, 2, 1], \"PLAN_NODES\": ["
+        "{\"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\", \"CHILDREN_IDS\": [2]}, "
+        "{\"ID\": 2, \"PLAN_NODE_TYPE\": \"HASHAGGREGATE\", \"CHILDREN_IDS\": [3], "
+        "\"AGGREGATE_COLUMNS\": ["
+        "{\"AGGREGATE_TYPE\": \"AGGREGATE_SUM\", \"AGGREGATE_DISTINCT\": 0, "
+        "\"AGGREGATE_OUTPUT_COLUMN\": 1, \"AGGREGATE_EXPRESSION\": " TVE(3) "}, "
+        "{\"AGGREGATE_TYPE\": \"AGGREGATE_COUNT_STAR\", \"AGGREGATE_DISTINCT\": 0, "
+        "\"AGGREGATE_OUTPUT_COLUMN\": 2}], "
+        "\"GROUPBY_EXPRESSIONS\": [" + group + "], "
+        "\"OUTPUT_SCHEMA\": [{\"COLUMN_NAME\": \"G\", \"EXPRESSION\": " + group + "}, "
+        "{\"COLUMN_NAME\": \"S\", \"EXPRESSION\": " BIGINT_TVE(1) "}, "
+        "{\"COLUMN_NAME\": \"N\", \"EXPRESSION\": " BIGINT_TVE(2) "}]}, "
+        + scanPlanNode(3, "AAA") +
+        "]}";
+}
+
+// select * from AAA order by C;
+std::string orderByPlan() {
+    return
+        "{\"EXECUTE_LIST\": [3, 2, 1], \"PLAN_NODES\": ["
+        "{\"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\", \"CHILDREN_IDS\": [2]}, "
+        "{\"ID\": 2, \"PLAN_NODE_TYPE\": \"ORDERBY\", \"CHILDREN_IDS\": [3], "
+        "\"SORT_COLUMNS\": [{\"SORT_DIRECTION\": \"ASC\", \"SORT_EXPRESSION\": " TVE(2) "}]}, "
+        + scanPlanNode(3, "AAA") +
+        "]}";
+}
+
+}
+
+/**
+ * An engine with AAA and BBB loaded, and WWW empty with writeIndexCount
+ * indexes, that runs the scenarios.
+ */
+class ExecutorBenchmark : public PlanTestingBaseClass<EngineTestTopend> {
+public:
+    ExecutorBenchmark(int rows, int runs, int writeIndexCount)
+        : m_rows(rows), m_runs(runs), m_catalogText(databaseCatalog(writeIndexCount)),
+          m_nextFragmentId(100), m_nextUndoToken(1), m_nextSpHandle(1)
+    {
+        initialize(m_catalogText.c_str(), 0, NULL, 0);
+        // Let results of any size through, a chunk at a time
+        m_topend->acceptResultChunks = true;
+        m_aaa = getPersistentTableAndId("AAA", &m_aaaId);
+        m_bbb = getPersistentTableAndId("BBB", NULL);
+        m_www = getPersistentTableAndId("WWW", NULL);
+        load(m_aaa, m_rows);
+        load(m_bbb, m_rows / 10);
+    }
+
+    virtual void run() { }
+    virtual const char* suiteName() const { return "ExecutorBenchmark"; }
+    virtual const char* testName() const { return "ExecutorBenchmark"; }
+
+    void benchmarkSeqScan() {
+        const int percents[] = { 1, 10, 50, 100 };
+        for (int i = 0; i < sizeof(percents) / sizeof(percents[0]); i++) {
+            timePlan("seqscan", "selectivity=" + toString(percents[i]) + "%", m_rows,
+                     seqScanPlan(percents[i]));
+        }
+    }
+
+    void benchmarkIndexScan() {
+        const int percents[] = { 1, 10, 50, 100 };
+        for (int i = 0; i < sizeof(percents) / sizeof(percents[0]); i++) {
+            int64_t matched = static_cast<int64_t>(m_rows) * percents[i] / 100;
+            timePlan("indexscan", "selectivity=" + toString(percents[i]) + "%", matched,
+                     indexScanPlan(static_cast<int>(m_rows - matched)));
+        }
+    }
+
+    void benchmarkNestLoopIndex() {
+        timePlan("nestloopindex", "outer=" + toString(m_bbb->activeTupleCount()),
+                 m_bbb->activeTupleCount(), nestLoopIndexPlan());
+    }
+
+    void benchmarkHashAggregate() {
+        timePlan("hashaggregate", "groups=10", m_rows, hashAggregatePlan(1));
+        timePlan("hashaggregate", "groups=rows", m_rows, hashAggregatePlan(2));
+    }
+
+    void benchmarkOrderBy() {
+        timePlan("orderby", "key=random", m_rows, orderByPlan());
+    }
+
+    /**
+     * Insert rows into WWW and then delete them all, each as one
+     * committed transaction.
+     */
+    void benchmarkWrites() {
+        const std::string parameter = "indexes=" + toString(m_www->indexCount());
+        BenchmarkRecorder inserts("insert", parameter, m_rows);
+        BenchmarkRecorder deletes("delete", parameter, m_rows);
+        std::vector<char*> addresses;
+        addresses.reserve(m_rows);
+        TableTuple tuple(m_www->schema());
+        for (int run = 0; run <= m_runs; run++) {
+            bool timed = run > 0;
+            if (timed) inserts.start();
+            m_engine->setUndoToken(m_nextUndoToken);
+            load(m_www, m_rows);
+            m_engine->releaseUndoToken(m_nextUndoToken++);
+            if (timed) inserts.stop();
+
+            addresses.clear();
+            TableIterator iterator = m_www->iterator();
+            while (iterator.next(tuple)) {
+                addresses.push_back(tuple.address());
+            }
+
+            if (timed) deletes.start();
+            m_engine->setUndoToken(m_nextUndoToken);
+            for (size_t i = 0; i < addresses.size(); i++) {
+                tuple.move(addresses[i]);
+                m_www->deleteTuple(tuple, true);
+            }
+            m_engine->releaseUndoToken(m_nextUndoToken++);
+            if (timed) deletes.stop();
+        }
+        inserts.report();
+        deletes.report();
+    }
+
+    /** Append each row of AAA to an export stream as its own transaction. */
+    void benchmarkExport() {
+        ExportTupleStream stream(0, 1);
+        stream.setSignatureAndGeneration("BENCHMARK", 1);
+        BenchmarkRecorder recorder("export", "columns=" + toString(m_aaa->columnCount()), m_rows);
+        TableTuple tuple(m_aaa->schema());
+        for (int run = 0; run <= m_runs; run++) {
+            if (run > 0) recorder.start();
+            TableIterator iterator = m_aaa->iterator();
+            int64_t seqNo = 0;
+            while (iterator.next(tuple)) {
+                int64_t spHandle = m_nextSpHandle++;
+                stream.appendTuple(spHandle - 1, spHandle, seqNo++, spHandle, 0, tuple,
+                                   ExportTupleStream::INSERT);
+            }
+            stream.periodicFlush(-1, m_nextSpHandle - 1);
+            if (run > 0) recorder.stop();
+            drainStreamBlocks();
+        }
+        recorder.report();
+    }
+
+    /** Append the rows of AAA to a DR stream in transactions of rowsPerTxn rows. */
+    void benchmarkDR() {
+        const int rowsPerTxn[] = { 1, 100 };
+        char tableHandle[20] = { 0 };
+        for (int t = 0; t < 2; t++) {
+            DRTupleStream stream(0, 2 * 1024 * 1024);
+            stream.m_enabled = true;
+            BenchmarkRecorder recorder("dr", "rows_per_txn=" + toString(rowsPerTxn[t]), m_rows);
+            TableTuple tuple(m_aaa->schema());
+            for (int run = 0; run <= m_runs; run++) {
+                if (run > 0) recorder.start();
+                TableIterator iterator = m_aaa->iterator();
+                int rowsInTxn = 0;
+                int64_t spHandle = 0;
+                while (iterator.next(tuple)) {
+                    if (rowsInTxn == 0) {
+                        // DR handles carry the partition id in their low 14 bits
+                        spHandle = m_nextSpHandle++ << 14;
+                    }
+                    stream.appendTuple(spHandle - (1 << 14), tableHandle, 0, spHandle, spHandle,
+                                       tuple, DR_RECORD_INSERT);
+                    if (++rowsInTxn == rowsPerTxn[t]) {
+                        stream.endTransaction(spHandle);
+                        rowsInTxn = 0;
+                    }
+                }
+                stream.endTransaction(spHandle);
+                stream.periodicFlush(-1, spHandle);
+                if (run > 0) recorder.stop();
+                drainStreamBlocks();
+            }
+            recorder.report();
+        }
+    }
+
+    /** Stream all of AAA as a snapshot would. */
+    void benchmarkSnapshot() {
+        BenchmarkRecorder recorder("snapshot", "buffer=" + toString(sizeof(m_streamBuffer)), m_rows);
+        char config[4] = { 0 };
+        for (int run = 0; run <= m_runs; run++) {
+            if (run > 0) recorder.start();
+            ReferenceSerializeInputBE predicateInput(config, sizeof(config));
+            m_aaa->activateStream(TABLE_STREAM_SNAPSHOT, 0, m_aaaId, predicateInput);
+            while (true) {
+                TupleOutputStreamProcessor outputStreams(m_streamBuffer, sizeof(m_streamBuffer));
+                std::vector<int> retPositions;
+                m_aaa->streamMore(outputStreams, TABLE_STREAM_SNAPSHOT, retPositions);
+                if (outputStreams.at(0).position() == 0) {
+                    break;
+                }
+            }
+            if (run > 0) recorder.stop();
+        }
+        recorder.report();
+    }
+
+private:
+    void load(PersistentTable* table, int rows) {
+        TableTuple& tuple = table->tempTuple();
+        for (int i = 0; i < rows; i++) {
+            tuple.setNValue(0, ValueFactory::getIntegerValue(i));
+            tuple.setNValue(1, ValueFactory::getIntegerValue(i % 10));
+            tuple.setNValue(2, ValueFactory::getIntegerValue(rand() % m_rows));
+            tuple.setNValue(3, ValueFactory::getIntegerValue(rand() % 100));
+            table->insertTuple(tuple);
+        }
+    }
+
+    void timePlan(const std::string& scenario, const std::string& parameter, int64_t rowsPerRun,
+                  const std::string& plan) {
+        fragmentId_t fragmentId = m_nextFragmentId++;
+        BenchmarkRecorder recorder(scenario, parameter, rowsPerRun);
+        for (int run = 0; run <= m_runs; run++) {
+            if (run > 0) recorder.start();
+            executeFragment(fragmentId, plan.c_str());
+            if (run > 0) recorder.stop();
+            m_topend->resultChunks.clear();
+        }
+        recorder.report();
+    }
+
+    // Let go of the blocks the streams pushed to the topend
+    void drainStreamBlocks() {
+        m_topend->blocks.clear();
+        m_topend->data.clear();
+        while ( ! m_topend->partitionIds.empty()) {
+            m_topend->partitionIds.pop();
+        }
+        while ( ! m_topend->signatures.empty()) {
+            m_topend->signatures.pop();
+        }
+    }
+
+    const int m_rows;
+    const int m_runs;
+    const std::string m_catalogText;
+    PersistentTable* m_aaa;
+    PersistentTable* m_bbb;
+    PersistentTable* m_www;
+    int m_aaaId;
+    fragmentId_t m_nextFragmentId;
+    int64_t m_nextUndoToken;
+    int64_t m_nextSpHandle;
+    char m_streamBuffer[128 * 1024];
+};
+
+static const char* SCENARIOS[] = {
+    "seqscan", "indexscan", "nestloopindex", "hashaggregate", "orderby",
+    "write", "export", "dr", "snapshot"
+};
+
+int main(int argc, char *argv[]) {
+    if ((argc > 1 && *argv[1] == '-') || argc <= 2) {
+        printf("To run a benchmark, execute %s with command line arguments. "
+                "The first two are required: ("
+                "data_scale<int>, "
+                "repeat<int>, "
+                "[scenario ...])\n"
+                "Scenarios:", argv[0]);
+        for (int i = 0; i < sizeof(SCENARIOS) / sizeof(SCENARIOS[0]); i++) {
+            printf(" %s", SCENARIOS[i]);
+        }
+        printf("\n");
+        return 0;
+    }
+    int data_scale = std::atoi(argv[1]);
+    if (data_scale <= 0 || data_scale > MAXSCALE) {
+        printf("data scale must be between 1 and %d\n", MAXSCALE);
+        return 0;
+    }
+    int repeat = std::atoi(argv[2]);
+    std::set<std::string> scenarios;
+    for (int i = 3; i < argc; i++) {
+        scenarios.insert(argv[i]);
+    }
+#define SELECTED(name) (scenarios.empty() || scenarios.count(name) > 0)
+
+    srand(0);
+    BenchmarkRecorder::printHeader();
+    {
+        ExecutorBenchmark benchmark(data_scale, repeat, 1);
+        if (SELECTED("seqscan")) benchmark.benchmarkSeqScan();
+        if (SELECTED("indexscan")) benchmark.benchmarkIndexScan();
+        if (SELECTED("nestloopindex")) benchmark.benchmarkNestLoopIndex();
+        if (SELECTED("hashaggregate")) benchmark.benchmarkHashAggregate();
+        if (SELECTED("orderby")) benchmark.benchmarkOrderBy();
+        if (SELECTED("export")) benchmark.benchmarkExport();
+        if (SELECTED("dr")) benchmark.benchmarkDR();
+        if (SELECTED("snapshot")) benchmark.benchmarkSnapshot();
+    }
+    if (SELECTED("write")) {
+        const int indexCounts[] = { 0, 1, 2, 4 };
+        for (int i = 0; i < sizeof(indexCounts) / sizeof(indexCounts[0]); i++) {
+            ExecutorBenchmark benchmark(data_scale, repeat, indexCounts[i]);
+            benchmark.benchmarkWrites();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,356 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "harness.h"
+
+#include "storage/persistenttable.h"
+#include "storage/temptable.h"
+#include "test_utils/plan_testing_config.h"
+#include "test_utils/LoadTableFrom.hpp"
+#include "test_utils/plan_testing_baseclass.h"
+
+#include <vector>
+
+/*
+ * Joins an outer table with repeated keys to a table with a unique index,
+ * enough rows for several probe batches, and checks that the batched key
+ * lookups give the same rows in the same order as probing one outer tuple
+ * at a time would.
+ */
+
+namespace {
+
+// AAA has A = i, B = i % 700, C = i % 5.  BBB has A = j, B = 10 * j, C = j
+// for j < 500, with a unique index on A.  So the rows of AAA whose B is
+// 500 or more have no match.
+const int NUM_TABLE_ROWS_AAA = 3000;
+const int NUM_TABLE_ROWS_BBB = 500;
+const int NUM_TABLE_COLS = 3;
+const int AAA_B_MODULUS = 700;
+
+const char *ColumnNames[] = {
+    "A",
+    "B",
+    "C",
+};
+
+std::vector<int> makeAAAData() {
+    std::vector<int> data;
+    for (int i = 0; i < NUM_TABLE_ROWS_AAA; i++) {
+        data.push_back(i);
+        data.push_back(i % AAA_B_MODULUS);
+        data.push_back(i % 5);
+    }
+    return data;
+}
+
+std::vector<int> makeBBBData() {
+    std::vector<int> data;
+    // Insert in descending order, so that the index order differs from the table order
+    for (int j = NUM_TABLE_ROWS_BBB - 1; j >= 0; j--) {
+        data.push_back(j);
+        data.push_back(10 * j);
+        data.push_back(j);
+    }
+    return data;
+}
+
+const std::vector<int> AAAData = makeAAAData();
+const std::vector<int> BBBData = makeBBBData();
+
+const TableConfig AAAConfig = {
+    "AAA",
+    ColumnNames,
+    NUM_TABLE_ROWS_AAA,
+    NUM_TABLE_COLS,
+    &AAAData[0]
+};
+
+const TableConfig BBBConfig = {
+    "BBB",
+    ColumnNames,
+    NUM_TABLE_ROWS_BBB,
+    NUM_TABLE_COLS,
+    &BBBData[0]
+};
+
+const TableConfig *allTables[] = {
+    &AAAConfig,
+    &BBBConfig,
+};
+
+#define TVE(idx) "{\"COLUMN_IDX\": " #idx ", \"TYPE\": 32, \"VALUE_TYPE\": 5}"
+#define INNER_TVE(idx) "{\"COLUMN_IDX\": " #idx ", \"TABLE_IDX\": 1, \"TYPE\": 32, \"VALUE_TYPE\": 5}"
+#define OUTPUT_COLUMN(name, idx) "{\"COLUMN_NAME\": \"" name "\", \"EXPRESSION\": " TVE(idx) "}"
+#define INNER_OUTPUT_COLUMN(name, idx) "{\"COLUMN_NAME\": \"" name "\", \"EXPRESSION\": " INNER_TVE(idx) "}"
+
+#define SCAN_AAA(id) \
+    "{\"ID\": " #id ", \"PLAN_NODE_TYPE\": \"SEQSCAN\", " \
+    "\"TARGET_TABLE_ALIAS\": \"AAA\", \"TARGET_TABLE_NAME\": \"AAA\", " \
+    "\"INLINE_NODES\": [{\"ID\": 1" #id ", \"PLAN_NODE_TYPE\": \"PROJECTION\", \"OUTPUT_SCHEMA\": [" \
+    OUTPUT_COLUMN("A", 0) ", " OUTPUT_COLUMN("B", 1) ", " OUTPUT_COLUMN("C", 2) "]}]}"
+
+// AAA join BBB on BBB.A = AAA.B, looking up BBB_A with AAA.B. Further
+// inline nodes of the join (such as a limit) follow the index scan.
+#define NESTLOOPINDEX(id, outer, joinType, where, inlineNodes) \
+    "{\"ID\": " #id ", \"PLAN_NODE_TYPE\": \"NESTLOOPINDEX\", \"CHILDREN_IDS\": [" #outer "], " \
+    "\"JOIN_TYPE\": \"" joinType "\", \"PRE_JOIN_PREDICATE\": null, \"JOIN_PREDICATE\": null, " \
+    "\"WHERE_PREDICATE\": " where ", " \
+    "\"OUTPUT_SCHEMA\": [" OUTPUT_COLUMN("A", 0) ", " OUTPUT_COLUMN("B", 1) ", " \
+    OUTPUT_COLUMN("C", 2) ", " INNER_OUTPUT_COLUMN("B", 1) ", " INNER_OUTPUT_COLUMN("C", 2) "], " \
+    "\"INLINE_NODES\": [{\"ID\": 1" #id ", \"PLAN_NODE_TYPE\": \"INDEXSCAN\", " \
+    "\"TARGET_TABLE_ALIAS\": \"BBB\", \"TARGET_TABLE_NAME\": \"BBB\", " \
+    "\"TARGET_INDEX_NAME\": \"BBB_A\", \"LOOKUP_TYPE\": \"EQ\", \"SORT_DIRECTION\": \"INVALID\", " \
+    "\"SEARCHKEY_EXPRESSIONS\": [" TVE(1) "], \"COMPARE_NOTDISTINCT\": [false], " \
+    "\"OUTPUT_SCHEMA\": [" OUTPUT_COLUMN("A", 0) ", " OUTPUT_COLUMN("B", 1) ", " OUTPUT_COLUMN("C", 2) "]}" \
+    inlineNodes "]}"
+
+// select AAA.A, BBB.B from AAA join BBB on BBB.A = AAA.B;
+const char *innerJoinPlan =
+    "{\"EXECUTE_LIST\": [4, 3, 2, 1], \"PLAN_NODES\": ["
+    "{\"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\", \"CHILDREN_IDS\": [2]}, "
+    "{\"ID\": 2, \"PLAN_NODE_TYPE\": \"PROJECTION\", \"CHILDREN_IDS\": [3], \"OUTPUT_SCHEMA\": ["
+    OUTPUT_COLUMN("A", 0) ", " OUTPUT_COLUMN("B", 3) "]}, "
+    NESTLOOPINDEX(3, 4, "INNER", "null", "") ", "
+    SCAN_AAA(4)
+    "]}";
+
+// select AAA.A, BBB.C from AAA left join BBB on BBB.A = AAA.B where BBB.C is null;
+const char *leftJoinPlan =
+    "{\"EXECUTE_LIST\": [4, 3, 2, 1], \"PLAN_NODES\": ["
+    "{\"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\", \"CHILDREN_IDS\": [2]}, "
+    "{\"ID\": 2, \"PLAN_NODE_TYPE\": \"PROJECTION\", \"CHILDREN_IDS\": [3], \"OUTPUT_SCHEMA\": ["
+    OUTPUT_COLUMN("A", 0) "]}, "
+    NESTLOOPINDEX(3, 4, "LEFT", "{\"TYPE\": 9, \"VALUE_TYPE\": 23, \"LEFT\": " INNER_TVE(2) "}", "") ", "
+    SCAN_AAA(4)
+    "]}";
+
+// select AAA.A, BBB.B from AAA join BBB on BBB.A = AAA.B limit 5 offset 600;
+const char *limitPlan =
+    "{\"EXECUTE_LIST\": [4, 3, 2, 1], \"PLAN_NODES\": ["
+    "{\"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\", \"CHILDREN_IDS\": [2]}, "
+    "{\"ID\": 2, \"PLAN_NODE_TYPE\": \"PROJECTION\", \"CHILDREN_IDS\": [3], \"OUTPUT_SCHEMA\": ["
+    OUTPUT_COLUMN("A", 0) ", " OUTPUT_COLUMN("B", 3) "]}, "
+    NESTLOOPINDEX(3, 4, "INNER", "null",
+                  ", {\"ID\": 23, \"PLAN_NODE_TYPE\": \"LIMIT\", \"LIMIT\": 5, \"OFFSET\": 600}") ", "
+    SCAN_AAA(4)
+    "]}";
+
+// The rows of the inner join, in the order of the outer table
+std::vector<int> makeInnerJoinRows() {
+    std::vector<int> rows;
+    for (int i = 0; i < NUM_TABLE_ROWS_AAA; i++) {
+        int key = i % AAA_B_MODULUS;
+        if (key < NUM_TABLE_ROWS_BBB) {
+            rows.push_back(i);
+            rows.push_back(10 * key);
+        }
+    }
+    return rows;
+}
+
+}
+
+class NestLoopIndexExecutorTest : public PlanTestingBaseClass<EngineTestTopend> {
+public:
+    NestLoopIndexExecutorTest() {
+        initialize(m_nestLoopIndexDB);
+    }
+
+protected:
+    static DBConfig m_nestLoopIndexDB;
+};
+
+TEST_F(NestLoopIndexExecutorTest, BatchedProbesKeepOuterOrder) {
+    std::vector<int> expected = makeInnerJoinRows();
+    int rows = static_cast<int>(expected.size()) / 2;
+    // Run it twice to make sure that the probe batch is reset.
+    executeFragment(100, innerJoinPlan);
+    validateResult(&expected[0], rows, 2);
+    executeFragment(100, innerJoinPlan);
+    validateResult(&expected[0], rows, 2);
+}
+
+TEST_F(NestLoopIndexExecutorTest, BatchedProbesLeftJoin) {
+    std::vector<int> expected;
+    for (int i = 0; i < NUM_TABLE_ROWS_AAA; i++) {
+        if (i % AAA_B_MODULUS >= NUM_TABLE_ROWS_BBB) {
+            expected.push_back(i);
+        }
+    }
+    executeFragment(101, leftJoinPlan);
+    validateResult(&expected[0], static_cast<int>(expected.size()), 1);
+}
+
+TEST_F(NestLoopIndexExecutorTest, BatchedProbesInlineLimit) {
+    std::vector<int> rows = makeInnerJoinRows();
+    std::vector<int> expected(rows.begin() + 600 * 2, rows.begin() + 605 * 2);
+    executeFragment(102, limitPlan);
+    validateResult(&expected[0], 5, 2);
+}
+
+DBConfig NestLoopIndexExecutorTest::m_nestLoopIndexDB =
+{
+    // DDL.
+    "create table AAA (A integer, B integer, C integer);\n"
+    "create table BBB (A integer, B integer, C integer);\n"
+    "create unique index BBB_A on BBB (A);\n",
+    // Catalog String
+    "add / clusters cluster\n"
+    "set /clusters#cluster localepoch 0\n"
+    "set $PREV securityEnabled false\n"
+    "set $PREV httpdportno 0\n"
+    "set $PREV jsonapi false\n"
+    "set $PREV networkpartition false\n"
+    "set $PREV heartbeatTimeout 0\n"
+    "set $PREV useddlschema false\n"
+    "set $PREV drConsumerEnabled false\n"
+    "set $PREV drProducerEnabled false\n"
+    "set $PREV drClusterId 0\n"
+    "set $PREV drProducerPort 0\n"
+    "set $PREV drMasterHost \"\"\n"
+    "set $PREV drFlushInterval 0\n"
+    "add /clusters#cluster databases database\n"
+    "set /clusters#cluster/databases#database schema \"eJy1UkFyhDAMu/c1wZFtfN2U/P9JlVkKdIBd9tDJJMNgOZKsGFyse5HisMHEmqkUhRQLM57qo4VXh9f6+LJTOIZcn7VIro9aVOoVB6oKFIMCs3rKETQsTmTkLimTOzAlCg5VkbZU5LJSD5Ui8Zpy1rmSBnC8AhN6SuNfZVf7pSMmkXG/g6zBcd1noD5iv6lcZp4H8ZF6Z6Wx2LPKCNQGBqDnYe+nylCmRJozmD9TvajUQ6W8J16ezD8RXweKvgWq28AO614EZOhP5Nsb2uvAVi1xaiEvA790fL5CHUlMKzxXCdo3Q9Zt2szuZLad7aT5AeGp3Yc=\"\n"
+    "set $PREV isActiveActiveDRed false\n"
+    "set $PREV securityprovider \"\"\n"
+    "add /clusters#cluster/databases#database groups administrator\n"
+    "set /clusters#cluster/databases#database/groups#administrator admin true\n"
+    "set $PREV defaultproc true\n"
+    "set $PREV defaultprocread true\n"
+    "set $PREV sql true\n"
+    "set $PREV sqlread true\n"
+    "set $PREV allproc true\n"
+    "add /clusters#cluster/databases#database groups user\n"
+    "set /clusters#cluster/databases#database/groups#user admin false\n"
+    "set $PREV defaultproc true\n"
+    "set $PREV defaultprocread true\n"
+    "set $PREV sql true\n"
+    "set $PREV sqlread true\n"
+    "set $PREV allproc true\n"
+    "add /clusters#cluster/databases#database tables AAA\n"
+    "set /clusters#cluster/databases#database/tables#AAA isreplicated true\n"
+    "set $PREV partitioncolumn null\n"
+    "set $PREV estimatedtuplecount 0\n"
+    "set $PREV materializer null\n"
+    "set $PREV signature \"AAA|iii\"\n"
+    "set $PREV tuplelimit 2147483647\n"
+    "set $PREV isDRed false\n"
+    "add /clusters#cluster/databases#database/tables#AAA columns A\n"
+    "set /clusters#cluster/databases#database/tables#AAA/columns#A index 0\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"A\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#AAA columns B\n"
+    "set /clusters#cluster/databases#database/tables#AAA/columns#B index 1\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"B\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#AAA columns C\n"
+    "set /clusters#cluster/databases#database/tables#AAA/columns#C index 2\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"C\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database tables BBB\n"
+    "set /clusters#cluster/databases#database/tables#BBB isreplicated true\n"
+    "set $PREV partitioncolumn null\n"
+    "set $PREV estimatedtuplecount 0\n"
+    "set $PREV materializer null\n"
+    "set $PREV signature \"BBB|iii\"\n"
+    "set $PREV tuplelimit 2147483647\n"
+    "set $PREV isDRed false\n"
+    "add /clusters#cluster/databases#database/tables#BBB columns A\n"
+    "set /clusters#cluster/databases#database/tables#BBB/columns#A index 0\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"A\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#BBB columns B\n"
+    "set /clusters#cluster/databases#database/tables#BBB/columns#B index 1\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"B\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#BBB columns C\n"
+    "set /clusters#cluster/databases#database/tables#BBB/columns#C index 2\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"C\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#BBB indexes BBB_A\n"
+    "set /clusters#cluster/databases#database/tables#BBB/indexes#BBB_A unique true\n"
+    "set $PREV assumeUnique false\n"
+    "set $PREV countable true\n"
+    "set $PREV type 1\n"
+    "set $PREV expressionsjson \"\"\n"
+    "set $PREV predicatejson \"\"\n"
+    "add /clusters#cluster/databases#database/tables#BBB/indexes#BBB_A columns A\n"
+    "set /clusters#cluster/databases#database/tables#BBB/indexes#BBB_A/columns#A index 0\n"
+    "set $PREV column /clusters#cluster/databases#database/tables#BBB/columns#A\n"
+    "",
+    2,
+    allTables
+};
+
+int main() {
+     return TestSuite::globalInstance()->runAll();
+}
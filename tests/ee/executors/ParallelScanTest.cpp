@@ -0,0 +1,338 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "harness.h"
+
+#include "common/PlannerDomValue.h"
+#include "common/SQLException.h"
+#include "common/TupleSchema.h"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+#include "common/executorcontext.hpp"
+#include "executors/ParallelScan.h"
+#include "executors/aggregateexecutor.h"
+#include "expressions/abstractexpression.h"
+#include "storage/persistenttable.h"
+#include "storage/tablefactory.h"
+#include "storage/tableiterator.h"
+
+#include <boost/scoped_ptr.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace voltdb;
+
+static const int NUM_ROWS = 20000;
+
+// A = i, B = i % 7, C = i % 3
+static const char* s_safePredicate =
+    "{\"TYPE\": 20, \"VALUE_TYPE\": 23,"
+    " \"LEFT\": {\"TYPE\": 12, \"VALUE_TYPE\": 23,"
+    "   \"LEFT\": {\"TYPE\": 32, \"VALUE_TYPE\": 5, \"COLUMN_IDX\": 0},"
+    "   \"RIGHT\": {\"TYPE\": 30, \"VALUE_TYPE\": 5, \"ISNULL\": false, \"VALUE\": 15000}},"
+    " \"RIGHT\": {\"TYPE\": 21, \"VALUE_TYPE\": 23,"
+    "   \"LEFT\": {\"TYPE\": 10, \"VALUE_TYPE\": 23,"
+    "     \"LEFT\": {\"TYPE\": 32, \"VALUE_TYPE\": 5, \"COLUMN_IDX\": 1},"
+    "     \"RIGHT\": {\"TYPE\": 30, \"VALUE_TYPE\": 5, \"ISNULL\": false, \"VALUE\": 3}},"
+    "   \"RIGHT\": {\"TYPE\": 9, \"VALUE_TYPE\": 23,"
+    "     \"LEFT\": {\"TYPE\": 32, \"VALUE_TYPE\": 5, \"COLUMN_IDX\": 2}}}}";
+
+// A + 1 > 100, which needs arithmetic
+static const char* s_unsafePredicate =
+    "{\"TYPE\": 13, \"VALUE_TYPE\": 23,"
+    " \"LEFT\": {\"TYPE\": 1, \"VALUE_TYPE\": 5,"
+    "   \"LEFT\": {\"TYPE\": 32, \"VALUE_TYPE\": 5, \"COLUMN_IDX\": 0},"
+    "   \"RIGHT\": {\"TYPE\": 30, \"VALUE_TYPE\": 5, \"ISNULL\": false, \"VALUE\": 1}},"
+    " \"RIGHT\": {\"TYPE\": 30, \"VALUE_TYPE\": 5, \"ISNULL\": false, \"VALUE\": 100}}";
+
+// A <> failAt OR A = 'x', which raises a type mismatch on the row with A = failAt
+static std::string failingPredicate(int32_t failAt) {
+    return "{\"TYPE\": 21, \"VALUE_TYPE\": 23,"
+           " \"LEFT\": {\"TYPE\": 11, \"VALUE_TYPE\": 23,"
+           "   \"LEFT\": {\"TYPE\": 32, \"VALUE_TYPE\": 5, \"COLUMN_IDX\": 0},"
+           "   \"RIGHT\": {\"TYPE\": 30, \"VALUE_TYPE\": 5, \"ISNULL\": false, \"VALUE\": " +
+           std::to_string(failAt) + "}},"
+           " \"RIGHT\": {\"TYPE\": 10, \"VALUE_TYPE\": 23,"
+           "   \"LEFT\": {\"TYPE\": 32, \"VALUE_TYPE\": 5, \"COLUMN_IDX\": 0},"
+           "   \"RIGHT\": {\"TYPE\": 30, \"VALUE_TYPE\": 9, \"ISNULL\": false, \"VALUE\": \"x\"}}}";
+}
+
+static const char* s_columnA = "{\"TYPE\": 32, \"VALUE_TYPE\": 5, \"COLUMN_IDX\": 0}";
+static const char* s_columnB = "{\"TYPE\": 32, \"VALUE_TYPE\": 5, \"COLUMN_IDX\": 1}";
+static const char* s_columnC = "{\"TYPE\": 32, \"VALUE_TYPE\": 5, \"COLUMN_IDX\": 2}";
+
+class ParallelScanTest : public Test {
+public:
+    ParallelScanTest()
+        : m_pool(new Pool())
+        , m_executorContext(new ExecutorContext(0, 0, NULL, NULL, m_pool.get(), NULL, "", 0, NULL, NULL, 0))
+    {
+        std::vector<ValueType> types(3, VALUE_TYPE_INTEGER);
+        std::vector<int32_t> sizes(3, NValue::getTupleStorageSize(VALUE_TYPE_INTEGER));
+        std::vector<bool> allowNull(3, true);
+        TupleSchema* schema = TupleSchema::createTupleSchemaForTest(types, sizes, allowNull);
+        std::vector<std::string> names;
+        names.push_back("A");
+        names.push_back("B");
+        names.push_back("C");
+        char signature[20];
+        // Small blocks, so that the table has plenty of them
+        m_table.reset(static_cast<PersistentTable*>(
+                TableFactory::getPersistentTable(0, "T", schema, names, signature,
+                                                 false, -1, false, false, 4096)));
+
+        TableTuple& tuple = m_table->tempTuple();
+        for (int i = 0; i < NUM_ROWS; i++) {
+            tuple.setNValue(0, ValueFactory::getIntegerValue(i));
+            tuple.setNValue(1, ValueFactory::getIntegerValue(i % 7));
+            tuple.setNValue(2, (i % 3 == 0) ? NValue::getNullValue(VALUE_TYPE_INTEGER)
+                                            : ValueFactory::getIntegerValue(i % 3));
+            m_table->insertTuple(tuple);
+        }
+
+        // Leave holes in the blocks
+        std::vector<char*> doomed;
+        TableTuple scanned(m_table->schema());
+        TableIterator iterator = m_table->iterator();
+        int row = 0;
+        while (iterator.next(scanned)) {
+            if (row++ % 5 == 0) {
+                doomed.push_back(scanned.address());
+            }
+        }
+        for (size_t i = 0; i < doomed.size(); i++) {
+            scanned.move(doomed[i]);
+            m_table->deleteTuple(scanned, false);
+        }
+    }
+
+    ~ParallelScanTest() {
+        ParallelScanPool::instance().setThreadCount(0);
+    }
+
+    AbstractExpression* buildPredicate(const char* json) {
+        PlannerDomRoot domRoot(json);
+        return AbstractExpression::buildExpressionTree(domRoot.rootObject());
+    }
+
+    // The addresses of the matching tuples, in table order
+    std::vector<char*> serialScan(const AbstractExpression* predicate) {
+        std::vector<char*> matches;
+        TableTuple tuple(m_table->schema());
+        TableIterator iterator = m_table->iterator();
+        while (iterator.next(tuple)) {
+            if (predicate->eval(&tuple, NULL).isTrue()) {
+                matches.push_back(tuple.address());
+            }
+        }
+        return matches;
+    }
+
+protected:
+    boost::scoped_ptr<Pool> m_pool;
+    boost::scoped_ptr<ExecutorContext> m_executorContext;
+    boost::scoped_ptr<PersistentTable> m_table;
+};
+
+TEST_F(ParallelScanTest, MatchesSerialScan) {
+    boost::scoped_ptr<AbstractExpression> predicate(buildPredicate(s_safePredicate));
+    ASSERT_TRUE(ParallelScanFilter::isParallelSafe(predicate.get()));
+    ASSERT_TRUE(m_table->allocatedBlockCount() >= ParallelScanFilter::MIN_BLOCKS);
+    std::vector<char*> expected = serialScan(predicate.get());
+    ASSERT_TRUE(expected.size() > 0);
+
+    // Without helper threads the scan is left alone
+    ParallelScanFilter unused;
+    ASSERT_FALSE(unused.filter(m_table.get(), predicate.get()));
+
+    ParallelScanPool::instance().setThreadCount(3);
+    // Repeat, to catch tasks being dropped or handed out twice
+    for (int run = 0; run < 20; run++) {
+        ParallelScanFilter filter;
+        ASSERT_TRUE(filter.filter(m_table.get(), predicate.get()));
+        TableTuple tuple(m_table->schema());
+        std::vector<char*> actual;
+        while (filter.next(tuple)) {
+            actual.push_back(tuple.address());
+        }
+        ASSERT_TRUE(expected == actual);
+    }
+}
+
+TEST_F(ParallelScanTest, OnlySafePredicates) {
+    boost::scoped_ptr<AbstractExpression> predicate(buildPredicate(s_unsafePredicate));
+    ASSERT_FALSE(ParallelScanFilter::isParallelSafe(predicate.get()));
+
+    ParallelScanPool::instance().setThreadCount(2);
+    ParallelScanFilter filter;
+    ASSERT_FALSE(filter.filter(m_table.get(), predicate.get()));
+}
+
+TEST_F(ParallelScanTest, ErrorsRaisedInTableOrder) {
+    // Fail on the row half way through the table, in table order, which
+    // need not be the order the rows were inserted in
+    TableTuple tuple(m_table->schema());
+    int32_t failAt = -1;
+    int64_t row = 0;
+    {
+        TableIterator iterator = m_table->iterator();
+        while (iterator.next(tuple)) {
+            if (row++ == m_table->activeTupleCount() / 2) {
+                failAt = ValuePeeker::peekInteger(tuple.getNValue(0));
+            }
+        }
+    }
+    boost::scoped_ptr<AbstractExpression> predicate(buildPredicate(failingPredicate(failAt).c_str()));
+    ASSERT_TRUE(ParallelScanFilter::isParallelSafe(predicate.get()));
+
+    // A serial scan returns the rows before the failing one, then raises
+    size_t expected = 0;
+    bool raised = false;
+    try {
+        TableIterator iterator = m_table->iterator();
+        while (iterator.next(tuple)) {
+            if (predicate->eval(&tuple, NULL).isTrue()) {
+                expected++;
+            }
+        }
+    }
+    catch (const SQLException&) {
+        raised = true;
+    }
+    ASSERT_TRUE(raised);
+    ASSERT_TRUE(expected > 0);
+
+    ParallelScanPool::instance().setThreadCount(3);
+    for (int run = 0; run < 5; run++) {
+        ParallelScanFilter filter;
+        ASSERT_TRUE(filter.filter(m_table.get(), predicate.get()));
+        size_t actual = 0;
+        raised = false;
+        try {
+            while (filter.next(tuple)) {
+                actual++;
+            }
+        }
+        catch (const SQLException&) {
+            raised = true;
+        }
+        ASSERT_TRUE(raised);
+        ASSERT_EQ(expected, actual);
+
+        ParallelScanAggregate aggregate;
+        std::vector<ExpressionType> aggTypes(1, EXPRESSION_TYPE_AGGREGATE_COUNT_STAR);
+        std::vector<const AbstractExpression*> inputs(1, NULL);
+        raised = false;
+        try {
+            aggregate.aggregate(m_table.get(), predicate.get(), aggTypes, inputs);
+        }
+        catch (const SQLException&) {
+            raised = true;
+        }
+        ASSERT_TRUE(raised);
+    }
+}
+
+TEST_F(ParallelScanTest, MergedAggregatesMatchSerialScan) {
+    boost::scoped_ptr<AbstractExpression> predicate(buildPredicate(s_safePredicate));
+    boost::scoped_ptr<AbstractExpression> columnA(buildPredicate(s_columnA));
+    boost::scoped_ptr<AbstractExpression> columnB(buildPredicate(s_columnB));
+    boost::scoped_ptr<AbstractExpression> columnC(buildPredicate(s_columnC));
+
+    // COUNT(*), COUNT(C), SUM(A), MIN(B), MAX(A)
+    std::vector<ExpressionType> aggTypes;
+    std::vector<const AbstractExpression*> inputs;
+    aggTypes.push_back(EXPRESSION_TYPE_AGGREGATE_COUNT_STAR);
+    inputs.push_back(NULL);
+    aggTypes.push_back(EXPRESSION_TYPE_AGGREGATE_COUNT);
+    inputs.push_back(columnC.get());
+    aggTypes.push_back(EXPRESSION_TYPE_AGGREGATE_SUM);
+    inputs.push_back(columnA.get());
+    aggTypes.push_back(EXPRESSION_TYPE_AGGREGATE_MIN);
+    inputs.push_back(columnB.get());
+    aggTypes.push_back(EXPRESSION_TYPE_AGGREGATE_MAX);
+    inputs.push_back(columnA.get());
+
+    int64_t count = 0, countC = 0, sumA = 0, minB = std::numeric_limits<int64_t>::max();
+    int64_t maxA = std::numeric_limits<int64_t>::min();
+    std::vector<char*> matches = serialScan(predicate.get());
+    ASSERT_TRUE(matches.size() > 0);
+    TableTuple tuple(m_table->schema());
+    for (size_t i = 0; i < matches.size(); i++) {
+        tuple.move(matches[i]);
+        int64_t a = ValuePeeker::peekAsBigInt(tuple.getNValue(0));
+        int64_t b = ValuePeeker::peekAsBigInt(tuple.getNValue(1));
+        count++;
+        if ( ! tuple.getNValue(2).isNull()) {
+            countC++;
+        }
+        sumA += a;
+        minB = std::min(minB, b);
+        maxA = std::max(maxA, a);
+    }
+
+    // Without helper threads the scan is left alone
+    ParallelScanAggregate unused;
+    ASSERT_FALSE(unused.aggregate(m_table.get(), predicate.get(), aggTypes, inputs));
+
+    ParallelScanPool::instance().setThreadCount(3);
+    for (int run = 0; run < 20; run++) {
+        ParallelScanAggregate aggregate;
+        ASSERT_TRUE(aggregate.aggregate(m_table.get(), predicate.get(), aggTypes, inputs));
+        ASSERT_TRUE(aggregate.firstMatch(tuple));
+        ASSERT_TRUE(tuple.address() == matches[0]);
+
+        Pool pool;
+        AggregateRow* merged = newPartialAggregateRow(pool, aggTypes);
+        std::vector<AggregateRow*> partials = aggregate.partials();
+        ASSERT_TRUE(partials.size() > 1);
+        for (size_t i = 0; i < partials.size(); i++) {
+            for (size_t agg = 0; agg < aggTypes.size(); agg++) {
+                merged->m_aggregates[agg]->merge(*partials[i]->m_aggregates[agg]);
+            }
+        }
+        ASSERT_EQ(count, ValuePeeker::peekAsBigInt(merged->m_aggregates[0]->finalize(VALUE_TYPE_BIGINT)));
+        ASSERT_EQ(countC, ValuePeeker::peekAsBigInt(merged->m_aggregates[1]->finalize(VALUE_TYPE_BIGINT)));
+        ASSERT_EQ(sumA, ValuePeeker::peekAsBigInt(merged->m_aggregates[2]->finalize(VALUE_TYPE_BIGINT)));
+        ASSERT_EQ(minB, ValuePeeker::peekAsBigInt(merged->m_aggregates[3]->finalize(VALUE_TYPE_INTEGER)));
+        ASSERT_EQ(maxA, ValuePeeker::peekAsBigInt(merged->m_aggregates[4]->finalize(VALUE_TYPE_INTEGER)));
+        delete merged;
+    }
+}
+
+TEST_F(ParallelScanTest, SettingTheSameThreadCountKeepsThreads) {
+    ParallelScanPool& pool = ParallelScanPool::instance();
+    pool.setThreadCount(2);
+    ASSERT_EQ(2, pool.threadCount());
+    pool.setThreadCount(2);
+    ASSERT_EQ(2, pool.threadCount());
+    pool.setThreadCount(0);
+    ASSERT_EQ(0, pool.threadCount());
+}
+
+int main() {
+    return TestSuite::globalInstance()->runAll();
+}
@@ -0,0 +1,338 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "harness.h"
+
+#include "storage/persistenttable.h"
+#include "storage/temptable.h"
+#include "test_utils/plan_testing_config.h"
+#include "test_utils/LoadTableFrom.hpp"
+#include "test_utils/plan_testing_baseclass.h"
+
+#include <vector>
+
+/*
+ * Runs plans whose scans hand their output to the parent a batch at a time
+ * (see AbstractExecutor::isDrivenByParent) over enough rows to need several
+ * batches, and checks that nothing is lost or repeated at batch boundaries.
+ */
+
+namespace {
+
+// AAA has A = i, B = 2 * i, C = i % 5.  BBB has A = B = C = j for j < 5.
+const int NUM_TABLE_ROWS_AAA = 3000;
+const int NUM_TABLE_ROWS_BBB = 5;
+const int NUM_TABLE_COLS = 3;
+
+const char *ColumnNames[] = {
+    "A",
+    "B",
+    "C",
+};
+
+std::vector<int> makeAAAData() {
+    std::vector<int> data;
+    for (int i = 0; i < NUM_TABLE_ROWS_AAA; i++) {
+        data.push_back(i);
+        data.push_back(2 * i);
+        data.push_back(i % 5);
+    }
+    return data;
+}
+
+std::vector<int> makeBBBData() {
+    std::vector<int> data;
+    for (int j = 0; j < NUM_TABLE_ROWS_BBB; j++) {
+        data.push_back(j);
+        data.push_back(j);
+        data.push_back(j);
+    }
+    return data;
+}
+
+const std::vector<int> AAAData = makeAAAData();
+const std::vector<int> BBBData = makeBBBData();
+
+const TableConfig AAAConfig = {
+    "AAA",
+    ColumnNames,
+    NUM_TABLE_ROWS_AAA,
+    NUM_TABLE_COLS,
+    &AAAData[0]
+};
+
+const TableConfig BBBConfig = {
+    "BBB",
+    ColumnNames,
+    NUM_TABLE_ROWS_BBB,
+    NUM_TABLE_COLS,
+    &BBBData[0]
+};
+
+const TableConfig *allTables[] = {
+    &AAAConfig,
+    &BBBConfig,
+};
+
+// Column expressions used by the plans below
+#define TVE(idx) "{\"COLUMN_IDX\": " #idx ", \"TYPE\": 32, \"VALUE_TYPE\": 5}"
+#define OUTPUT_COLUMN(name, idx) "{\"COLUMN_NAME\": \"" name "\", \"EXPRESSION\": " TVE(idx) "}"
+
+// Scan of AAA with an inline projection, so that it fills its own output table
+#define SCAN_AAA(id) \
+    "{\"ID\": " #id ", \"PLAN_NODE_TYPE\": \"SEQSCAN\", " \
+    "\"TARGET_TABLE_ALIAS\": \"AAA\", \"TARGET_TABLE_NAME\": \"AAA\", " \
+    "\"INLINE_NODES\": [{\"ID\": 1" #id ", \"PLAN_NODE_TYPE\": \"PROJECTION\", \"OUTPUT_SCHEMA\": [" \
+    OUTPUT_COLUMN("A", 0) ", " OUTPUT_COLUMN("B", 1) ", " OUTPUT_COLUMN("C", 2) "]}]}"
+
+#define SCAN_BBB(id) \
+    "{\"ID\": " #id ", \"PLAN_NODE_TYPE\": \"SEQSCAN\", " \
+    "\"TARGET_TABLE_ALIAS\": \"BBB\", \"TARGET_TABLE_NAME\": \"BBB\", " \
+    "\"INLINE_NODES\": [{\"ID\": 1" #id ", \"PLAN_NODE_TYPE\": \"PROJECTION\", \"OUTPUT_SCHEMA\": [" \
+    OUTPUT_COLUMN("C", 2) "]}]}"
+
+// AAA join BBB on AAA.C = BBB.C, with AAA as the outer table
+#define NESTLOOP(id, outer, inner) \
+    "{\"ID\": " #id ", \"PLAN_NODE_TYPE\": \"NESTLOOP\", \"CHILDREN_IDS\": [" #outer ", " #inner "], " \
+    "\"JOIN_TYPE\": \"INNER\", \"PRE_JOIN_PREDICATE\": null, \"WHERE_PREDICATE\": null, " \
+    "\"JOIN_PREDICATE\": {\"TYPE\": 10, \"VALUE_TYPE\": 23, " \
+    "\"LEFT\": {\"COLUMN_IDX\": 0, \"TABLE_IDX\": 1, \"TYPE\": 32, \"VALUE_TYPE\": 5}, " \
+    "\"RIGHT\": " TVE(2) "}, " \
+    "\"OUTPUT_SCHEMA\": [" OUTPUT_COLUMN("A", 0) ", " OUTPUT_COLUMN("B", 1) ", " \
+    OUTPUT_COLUMN("C", 2) ", " OUTPUT_COLUMN("C", 0) "]}"
+
+// select AAA.A, AAA.B, BBB.C from AAA join BBB on AAA.C = BBB.C;
+const char *joinPlan =
+    "{\"EXECUTE_LIST\": [5, 7, 4, 2, 1], \"PLAN_NODES\": ["
+    "{\"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\", \"CHILDREN_IDS\": [2]}, "
+    "{\"ID\": 2, \"PLAN_NODE_TYPE\": \"PROJECTION\", \"CHILDREN_IDS\": [4], \"OUTPUT_SCHEMA\": ["
+    OUTPUT_COLUMN("A", 0) ", " OUTPUT_COLUMN("B", 1) ", " OUTPUT_COLUMN("C", 3) "]}, "
+    NESTLOOP(4, 5, 7) ", "
+    SCAN_AAA(5) ", "
+    SCAN_BBB(7)
+    "]}";
+
+// The same join with a projection between the outer scan and the join,
+// so that the join pulls from the projection which pulls from the scan.
+const char *chainedJoinPlan =
+    "{\"EXECUTE_LIST\": [5, 3, 7, 4, 1], \"PLAN_NODES\": ["
+    "{\"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\", \"CHILDREN_IDS\": [4]}, "
+    "{\"ID\": 3, \"PLAN_NODE_TYPE\": \"PROJECTION\", \"CHILDREN_IDS\": [5], \"OUTPUT_SCHEMA\": ["
+    OUTPUT_COLUMN("A", 0) ", " OUTPUT_COLUMN("B", 1) ", " OUTPUT_COLUMN("C", 2) "]}, "
+    NESTLOOP(4, 3, 7) ", "
+    SCAN_AAA(5) ", "
+    SCAN_BBB(7)
+    "]}";
+
+// select A, B, C from AAA limit 5 offset 1020;
+// The rows straddle the end of the first batch.
+const char *limitPlan =
+    "{\"EXECUTE_LIST\": [3, 2, 1], \"PLAN_NODES\": ["
+    "{\"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\", \"CHILDREN_IDS\": [2]}, "
+    "{\"ID\": 2, \"PLAN_NODE_TYPE\": \"LIMIT\", \"CHILDREN_IDS\": [3], \"LIMIT\": 5, \"OFFSET\": 1020}, "
+    SCAN_AAA(3)
+    "]}";
+
+}
+
+class PipelinedExecutionTest : public PlanTestingBaseClass<EngineTestTopend> {
+public:
+    PipelinedExecutionTest() {
+        initialize(m_pipelinedDB);
+    }
+
+protected:
+    static DBConfig m_pipelinedDB;
+};
+
+TEST_F(PipelinedExecutionTest, JoinPullsOuterScanInBatches) {
+    std::vector<int> expected;
+    for (int i = 0; i < NUM_TABLE_ROWS_AAA; i++) {
+        expected.push_back(i);
+        expected.push_back(2 * i);
+        expected.push_back(i % 5);
+    }
+    executeFragment(100, joinPlan);
+    validateResult(&expected[0], NUM_TABLE_ROWS_AAA, 3);
+}
+
+TEST_F(PipelinedExecutionTest, ChainedProducers) {
+    std::vector<int> expected;
+    for (int i = 0; i < NUM_TABLE_ROWS_AAA; i++) {
+        expected.push_back(i);
+        expected.push_back(2 * i);
+        expected.push_back(i % 5);
+        expected.push_back(i % 5);
+    }
+    // Run it twice to make sure that the batch state is reset.
+    executeFragment(101, chainedJoinPlan);
+    validateResult(&expected[0], NUM_TABLE_ROWS_AAA, 4);
+    executeFragment(101, chainedJoinPlan);
+    validateResult(&expected[0], NUM_TABLE_ROWS_AAA, 4);
+}
+
+TEST_F(PipelinedExecutionTest, LimitStopsPullingBatches) {
+    std::vector<int> expected;
+    for (int i = 1020; i < 1025; i++) {
+        expected.push_back(i);
+        expected.push_back(2 * i);
+        expected.push_back(i % 5);
+    }
+    executeFragment(102, limitPlan);
+    validateResult(&expected[0], 5, 3);
+}
+
+DBConfig PipelinedExecutionTest::m_pipelinedDB =
+{
+    // DDL.
+    "create table AAA (A integer, B integer, C integer);\n"
+    "create table BBB (A integer, B integer, C integer);\n",
+    // Catalog String
+    "add / clusters cluster\n"
+    "set /clusters#cluster localepoch 0\n"
+    "set $PREV securityEnabled false\n"
+    "set $PREV httpdportno 0\n"
+    "set $PREV jsonapi false\n"
+    "set $PREV networkpartition false\n"
+    "set $PREV heartbeatTimeout 0\n"
+    "set $PREV useddlschema false\n"
+    "set $PREV drConsumerEnabled false\n"
+    "set $PREV drProducerEnabled false\n"
+    "set $PREV drClusterId 0\n"
+    "set $PREV drProducerPort 0\n"
+    "set $PREV drMasterHost \"\"\n"
+    "set $PREV drFlushInterval 0\n"
+    "add /clusters#cluster databases database\n"
+    "set /clusters#cluster/databases#database schema \"eJy1UkFyhDAMu/c1wZFtfN2U/P9JlVkKdIBd9tDJJMNgOZKsGFyse5HisMHEmqkUhRQLM57qo4VXh9f6+LJTOIZcn7VIro9aVOoVB6oKFIMCs3rKETQsTmTkLimTOzAlCg5VkbZU5LJSD5Ui8Zpy1rmSBnC8AhN6SuNfZVf7pSMmkXG/g6zBcd1noD5iv6lcZp4H8ZF6Z6Wx2LPKCNQGBqDnYe+nylCmRJozmD9TvajUQ6W8J16ezD8RXweKvgWq28AO614EZOhP5Nsb2uvAVi1xaiEvA790fL5CHUlMKzxXCdo3Q9Zt2szuZLad7aT5AeGp3Yc=\"\n"
+    "set $PREV isActiveActiveDRed false\n"
+    "set $PREV securityprovider \"\"\n"
+    "add /clusters#cluster/databases#database groups administrator\n"
+    "set /clusters#cluster/databases#database/groups#administrator admin true\n"
+    "set $PREV defaultproc true\n"
+    "set $PREV defaultprocread true\n"
+    "set $PREV sql true\n"
+    "set $PREV sqlread true\n"
+    "set $PREV allproc true\n"
+    "add /clusters#cluster/databases#database groups user\n"
+    "set /clusters#cluster/databases#database/groups#user admin false\n"
+    "set $PREV defaultproc true\n"
+    "set $PREV defaultprocread true\n"
+    "set $PREV sql true\n"
+    "set $PREV sqlread true\n"
+    "set $PREV allproc true\n"
+    "add /clusters#cluster/databases#database tables AAA\n"
+    "set /clusters#cluster/databases#database/tables#AAA isreplicated true\n"
+    "set $PREV partitioncolumn null\n"
+    "set $PREV estimatedtuplecount 0\n"
+    "set $PREV materializer null\n"
+    "set $PREV signature \"AAA|iii\"\n"
+    "set $PREV tuplelimit 2147483647\n"
+    "set $PREV isDRed false\n"
+    "add /clusters#cluster/databases#database/tables#AAA columns A\n"
+    "set /clusters#cluster/databases#database/tables#AAA/columns#A index 0\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"A\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#AAA columns B\n"
+    "set /clusters#cluster/databases#database/tables#AAA/columns#B index 1\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"B\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#AAA columns C\n"
+    "set /clusters#cluster/databases#database/tables#AAA/columns#C index 2\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"C\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database tables BBB\n"
+    "set /clusters#cluster/databases#database/tables#BBB isreplicated true\n"
+    "set $PREV partitioncolumn null\n"
+    "set $PREV estimatedtuplecount 0\n"
+    "set $PREV materializer null\n"
+    "set $PREV signature \"BBB|iii\"\n"
+    "set $PREV tuplelimit 2147483647\n"
+    "set $PREV isDRed false\n"
+    "add /clusters#cluster/databases#database/tables#BBB columns A\n"
+    "set /clusters#cluster/databases#database/tables#BBB/columns#A index 0\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"A\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#BBB columns B\n"
+    "set /clusters#cluster/databases#database/tables#BBB/columns#B index 1\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"B\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#BBB columns C\n"
+    "set /clusters#cluster/databases#database/tables#BBB/columns#C index 2\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"C\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "",
+    2,
+    allTables
+};
+
+int main() {
+     return TestSuite::globalInstance()->runAll();
+}
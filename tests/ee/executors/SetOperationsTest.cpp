@@ -0,0 +1,410 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "harness.h"
+
+#include "storage/persistenttable.h"
+#include "storage/temptable.h"
+#include "test_utils/plan_testing_config.h"
+#include "test_utils/LoadTableFrom.hpp"
+#include "test_utils/plan_testing_baseclass.h"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+/*
+ * Runs UNION, EXCEPT and INTERSECT over inputs in no particular order,
+ * which are hashed, over inputs that are already sorted, which are
+ * merged, and with a temp table limit too small to hash them at all,
+ * so that they are partitioned into spill files.
+ */
+
+namespace {
+
+// AAA has A = i, B = (37 * i) % 700, C = i % 5.  BBB has A = j, B = 10 * j,
+// C = j % 3 for j < 500.
+const int NUM_TABLE_ROWS_AAA = 100000;
+const int NUM_TABLE_ROWS_BBB = 500;
+const int NUM_TABLE_COLS = 3;
+const int AAA_B_MODULUS = 700;
+
+// Too little for the hash tables of a set operation over all of AAA
+const int64_t SPILL_TEMP_TABLE_MEMORY = 4 * 1024 * 1024;
+
+const char *ColumnNames[] = {
+    "A",
+    "B",
+    "C",
+};
+
+int AAAB(int i) {
+    return (37 * i) % AAA_B_MODULUS;
+}
+
+std::vector<int> makeAAAData() {
+    std::vector<int> data;
+    for (int i = 0; i < NUM_TABLE_ROWS_AAA; i++) {
+        data.push_back(i);
+        data.push_back(AAAB(i));
+        data.push_back(i % 5);
+    }
+    return data;
+}
+
+std::vector<int> makeBBBData() {
+    std::vector<int> data;
+    for (int j = 0; j < NUM_TABLE_ROWS_BBB; j++) {
+        data.push_back(j);
+        data.push_back(10 * j);
+        data.push_back(j % 3);
+    }
+    return data;
+}
+
+const std::vector<int> AAAData = makeAAAData();
+const std::vector<int> BBBData = makeBBBData();
+
+const TableConfig AAAConfig = {
+    "AAA",
+    ColumnNames,
+    NUM_TABLE_ROWS_AAA,
+    NUM_TABLE_COLS,
+    &AAAData[0]
+};
+
+const TableConfig BBBConfig = {
+    "BBB",
+    ColumnNames,
+    NUM_TABLE_ROWS_BBB,
+    NUM_TABLE_COLS,
+    &BBBData[0]
+};
+
+const TableConfig *allTables[] = {
+    &AAAConfig,
+    &BBBConfig,
+};
+
+#define TVE(idx) "{\"COLUMN_IDX\": " #idx ", \"TYPE\": 32, \"VALUE_TYPE\": 5}"
+#define OUTPUT_COLUMN(name, idx) "{\"COLUMN_NAME\": \"" name "\", \"EXPRESSION\": " TVE(idx) "}"
+
+#define SCAN(id, table, column, idx) \
+    "{\"ID\": " #id ", \"PLAN_NODE_TYPE\": \"SEQSCAN\", " \
+    "\"TARGET_TABLE_ALIAS\": \"" table "\", \"TARGET_TABLE_NAME\": \"" table "\", " \
+    "\"INLINE_NODES\": [{\"ID\": 1" #id ", \"PLAN_NODE_TYPE\": \"PROJECTION\", \"OUTPUT_SCHEMA\": [" \
+    OUTPUT_COLUMN(column, idx) "]}]}"
+
+// select <column> from AAA <unionType> select <column> from BBB;
+#define SET_OPERATION(unionType, column, idx) \
+    "{\"EXECUTE_LIST\": [3, 4, 2, 1], \"PLAN_NODES\": [" \
+    "{\"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\", \"CHILDREN_IDS\": [2]}, " \
+    "{\"ID\": 2, \"PLAN_NODE_TYPE\": \"UNION\", \"CHILDREN_IDS\": [3, 4], \"UNION_TYPE\": \"" unionType "\"}, " \
+    SCAN(3, "AAA", column, idx) ", " \
+    SCAN(4, "BBB", column, idx) \
+    "]}"
+
+const char *unionCPlan = SET_OPERATION("UNION", "C", 2);
+const char *exceptBPlan = SET_OPERATION("EXCEPT", "B", 1);
+const char *exceptAllBPlan = SET_OPERATION("EXCEPT_ALL", "B", 1);
+const char *intersectAllBPlan = SET_OPERATION("INTERSECT_ALL", "B", 1);
+const char *exceptAPlan = SET_OPERATION("EXCEPT", "A", 0);
+const char *intersectAPlan = SET_OPERATION("INTERSECT", "A", 0);
+
+// How many times each value of AAA.B and BBB.B occurs
+std::map<int, int> countAAAB() {
+    std::map<int, int> counts;
+    for (int i = 0; i < NUM_TABLE_ROWS_AAA; i++) {
+        ++counts[AAAB(i)];
+    }
+    return counts;
+}
+
+std::map<int, int> countBBBB() {
+    std::map<int, int> counts;
+    for (int j = 0; j < NUM_TABLE_ROWS_BBB; j++) {
+        ++counts[10 * j];
+    }
+    return counts;
+}
+
+std::vector<int> expectedExceptB(bool all) {
+    std::map<int, int> aaa = countAAAB();
+    std::map<int, int> bbb = countBBBB();
+    std::vector<int> expected;
+    for (std::map<int, int>::const_iterator it = aaa.begin(); it != aaa.end(); ++it) {
+        int copies = all ? it->second - bbb[it->first] : (bbb[it->first] == 0 ? 1 : 0);
+        expected.insert(expected.end(), std::max(copies, 0), it->first);
+    }
+    return expected;
+}
+
+std::vector<int> expectedIntersectAllB() {
+    std::map<int, int> aaa = countAAAB();
+    std::map<int, int> bbb = countBBBB();
+    std::vector<int> expected;
+    for (std::map<int, int>::const_iterator it = aaa.begin(); it != aaa.end(); ++it) {
+        expected.insert(expected.end(), std::min(it->second, bbb[it->first]), it->first);
+    }
+    return expected;
+}
+
+std::vector<int> expectedUnionC() {
+    std::vector<int> expected;
+    for (int c = 0; c < 5; c++) {
+        expected.push_back(c);
+    }
+    return expected;
+}
+
+}
+
+class SetOperationsTest : public PlanTestingBaseClass<EngineTestTopend> {
+public:
+    SetOperationsTest(int64_t tempTableMemoryLimit = voltdb::DEFAULT_TEMP_TABLE_MEMORY) {
+        m_tempTableMemoryLimit = tempTableMemoryLimit;
+        initialize(m_setOperationsDB);
+    }
+
+protected:
+    void execute(fragmentId_t fragmentId, const char *plan) {
+        // Start each result at the beginning of the buffer
+        m_engine->resetReusedResultOutputBuffer();
+        executeFragment(fragmentId, plan);
+    }
+
+    /** The first column of the result, in the order it came out */
+    std::vector<int> getResult() {
+        boost::scoped_ptr<voltdb::TempTable> result(voltdb::loadTableFrom(m_result_buffer.get(),
+                                                                           m_engine->getResultsSize()));
+        std::vector<int> values;
+        voltdb::TableTuple tuple(result->schema());
+        voltdb::TableIterator iter = result->iterator();
+        while (iter.next(tuple)) {
+            values.push_back(static_cast<int>(voltdb::ValuePeeker::peekAsBigInt(tuple.getNValue(0))));
+        }
+        return values;
+    }
+
+    std::vector<int> getSortedResult() {
+        std::vector<int> values = getResult();
+        std::sort(values.begin(), values.end());
+        return values;
+    }
+
+    static DBConfig m_setOperationsDB;
+};
+
+class SetOperationsSpillTest : public SetOperationsTest {
+public:
+    SetOperationsSpillTest() : SetOperationsTest(SPILL_TEMP_TABLE_MEMORY) { }
+};
+
+TEST_F(SetOperationsTest, HashedUnion) {
+    execute(100, unionCPlan);
+    ASSERT_TRUE(getSortedResult() == expectedUnionC());
+}
+
+TEST_F(SetOperationsTest, HashedExcept) {
+    execute(100, exceptBPlan);
+    std::vector<int> result = getSortedResult();
+    ASSERT_EQ(630, static_cast<int>(result.size()));
+    ASSERT_TRUE(result == expectedExceptB(false));
+
+    execute(101, exceptAllBPlan);
+    ASSERT_TRUE(getSortedResult() == expectedExceptB(true));
+}
+
+TEST_F(SetOperationsTest, HashedIntersect) {
+    execute(100, intersectAllBPlan);
+    std::vector<int> result = getSortedResult();
+    ASSERT_EQ(AAA_B_MODULUS / 10, static_cast<int>(result.size()));
+    ASSERT_TRUE(result == expectedIntersectAllB());
+}
+
+TEST_F(SetOperationsTest, MergedSortedInputs) {
+    // Both scans produce A in order, so the results come out in order too.
+    execute(100, exceptAPlan);
+    std::vector<int> result = getResult();
+    ASSERT_EQ(NUM_TABLE_ROWS_AAA - NUM_TABLE_ROWS_BBB, static_cast<int>(result.size()));
+    for (size_t i = 0; i < result.size(); i++) {
+        ASSERT_EQ(NUM_TABLE_ROWS_BBB + static_cast<int>(i), result[i]);
+    }
+
+    execute(101, intersectAPlan);
+    result = getResult();
+    ASSERT_EQ(NUM_TABLE_ROWS_BBB, static_cast<int>(result.size()));
+    for (size_t i = 0; i < result.size(); i++) {
+        ASSERT_EQ(static_cast<int>(i), result[i]);
+    }
+}
+
+TEST_F(SetOperationsSpillTest, SpilledSetOperations) {
+    // None of these fit in the temp table limit without spilling.
+    execute(100, unionCPlan);
+    ASSERT_TRUE(getSortedResult() == expectedUnionC());
+
+    execute(101, exceptBPlan);
+    ASSERT_TRUE(getSortedResult() == expectedExceptB(false));
+
+    execute(102, exceptAllBPlan);
+    ASSERT_TRUE(getSortedResult() == expectedExceptB(true));
+
+    execute(103, intersectAllBPlan);
+    ASSERT_TRUE(getSortedResult() == expectedIntersectAllB());
+}
+
+DBConfig SetOperationsTest::m_setOperationsDB =
+{
+    // DDL.
+    "create table AAA (A integer, B integer, C integer);\n"
+    "create table BBB (A integer, B integer, C integer);\n",
+    // Catalog String
+    "add / clusters cluster\n"
+    "set /clusters#cluster localepoch 0\n"
+    "set $PREV securityEnabled false\n"
+    "set $PREV httpdportno 0\n"
+    "set $PREV jsonapi false\n"
+    "set $PREV networkpartition false\n"
+    "set $PREV heartbeatTimeout 0\n"
+    "set $PREV useddlschema false\n"
+    "set $PREV drConsumerEnabled false\n"
+    "set $PREV drProducerEnabled false\n"
+    "set $PREV drClusterId 0\n"
+    "set $PREV drProducerPort 0\n"
+    "set $PREV drMasterHost \"\"\n"
+    "set $PREV drFlushInterval 0\n"
+    "add /clusters#cluster databases database\n"
+    "set /clusters#cluster/databases#database schema \"eJy1UkFyhDAMu/c1wZFtfN2U/P9JlVkKdIBd9tDJJMNgOZKsGFyse5HisMHEmqkUhRQLM57qo4VXh9f6+LJTOIZcn7VIro9aVOoVB6oKFIMCs3rKETQsTmTkLimTOzAlCg5VkbZU5LJSD5Ui8Zpy1rmSBnC8AhN6SuNfZVf7pSMmkXG/g6zBcd1noD5iv6lcZp4H8ZF6Z6Wx2LPKCNQGBqDnYe+nylCmRJozmD9TvajUQ6W8J16ezD8RXweKvgWq28AO614EZOhP5Nsb2uvAVi1xaiEvA790fL5CHUlMKzxXCdo3Q9Zt2szuZLad7aT5AeGp3Yc=\"\n"
+    "set $PREV isActiveActiveDRed false\n"
+    "set $PREV securityprovider \"\"\n"
+    "add /clusters#cluster/databases#database groups administrator\n"
+    "set /clusters#cluster/databases#database/groups#administrator admin true\n"
+    "set $PREV defaultproc true\n"
+    "set $PREV defaultprocread true\n"
+    "set $PREV sql true\n"
+    "set $PREV sqlread true\n"
+    "set $PREV allproc true\n"
+    "add /clusters#cluster/databases#database groups user\n"
+    "set /clusters#cluster/databases#database/groups#user admin false\n"
+    "set $PREV defaultproc true\n"
+    "set $PREV defaultprocread true\n"
+    "set $PREV sql true\n"
+    "set $PREV sqlread true\n"
+    "set $PREV allproc true\n"
+    "add /clusters#cluster/databases#database tables AAA\n"
+    "set /clusters#cluster/databases#database/tables#AAA isreplicated true\n"
+    "set $PREV partitioncolumn null\n"
+    "set $PREV estimatedtuplecount 0\n"
+    "set $PREV materializer null\n"
+    "set $PREV signature \"AAA|iii\"\n"
+    "set $PREV tuplelimit 2147483647\n"
+    "set $PREV isDRed false\n"
+    "add /clusters#cluster/databases#database/tables#AAA columns A\n"
+    "set /clusters#cluster/databases#database/tables#AAA/columns#A index 0\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"A\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#AAA columns B\n"
+    "set /clusters#cluster/databases#database/tables#AAA/columns#B index 1\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"B\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#AAA columns C\n"
+    "set /clusters#cluster/databases#database/tables#AAA/columns#C index 2\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"C\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database tables BBB\n"
+    "set /clusters#cluster/databases#database/tables#BBB isreplicated true\n"
+    "set $PREV partitioncolumn null\n"
+    "set $PREV estimatedtuplecount 0\n"
+    "set $PREV materializer null\n"
+    "set $PREV signature \"BBB|iii\"\n"
+    "set $PREV tuplelimit 2147483647\n"
+    "set $PREV isDRed false\n"
+    "add /clusters#cluster/databases#database/tables#BBB columns A\n"
+    "set /clusters#cluster/databases#database/tables#BBB/columns#A index 0\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"A\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#BBB columns B\n"
+    "set /clusters#cluster/databases#database/tables#BBB/columns#B index 1\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"B\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#BBB columns C\n"
+    "set /clusters#cluster/databases#database/tables#BBB/columns#C index 2\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"C\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "",
+    2,
+    allTables
+};
+
+int main() {
+     return TestSuite::globalInstance()->runAll();
+}
@@ -0,0 +1,410 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "harness.h"
+
+#include "common/TupleSchema.h"
+#include "common/ValueFactory.hpp"
+#include "common/ValuePeeker.hpp"
+#include "expressions/subqueryresultmemo.h"
+#include "storage/persistenttable.h"
+#include "storage/tablefactory.h"
+#include "storage/tableiterator.h"
+#include "storage/temptable.h"
+#include "test_utils/plan_testing_config.h"
+#include "test_utils/LoadTableFrom.hpp"
+#include "test_utils/plan_testing_baseclass.h"
+
+#include <boost/scoped_ptr.hpp>
+
+#include <string>
+#include <vector>
+
+/*
+ * Runs subqueries correlated by a column whose values repeat in no
+ * particular order, so that the results come from the memo of earlier
+ * results rather than from the last run, and an uncorrelated
+ * IN (SELECT ...) that is looked up rather than scanned for every row.
+ */
+
+namespace {
+
+// AAA has A = i, B = (37 * i) % 700, C = i % 5.  BBB has A = j, B = 10 * j,
+// C = j % 3 for j < 500.
+const int NUM_TABLE_ROWS_AAA = 3000;
+const int NUM_TABLE_ROWS_BBB = 500;
+const int NUM_TABLE_COLS = 3;
+const int AAA_B_MODULUS = 700;
+
+const char *ColumnNames[] = {
+    "A",
+    "B",
+    "C",
+};
+
+int AAAB(int i) {
+    return (37 * i) % AAA_B_MODULUS;
+}
+
+std::vector<int> makeAAAData() {
+    std::vector<int> data;
+    for (int i = 0; i < NUM_TABLE_ROWS_AAA; i++) {
+        data.push_back(i);
+        data.push_back(AAAB(i));
+        data.push_back(i % 5);
+    }
+    return data;
+}
+
+std::vector<int> makeBBBData() {
+    std::vector<int> data;
+    for (int j = 0; j < NUM_TABLE_ROWS_BBB; j++) {
+        data.push_back(j);
+        data.push_back(10 * j);
+        data.push_back(j % 3);
+    }
+    return data;
+}
+
+const std::vector<int> AAAData = makeAAAData();
+const std::vector<int> BBBData = makeBBBData();
+
+const TableConfig AAAConfig = {
+    "AAA",
+    ColumnNames,
+    NUM_TABLE_ROWS_AAA,
+    NUM_TABLE_COLS,
+    &AAAData[0]
+};
+
+const TableConfig BBBConfig = {
+    "BBB",
+    ColumnNames,
+    NUM_TABLE_ROWS_BBB,
+    NUM_TABLE_COLS,
+    &BBBData[0]
+};
+
+const TableConfig *allTables[] = {
+    &AAAConfig,
+    &BBBConfig,
+};
+
+#define TVE(idx) "{\"COLUMN_IDX\": " #idx ", \"TYPE\": 32, \"VALUE_TYPE\": 5}"
+#define PVE(idx) "{\"PARAM_IDX\": " #idx ", \"TYPE\": 31, \"VALUE_TYPE\": 5}"
+#define OUTPUT_COLUMN(name, idx) "{\"COLUMN_NAME\": \"" name "\", \"EXPRESSION\": " TVE(idx) "}"
+
+// select A from AAA where <predicate>
+#define SCAN_AAA(predicate) \
+    "{\"ID\": 1, \"PLAN_NODE_TYPE\": \"SEND\", \"CHILDREN_IDS\": [2]}, " \
+    "{\"ID\": 2, \"PLAN_NODE_TYPE\": \"SEQSCAN\", " \
+    "\"TARGET_TABLE_ALIAS\": \"AAA\", \"TARGET_TABLE_NAME\": \"AAA\", \"PREDICATE\": " predicate ", " \
+    "\"INLINE_NODES\": [{\"ID\": 3, \"PLAN_NODE_TYPE\": \"PROJECTION\", \"OUTPUT_SCHEMA\": [" \
+    OUTPUT_COLUMN("A", 0) "]}]}"
+
+// select <column> from BBB where <predicate>
+#define SCAN_BBB(predicate, column, idx) \
+    "{\"ID\": 4, \"PLAN_NODE_TYPE\": \"SEQSCAN\", " \
+    "\"TARGET_TABLE_ALIAS\": \"BBB\", \"TARGET_TABLE_NAME\": \"BBB\", \"PREDICATE\": " predicate ", " \
+    "\"INLINE_NODES\": [{\"ID\": 5, \"PLAN_NODE_TYPE\": \"PROJECTION\", \"OUTPUT_SCHEMA\": [" \
+    OUTPUT_COLUMN(column, idx) "]}]}"
+
+// Subquery 1, correlated by AAA.B as parameter 0
+#define CORRELATED_SUBQUERY \
+    "{\"TYPE\": 401, \"VALUE_TYPE\": 5, \"SUBQUERY_ID\": 1, \"PARAM_IDX\": [0], \"ARGS\": [" TVE(1) "]}"
+
+#define UNCORRELATED_SUBQUERY "{\"TYPE\": 401, \"VALUE_TYPE\": 5, \"SUBQUERY_ID\": 1}"
+
+#define BBB_A_EQUALS_PARAMETER "{\"TYPE\": 10, \"VALUE_TYPE\": 23, \"LEFT\": " TVE(0) ", \"RIGHT\": " PVE(0) "}"
+
+#define FRAGMENT(outerNodes, subqueryNodes) \
+    "{\"PLAN_NODES_LISTS\": [" \
+    "{\"STATEMENT_ID\": 0, \"PLAN_NODES\": [" outerNodes "]}, " \
+    "{\"STATEMENT_ID\": 1, \"PLAN_NODES\": [" subqueryNodes "]}], " \
+    "\"EXECUTE_LISTS\": [{\"EXECUTE_LIST\": [2, 1]}, {\"EXECUTE_LIST\": [4]}]}"
+
+// select A from AAA where exists (select C from BBB where BBB.A = AAA.B);
+const char *existsPlan =
+    FRAGMENT(SCAN_AAA("{\"TYPE\": 18, \"VALUE_TYPE\": 23, \"LEFT\": " CORRELATED_SUBQUERY "}"),
+             SCAN_BBB(BBB_A_EQUALS_PARAMETER, "C", 2));
+
+// select A from AAA where AAA.C = (select C from BBB where BBB.A = AAA.B);
+const char *scalarPlan =
+    FRAGMENT(SCAN_AAA("{\"TYPE\": 10, \"VALUE_TYPE\": 23, \"QUANTIFIER\": 0, "
+                      "\"LEFT\": " TVE(2) ", \"RIGHT\": " CORRELATED_SUBQUERY "}"),
+             SCAN_BBB(BBB_A_EQUALS_PARAMETER, "C", 2));
+
+// select A from AAA where AAA.B in (select B from BBB where BBB.C < 2);
+const char *inPlan =
+    FRAGMENT(SCAN_AAA("{\"TYPE\": 10, \"VALUE_TYPE\": 23, \"QUANTIFIER\": 1, "
+                      "\"LEFT\": " TVE(1) ", \"RIGHT\": " UNCORRELATED_SUBQUERY "}"),
+             SCAN_BBB("{\"TYPE\": 12, \"VALUE_TYPE\": 23, \"LEFT\": " TVE(2) ", "
+                      "\"RIGHT\": {\"TYPE\": 30, \"VALUE_TYPE\": 5, \"ISNULL\": false, \"VALUE\": 2}}",
+                      "B", 1));
+
+}
+
+class SubqueryMemoTest : public PlanTestingBaseClass<EngineTestTopend> {
+public:
+    SubqueryMemoTest() {
+        initialize(m_subqueryMemoDB);
+    }
+
+protected:
+    static DBConfig m_subqueryMemoDB;
+};
+
+TEST_F(SubqueryMemoTest, CorrelatedExists) {
+    std::vector<int> expected;
+    for (int i = 0; i < NUM_TABLE_ROWS_AAA; i++) {
+        if (AAAB(i) < NUM_TABLE_ROWS_BBB) {
+            expected.push_back(i);
+        }
+    }
+    // Run it twice to make sure that nothing is remembered between fragments.
+    executeFragment(100, existsPlan);
+    validateResult(&expected[0], static_cast<int>(expected.size()), 1);
+    executeFragment(100, existsPlan);
+    validateResult(&expected[0], static_cast<int>(expected.size()), 1);
+}
+
+TEST_F(SubqueryMemoTest, CorrelatedScalar) {
+    // The remembered rows must be the ones that the comparison sees.
+    std::vector<int> expected;
+    for (int i = 0; i < NUM_TABLE_ROWS_AAA; i++) {
+        if (AAAB(i) < NUM_TABLE_ROWS_BBB && i % 5 == AAAB(i) % 3) {
+            expected.push_back(i);
+        }
+    }
+    executeFragment(101, scalarPlan);
+    validateResult(&expected[0], static_cast<int>(expected.size()), 1);
+}
+
+TEST_F(SubqueryMemoTest, UncorrelatedIn) {
+    std::vector<int> expected;
+    for (int i = 0; i < NUM_TABLE_ROWS_AAA; i++) {
+        int b = AAAB(i);
+        if (b % 10 == 0 && (b / 10) % 3 < 2) {
+            expected.push_back(i);
+        }
+    }
+    executeFragment(102, inPlan);
+    validateResult(&expected[0], static_cast<int>(expected.size()), 1);
+}
+
+TEST_F(SubqueryMemoTest, MemoEvictsLeastRecentlyUsed) {
+    std::vector<voltdb::ValueType> types(1, voltdb::VALUE_TYPE_INTEGER);
+    std::vector<int32_t> sizes(1, voltdb::NValue::getTupleStorageSize(voltdb::VALUE_TYPE_INTEGER));
+    std::vector<bool> allowNull(1, true);
+    std::vector<std::string> names(1, "A");
+    boost::scoped_ptr<voltdb::TempTable> table(voltdb::TableFactory::buildTempTable("RESULT",
+            voltdb::TupleSchema::createTupleSchemaForTest(types, sizes, allowNull), names, NULL));
+
+    // Each result is ten rows, so a budget of a bit more than three of them
+    // holds three entries.
+    voltdb::TableTuple& tuple = table->tempTuple();
+    for (int i = 0; i < 10; i++) {
+        tuple.setNValue(0, voltdb::ValueFactory::getIntegerValue(i));
+        table->insertTempTuple(tuple);
+    }
+    voltdb::SubqueryResultMemo::Key key(1);
+    key[0] = voltdb::ValueFactory::getIntegerValue(0);
+    voltdb::SubqueryResultMemo probe;
+    probe.remember(key, table.get());
+    const int64_t footprint = probe.memoryUsed();
+    ASSERT_TRUE(footprint > 0);
+
+    voltdb::SubqueryResultMemo memo(footprint * 3 + footprint / 2);
+    for (int k = 0; k < 3; k++) {
+        key[0] = voltdb::ValueFactory::getIntegerValue(k);
+        memo.remember(key, table.get());
+    }
+    ASSERT_EQ(3, static_cast<int>(memo.entryCount()));
+
+    // Using key 0 again makes key 1 the least recently used, so it goes first.
+    key[0] = voltdb::ValueFactory::getIntegerValue(0);
+    ASSERT_TRUE(memo.restore(key, table.get()));
+    ASSERT_EQ(10, table->activeTupleCount());
+    key[0] = voltdb::ValueFactory::getIntegerValue(3);
+    memo.remember(key, table.get());
+    ASSERT_EQ(3, static_cast<int>(memo.entryCount()));
+    ASSERT_EQ(footprint * 3, memo.memoryUsed());
+
+    key[0] = voltdb::ValueFactory::getIntegerValue(1);
+    ASSERT_FALSE(memo.restore(key, table.get()));
+    for (int k = 0; k < 4; k++) {
+        if (k == 1) {
+            continue;
+        }
+        key[0] = voltdb::ValueFactory::getIntegerValue(k);
+        ASSERT_TRUE(memo.restore(key, table.get()));
+        voltdb::TableTuple restored(table->schema());
+        voltdb::TableIterator iterator = table->iterator();
+        int expected = 0;
+        while (iterator.next(restored)) {
+            ASSERT_EQ(expected++, voltdb::ValuePeeker::peekAsInteger(restored.getNValue(0)));
+        }
+        ASSERT_EQ(10, expected);
+    }
+
+    // A result bigger than the whole budget is not kept, and evicts nothing.
+    voltdb::SubqueryResultMemo small(footprint - 1);
+    small.remember(key, table.get());
+    ASSERT_EQ(0, static_cast<int>(small.entryCount()));
+    ASSERT_EQ(0, small.memoryUsed());
+}
+
+DBConfig SubqueryMemoTest::m_subqueryMemoDB =
+{
+    // DDL.
+    "create table AAA (A integer, B integer, C integer);\n"
+    "create table BBB (A integer, B integer, C integer);\n",
+    // Catalog String
+    "add / clusters cluster\n"
+    "set /clusters#cluster localepoch 0\n"
+    "set $PREV securityEnabled false\n"
+    "set $PREV httpdportno 0\n"
+    "set $PREV jsonapi false\n"
+    "set $PREV networkpartition false\n"
+    "set $PREV heartbeatTimeout 0\n"
+    "set $PREV useddlschema false\n"
+    "set $PREV drConsumerEnabled false\n"
+    "set $PREV drProducerEnabled false\n"
+    "set $PREV drClusterId 0\n"
+    "set $PREV drProducerPort 0\n"
+    "set $PREV drMasterHost \"\"\n"
+    "set $PREV drFlushInterval 0\n"
+    "add /clusters#cluster databases database\n"
+    "set /clusters#cluster/databases#database schema \"eJy1UkFyhDAMu/c1wZFtfN2U/P9JlVkKdIBd9tDJJMNgOZKsGFyse5HisMHEmqkUhRQLM57qo4VXh9f6+LJTOIZcn7VIro9aVOoVB6oKFIMCs3rKETQsTmTkLimTOzAlCg5VkbZU5LJSD5Ui8Zpy1rmSBnC8AhN6SuNfZVf7pSMmkXG/g6zBcd1noD5iv6lcZp4H8ZF6Z6Wx2LPKCNQGBqDnYe+nylCmRJozmD9TvajUQ6W8J16ezD8RXweKvgWq28AO614EZOhP5Nsb2uvAVi1xaiEvA790fL5CHUlMKzxXCdo3Q9Zt2szuZLad7aT5AeGp3Yc=\"\n"
+    "set $PREV isActiveActiveDRed false\n"
+    "set $PREV securityprovider \"\"\n"
+    "add /clusters#cluster/databases#database groups administrator\n"
+    "set /clusters#cluster/databases#database/groups#administrator admin true\n"
+    "set $PREV defaultproc true\n"
+    "set $PREV defaultprocread true\n"
+    "set $PREV sql true\n"
+    "set $PREV sqlread true\n"
+    "set $PREV allproc true\n"
+    "add /clusters#cluster/databases#database groups user\n"
+    "set /clusters#cluster/databases#database/groups#user admin false\n"
+    "set $PREV defaultproc true\n"
+    "set $PREV defaultprocread true\n"
+    "set $PREV sql true\n"
+    "set $PREV sqlread true\n"
+    "set $PREV allproc true\n"
+    "add /clusters#cluster/databases#database tables AAA\n"
+    "set /clusters#cluster/databases#database/tables#AAA isreplicated true\n"
+    "set $PREV partitioncolumn null\n"
+    "set $PREV estimatedtuplecount 0\n"
+    "set $PREV materializer null\n"
+    "set $PREV signature \"AAA|iii\"\n"
+    "set $PREV tuplelimit 2147483647\n"
+    "set $PREV isDRed false\n"
+    "add /clusters#cluster/databases#database/tables#AAA columns A\n"
+    "set /clusters#cluster/databases#database/tables#AAA/columns#A index 0\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"A\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#AAA columns B\n"
+    "set /clusters#cluster/databases#database/tables#AAA/columns#B index 1\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"B\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#AAA columns C\n"
+    "set /clusters#cluster/databases#database/tables#AAA/columns#C index 2\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"C\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database tables BBB\n"
+    "set /clusters#cluster/databases#database/tables#BBB isreplicated true\n"
+    "set $PREV partitioncolumn null\n"
+    "set $PREV estimatedtuplecount 0\n"
+    "set $PREV materializer null\n"
+    "set $PREV signature \"BBB|iii\"\n"
+    "set $PREV tuplelimit 2147483647\n"
+    "set $PREV isDRed false\n"
+    "add /clusters#cluster/databases#database/tables#BBB columns A\n"
+    "set /clusters#cluster/databases#database/tables#BBB/columns#A index 0\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"A\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#BBB columns B\n"
+    "set /clusters#cluster/databases#database/tables#BBB/columns#B index 1\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"B\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "add /clusters#cluster/databases#database/tables#BBB columns C\n"
+    "set /clusters#cluster/databases#database/tables#BBB/columns#C index 2\n"
+    "set $PREV type 5\n"
+    "set $PREV size 4\n"
+    "set $PREV nullable true\n"
+    "set $PREV name \"C\"\n"
+    "set $PREV defaultvalue null\n"
+    "set $PREV defaulttype 0\n"
+    "set $PREV aggregatetype 0\n"
+    "set $PREV matviewsource null\n"
+    "set $PREV matview null\n"
+    "set $PREV inbytes false\n"
+    "",
+    2,
+    allTables
+};
+
+int main() {
+     return TestSuite::globalInstance()->runAll();
+}
@@ -61,6 +61,9 @@
 
 #include "expressions/abstractexpression.h"
 #include "expressions/expressions.h"
+#include "expressions/expressionutil.h"
+#include "common/executorcontext.hpp"
+#include "common/ThreadLocalPool.h"
 #include "common/types.h"
 #include "common/ValuePeeker.hpp"
 #include "common/PlannerDomValue.h"
@@ -453,6 +456,77 @@ TEST_F(ExpressionTest, Timestamp) {
 
 }
 
+/*
+ * Show that IN lists of parameters and constants, which are arranged for
+ * lookups rather than scanned, agree with NValue::inList, and that a
+ * parameter list is rearranged once the parameters change.
+ */
+TEST_F(ExpressionTest, InListLookup) {
+    // The lists are allocated from the temp string pool, and the
+    // parameter change count lives in the executor context.
+    ThreadLocalPool threadLocalPool;
+    boost::scoped_ptr<Pool> pool(new Pool());
+    boost::scoped_ptr<ExecutorContext> context(new ExecutorContext(0, 0, NULL, NULL, pool.get(), NULL, "", 0, NULL, NULL, 0));
+
+    vector<bool> allowNull(1, true);
+    vector<int32_t> columnSizes(1, 4);
+    vector<voltdb::ValueType> types(1, voltdb::VALUE_TYPE_INTEGER);
+    TupleSchema *schema = TupleSchema::createTupleSchemaForTest(types, columnSizes, allowNull);
+    boost::scoped_array<char> tupleStorage(new char[schema->tupleLength() + TUPLE_HEADER_SIZE]);
+    TableTuple t(tupleStorage.get(), schema);
+
+    // 2000 BIGINTs with repeats, plus a NULL that must not match anything
+    std::vector<NValue> elements;
+    for (int i = 0; i < 2000; i++) {
+        elements.push_back(ValueFactory::getBigIntValue((i * 7919) % 5000));
+    }
+    elements.push_back(NValue::getNullValue(VALUE_TYPE_BIGINT));
+    NValue param = ValueFactory::getArrayValueFromSizeAndType(elements.size(), VALUE_TYPE_BIGINT);
+    param.setArrayElements(elements);
+
+    PlannerDomRoot emptyObject("{}");
+    boost::scoped_ptr<AbstractExpression> inParam(
+            ExpressionUtil::comparisonFactory(emptyObject.rootObject(), EXPRESSION_TYPE_COMPARE_IN,
+                                              new TupleValueExpression(0, 0),
+                                              new ParameterValueExpression(0, &param)));
+    ASSERT_TRUE(dynamic_cast<InListExpression*>(inParam.get()) != NULL);
+    for (int v = -10; v < 5010; v++) {
+        t.setNValue(0, ValueFactory::getIntegerValue(v));
+        ASSERT_EQ(t.getNValue(0).inList(param), inParam->eval(&t, NULL).isTrue());
+    }
+    t.setNValue(0, NValue::getNullValue(VALUE_TYPE_INTEGER));
+    ASSERT_TRUE(inParam->eval(&t, NULL).isNull());
+
+    // New parameter values, e.g. for the next fragment
+    elements.clear();
+    elements.push_back(ValueFactory::getBigIntValue(-3));
+    elements.push_back(ValueFactory::getBigIntValue(6000));
+    param = ValueFactory::getArrayValueFromSizeAndType(elements.size(), VALUE_TYPE_BIGINT);
+    param.setArrayElements(elements);
+    context->parametersChanged();
+    for (int v = -10; v < 6010; v++) {
+        t.setNValue(0, ValueFactory::getIntegerValue(v));
+        ASSERT_EQ(v == -3 || v == 6000, inParam->eval(&t, NULL).isTrue());
+    }
+
+    // A list of DECIMAL constants, looked up with integers
+    std::vector<AbstractExpression*>* args = new std::vector<AbstractExpression*>();
+    args->push_back(new ConstantValueExpression(ValueFactory::getDecimalValueFromString("17")));
+    args->push_back(new ConstantValueExpression(ValueFactory::getDecimalValueFromString("-4")));
+    args->push_back(new ConstantValueExpression(ValueFactory::getDecimalValueFromString("2.5")));
+    boost::scoped_ptr<AbstractExpression> inConstants(
+            ExpressionUtil::comparisonFactory(emptyObject.rootObject(), EXPRESSION_TYPE_COMPARE_IN,
+                                              new TupleValueExpression(0, 0),
+                                              ExpressionUtil::vectorFactory(VALUE_TYPE_DECIMAL, args)));
+    ASSERT_TRUE(dynamic_cast<InListExpression*>(inConstants.get()) != NULL);
+    for (int v = -10; v < 20; v++) {
+        t.setNValue(0, ValueFactory::getIntegerValue(v));
+        ASSERT_EQ(v == 17 || v == -4, inConstants->eval(&t, NULL).isTrue());
+    }
+
+    TupleSchema::freeTupleSchema(schema);
+}
+
 int main() {
      return TestSuite::globalInstance()->runAll();
 }
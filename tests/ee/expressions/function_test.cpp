@@ -753,6 +753,59 @@ TEST_F(FunctionTest, RegularExpressionMatch) {
     ASSERT_EQ(testBinary(FUNC_VOLT_REGEXP_POSITION, testUTF8String, "[a-z]家", 0), 0);
 }
 
+TEST_F(FunctionTest, JsonFieldTest) {
+    std::string doc("{ \"status\": \"open\", \"n\": 150, \"t\": true, \"z\": null,"
+                    " \"o\": { \"b\": 2, \"a\": [1, \"two\", {\"c\": 3}] }, \"e\": \"x\\ty\" }");
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, std::string("status"), std::string("open")), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, std::string("n"), std::string("150")), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, std::string("t"), std::string("true")), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, std::string("e"), std::string("x\ty")), 0);
+    // Nested documents come back normalized, with sorted field names
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, std::string("o"),
+                         std::string("{\"a\":[1,\"two\",{\"c\":3}],\"b\":2}")), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, std::string("o.a[1]"), std::string("two")), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, std::string("o.a[-1].c"), std::string("3")), 0);
+    // As with a full parse, the last of any duplicated fields wins
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, std::string("{\"d\": 1, \"x\": 0, \"d\": 2}"),
+                         std::string("d"), std::string("2")), 0);
+    // Missing values and JSON nulls are SQL nulls
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, std::string("z"), std::string(""), true), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, std::string("missing"), std::string(""), true), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, std::string("o.a[3]"), std::string(""), true), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, doc, std::string("status.x"), std::string(""), true), 0);
+    // Escaped field names and comments are left to the full parse
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, std::string("{\"a\\u0062\": 1}"), std::string("ab"),
+                         std::string("1")), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_FIELD, std::string("{/* c */ \"a\": 1}"), std::string("a"),
+                         std::string("1")), 0);
+
+    ASSERT_EQ("success", testBinaryThrows(FUNC_VOLT_FIELD, std::string("{\"a\": [1, 2}"),
+                                          std::string("b"), "Invalid JSON"));
+    ASSERT_EQ("success", testBinaryThrows(FUNC_VOLT_FIELD, doc, std::string("o.a[-2]"),
+                                          "Invalid JSON path"));
+
+    std::string array("[10, \"x\", {\"k\": true}]");
+    ASSERT_EQ(testBinary(FUNC_VOLT_ARRAY_ELEMENT, array, 0, std::string("10")), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_ARRAY_ELEMENT, array, 2, std::string("{\"k\":true}")), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_ARRAY_ELEMENT, array, 3, std::string(""), true), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_ARRAY_ELEMENT, array, -1, std::string(""), true), 0);
+    ASSERT_EQ(testBinary(FUNC_VOLT_ARRAY_ELEMENT, doc, 0, std::string(""), true), 0);
+    // A document is rejected wherever the damage is, even past the value found
+    ASSERT_EQ("success", testBinaryThrows(FUNC_VOLT_ARRAY_ELEMENT, std::string("[1, 2"),
+                                          0, "Invalid JSON"));
+    ASSERT_EQ("success", testBinaryThrows(FUNC_VOLT_ARRAY_ELEMENT, std::string("[1, 2"),
+                                          5, "Invalid JSON"));
+    // Text after the document is left to the full parse, which ignores it
+    ASSERT_EQ(testBinary(FUNC_VOLT_ARRAY_ELEMENT, std::string("[1, 2] x"), 0, std::string("1")), 0);
+    ASSERT_EQ("success", testBinaryThrows(FUNC_VOLT_FIELD, std::string("{\"a\": 1, \"b\": [}"),
+                                          std::string("a"), "Invalid JSON"));
+    ASSERT_EQ("success", testBinaryThrows(FUNC_VOLT_FIELD, std::string("[{\"a\": 1}, {]"),
+                                          std::string("[0].a"), "Invalid JSON"));
+
+    ASSERT_EQ(testTernary(FUNC_VOLT_SET_FIELD, std::string("{\"a\": 1}"), std::string("b[1]"),
+                          std::string("\"v\""), std::string("{\"a\":1,\"b\":[null,\"v\"]}")), 0);
+}
+
 static NValue timestampFromString(const std::string& dateString) {
     return ValueFactory::getTimestampValue(NValue::parseTimestampString(dateString));
 }
@@ -986,6 +1039,87 @@ TEST_F(FunctionTest, DateFunctionsAdd) {
     }
 }
 
+TEST_F(FunctionTest, DateFunctionsCivilKernels) {
+    // Walk the supported range in steps that fall at a different time
+    // of day each time, checking the integer kernels against boost.
+    const int64_t step = 7 * MICROS_PER_DAY + 3 * MICROS_PER_HOUR + 17 * MICROS_PER_MINUTE + 13000123;
+    const int monthOffsets[] = { 1, -1, 2, 13, -25, 120 };
+    for (int64_t epochMicros = GREGORIAN_EPOCH; epochMicros <= NYE9999; epochMicros += step) {
+        boost::posix_time::ptime asPtime = EPOCH + boost::posix_time::microseconds(epochMicros);
+        boost::gregorian::date asDate = asPtime.date();
+        boost::posix_time::time_duration asTime = asPtime.time_of_day();
+
+        CivilDate civil;
+        int64_t microsOfDay = civil_from_epoch_micros(epochMicros, civil);
+        ASSERT_EQ(asDate.year(), civil.year);
+        ASSERT_EQ(asDate.month(), civil.month);
+        ASSERT_EQ(asDate.day(), civil.day);
+        ASSERT_EQ(asTime.total_microseconds(), microsOfDay);
+        ASSERT_EQ(days_from_civil(civil.year, civil.month, civil.day), civil.epochDays);
+        ASSERT_EQ(asDate.day_of_week(), day_of_week(civil));
+        ASSERT_EQ(asDate.day_of_year(), day_of_year(civil));
+        ASSERT_EQ(asDate.week_number(), iso_week_number(civil));
+
+        boost::posix_time::ptime startOfDay(asDate);
+        ASSERT_EQ((boost::posix_time::ptime(boost::gregorian::date(asDate.year(), 1, 1)) - EPOCH).total_microseconds(),
+                  truncate_epoch_micros<FUNC_TRUNCATE_YEAR>(epochMicros));
+        ASSERT_EQ((boost::posix_time::ptime(boost::gregorian::date(asDate.year(), asDate.month(), 1)) - EPOCH).total_microseconds(),
+                  truncate_epoch_micros<FUNC_TRUNCATE_MONTH>(epochMicros));
+        ASSERT_EQ((startOfDay - EPOCH).total_microseconds(),
+                  truncate_epoch_micros<FUNC_TRUNCATE_DAY>(epochMicros));
+        ASSERT_EQ((startOfDay + boost::posix_time::hours(asTime.hours()) - EPOCH).total_microseconds(),
+                  truncate_epoch_micros<FUNC_TRUNCATE_HOUR>(epochMicros));
+
+        BOOST_FOREACH(int months, monthOffsets) {
+            boost::posix_time::ptime expected;
+            try {
+                expected = asPtime + boost::gregorian::months(months);
+            } catch (std::out_of_range&) {
+                continue;
+            }
+            ASSERT_EQ((expected - EPOCH).total_microseconds(), addMonths(epochMicros, months));
+        }
+    }
+
+    // Month ends stay month ends, as with boost
+    ASSERT_EQ(epoch_microseconds_from_components(2016, 2, 29), addMonths(epoch_microseconds_from_components(2015, 2, 28), 12));
+    ASSERT_EQ(epoch_microseconds_from_components(2001, 2, 28), addMonths(epoch_microseconds_from_components(2000, 2, 29), 12));
+    ASSERT_EQ(epoch_microseconds_from_components(1900, 3, 31), addMonths(epoch_microseconds_from_components(1900, 2, 28), 1));
+    ASSERT_EQ(epoch_microseconds_from_components(2017, 4, 30), addMonths(epoch_microseconds_from_components(2017, 1, 30), 3));
+
+    // The batch forms match the kernels one value at a time
+    int64_t column[] = { GREGORIAN_EPOCH, -1, 0, 1, INT64_NULL, 1500000000123456, NYE9999 };
+    const size_t count = sizeof(column) / sizeof(column[0]);
+    CivilDate dates[count];
+    civil_from_epoch_micros(column, count, dates);
+    int64_t truncated[count];
+    std::copy(column, column + count, truncated);
+    truncate_epoch_micros<FUNC_TRUNCATE_QUARTER>(truncated, count);
+    for (size_t i = 0; i < count; ++i) {
+        if (column[i] == INT64_NULL) {
+            ASSERT_EQ(INT64_NULL, truncated[i]);
+            continue;
+        }
+        CivilDate expected;
+        civil_from_epoch_micros(column[i], expected);
+        ASSERT_EQ(expected.epochDays, dates[i].epochDays);
+        ASSERT_EQ(expected.year, dates[i].year);
+        ASSERT_EQ(expected.month, dates[i].month);
+        ASSERT_EQ(expected.day, dates[i].day);
+        ASSERT_EQ(truncate_epoch_micros<FUNC_TRUNCATE_QUARTER>(column[i]), truncated[i]);
+    }
+    ASSERT_EQ(epoch_microseconds_from_components(2017, 7, 1), truncated[5]);
+
+    int64_t outOfRange[] = { 0, GREGORIAN_EPOCH - 1 };
+    bool sawException = false;
+    try {
+        truncate_epoch_micros<FUNC_TRUNCATE_DAY>(outOfRange, 2);
+    } catch (const SQLException& exc) {
+        sawException = exc.message().find(getInputOutOfRangeMessage("TRUNCATE")) != std::string::npos;
+    }
+    ASSERT_TRUE(sawException);
+}
+
 static const int64_t MIN_INT64 = std::numeric_limits<int64_t>::min() + 1;
 static const int64_t MAX_INT64 = std::numeric_limits<int64_t>::max();
 
@@ -443,6 +443,70 @@ TEST_F(IndexKeyTest, Int64Packing2Int32sWithSecondNull) {
     voltdb::TupleSchema::freeTupleSchema(keySchema);
 }
 
+TEST_F(IndexKeyTest, PrefixedTupleKey) {
+    std::vector<voltdb::ValueType> columnTypes;
+    std::vector<int32_t> columnLengths;
+    std::vector<bool> columnAllowNull(2, true);
+
+    columnTypes.push_back(voltdb::VALUE_TYPE_VARCHAR);
+    columnTypes.push_back(voltdb::VALUE_TYPE_BIGINT);
+    columnLengths.push_back(300);
+    columnLengths.push_back(NValue::getTupleStorageSize(voltdb::VALUE_TYPE_BIGINT));
+
+    voltdb::TupleSchema *keySchema = voltdb::TupleSchema::createTupleSchemaForTest(columnTypes, columnLengths, columnAllowNull);
+
+    voltdb::PrefixedTupleKey::KeyComparator comparator(keySchema);
+
+    // Strings that tie, differ, or end within the 8 prefix bytes,
+    // including embedded NULs, which NValue compares like C strings.
+    std::vector<NValue> strings;
+    strings.push_back(ValueFactory::getNullStringValue());
+    strings.push_back(ValueFactory::getStringValue(""));
+    strings.push_back(ValueFactory::getStringValue("a"));
+    strings.push_back(ValueFactory::getStringValue("abcdefg"));
+    strings.push_back(ValueFactory::getStringValue("abcdefgh"));
+    strings.push_back(ValueFactory::getStringValue("abcdefgha"));
+    strings.push_back(ValueFactory::getStringValue("abcdefghb"));
+    strings.push_back(ValueFactory::getStringValue("http://www.example.com/a"));
+    strings.push_back(ValueFactory::getStringValue("http://www.example.com/b"));
+    strings.push_back(ValueFactory::getStringValue(std::string("ab\0c", 4)));
+    strings.push_back(ValueFactory::getStringValue(std::string("ab\0d", 4)));
+    strings.push_back(ValueFactory::getStringValue(std::string("ab\0", 3)));
+    strings.push_back(ValueFactory::getStringValue("ab"));
+    strings.push_back(ValueFactory::getStringValue("\xc3\xa9t\xc3\xa9"));
+
+    std::vector<voltdb::TableTuple> tuples;
+    for (size_t ii = 0; ii < strings.size(); ++ii) {
+        for (int64_t second = 0; second < 2; ++second) {
+            voltdb::TableTuple tuple(keySchema);
+            tuple.move(new char[tuple.tupleLength()]);
+            tuple.setNValue(0, strings[ii]);
+            tuple.setNValue(1, ValueFactory::getBigIntValue(second));
+            tuples.push_back(tuple);
+        }
+    }
+
+    for (size_t ii = 0; ii < tuples.size(); ++ii) {
+        voltdb::PrefixedTupleKey lhs(&tuples[ii]);
+        for (size_t jj = 0; jj < tuples.size(); ++jj) {
+            voltdb::PrefixedTupleKey rhs(&tuples[jj]);
+            int expected = tuples[ii].getNValue(0).compare(tuples[jj].getNValue(0));
+            if (expected == 0) {
+                expected = tuples[ii].getNValue(1).compare(tuples[jj].getNValue(1));
+            }
+            EXPECT_EQ(expected, comparator(lhs, rhs));
+        }
+    }
+
+    for (size_t ii = 0; ii < tuples.size(); ++ii) {
+        delete [] tuples[ii].address();
+    }
+    for (size_t ii = 0; ii < strings.size(); ++ii) {
+        strings[ii].free();
+    }
+    voltdb::TupleSchema::freeTupleSchema(keySchema);
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
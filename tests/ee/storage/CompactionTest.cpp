@@ -599,6 +599,177 @@ TEST_F(CompactionTest, TestENG897) {
     //m_table->printBucketInfo();
 }
 #endif
+/**
+ * Deletes released with incremental compaction on leave the table as it
+ * is; budgeted slices then compact it without going over their budgets.
+ */
+TEST_F(CompactionTest, BudgetedCompaction) {
+    initTable();
+#ifdef MEMCHECK
+    int tupleCount = 1000;
+    const int64_t budget = 50;
+#else
+    int tupleCount = 645260;
+    const int64_t budget = 10000;
+#endif
+    addRandomUniqueTuples(m_table, tupleCount);
+    m_table->setIncrementalCompaction(true);
+
+    m_engine->setUndoToken(m_undoToken);
+    ExecutorContext::getExecutorContext()->setupForPlanFragments(m_engine->getCurrentUndoQuantum(), 0, 0, 0, 0, false);
+    stx::btree_set<int32_t> pkeysNotDeleted;
+    voltdb::TableIndex *pkeyIndex = m_table->primaryKeyIndex();
+    TableTuple key(pkeyIndex->getKeySchema());
+    boost::scoped_array<char> backingStore(new char[pkeyIndex->getKeySchema()->tupleLength()]);
+    key.moveNoHeader(backingStore.get());
+    IndexCursor indexCursor(pkeyIndex->getTupleSchema());
+    for (int ii = 0; ii < tupleCount; ii++) {
+        if (ii % 4 == 0) {
+            pkeysNotDeleted.insert(ii);
+            continue;
+        }
+        key.setNValue(0, ValueFactory::getIntegerValue(ii));
+        ASSERT_TRUE(pkeyIndex->moveToKey(&key, indexCursor));
+        TableTuple tuple = pkeyIndex->nextValueAtKey(indexCursor);
+        m_table->deleteTuple(tuple, true);
+    }
+    m_engine->releaseUndoToken(m_undoToken);
+    m_engine->setUndoToken(++m_undoToken);
+    ExecutorContext::getExecutorContext()->setupForPlanFragments(m_engine->getCurrentUndoQuantum(), 0, 0, 0, 0, false);
+
+    const size_t blockCount = m_table->allocatedBlockCount();
+    ASSERT_TRUE(m_table->compactionPredicate());
+    ASSERT_EQ(0, m_table->compactionTuplesMoved());
+    ASSERT_TRUE(m_table->reclaimableBlockCount() > 0);
+    std::vector<size_t> histogram;
+    m_table->blockLoadHistogram(histogram);
+    ASSERT_EQ(TUPLE_BLOCK_NUM_BUCKETS + 1, histogram.size());
+    size_t histogramBlocks = 0;
+    for (size_t ii = 0; ii < histogram.size(); ii++) {
+        histogramBlocks += histogram[ii];
+    }
+    ASSERT_EQ(blockCount, histogramBlocks);
+
+    int64_t totalMoved = 0;
+    int slices = 0;
+    while (true) {
+        int64_t moved = m_table->doBudgetedCompaction(budget);
+        ASSERT_TRUE(moved <= budget);
+        if (moved == 0) {
+            break;
+        }
+        totalMoved += moved;
+        slices++;
+    }
+    ASSERT_TRUE(slices > 1);
+    ASSERT_FALSE(m_table->compactionPredicate());
+    ASSERT_EQ(totalMoved, m_table->compactionTuplesMoved());
+    ASSERT_TRUE(m_table->allocatedBlockCount() < blockCount);
+    ASSERT_EQ(blockCount - m_table->allocatedBlockCount(), m_table->compactionBlocksReclaimed());
+
+    // The stats report the work done
+    std::vector<std::string> columnNames = CompactionStats::generateCompactionStatsColumnNames();
+    int tuplesMovedColumn = static_cast<int>(std::find(columnNames.begin(), columnNames.end(),
+                                                       "TUPLES_MOVED") - columnNames.begin());
+    int blocksReclaimedColumn = static_cast<int>(std::find(columnNames.begin(), columnNames.end(),
+                                                           "BLOCKS_RECLAIMED") - columnNames.begin());
+    TableTuple *statsTuple = m_table->getCompactionStats()->getStatsTuple(false, 0);
+    ASSERT_EQ(totalMoved, ValuePeeker::peekBigInt(statsTuple->getNValue(tuplesMovedColumn)));
+    ASSERT_EQ(m_table->compactionBlocksReclaimed(),
+              ValuePeeker::peekBigInt(statsTuple->getNValue(blocksReclaimedColumn)));
+
+    // Every remaining tuple is still found through every index
+    stx::btree_set<int32_t> pkeysFound;
+    TableIterator& iter = m_table->iterator();
+    TableTuple tuple(m_table->schema());
+    while (iter.next(tuple)) {
+        int32_t pkey = ValuePeeker::peekAsInteger(tuple.getNValue(0));
+        key.setNValue(0, ValueFactory::getIntegerValue(pkey));
+        for (int ii = 0; ii < 4; ii++) {
+            ASSERT_TRUE(m_table->m_indexes[ii]->moveToKey(&key, indexCursor));
+            TableTuple indexTuple = m_table->m_indexes[ii]->nextValueAtKey(indexCursor);
+            ASSERT_EQ(indexTuple.address(), tuple.address());
+        }
+        pkeysFound.insert(pkey);
+    }
+    ASSERT_TRUE(pkeysFound == pkeysNotDeleted);
+}
+
+TEST_F(CompactionTest, ColdTier) {
+    initTable();
+    const int tuplesPerBlock = m_table->getTuplesPerBlock();
+    const int tupleCount = tuplesPerBlock * 4 + tuplesPerBlock / 2;
+    addRandomUniqueTuples(m_table, tupleCount);
+    ASSERT_EQ(5, m_table->allocatedBlockCount());
+    // Blocks filled before the tier is enabled can go too
+    m_table->enableColdTier("/tmp", 2);
+
+    // Every block was just written to, and has to sit out two ticks
+    ASSERT_EQ(0, m_table->tierColdBlocks(100));
+    ASSERT_EQ(0, m_table->tierColdBlocks(100));
+
+    // Changing a tuple in place keeps its block warm for two more ticks
+    m_engine->setUndoToken(m_undoToken);
+    ExecutorContext::getExecutorContext()->setupForPlanFragments(m_engine->getCurrentUndoQuantum(), 0, 0, 0, 0, false);
+    voltdb::TableIndex *pkeyIndex = m_table->primaryKeyIndex();
+    TableTuple key(pkeyIndex->getKeySchema());
+    boost::scoped_array<char> backingStore(new char[pkeyIndex->getKeySchema()->tupleLength()]);
+    key.moveNoHeader(backingStore.get());
+    IndexCursor indexCursor(pkeyIndex->getTupleSchema());
+    // The first tuple inserted is in the first block filled
+    key.setNValue(0, ValueFactory::getIntegerValue(0));
+    ASSERT_TRUE(pkeyIndex->moveToKey(&key, indexCursor));
+    TableTuple updated = pkeyIndex->nextValueAtKey(indexCursor);
+    TableTuple tempTuple = m_table->tempTuple();
+    tempTuple.copy(updated);
+    tempTuple.setNValue(1, ValueFactory::getIntegerValue(::rand()));
+    m_table->updateTuple(updated, tempTuple);
+    m_engine->releaseUndoToken(m_undoToken);
+    m_engine->setUndoToken(++m_undoToken);
+
+    // The other three full blocks go, but no more per tick than asked for;
+    // the updated block follows once it has sat out its ticks, and the half
+    // full last block stays
+    ASSERT_EQ(2, m_table->tierColdBlocks(2));
+    ASSERT_EQ(1, m_table->tierColdBlocks(100));
+    ASSERT_EQ(1, m_table->tierColdBlocks(100));
+    ASSERT_EQ(0, m_table->tierColdBlocks(100));
+    ASSERT_EQ(4, m_table->coldBlockCount());
+    ASSERT_EQ(5, m_table->allocatedBlockCount());
+
+    // Every tuple is still there, at the address every index has for it
+    stx::btree_set<int32_t> pkeysFound;
+    TableIterator& iter = m_table->iterator();
+    TableTuple tuple(m_table->schema());
+    while (iter.next(tuple)) {
+        int32_t pkey = ValuePeeker::peekAsInteger(tuple.getNValue(0));
+        key.setNValue(0, ValueFactory::getIntegerValue(pkey));
+        for (int ii = 0; ii < 4; ii++) {
+            ASSERT_TRUE(m_table->m_indexes[ii]->moveToKey(&key, indexCursor));
+            TableTuple indexTuple = m_table->m_indexes[ii]->nextValueAtKey(indexCursor);
+            ASSERT_EQ(indexTuple.address(), tuple.address());
+        }
+        pkeysFound.insert(pkey);
+    }
+    ASSERT_EQ(tupleCount, pkeysFound.size());
+    ASSERT_EQ(0, *pkeysFound.begin());
+    ASSERT_EQ(tupleCount - 1, *pkeysFound.rbegin());
+
+    // Cold blocks can still be changed, and give their slots back once emptied
+    m_engine->setUndoToken(m_undoToken);
+    ExecutorContext::getExecutorContext()->setupForPlanFragments(m_engine->getCurrentUndoQuantum(), 0, 0, 0, 0, false);
+    for (int ii = 0; ii < tupleCount; ii++) {
+        key.setNValue(0, ValueFactory::getIntegerValue(ii));
+        ASSERT_TRUE(pkeyIndex->moveToKey(&key, indexCursor));
+        TableTuple tuple = pkeyIndex->nextValueAtKey(indexCursor);
+        m_table->deleteTuple(tuple, true);
+    }
+    m_engine->releaseUndoToken(m_undoToken);
+    m_engine->setUndoToken(++m_undoToken);
+    ASSERT_EQ(0, m_table->activeTupleCount());
+    ASSERT_EQ(0, m_table->coldBlockCount());
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
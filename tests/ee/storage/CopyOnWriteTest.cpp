@@ -1097,6 +1097,32 @@ public:
         ASSERT_EQ(expected,activated);
     }
 
+    /**
+     * Stream one buffer of the given type and add the rows to the value set.
+     * Return what streamMore() returned.
+     */
+    int64_t streamValues(TableStreamType streamType, T_ValueSet &values) {
+        TupleOutputStreamProcessor outputStreams(m_serializationBuffer, sizeof(m_serializationBuffer));
+        std::vector<int> retPositions;
+        int64_t remaining = m_table->streamMore(outputStreams, streamType, retPositions);
+        const size_t serialized = outputStreams.at(0).position();
+        for (size_t ii = sizeof(int32_t)*3; // skip partition id, row count, and first tuple length
+             ii + sizeof(int64_t) <= serialized;
+             ii += m_tupleWidth + sizeof(int32_t)) {
+            int pair[2];
+            pair[0] = ntohl(*reinterpret_cast<const int32_t*>(&m_serializationBuffer[ii]));
+            pair[1] = ntohl(*reinterpret_cast<const int32_t*>(&m_serializationBuffer[ii + 4]));
+            void *pairVoid = reinterpret_cast<void*>(pair);
+            const bool inserted = values.insert(*reinterpret_cast<const int64_t*>(pairVoid)).second;
+            if (!inserted) {
+                printf("%s streamed %d/%d twice\n", tableStreamTypeToString(streamType).c_str(),
+                       pair[0], pair[1]);
+            }
+            EXPECT_TRUE(inserted);
+        }
+        return remaining;
+    }
+
     voltdb::VoltDBEngine *m_engine;
     voltdb::TupleSchema *m_tableSchema;
     voltdb::PersistentTable *m_table;
@@ -1595,6 +1621,111 @@ TEST_F(CopyOnWriteTest, BufferBoundaryCondition) {
     ASSERT_EQ(origPendingCount, curPendingCount);
 }
 
+/**
+ * Run a point-in-time read alongside a snapshot while the table is mutated
+ * and undone between buffers; both must deliver the table as it was.
+ */
+TEST_F(CopyOnWriteTest, SnapshotReadWithSnapshot) {
+    initTable(1, 0);
+    int tupleCount = TUPLE_COUNT;
+    addRandomUniqueTuples(m_table, tupleCount);
+    m_engine->setUndoToken(0);
+    ExecutorContext::getExecutorContext()->setupForPlanFragments(m_engine->getCurrentUndoQuantum(),
+                                                                 0, 0, 0, 0, false);
+    for (int qq = 0; qq < NUM_REPETITIONS; qq++) {
+        T_ValueSet originalTuples;
+        getTableValueSet(originalTuples);
+
+        char config[4];
+        ::memset(config, 0, 4);
+        ReferenceSerializeInputBE readInput(config, 4);
+        ASSERT_TRUE(m_table->activateStream(TABLE_STREAM_SNAPSHOT_READ, 0, m_tableId, readInput));
+        // Only one read of a table at a time.
+        ReferenceSerializeInputBE secondReadInput(config, 4);
+        ASSERT_FALSE(m_table->activateStream(TABLE_STREAM_SNAPSHOT_READ, 0, m_tableId, secondReadInput));
+        ReferenceSerializeInputBE snapshotInput(config, 4);
+        ASSERT_TRUE(m_table->activateStream(TABLE_STREAM_SNAPSHOT, 0, m_tableId, snapshotInput));
+
+        T_ValueSet readTuples;
+        T_ValueSet COWTuples;
+        bool readDone = false;
+        bool snapshotDone = false;
+        while (!readDone || !snapshotDone) {
+            if (!readDone) {
+                readDone = streamValues(TABLE_STREAM_SNAPSHOT_READ, readTuples) <= 0;
+            }
+            if (!snapshotDone) {
+                snapshotDone = streamValues(TABLE_STREAM_SNAPSHOT, COWTuples) <= 0;
+            }
+            for (int jj = 0; jj < NUM_MUTATIONS; jj++) {
+                doRandomTableMutation(m_table);
+            }
+            doRandomUndo();
+        }
+
+        checkTuples(tupleCount + (m_tuplesInserted - m_tuplesDeleted), originalTuples, readTuples);
+        checkTuples(0, originalTuples, COWTuples);
+    }
+}
+
+/**
+ * Compact the table part way through a point-in-time read. Tuples moved
+ * from ahead of the scan to behind it must still be read, and tuples moved
+ * the other way must not be read twice.
+ */
+TEST_F(CopyOnWriteTest, SnapshotReadWithCompaction) {
+    initTable(1, 0);
+    int tupleCount = TUPLE_COUNT;
+    addRandomUniqueTuples(m_table, tupleCount);
+    m_engine->setUndoToken(0);
+    ExecutorContext::getExecutorContext()->setupForPlanFragments(m_engine->getCurrentUndoQuantum(),
+                                                                 0, 0, 0, 0, false);
+    T_ValueSet originalTuples;
+    getTableValueSet(originalTuples);
+
+    char config[4];
+    ::memset(config, 0, 4);
+    ReferenceSerializeInputBE input(config, 4);
+    ASSERT_TRUE(m_table->activateStream(TABLE_STREAM_SNAPSHOT_READ, 0, m_tableId, input));
+
+    T_ValueSet readTuples;
+    bool done = streamValues(TABLE_STREAM_SNAPSHOT_READ, readTuples) <= 0;
+    bool compacted = false;
+    while (!done) {
+        if (!compacted) {
+            // Thin the table out enough for compaction to merge blocks.
+            std::vector<char*> victims;
+            voltdb::TableIterator& iterator = m_table->iterator();
+            TableTuple tuple(m_table->schema());
+            while (iterator.next(tuple)) {
+                if (::rand() % 2 == 0) {
+                    victims.push_back(tuple.address());
+                }
+            }
+            for (size_t jj = 0; jj < victims.size(); jj++) {
+                tuple.move(victims[jj]);
+                m_table->deleteTuple(tuple, true);
+                m_tuplesDeleted++;
+            }
+            for (int jj = 0; jj < NUM_MUTATIONS; jj++) {
+                doRandomInsert(m_table);
+            }
+            // Releasing the deletes compacts the table.
+            size_t blockCount = m_table->allocatedBlockCount();
+            m_engine->releaseUndoToken(m_undoToken);
+            m_engine->setUndoToken(++m_undoToken);
+            ExecutorContext::getExecutorContext()->setupForPlanFragments(m_engine->getCurrentUndoQuantum(),
+                                                                         0, 0, 0, 0, false);
+            doForcedCompaction(m_table);
+            ASSERT_TRUE(m_table->allocatedBlockCount() < blockCount);
+            compacted = true;
+        }
+        done = streamValues(TABLE_STREAM_SNAPSHOT_READ, readTuples) <= 0;
+    }
+
+    checkTuples(tupleCount + (m_tuplesInserted - m_tuplesDeleted), originalTuples, readTuples);
+}
+
 /**
  * Dummy TableStreamer for intercepting and tracking tuple notifications.
  */
@@ -1993,6 +2124,198 @@ TEST_F(CopyOnWriteTest, ElasticIndexLowerUpperBounds) {
     ASSERT_TRUE(index.createUpperBoundIterator(3) == index.end());
 }
 
+/**
+ * Keys spread over many partitions still iterate and search in hash order.
+ */
+TEST_F(CopyOnWriteTest, ElasticIndexPartitionOrder) {
+    const size_t NUM_KEYS = 20000;
+    ElasticIndex index(NUM_KEYS);
+    ASSERT_TRUE(index.partitionCount() > 1);
+    char *base = reinterpret_cast<char*>(&index);
+    std::vector<ElasticIndexKey> keys;
+    for (size_t ii = 0; ii < NUM_KEYS; ii++) {
+        ElasticIndexKey key(static_cast<int32_t>(::rand() % 1000000000 - 500000000) * 2, base + ii);
+        if (index.add(key)) {
+            keys.push_back(key);
+        }
+    }
+    ASSERT_EQ(keys.size(), index.size());
+    std::sort(keys.begin(), keys.end(), ElasticIndexComparator());
+
+    // Drop every third key.
+    std::vector<ElasticIndexKey> remaining;
+    for (size_t ii = 0; ii < keys.size(); ii++) {
+        if (ii % 3 == 0) {
+            ASSERT_TRUE(index.erase(keys[ii]) == 1);
+        }
+        else {
+            remaining.push_back(keys[ii]);
+        }
+    }
+    index.compact();
+    ASSERT_EQ(remaining.size(), index.size());
+
+    size_t position = 0;
+    for (ElasticIndex::const_iterator iter = index.begin(); iter != index.end(); ++iter) {
+        ASSERT_TRUE(position < remaining.size());
+        ASSERT_TRUE(*iter == remaining[position]);
+        position++;
+    }
+    ASSERT_EQ(remaining.size(), position);
+
+    for (size_t ii = 0; ii < remaining.size(); ii += 97) {
+        // Odd hashes fall between keys.
+        int32_t hash = remaining[ii].getHash() - 1;
+        ElasticIndex::const_iterator lower = index.createLowerBoundIterator(hash);
+        ASSERT_TRUE(lower != index.end());
+        ASSERT_TRUE(*lower == *std::lower_bound(remaining.begin(), remaining.end(),
+                                                ElasticIndexKey(hash, (uintptr_t)0),
+                                                ElasticIndexComparator()));
+        ElasticIndex::const_iterator upper = index.createUpperBoundIterator(remaining[ii].getHash());
+        std::vector<ElasticIndexKey>::iterator expected =
+            std::upper_bound(remaining.begin(), remaining.end(),
+                             ElasticIndexKey(remaining[ii].getHash(), std::numeric_limits<uintptr_t>::max()),
+                             ElasticIndexComparator());
+        if (expected == remaining.end()) {
+            ASSERT_TRUE(upper == index.end());
+        }
+        else {
+            ASSERT_TRUE(*upper == *expected);
+        }
+    }
+}
+
+/**
+ * Build an index from a million keys whose hashes arrive in random order,
+ * as they do from the table scan, starting from an index sized for far
+ * fewer keys, so that the partitions have to grow along the way.
+ */
+TEST_F(CopyOnWriteTest, ElasticIndexRandomHashes) {
+    const size_t NUM_KEYS = 1000000;
+    ElasticIndex index;
+    const size_t initialPartitions = index.partitionCount();
+    char *base = reinterpret_cast<char*>(&index);
+    std::vector<ElasticIndexKey> keys;
+    keys.reserve(NUM_KEYS);
+    for (size_t ii = 0; ii < NUM_KEYS; ii++) {
+        ElasticIndexKey key(static_cast<int32_t>((::rand() << 16) ^ ::rand()), base + ii);
+        ASSERT_TRUE(index.add(key));
+        keys.push_back(key);
+    }
+    ASSERT_TRUE(index.partitionCount() > initialPartitions);
+
+    // Adding a key again while it sits in an unsorted tail keeps one copy.
+    index.add(keys[NUM_KEYS - 1]);
+    ASSERT_EQ(NUM_KEYS, index.size());
+    ASSERT_FALSE(index.add(keys[NUM_KEYS - 1]));
+
+    std::sort(keys.begin(), keys.end(), ElasticIndexComparator());
+    size_t position = 0;
+    for (ElasticIndex::const_iterator iter = index.begin(); iter != index.end(); ++iter) {
+        ASSERT_TRUE(*iter == keys[position]);
+        position++;
+    }
+    ASSERT_EQ(NUM_KEYS, position);
+
+    for (size_t ii = 0; ii < NUM_KEYS; ii += 1009) {
+        ASSERT_TRUE(index.exists(keys[ii]));
+        ASSERT_TRUE(index.erase(keys[ii]) == 1);
+        ASSERT_FALSE(index.exists(keys[ii]));
+    }
+}
+
+/**
+ * Materialize two hash ranges of the elastic index side by side, each into
+ * its own output stream, in buffers small enough to take several calls.
+ */
+TEST_F(CopyOnWriteTest, ElasticIndexReadMultipleRanges) {
+    const int NUM_PARTITIONS = 1;
+    const int TUPLES_PER_BLOCK = 50;
+    const int NUM_INITIAL = 300;
+    const int NUM_CYCLES = 100;
+    const int FREQ_INSERT = 1;
+    const int FREQ_DELETE = 10;
+    const int FREQ_UPDATE = 5;
+    const int FREQ_COMPACTION = 100;
+    const int32_t maxint = std::numeric_limits<int32_t>::max();
+    const int32_t minint = std::numeric_limits<int32_t>::min();
+
+    ElasticTableScrambler tableScrambler(*this,
+                                         NUM_PARTITIONS, TUPLES_PER_BLOCK, NUM_INITIAL,
+                                         FREQ_INSERT, FREQ_DELETE,
+                                         FREQ_UPDATE, FREQ_COMPACTION);
+    tableScrambler.initialize();
+
+    std::vector<std::string> predicateStrings;
+    predicateStrings.push_back(generateHashRangePredicate(T_HashRange(minint, maxint)));
+    streamElasticIndex(predicateStrings, true);
+    for (size_t icycle = 0; icycle < NUM_CYCLES; icycle++) {
+        tableScrambler.scramble();
+    }
+    const size_t indexSize = getElasticIndex()->size();
+    ASSERT_EQ(m_table->activeTupleCount(), indexSize);
+
+    // Overlapping ranges can't be streamed side by side.
+    {
+        ReferenceSerializeOutput rangeOutput(m_hashRangeBuffer, sizeof(m_hashRangeBuffer));
+        rangeOutput.writeInt(2);
+        rangeOutput.writeTextString("0:1000");
+        rangeOutput.writeTextString("500:2000");
+        ReferenceSerializeInputBE rangeInput(m_hashRangeBuffer, rangeOutput.position());
+        ASSERT_FALSE(m_table->activateStream(TABLE_STREAM_ELASTIC_INDEX_READ, 0, m_tableId, rangeInput));
+    }
+
+    const T_HashRange ranges[2] = { T_HashRange(minint, -1), T_HashRange(0, maxint) };
+    ReferenceSerializeOutput rangeOutput(m_hashRangeBuffer, sizeof(m_hashRangeBuffer));
+    rangeOutput.writeInt(2);
+    for (int irange = 0; irange < 2; irange++) {
+        std::ostringstream rangeString;
+        rangeString << ranges[irange].first << ':' << ranges[irange].second;
+        rangeOutput.writeTextString(rangeString.str());
+    }
+    ReferenceSerializeInputBE rangeInput(m_hashRangeBuffer, rangeOutput.position());
+    m_engine->setUndoToken(m_undoToken);
+    ASSERT_TRUE(m_table->activateStream(TABLE_STREAM_ELASTIC_INDEX_READ, 0, m_tableId, rangeInput));
+
+    const size_t bufferSize = 1024;
+    char buffers[2][bufferSize];
+    T_ValueSet streamed;
+    size_t nCalls = 0;
+    int64_t remaining = 1;
+    while (remaining > 0) {
+        TupleOutputStreamProcessor outputStreams(2);
+        outputStreams.add(buffers[0], bufferSize);
+        outputStreams.add(buffers[1], bufferSize);
+        std::vector<int> retPositions;
+        remaining = m_table->streamMore(outputStreams, TABLE_STREAM_ELASTIC_INDEX_READ, retPositions);
+        ASSERT_LE(0, remaining);
+        ASSERT_EQ(outputStreams.size(), retPositions.size());
+        nCalls++;
+        for (int irange = 0; irange < 2; irange++) {
+            const char *buffer = buffers[irange];
+            for (size_t ii = sizeof(int32_t)*3; // skip partition id, row count, and first tuple length
+                 ii + sizeof(int32_t) < retPositions[irange];
+                 ii += m_tupleWidth + sizeof(int32_t)) {
+                int32_t value = ntohl(*reinterpret_cast<const int32_t*>(&buffer[ii]));
+                // The index hashes the partition column the way the hashinator does.
+                int32_t hash = ValueFactory::getIntegerValue(value).murmurHash3();
+                ASSERT_TRUE(hash >= ranges[irange].first && hash <= ranges[irange].second);
+                ASSERT_TRUE(streamed.insert(value).second);
+            }
+        }
+    }
+    ASSERT_LE(2, nCalls);
+    ASSERT_EQ(indexSize, streamed.size());
+
+    // Releasing the deletes of the streamed tuples empties the index.
+    m_engine->releaseUndoToken(m_undoToken);
+    ExecutorContext::getExecutorContext()->setupForPlanFragments(m_engine->getCurrentUndoQuantum(),
+                                                                 0, 0, 0, 0, false);
+    m_undoToken++;
+    ASSERT_EQ(0, getElasticIndex()->size());
+    ASSERT_EQ(0, m_table->activeTupleCount());
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
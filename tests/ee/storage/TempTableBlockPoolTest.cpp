@@ -0,0 +1,155 @@
+/* This file is part of VoltDB.
+ * Copyright (C) 2008-2017 VoltDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "storage/TempTableBlockPool.h"
+
+#include "harness.h"
+#include "common/TupleSchema.h"
+#include "common/types.h"
+#include "execution/VoltDBEngine.h"
+#include "storage/tablefactory.h"
+#include "storage/tableutil.h"
+#include "storage/temptable.h"
+
+#include <boost/scoped_ptr.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace voltdb;
+
+class TempTableBlockPoolTest : public Test
+{
+public:
+    TempTable* createTempTable() {
+        std::vector<ValueType> types(3, VALUE_TYPE_BIGINT);
+        std::vector<int32_t> lengths(3, NValue::getTupleStorageSize(VALUE_TYPE_BIGINT));
+        std::vector<bool> allowNull(3, true);
+        TupleSchema* schema = TupleSchema::createTupleSchemaForTest(types, lengths, allowNull);
+        std::vector<std::string> names;
+        names.push_back("A");
+        names.push_back("B");
+        names.push_back("C");
+        return TableFactory::buildTempTable("T", schema, names, NULL);
+    }
+};
+
+TEST_F(TempTableBlockPoolTest, ReusesStorage)
+{
+    TempTableBlockPool pool;
+    char* first = pool.acquire(1024);
+    EXPECT_EQ(1, pool.misses());
+    pool.release(first, 1024);
+    EXPECT_EQ(1024, pool.memoryHeld());
+
+    // Only storage of the same size is reused
+    char* second = pool.acquire(2048);
+    EXPECT_EQ(2, pool.misses());
+    char* third = pool.acquire(1024);
+    EXPECT_EQ(first, third);
+    EXPECT_EQ(1, pool.hits());
+    EXPECT_EQ(0, pool.memoryHeld());
+
+    pool.release(second, 2048);
+    pool.release(third, 1024);
+    EXPECT_EQ(3072, pool.memoryHeld());
+    EXPECT_EQ(3072, pool.peakMemoryHeld());
+    EXPECT_EQ(0, pool.discards());
+}
+
+TEST_F(TempTableBlockPoolTest, KeepsWithinMemoryLimit)
+{
+    TempTableBlockPool pool;
+    pool.setMemoryLimit(2048);
+    char* storage[3];
+    for (int i = 0; i < 3; ++i) {
+        storage[i] = pool.acquire(1024);
+    }
+    for (int i = 0; i < 3; ++i) {
+        pool.release(storage[i], 1024);
+    }
+    EXPECT_EQ(2048, pool.memoryHeld());
+    EXPECT_EQ(1, pool.discards());
+
+    // Lowering the limit frees what is held beyond it
+    pool.setMemoryLimit(1024);
+    EXPECT_EQ(1024, pool.memoryHeld());
+    pool.setMemoryLimit(0);
+    EXPECT_EQ(0, pool.memoryHeld());
+
+    // Nothing is kept under a zero limit
+    pool.release(pool.acquire(1024), 1024);
+    EXPECT_EQ(0, pool.memoryHeld());
+    EXPECT_EQ(2, pool.discards());
+}
+
+TEST_F(TempTableBlockPoolTest, Prefault)
+{
+    TempTableBlockPool pool;
+    pool.setMemoryLimit(4096);
+    pool.prefault(1024, 10);
+    EXPECT_EQ(4096, pool.memoryHeld());
+    char* storage[4];
+    for (int i = 0; i < 4; ++i) {
+        storage[i] = pool.acquire(1024);
+    }
+    EXPECT_EQ(4, pool.hits());
+    EXPECT_EQ(0, pool.misses());
+    for (int i = 0; i < 4; ++i) {
+        pool.release(storage[i], 1024);
+    }
+}
+
+TEST_F(TempTableBlockPoolTest, TempTablesRecycleBlocks)
+{
+    boost::scoped_ptr<VoltDBEngine> engine(new VoltDBEngine());
+    engine->initialize(1, 1, 0, 0, "", 0, 1024, DEFAULT_TEMP_TABLE_MEMORY, false);
+    TempTableBlockPool* pool = engine->getTempTableBlockPool();
+
+    boost::scoped_ptr<TempTable> table(createTempTable());
+    const int64_t blockSize = table->getTableAllocationSize();
+    const int tuples = 3 * table->getTuplesPerBlock();
+    ASSERT_TRUE(tableutil::addRandomTuples(table.get(), tuples));
+    const int64_t misses = pool->misses();
+    const int64_t held = pool->memoryHeld();
+    table.reset();
+    EXPECT_EQ(held + 3 * blockSize, pool->memoryHeld());
+
+    // The next temp table takes its blocks from the pool
+    const int64_t hits = pool->hits();
+    table.reset(createTempTable());
+    ASSERT_TRUE(tableutil::addRandomTuples(table.get(), tuples));
+    EXPECT_EQ(hits + 3, pool->hits());
+    EXPECT_EQ(misses, pool->misses());
+    EXPECT_EQ(held, pool->memoryHeld());
+
+    // Without a limit nothing is kept
+    engine->setTempTableBlockPool(0, 0);
+    table.reset();
+    EXPECT_EQ(0, pool->memoryHeld());
+}
+
+int main()
+{
+    return TestSuite::globalInstance()->runAll();
+}
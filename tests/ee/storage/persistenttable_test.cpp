@@ -26,6 +26,7 @@
 #include "harness.h"
 #include "test_utils/ScopedTupleSchema.hpp"
 
+#include "common/StringDictionary.h"
 #include "common/tabletuple.h"
 #include "common/TupleSchemaBuilder.h"
 #include "common/types.h"
@@ -786,6 +787,90 @@ TEST_F(PersistentTableTest, SwapTablesTest) {
     rollback();
 }
 
+TEST_F(PersistentTableTest, StringDictionaryTest) {
+    VoltDBEngine* engine = getEngine();
+    engine->loadCatalog(0, catalogPayload());
+    PersistentTable* table = engine->getTableDelegate("T")->getPersistentTable();
+    ASSERT_NE(NULL, table);
+
+    // Only the uninlined VARCHAR column can share its values
+    ASSERT_FALSE(table->enableStringDictionary(0));
+    ASSERT_TRUE(table->enableStringDictionary(1));
+    ASSERT_TRUE(table->stringDictionary(0) == NULL);
+    const voltdb::StringDictionary* dictionary = table->stringDictionary(1);
+    ASSERT_TRUE(dictionary != NULL);
+
+    const voltdb::TupleSchema* schema = table->schema();
+    voltdb::StandAloneTupleStorage storage(schema);
+    TableTuple &srcTuple = const_cast<TableTuple&>(storage.tuple());
+
+    const char* colors[] = { "red", "green", "red", "blue", "red", "green" };
+    const int rowCount = 6;
+    beginWork();
+    for (int i = 0; i < rowCount; ++i) {
+        srcTuple.setNValue(0, ValueFactory::getBigIntValue(i));
+        srcTuple.setNValue(1, ValueFactory::getTempStringValue(colors[i]));
+        table->insertTuple(srcTuple);
+    }
+    commit();
+    ASSERT_EQ(3, dictionary->entryCount());
+    // Every string is stored once, in the dictionary
+    ASSERT_EQ(dictionary->memorySize(), table->nonInlinedMemorySize());
+
+    std::vector<NValue> values;
+    TableTuple tuple(schema);
+    auto iterator = table->iteratorDeletingAsWeGo();
+    while (iterator.next(tuple)) {
+        values.push_back(tuple.getNValue(1));
+    }
+    ASSERT_EQ(rowCount, values.size());
+    for (int i = 0; i < rowCount; ++i) {
+        NValue expected = ValueFactory::getTempStringValue(colors[i]);
+        EXPECT_EQ(0, values[i].compare(expected));
+        std::size_t sharedHash = 0;
+        values[i].hashCombine(sharedHash);
+        std::size_t expectedHash = 0;
+        expected.hashCombine(expectedHash);
+        EXPECT_EQ(expectedHash, sharedHash);
+        for (int j = 0; j < rowCount; ++j) {
+            bool same = ::strcmp(colors[i], colors[j]) == 0;
+            EXPECT_EQ(same, values[i].op_equals(values[j]).isTrue());
+            EXPECT_EQ(!same, values[i].op_notEquals(values[j]).isTrue());
+        }
+    }
+
+    // A new value that is rolled back leaves no entry behind
+    beginWork();
+    iterator = table->iteratorDeletingAsWeGo();
+    ASSERT_TRUE(iterator.next(tuple));
+    TableTuple& tempTuple = table->copyIntoTempTuple(tuple);
+    tempTuple.setNValue(1, ValueFactory::getTempStringValue("purple"));
+    table->updateTupleWithSpecificIndexes(tuple, tempTuple, table->allIndexes());
+    ASSERT_EQ(4, dictionary->entryCount());
+    rollback();
+    ASSERT_EQ(3, dictionary->entryCount());
+
+    // Updating both "green" rows to "red" frees the "green" entry
+    beginWork();
+    iterator = table->iteratorDeletingAsWeGo();
+    while (iterator.next(tuple)) {
+        if (tuple.getNValue(1).compare(ValueFactory::getTempStringValue("green")) == 0) {
+            TableTuple& updated = table->copyIntoTempTuple(tuple);
+            updated.setNValue(1, ValueFactory::getTempStringValue("red"));
+            table->updateTupleWithSpecificIndexes(tuple, updated, table->allIndexes());
+        }
+    }
+    commit();
+    ASSERT_EQ(2, dictionary->entryCount());
+    ASSERT_EQ(dictionary->memorySize(), table->nonInlinedMemorySize());
+
+    beginWork();
+    table->deleteAllTuples(true);
+    commit();
+    ASSERT_EQ(0, dictionary->entryCount());
+    ASSERT_EQ(0, table->nonInlinedMemorySize());
+}
+
 int main() {
     return TestSuite::globalInstance()->runAll();
 }
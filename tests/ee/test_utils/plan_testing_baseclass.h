@@ -66,6 +66,8 @@ class EngineTestTopend : public voltdb::DummyTopend {
     typedef std::map<fragmentId_t, std::string> fragmentMap;
     fragmentMap m_fragments;
 public:
+    EngineTestTopend() : acceptResultChunks(false), resultChunksOffset(0) { }
+
     static EngineTestTopend *newInstance() {
         return new EngineTestTopend();
     }
@@ -81,6 +83,23 @@ public:
             return it->second;
         }
     }
+
+    /**
+     * Keep the result chunks pushed by the engine, once acceptResultChunks
+     * is set, rather than make it fall back to a larger buffer.
+     */
+    bool pushResultChunk(const char *data, size_t length, size_t headLength) {
+        if ( ! acceptResultChunks) {
+            return false;
+        }
+        resultChunks.append(data, length);
+        resultChunksOffset = headLength;
+        return true;
+    }
+
+    bool acceptResultChunks;
+    std::string resultChunks;
+    size_t resultChunksOffset;
 };
 
 /**
@@ -104,7 +123,8 @@ public:
         m_constraint(NULL),
         m_isinitialized(false),
         m_fragmentNumber(100),
-        m_paramCount(0)
+        m_paramCount(0),
+        m_tempTableMemoryLimit(voltdb::DEFAULT_TEMP_TABLE_MEMORY)
     { }
 
     void initialize(const char   *catalogString,
@@ -154,7 +174,7 @@ public:
         m_engine->resetReusedResultOutputBuffer();
         m_engine->resetPerFragmentStatsOutputBuffer();
         int partitionCount = 3;
-        m_engine->initialize(m_cluster_id, m_site_id, 0, 0, "", 0, 1024, voltdb::DEFAULT_TEMP_TABLE_MEMORY, false);
+        m_engine->initialize(m_cluster_id, m_site_id, 0, 0, "", 0, 1024, m_tempTableMemoryLimit, false);
         m_engine->updateHashinator(voltdb::HASHINATOR_LEGACY, (char*)&partitionCount, NULL, 0);
         ASSERT_TRUE(m_engine->loadCatalog( -2, m_catalog_string));
 
@@ -394,6 +414,8 @@ protected:
     size_t                                   m_paramCountOffset;
     int16_t                                  m_paramCount;
     voltdb::ReferenceSerializeOutput         m_paramsOutput;
+    // The engine's temp table limit, which a test can set before initialize()
+    int64_t                                  m_tempTableMemoryLimit;
     // The size for all the synthetic buffers except the result buffer.
     static const size_t  m_smallBufferSize = 4 * 1024;
     // The size of the result buffer.